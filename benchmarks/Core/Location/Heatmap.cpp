@@ -0,0 +1,91 @@
+#include "Core/Location/Heatmap.h"
+#include "Points.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @file Heatmap.cpp
+ * @brief heatmap ingestion from concurrent writers, and snapshots of a
+ * heatmap holding 1M events.
+ */
+
+namespace {
+constexpr size_t PointCount = 1 << 20;
+
+const Heatmap::TimePoint Now =
+    Heatmap::TimePoint(std::chrono::seconds(1'700'000'000));
+
+const std::vector<GeoPoint> &Points() {
+  static const auto Data = [] {
+    std::vector<GeoPoint> Data;
+    Data.reserve(PointCount);
+    for (const auto &Point : MakePoints(PointCount, 8)) {
+      Data.push_back(*GeoPoint::Create(Point.latitude, Point.longitude));
+    }
+    return Data;
+  }();
+  return Data;
+}
+
+/**
+ * @brief the events spread over the last 10 minutes.
+ */
+const Heatmap &Loaded(size_t CodeLength) {
+  static std::vector<std::unique_ptr<Heatmap>> Maps(13);
+  if (!Maps[CodeLength]) {
+    Maps[CodeLength] =
+        std::make_unique<Heatmap>(HeatmapOptions{.CodeLength = CodeLength});
+    const auto &Data = Points();
+    for (size_t i = 0; i < Data.size(); i++) {
+      Maps[CodeLength]->Record(Data[i], 1,
+                               Now - std::chrono::seconds(i % 600));
+    }
+  }
+  return *Maps[CodeLength];
+}
+} // namespace
+
+static void BM_Record(benchmark::State &State) {
+  static Heatmap Map;
+  const auto &Data = Points();
+  size_t i = State.thread_index() * (Data.size() / State.threads());
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Map.Record(Data[i++ % Data.size()], 1, Now));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_Record)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_Get(benchmark::State &State) {
+  const auto &Map = Loaded(10);
+  const auto &Data = Points();
+  size_t i = 0;
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(
+        Map.Get(Data[i++ % Data.size()].GetCellId().parent(State.range(0)),
+                std::chrono::minutes(5), Now));
+  }
+}
+BENCHMARK(BM_Get)->Arg(10)->Arg(8)->Arg(6);
+
+static void BM_Snapshot(benchmark::State &State) {
+  const auto &Map = Loaded(State.range(0));
+  for (auto _ : State) {
+    auto Cells = Map.Snapshot(std::chrono::minutes(5), Now);
+    State.counters["Cells"] = static_cast<double>(Cells.size());
+    benchmark::DoNotOptimize(Cells);
+  }
+}
+BENCHMARK(BM_Snapshot)->Arg(8)->Arg(10)->Unit(benchmark::kMillisecond);
+
+static void BM_Rollup(benchmark::State &State) {
+  const auto Cells = Loaded(10).Snapshot(std::chrono::minutes(5), Now);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Heatmap::Rollup(Cells, State.range(0)));
+  }
+  State.SetItemsProcessed(State.iterations() * Cells.size());
+}
+BENCHMARK(BM_Rollup)->Arg(8)->Arg(6)->Arg(4)->Unit(benchmark::kMillisecond);
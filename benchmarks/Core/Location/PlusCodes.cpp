@@ -0,0 +1,345 @@
+#include "Core/Location/PlusCodes/openlocationcode.h"
+#include "Core/Location/PlusCodes/validator.h"
+#include "Core/PerfCounters.h"
+#include "Points.h"
+#include "Reference/Differential.h"
+
+#include <benchmark/benchmark.h>
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @file PlusCodes.cpp
+ * @brief plus code operations next to the reference implementation, over the
+ * same clustered coordinates as the spatial index benchmark. before running,
+ * the two implementations are compared and any difference fails the run.
+ */
+
+namespace olc = openlocationcode;
+namespace ref = openlocationcode_reference;
+
+namespace {
+constexpr size_t PointCount = 1 << 16;
+constexpr size_t DifferentialCount = 200'000;
+
+const std::vector<olc::LatLng> &Points() {
+  static const auto Data = MakePoints(PointCount, 3);
+  return Data;
+}
+
+/**
+ * @brief a reference location a few kilometres from each point, like the
+ * user's own location when shortening an address code.
+ */
+std::vector<olc::LatLng> MakeReferences(const std::vector<olc::LatLng> &Of,
+                                        uint32_t Seed) {
+  std::mt19937 Generator(Seed);
+  std::uniform_real_distribution<double> Offset(-0.05, 0.05);
+  std::vector<olc::LatLng> References;
+  References.reserve(Of.size());
+  for (const auto &Point : Of) {
+    References.push_back(
+        {Point.latitude + Offset(Generator), Point.longitude + Offset(Generator)});
+  }
+  return References;
+}
+
+const std::vector<olc::LatLng> &References() {
+  static const auto Data = MakeReferences(Points(), 4);
+  return Data;
+}
+
+const std::vector<std::string> &Codes() {
+  static const auto Data = [] {
+    std::vector<std::string> Codes;
+    Codes.reserve(Points().size());
+    for (const auto &Point : Points()) {
+      Codes.push_back(olc::Encode(Point));
+    }
+    return Codes;
+  }();
+  return Data;
+}
+
+/**
+ * @brief the codes, with every fourth one corrupted so IsValid rejects it at
+ * a random position.
+ */
+const std::vector<std::string> &MixedCodes() {
+  static const auto Data = [] {
+    std::mt19937 Generator(5);
+    std::uniform_int_distribution<size_t> Position(0, 10);
+    auto Codes = ::Codes();
+    for (size_t i = 0; i < Codes.size(); i += 4) {
+      Codes[i][Position(Generator)] = 'A';
+    }
+    return Codes;
+  }();
+  return Data;
+}
+
+const std::vector<std::string> &ShortCodes() {
+  static const auto Data = [] {
+    std::vector<std::string> Codes;
+    Codes.reserve(Points().size());
+    for (size_t i = 0; i < Points().size(); i++) {
+      Codes.push_back(olc::Shorten(::Codes()[i], References()[i]));
+    }
+    return Codes;
+  }();
+  return Data;
+}
+
+/**
+ * @brief the hardware counters of a benchmark's loop per item, next to its
+ * timings, from a read taken before the loop. the events the machine doesn't
+ * offer are left out.
+ */
+void SetPerfCounters(benchmark::State &State, const PerfSample &Begin,
+                     int64_t Items) {
+  const auto Delta = PerfCounters::ForThread().Read() - Begin;
+  if (Items <= 0) {
+    return;
+  }
+  for (size_t i = 0; i < PerfSample::Size; i++) {
+    const auto Event = static_cast<PerfEvent>(i);
+    if (Delta.Has(Event)) {
+      State.counters[std::string(PerfCounters::Name(Event))] =
+          static_cast<double>(Delta.Get(Event)) / static_cast<double>(Items);
+    }
+  }
+  if (Delta.Has(PerfEvent::Cycles) && Delta.Has(PerfEvent::Instructions) &&
+      Delta.Get(PerfEvent::Cycles) != 0) {
+    State.counters["ipc"] =
+        static_cast<double>(Delta.Get(PerfEvent::Instructions)) /
+        static_cast<double>(Delta.Get(PerfEvent::Cycles));
+  }
+}
+
+ref::LatLng ToReference(const olc::LatLng &Location) {
+  return {Location.latitude, Location.longitude};
+}
+
+/**
+ * @brief compares the implementations on the benchmark distribution, on
+ * points along the edges of the globe and on malformed codes.
+ * @return size_t, the number of differences, each printed to stderr.
+ */
+size_t RunDifferential() {
+  std::vector<olc::LatLng> Locations = MakePoints(DifferentialCount, 6);
+  for (double Latitude : {-90.0, -89.9999999, 0.0, 89.9999999, 90.0}) {
+    for (double Longitude : {-180.0, -179.9999999, 0.0, 179.9999999, 180.0}) {
+      Locations.push_back({Latitude, Longitude});
+    }
+  }
+  const auto Nearby = MakeReferences(Locations, 7);
+
+  size_t Differences = 0;
+  auto Report = [&Differences](const std::vector<std::string> &Found) {
+    for (const auto &Difference : Found) {
+      if (Differences++ < 20) {
+        std::cerr << "plus code difference: " << Difference << '\n';
+      }
+    }
+  };
+  for (size_t i = 0; i < Locations.size(); i++) {
+    Report(PlusCodesDifferences(Locations[i], Nearby[i]));
+  }
+  for (const char *Code :
+       {"", "+", "0", "8F", "8FVC+", "8FVC0000+", "8FVC000+", "8FVC00+00",
+        "8fvc2222+22", "8FVC2222+2", "8FVC2222+22A", "8FVC2222+2222222",
+        "22+", "CJ+2VX", "CJ+2V0", "+2VX", "9C3W9QCJ2VX", "9C3W9QCJ++2VX",
+        "9C3W9QCJ+0", "C2000000+", "WC2F0000+", "8FVC22 2+22"}) {
+    Report(PlusCodesValidationDifferences(Code));
+  }
+  return Differences;
+}
+} // namespace
+
+static void BM_Encode(benchmark::State &State) {
+  const auto &Data = Points();
+  const size_t Length = State.range(0);
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(olc::Encode(Data[i++ % Data.size()], Length));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_Encode)->DenseRange(2, 10, 2)->Arg(11)->Arg(12)->Arg(15);
+
+static void BM_ReferenceEncode(benchmark::State &State) {
+  const auto &Data = Points();
+  const size_t Length = State.range(0);
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(
+        ref::Encode(ToReference(Data[i++ % Data.size()]), Length));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_ReferenceEncode)->DenseRange(2, 10, 2)->Arg(11)->Arg(12)->Arg(15);
+
+static void BM_Decode(benchmark::State &State) {
+  const auto &Data = Codes();
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(olc::Decode(Data[i++ % Data.size()]));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_Decode);
+
+static void BM_ReferenceDecode(benchmark::State &State) {
+  const auto &Data = Codes();
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(ref::Decode(Data[i++ % Data.size()]));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_ReferenceDecode);
+
+static void BM_IsValid(benchmark::State &State) {
+  const auto &Data = MixedCodes();
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(olc::IsValid(Data[i++ % Data.size()]));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_IsValid);
+
+static void BM_ReferenceIsValid(benchmark::State &State) {
+  const auto &Data = MixedCodes();
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(ref::IsValid(Data[i++ % Data.size()]));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_ReferenceIsValid);
+
+static void BM_ReferenceIsFull(benchmark::State &State) {
+  const auto &Data = MixedCodes();
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(ref::IsFull(Data[i++ % Data.size()]));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_ReferenceIsFull);
+
+static void BM_Classify(benchmark::State &State) {
+  const auto &Data = MixedCodes();
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(olc::Classify(Data[i++ % Data.size()]));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_Classify);
+
+static void BM_ClassifyBatch(benchmark::State &State) {
+  const auto &Data = MixedCodes();
+  std::vector<olc::CodeType> Types(Data.size());
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    olc::ClassifyBatch(std::span<const std::string>(Data), Types);
+    benchmark::DoNotOptimize(Types.data());
+  }
+  State.SetItemsProcessed(State.iterations() * Data.size());
+  SetPerfCounters(State, Counters, State.iterations() * Data.size());
+}
+BENCHMARK(BM_ClassifyBatch);
+
+static void BM_Shorten(benchmark::State &State) {
+  const auto &Data = Codes();
+  const auto &Near = References();
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    const size_t Index = i++ % Data.size();
+    benchmark::DoNotOptimize(olc::Shorten(Data[Index], Near[Index]));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_Shorten);
+
+static void BM_ReferenceShorten(benchmark::State &State) {
+  const auto &Data = Codes();
+  const auto &Near = References();
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    const size_t Index = i++ % Data.size();
+    benchmark::DoNotOptimize(
+        ref::Shorten(Data[Index], ToReference(Near[Index])));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_ReferenceShorten);
+
+static void BM_RecoverNearest(benchmark::State &State) {
+  const auto &Data = ShortCodes();
+  const auto &Near = References();
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    const size_t Index = i++ % Data.size();
+    benchmark::DoNotOptimize(olc::RecoverNearest(Data[Index], Near[Index]));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_RecoverNearest);
+
+static void BM_ReferenceRecoverNearest(benchmark::State &State) {
+  const auto &Data = ShortCodes();
+  const auto &Near = References();
+  size_t i = 0;
+  const auto Counters = PerfCounters::ForThread().Read();
+  for (auto _ : State) {
+    const size_t Index = i++ % Data.size();
+    benchmark::DoNotOptimize(
+        ref::RecoverNearest(Data[Index], ToReference(Near[Index])));
+  }
+  State.SetItemsProcessed(State.iterations());
+  SetPerfCounters(State, Counters, State.iterations());
+}
+BENCHMARK(BM_ReferenceRecoverNearest);
+
+int main(int argc, char **argv) {
+  if (size_t Differences = RunDifferential(); Differences != 0) {
+    std::cerr << Differences
+              << " differences from the reference implementation\n";
+    return 1;
+  }
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
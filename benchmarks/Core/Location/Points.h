@@ -0,0 +1,51 @@
+#ifndef BENCHMARK_POINTS_H
+#define BENCHMARK_POINTS_H
+
+#include "Core/Location/PlusCodes/codearea.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * @file Points.h
+ * @brief coordinates for the location benchmarks, mostly clustered around
+ * cities (like addresses are) with the rest spread uniformly.
+ */
+
+inline const std::vector<openlocationcode::LatLng> &BenchmarkCities() {
+  static const std::vector<openlocationcode::LatLng> Cities = {
+      {32.0853, 34.7818},   {40.7128, -74.0060},  {51.5074, -0.1278},
+      {35.6895, 139.6917},  {-23.5505, -46.6333}, {19.0760, 72.8777},
+      {-33.8688, 151.2093}, {55.7558, 37.6173}};
+  return Cities;
+}
+
+/**
+ * @brief one in five points is uniform, the rest are around a city.
+ * @param Count
+ * @param Seed
+ * @return std::vector<openlocationcode::LatLng>
+ */
+inline std::vector<openlocationcode::LatLng> MakePoints(size_t Count,
+                                                        uint32_t Seed) {
+  const auto &Cities = BenchmarkCities();
+  std::mt19937 Generator(Seed);
+  std::normal_distribution<double> Spread(0, 0.15);
+  std::uniform_real_distribution<double> Latitude(-60, 70);
+  std::uniform_real_distribution<double> Longitude(-180, 180);
+  std::vector<openlocationcode::LatLng> Points;
+  Points.reserve(Count);
+  for (size_t i = 0; i < Count; i++) {
+    if (i % 5 == 0) {
+      Points.push_back({Latitude(Generator), Longitude(Generator)});
+    } else {
+      const auto &City = Cities[i % Cities.size()];
+      Points.push_back({City.latitude + Spread(Generator),
+                        City.longitude + Spread(Generator)});
+    }
+  }
+  return Points;
+}
+
+#endif
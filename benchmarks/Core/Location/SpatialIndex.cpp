@@ -0,0 +1,120 @@
+#include "Core/Location/SpatialIndex.h"
+#include "Points.h"
+
+#include <benchmark/benchmark.h>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+/**
+ * @file SpatialIndex.cpp
+ * @brief spatial index over 10M points, mostly clustered around cities (like
+ * addresses are) with the rest spread uniformly.
+ */
+
+namespace {
+using Index = SpatialIndex<uint32_t>;
+
+constexpr size_t PointCount = 10'000'000;
+constexpr size_t QueryCount = 4096;
+
+std::vector<Index::Entry> MakeEntries() {
+  auto Points = MakePoints(PointCount, 1);
+  std::vector<Index::Entry> Entries;
+  Entries.reserve(Points.size());
+  for (uint32_t i = 0; i < Points.size(); i++) {
+    Entries.push_back({i, Points[i]});
+  }
+  return Entries;
+}
+
+const std::vector<Index::Entry> &Entries() {
+  static const auto Data = MakeEntries();
+  return Data;
+}
+
+const Index &LoadedIndex(size_t CodeLength) {
+  static std::vector<std::unique_ptr<Index>> Indexes(11);
+  if (!Indexes[CodeLength]) {
+    Indexes[CodeLength] = std::make_unique<Index>(CodeLength);
+    Indexes[CodeLength]->BulkLoad(Entries());
+  }
+  return *Indexes[CodeLength];
+}
+
+const std::vector<Index::LatLng> &Queries() {
+  static const auto Data = MakePoints(QueryCount, 2);
+  return Data;
+}
+} // namespace
+
+static void BM_BulkLoad(benchmark::State &State) {
+  const auto &Data = Entries();
+  for (auto _ : State) {
+    Index Grid(State.range(0));
+    Grid.BulkLoad(Data);
+    benchmark::DoNotOptimize(Grid.CellCount());
+  }
+  State.SetItemsProcessed(State.iterations() * Data.size());
+}
+BENCHMARK(BM_BulkLoad)->Arg(6)->Arg(8)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+static void BM_Nearest(benchmark::State &State) {
+  const auto &Grid = LoadedIndex(State.range(0));
+  const auto &Points = Queries();
+  size_t i = 0;
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(
+        Grid.Nearest(Points[i++ % Points.size()], State.range(1)));
+  }
+}
+BENCHMARK(BM_Nearest)->ArgsProduct({{6, 8}, {1, 10, 100}});
+
+static void BM_WithinRadius(benchmark::State &State) {
+  const auto &Grid = LoadedIndex(State.range(0));
+  const auto &Points = Queries();
+  size_t i = 0;
+  size_t Found = 0;
+  for (auto _ : State) {
+    auto Results = Grid.WithinRadius(Points[i++ % Points.size()],
+                                     static_cast<double>(State.range(1)));
+    Found += Results.size();
+    benchmark::DoNotOptimize(Results);
+  }
+  State.counters["Found"] = benchmark::Counter(
+      static_cast<double>(Found), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_WithinRadius)->ArgsProduct({{6, 8}, {100, 1000, 5000}});
+
+static void BM_InsertRemove(benchmark::State &State) {
+  Index Grid(8);
+  Grid.BulkLoad(Entries());
+  const auto &Points = Queries();
+  uint32_t Key = PointCount;
+  for (auto _ : State) {
+    const auto &Point = Points[Key % Points.size()];
+    Grid.Insert(Key, Point);
+    benchmark::DoNotOptimize(Grid.Remove(Key, Point));
+    Key++;
+  }
+}
+BENCHMARK(BM_InsertRemove);
+
+/**
+ * @brief the baseline, a full scan with the same distance function.
+ */
+static void BM_LinearScanNearest(benchmark::State &State) {
+  const auto &Data = Entries();
+  const auto &Points = Queries();
+  size_t i = 0;
+  for (auto _ : State) {
+    const auto &Query = Points[i++ % Points.size()];
+    double Best = std::numeric_limits<double>::max();
+    for (const auto &Entry : Data) {
+      Best = std::min(Best, Index::Distance(Query, Entry.Location));
+    }
+    benchmark::DoNotOptimize(Best);
+  }
+}
+BENCHMARK(BM_LinearScanNearest)->Unit(benchmark::kMillisecond)->Iterations(3);
@@ -0,0 +1,410 @@
+#include "Config/Config.h"
+#include "Config/DatabasePool.h"
+#include "Config/QueryStats.h"
+#include "Models/AddressModel.h"
+#include "Models/BaseLogModel.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * @file Orm.cpp
+ * @brief drives the models against the test database from several threads
+ * and prints the throughput and latencies as json, to diff between commits.
+ * @details every operation borrows a connection from the pool and returns
+ * it, so pool sizes under the thread count show up as waiting. the address
+ * rows are the benchmark's own (addressnumber from 1000000000 up) and are
+ * deleted when the run ends, the log rows are kept.
+ *
+ * OrmBenchmark [--config=PATH] [--threads=4] [--pool=10] [--duration=10]
+ *              [--warmup=2] [--mix=add:30,get:40,update:15,delete:10,log:5]
+ *              [--seed=1] [--label=TEXT] [--output=PATH]
+ */
+
+namespace {
+enum class Operation : size_t { Add, Get, Update, Delete, Log, Count };
+
+constexpr size_t OperationCount = static_cast<size_t>(Operation::Count);
+constexpr std::array<std::string_view, OperationCount> OperationNames = {
+    "add", "get", "update", "delete", "log"};
+
+/** @brief a thread's address numbers start at its own offset. */
+constexpr int64_t FirstAddressNumber = 1'000'000'000;
+constexpr int64_t AddressNumbersPerThread = 10'000'000;
+constexpr int MaxThreads = 100;
+
+struct Options {
+  std::filesystem::path ConfigPath = "../../configs/config.json";
+  int Threads = 4;
+  int PoolSize = DatabasePool::DefaultPoolSize;
+  std::chrono::seconds Duration{10};
+  std::chrono::seconds Warmup{2};
+  /** @brief the operations' relative weights. */
+  std::array<unsigned, OperationCount> Mix = {30, 40, 15, 10, 5};
+  uint32_t Seed = 1;
+  std::string Label;
+  std::string Output;
+};
+
+template <typename T> bool ParseNumber(std::string_view Text, T &Value) {
+  auto [End, Error] =
+      std::from_chars(Text.data(), Text.data() + Text.size(), Value);
+  return Error == std::errc{} && End == Text.data() + Text.size();
+}
+
+bool ParseMix(std::string_view Text,
+              std::array<unsigned, OperationCount> &Mix) {
+  Mix.fill(0);
+  while (!Text.empty()) {
+    const size_t Comma = Text.find(',');
+    const auto Entry = Text.substr(0, Comma);
+    Text = Comma == std::string_view::npos ? std::string_view{}
+                                           : Text.substr(Comma + 1);
+    const size_t Colon = Entry.find(':');
+    if (Colon == std::string_view::npos) {
+      return false;
+    }
+    const auto Name = Entry.substr(0, Colon);
+    const auto It =
+        std::find(OperationNames.begin(), OperationNames.end(), Name);
+    if (It == OperationNames.end() ||
+        !ParseNumber(Entry.substr(Colon + 1),
+                     Mix[static_cast<size_t>(It - OperationNames.begin())])) {
+      return false;
+    }
+  }
+  return std::any_of(Mix.begin(), Mix.end(),
+                     [](unsigned Weight) { return Weight != 0; });
+}
+
+std::optional<Options> ParseOptions(int argc, char **argv) {
+  Options Parsed;
+  for (int i = 1; i < argc; i++) {
+    const std::string_view Argument = argv[i];
+    const size_t Equals = Argument.find('=');
+    const auto Key = Argument.substr(0, Equals);
+    const auto Value = Equals == std::string_view::npos
+                           ? std::string_view{}
+                           : Argument.substr(Equals + 1);
+    int64_t Seconds = 0;
+    bool Valid = true;
+    if (Key == "--config") {
+      Parsed.ConfigPath = Value;
+    } else if (Key == "--threads") {
+      Valid = ParseNumber(Value, Parsed.Threads) && Parsed.Threads > 0 &&
+              Parsed.Threads <= MaxThreads;
+    } else if (Key == "--pool") {
+      Valid = ParseNumber(Value, Parsed.PoolSize) && Parsed.PoolSize > 0;
+    } else if (Key == "--duration") {
+      Valid = ParseNumber(Value, Seconds) && Seconds > 0;
+      Parsed.Duration = std::chrono::seconds(Seconds);
+    } else if (Key == "--warmup") {
+      Valid = ParseNumber(Value, Seconds) && Seconds >= 0;
+      Parsed.Warmup = std::chrono::seconds(Seconds);
+    } else if (Key == "--mix") {
+      Valid = ParseMix(Value, Parsed.Mix);
+    } else if (Key == "--seed") {
+      Valid = ParseNumber(Value, Parsed.Seed);
+    } else if (Key == "--label") {
+      Parsed.Label = Value;
+    } else if (Key == "--output") {
+      Parsed.Output = Value;
+    } else {
+      Valid = false;
+    }
+    if (!Valid) {
+      std::cerr << "invalid argument: " << Argument << '\n';
+      return std::nullopt;
+    }
+  }
+  return Parsed;
+}
+
+struct ThreadResult {
+  std::array<std::vector<int64_t>, OperationCount> Latencies;
+  std::array<uint64_t, OperationCount> Errors{};
+};
+
+/**
+ * @class Worker
+ * @brief one benchmark thread, its own addresses and random stream.
+ */
+class Worker {
+public:
+  Worker(DatabasePool &Pool, int Index, const Options &Settings)
+      : m_Pool(Pool),
+        m_NextNumber(FirstAddressNumber + Index * AddressNumbersPerThread),
+        m_Generator(Settings.Seed + static_cast<uint32_t>(Index)),
+        m_Pick(Settings.Mix.begin(), Settings.Mix.end()) {}
+
+  /**
+   * @brief runs operations until End, timing those started after
+   * MeasureFrom.
+   */
+  void Run(std::chrono::steady_clock::time_point MeasureFrom,
+           std::chrono::steady_clock::time_point End) {
+    for (auto &Latencies : m_Result.Latencies) {
+      Latencies.reserve(1 << 14);
+    }
+    while (true) {
+      const auto Begin = std::chrono::steady_clock::now();
+      if (Begin >= End) {
+        break;
+      }
+      auto Picked = static_cast<Operation>(m_Pick(m_Generator));
+      if (m_Live.empty() && Picked != Operation::Log) {
+        Picked = Operation::Add;
+      }
+      const bool Succeeded = Execute(Picked);
+      if (Begin >= MeasureFrom) {
+        const auto Index = static_cast<size_t>(Picked);
+        m_Result.Latencies[Index].push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - Begin)
+                .count());
+        m_Result.Errors[Index] += Succeeded ? 0 : 1;
+      }
+    }
+  }
+
+  /**
+   * @brief deletes the addresses the run left behind.
+   */
+  void Cleanup() {
+    auto Manager = m_Pool.GetManagerConnection();
+    for (int64_t Number : m_Live) {
+      m_Address->Delete(Manager, "addressnumber", Number);
+    }
+    m_Live.clear();
+    m_Pool.ReturnConnection(Manager);
+  }
+
+  [[nodiscard]] ThreadResult &GetResult() { return m_Result; }
+
+private:
+  bool Execute(Operation Picked) {
+    auto Manager = m_Pool.GetManagerConnection();
+    bool Succeeded = false;
+    try {
+      Succeeded = ExecuteOn(Manager, Picked);
+    } catch (const std::exception &) {
+      Succeeded = false;
+    }
+    m_Pool.ReturnConnection(Manager);
+    return Succeeded;
+  }
+
+  bool ExecuteOn(SharedManager &Manager, Operation Picked) {
+    switch (Picked) {
+    case Operation::Add: {
+      const int64_t Number = m_NextNumber++;
+      auto Result = m_Address->Add(Manager, {{"addressname", "ormbenchmark"},
+                                             {"addressnumber",
+                                              std::to_string(Number)},
+                                             {"addresscity", "holon"},
+                                             {"addressdistrict", "center"},
+                                             {"country", "israel"},
+                                             {"latitude", "32.0158"},
+                                             {"longitude", "34.7874"}});
+      if (Result.affected_rows() == 0) {
+        return false;
+      }
+      m_Live.push_back(Number);
+      return true;
+    }
+    case Operation::Get: {
+      const int64_t Number = m_Live[PickLive()];
+      return !m_Address->GetAddressID(Manager, "ormbenchmark", Number).empty();
+    }
+    case Operation::Update: {
+      const int64_t Number = m_Live[PickLive()];
+      return m_Address
+                 ->Update(Manager, {{"addresscity", "tel aviv"}},
+                          "addressnumber", Number)
+                 .affected_rows() != 0;
+    }
+    case Operation::Delete: {
+      const size_t Index = PickLive();
+      const int64_t Number = m_Live[Index];
+      m_Live[Index] = m_Live.back();
+      m_Live.pop_back();
+      return m_Address->Delete(Manager, "addressnumber", Number)
+                 .affected_rows() != 0;
+    }
+    case Operation::Log:
+      return m_Log->GetModel()
+                 ->Add(Manager, {{"loglevel", "INFO"},
+                                 {"logmsg", "orm benchmark"}})
+                 .affected_rows() != 0;
+    case Operation::Count:
+      break;
+    }
+    return false;
+  }
+
+  size_t PickLive() {
+    return std::uniform_int_distribution<size_t>(0, m_Live.size() - 1)(
+        m_Generator);
+  }
+
+private:
+  DatabasePool &m_Pool;
+  UniquePtrModel<AddressModel> m_Address =
+      m_Pool.GetUniqueModelConnection<AddressModel>();
+  UniquePtrModel<LogModel> m_Log = m_Pool.GetUniqueModelConnection<LogModel>();
+  int64_t m_NextNumber;
+  std::vector<int64_t> m_Live;
+  std::mt19937 m_Generator;
+  std::discrete_distribution<size_t> m_Pick;
+  ThreadResult m_Result;
+};
+
+/**
+ * @brief count, errors, throughput and latency percentiles in microseconds.
+ */
+Json Summarize(std::vector<int64_t> &Latencies, uint64_t Errors,
+               std::chrono::seconds Duration) {
+  std::sort(Latencies.begin(), Latencies.end());
+  auto Quantile = [&Latencies](double Percentile) {
+    if (Latencies.empty()) {
+      return 0.0;
+    }
+    const auto Index = static_cast<size_t>(
+        Percentile / 100 * static_cast<double>(Latencies.size() - 1));
+    return static_cast<double>(Latencies[Index]) / 1000;
+  };
+  double Total = 0;
+  for (int64_t Latency : Latencies) {
+    Total += static_cast<double>(Latency);
+  }
+  return {
+      {"ops", Latencies.size()},
+      {"errors", Errors},
+      {"ops_per_second",
+       static_cast<double>(Latencies.size()) /
+           static_cast<double>(Duration.count())},
+      {"latency_us",
+       {{"mean", Latencies.empty()
+                     ? 0.0
+                     : Total / static_cast<double>(Latencies.size()) / 1000},
+        {"p50", Quantile(50)},
+        {"p90", Quantile(90)},
+        {"p99", Quantile(99)},
+        {"p999", Quantile(99.9)},
+        {"max", Quantile(100)}}}};
+}
+
+Json Report(const Options &Settings,
+            std::vector<std::unique_ptr<Worker>> &Workers) {
+  Json Mix;
+  for (size_t i = 0; i < OperationCount; i++) {
+    Mix[std::string(OperationNames[i])] = Settings.Mix[i];
+  }
+  Json Output = {{"benchmark", "orm"},
+                 {"label", Settings.Label},
+                 {"config",
+                  {{"threads", Settings.Threads},
+                   {"pool_size", Settings.PoolSize},
+                   {"duration_seconds", Settings.Duration.count()},
+                   {"warmup_seconds", Settings.Warmup.count()},
+                   {"seed", Settings.Seed},
+                   {"mix", Mix}}}};
+
+  std::vector<int64_t> All;
+  uint64_t AllErrors = 0;
+  for (size_t i = 0; i < OperationCount; i++) {
+    std::vector<int64_t> Latencies;
+    uint64_t Errors = 0;
+    for (auto &Current : Workers) {
+      auto &Result = Current->GetResult();
+      Latencies.insert(Latencies.end(), Result.Latencies[i].begin(),
+                       Result.Latencies[i].end());
+      Errors += Result.Errors[i];
+    }
+    All.insert(All.end(), Latencies.begin(), Latencies.end());
+    AllErrors += Errors;
+    Output["operations"][std::string(OperationNames[i])] =
+        Summarize(Latencies, Errors, Settings.Duration);
+  }
+  Output["total"] = Summarize(All, AllErrors, Settings.Duration);
+
+  /** @brief what the operations ran, from the same measured window. */
+  Json Queries = Json::array();
+  for (const auto &Entry : QueryStats::Snapshot()) {
+    Queries.push_back(Json{
+        {"table", Entry.Table},
+        {"fingerprint", Entry.Fingerprint},
+        {"count", Entry.Count},
+        {"errors", Entry.Errors},
+        {"mean_us",
+         std::chrono::duration<double, std::micro>(Entry.Mean()).count()},
+        {"p99_us",
+         std::chrono::duration<double, std::micro>(Entry.Quantile(99))
+             .count()}});
+  }
+  Output["queries"] = std::move(Queries);
+  return Output;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  const auto Settings = ParseOptions(argc, argv);
+  if (!Settings) {
+    std::cerr << "usage: OrmBenchmark [--config=PATH] [--threads=N] "
+                 "[--pool=N] [--duration=SECONDS] [--warmup=SECONDS] "
+                 "[--mix=add:W,get:W,update:W,delete:W,log:W] [--seed=N] "
+                 "[--label=TEXT] [--output=PATH]\n";
+    return 1;
+  }
+
+  auto ConnectionString = Config::TestDatabaseToString(Settings->ConfigPath);
+  DatabasePool Pool{std::move(ConnectionString), Settings->PoolSize};
+  Pool.InitModels();
+
+  std::vector<std::unique_ptr<Worker>> Workers;
+  for (int i = 0; i < Settings->Threads; i++) {
+    Workers.push_back(std::make_unique<Worker>(Pool, i, *Settings));
+  }
+
+  const auto Start = std::chrono::steady_clock::now();
+  const auto MeasureFrom = Start + Settings->Warmup;
+  const auto End = MeasureFrom + Settings->Duration;
+  std::vector<std::thread> Threads;
+  for (auto &Current : Workers) {
+    Threads.emplace_back(
+        [&Current, MeasureFrom, End] { Current->Run(MeasureFrom, End); });
+  }
+  std::this_thread::sleep_until(MeasureFrom);
+  QueryStats::Reset();
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  const auto Output = Report(*Settings, Workers);
+
+  Threads.clear();
+  for (auto &Current : Workers) {
+    Threads.emplace_back([&Current] { Current->Cleanup(); });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+
+  if (Settings->Output.empty()) {
+    std::cout << Output.dump(2) << '\n';
+  } else {
+    std::ofstream File(Settings->Output, std::ios::trunc);
+    File << Output.dump(2) << '\n';
+    if (!File) {
+      std::cerr << "can't write " << Settings->Output << '\n';
+      return 1;
+    }
+  }
+  return 0;
+}
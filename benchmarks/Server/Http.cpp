@@ -0,0 +1,426 @@
+#include "Config/Config.h"
+#include "Core/Server/AddressApi.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/**
+ * @file Http.cpp
+ * @brief a closed loop load test of the http server, prints the requests
+ * per second and the latencies as json.
+ * @details every connection keeps one request in flight and sends the next
+ * as soon as the response is in, a client thread drives its connections
+ * with its own epoll. without --port the server runs in the process on a
+ * free loopback port, with /health only, and the address api over the test
+ * database with --database. a connection the server closes counts as an
+ * error and is opened again.
+ *
+ * HttpLoadTest [--port=N] [--host=127.0.0.1] [--server-threads=0]
+ *              [--database] [--config=PATH] [--pool=10] [--threads=2]
+ *              [--connections=64] [--method=GET] [--path=/health]
+ *              [--body=TEXT] [--duration=10] [--warmup=2] [--label=TEXT]
+ *              [--output=PATH]
+ */
+
+namespace {
+constexpr int MaxConnections = 10'000;
+
+struct Options {
+  std::string Host = "127.0.0.1";
+  uint16_t Port = 0;
+  size_t ServerThreads = 0;
+  bool Database = false;
+  std::filesystem::path ConfigPath = "../../configs/config.json";
+  int PoolSize = DatabasePool::DefaultPoolSize;
+  int Threads = 2;
+  int Connections = 64;
+  std::string Method = "GET";
+  std::string Path = "/health";
+  std::string Body;
+  std::chrono::seconds Duration{10};
+  std::chrono::seconds Warmup{2};
+  std::string Label;
+  std::string Output;
+};
+
+template <typename T> bool ParseNumber(std::string_view Text, T &Value) {
+  auto [End, Error] =
+      std::from_chars(Text.data(), Text.data() + Text.size(), Value);
+  return Error == std::errc{} && End == Text.data() + Text.size();
+}
+
+std::optional<Options> ParseOptions(int argc, char **argv) {
+  Options Parsed;
+  for (int i = 1; i < argc; i++) {
+    const std::string_view Argument = argv[i];
+    const size_t Equals = Argument.find('=');
+    const auto Key = Argument.substr(0, Equals);
+    const auto Value = Equals == std::string_view::npos
+                           ? std::string_view{}
+                           : Argument.substr(Equals + 1);
+    int64_t Seconds = 0;
+    bool Valid = true;
+    if (Key == "--port") {
+      Valid = ParseNumber(Value, Parsed.Port) && Parsed.Port != 0;
+    } else if (Key == "--host") {
+      Parsed.Host = Value;
+    } else if (Key == "--server-threads") {
+      Valid = ParseNumber(Value, Parsed.ServerThreads);
+    } else if (Key == "--database") {
+      Parsed.Database = true;
+    } else if (Key == "--config") {
+      Parsed.ConfigPath = Value;
+    } else if (Key == "--pool") {
+      Valid = ParseNumber(Value, Parsed.PoolSize) && Parsed.PoolSize > 0;
+    } else if (Key == "--threads") {
+      Valid = ParseNumber(Value, Parsed.Threads) && Parsed.Threads > 0;
+    } else if (Key == "--connections") {
+      Valid = ParseNumber(Value, Parsed.Connections) &&
+              Parsed.Connections > 0 && Parsed.Connections <= MaxConnections;
+    } else if (Key == "--method") {
+      Parsed.Method = Value;
+    } else if (Key == "--path") {
+      Parsed.Path = Value;
+      Valid = Parsed.Path.starts_with('/');
+    } else if (Key == "--body") {
+      Parsed.Body = Value;
+    } else if (Key == "--duration") {
+      Valid = ParseNumber(Value, Seconds) && Seconds > 0;
+      Parsed.Duration = std::chrono::seconds(Seconds);
+    } else if (Key == "--warmup") {
+      Valid = ParseNumber(Value, Seconds) && Seconds >= 0;
+      Parsed.Warmup = std::chrono::seconds(Seconds);
+    } else if (Key == "--label") {
+      Parsed.Label = Value;
+    } else if (Key == "--output") {
+      Parsed.Output = Value;
+    } else {
+      Valid = false;
+    }
+    if (!Valid) {
+      std::cerr << "invalid argument: " << Argument << '\n';
+      return std::nullopt;
+    }
+  }
+  Parsed.Threads = std::min(Parsed.Threads, Parsed.Connections);
+  return Parsed;
+}
+
+struct ThreadResult {
+  std::vector<int64_t> Latencies;
+  uint64_t Errors = 0;
+};
+
+/**
+ * @brief the status and length of the response at the start of Input, 0
+ * while it's incomplete.
+ */
+size_t ResponseLength(std::string_view Input, int &Status) {
+  const size_t End = Input.find("\r\n\r\n");
+  if (End == std::string_view::npos || Input.size() < 12) {
+    return 0;
+  }
+  ParseNumber(Input.substr(9, 3), Status);
+  size_t ContentLength = 0;
+  const auto Headers = Input.substr(0, End);
+  const size_t Header = Headers.find("Content-Length: ");
+  if (Header != std::string_view::npos) {
+    const auto Value = Headers.substr(Header + 16);
+    std::from_chars(Value.data(), Value.data() + Value.size(), ContentLength);
+  }
+  const size_t Length = End + 4 + ContentLength;
+  return Input.size() < Length ? 0 : Length;
+}
+
+/**
+ * @class Client
+ * @brief one client thread, its connections and its epoll.
+ */
+class Client {
+public:
+  Client(const Options &Settings, std::string_view Request, int Connections)
+      : m_Settings(Settings), m_Request(Request), m_Connections(Connections),
+        m_Epoll(epoll_create1(EPOLL_CLOEXEC)) {}
+
+  ~Client() {
+    for (auto &Current : m_Connections) {
+      if (Current.Socket >= 0) {
+        close(Current.Socket);
+      }
+    }
+    close(m_Epoll);
+  }
+
+  Client(const Client &) = delete;
+  Client &operator=(const Client &) = delete;
+
+  /**
+   * @brief sends until End, timing the requests sent after MeasureFrom.
+   */
+  void Run(std::chrono::steady_clock::time_point MeasureFrom,
+           std::chrono::steady_clock::time_point End) {
+    m_Result.Latencies.reserve(1 << 20);
+    for (auto &Current : m_Connections) {
+      Open(Current);
+    }
+    std::array<epoll_event, 256> Events;
+    while (std::chrono::steady_clock::now() < End) {
+      const int Count =
+          epoll_wait(m_Epoll, Events.data(), Events.size(), 100);
+      for (int i = 0; i < Count; i++) {
+        Receive(*static_cast<Connection *>(Events[i].data.ptr), MeasureFrom);
+      }
+    }
+  }
+
+  [[nodiscard]] ThreadResult &GetResult() { return m_Result; }
+
+private:
+  struct Connection {
+    int Socket{-1};
+    std::string Input;
+    std::chrono::steady_clock::time_point Begin;
+  };
+
+  void Open(Connection &Current) {
+    if (Current.Socket >= 0) {
+      close(Current.Socket);
+    }
+    Current.Input.clear();
+    Current.Socket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in Address{};
+    Address.sin_family = AF_INET;
+    Address.sin_port = htons(m_Settings.Port);
+    inet_pton(AF_INET, m_Settings.Host.c_str(), &Address.sin_addr);
+    int Enable = 1;
+    setsockopt(Current.Socket, IPPROTO_TCP, TCP_NODELAY, &Enable,
+               sizeof(Enable));
+    epoll_event Event{};
+    Event.events = EPOLLIN;
+    Event.data.ptr = &Current;
+    if (connect(Current.Socket, reinterpret_cast<sockaddr *>(&Address),
+                sizeof(Address)) != 0 ||
+        epoll_ctl(m_Epoll, EPOLL_CTL_ADD, Current.Socket, &Event) != 0) {
+      std::cerr << "can't connect to " << m_Settings.Host << ':'
+                << m_Settings.Port << '\n';
+      std::exit(1);
+    }
+    Send(Current);
+  }
+
+  /**
+   * @brief the requests are small, a blocking send takes them whole.
+   */
+  void Send(Connection &Current) {
+    Current.Begin = std::chrono::steady_clock::now();
+    if (send(Current.Socket, m_Request.data(), m_Request.size(),
+             MSG_NOSIGNAL) != static_cast<ssize_t>(m_Request.size())) {
+      m_Result.Errors++;
+      Open(Current);
+    }
+  }
+
+  void Receive(Connection &Current,
+               std::chrono::steady_clock::time_point MeasureFrom) {
+    char Buffer[16 * 1024];
+    const ssize_t Read =
+        recv(Current.Socket, Buffer, sizeof(Buffer), MSG_DONTWAIT);
+    if (Read <= 0) {
+      if (Read == 0 || (errno != EAGAIN && errno != EINTR)) {
+        m_Result.Errors++;
+        Open(Current);
+      }
+      return;
+    }
+    Current.Input.append(Buffer, static_cast<size_t>(Read));
+    int Status = 0;
+    const size_t Length = ResponseLength(Current.Input, Status);
+    if (Length == 0) {
+      return;
+    }
+    if (Current.Begin >= MeasureFrom) {
+      m_Result.Latencies.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - Current.Begin)
+              .count());
+      m_Result.Errors += Status >= 200 && Status < 400 ? 0 : 1;
+    }
+    Current.Input.erase(0, Length);
+    Send(Current);
+  }
+
+private:
+  const Options &m_Settings;
+  std::string_view m_Request;
+  std::vector<Connection> m_Connections;
+  int m_Epoll;
+  ThreadResult m_Result;
+};
+
+/**
+ * @brief count, errors, throughput and latency percentiles in microseconds.
+ */
+Json Summarize(std::vector<int64_t> &Latencies, uint64_t Errors,
+               std::chrono::seconds Duration) {
+  std::sort(Latencies.begin(), Latencies.end());
+  auto Quantile = [&Latencies](double Percentile) {
+    if (Latencies.empty()) {
+      return 0.0;
+    }
+    const auto Index = static_cast<size_t>(
+        Percentile / 100 * static_cast<double>(Latencies.size() - 1));
+    return static_cast<double>(Latencies[Index]) / 1000;
+  };
+  double Total = 0;
+  for (int64_t Latency : Latencies) {
+    Total += static_cast<double>(Latency);
+  }
+  return {
+      {"requests", Latencies.size()},
+      {"errors", Errors},
+      {"requests_per_second",
+       static_cast<double>(Latencies.size()) /
+           static_cast<double>(Duration.count())},
+      {"latency_us",
+       {{"mean", Latencies.empty()
+                     ? 0.0
+                     : Total / static_cast<double>(Latencies.size()) / 1000},
+        {"p50", Quantile(50)},
+        {"p90", Quantile(90)},
+        {"p99", Quantile(99)},
+        {"p999", Quantile(99.9)},
+        {"max", Quantile(100)}}}};
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  auto Settings = ParseOptions(argc, argv);
+  if (!Settings) {
+    std::cerr << "usage: HttpLoadTest [--port=N] [--host=ADDRESS] "
+                 "[--server-threads=N] [--database] [--config=PATH] "
+                 "[--pool=N] [--threads=N] [--connections=N] "
+                 "[--method=METHOD] [--path=PATH] [--body=TEXT] "
+                 "[--duration=SECONDS] [--warmup=SECONDS] [--label=TEXT] "
+                 "[--output=PATH]\n";
+    return 1;
+  }
+
+  /** @brief the in process server, when no port is given. */
+  std::unique_ptr<DatabasePool> Pool;
+  std::unique_ptr<ObjectLogPipeline> Pipeline;
+  std::unique_ptr<AddressApi> Api;
+  std::unique_ptr<HttpServer> Server;
+  if (Settings->Port == 0) {
+    Server = std::make_unique<HttpServer>(HttpServerOptions{
+        .Address = Settings->Host,
+        .Port = 0,
+        .Threads = Settings->ServerThreads,
+        .MaxConnections = static_cast<size_t>(Settings->Connections)});
+    if (Settings->Database) {
+      Pool = std::make_unique<DatabasePool>(
+          Config::TestDatabaseToString(Settings->ConfigPath),
+          Settings->PoolSize);
+      Pool->InitModels();
+      Pipeline = std::make_unique<ObjectLogPipeline>(*Pool);
+      Api = std::make_unique<AddressApi>(*Pool, *Pipeline);
+      Api->Register(*Server);
+    } else {
+      Server->Route(HttpMethod::Get, "/health",
+                    [](const HttpRequest &, HttpResponse &Response) {
+                      Response.Body = R"({"status":"ok"})";
+                    });
+    }
+    if (!Server->Start()) {
+      std::cerr << "can't start the server\n";
+      return 1;
+    }
+    Settings->Port = Server->GetPort();
+  }
+
+  std::string Request;
+  Request.append(Settings->Method)
+      .append(" ")
+      .append(Settings->Path)
+      .append(" HTTP/1.1\r\nHost: ")
+      .append(Settings->Host)
+      .append("\r\n");
+  if (!Settings->Body.empty()) {
+    Request.append("Content-Type: application/json\r\nContent-Length: ")
+        .append(std::to_string(Settings->Body.size()))
+        .append("\r\n");
+  }
+  Request.append("\r\n").append(Settings->Body);
+
+  std::vector<std::unique_ptr<Client>> Clients;
+  for (int i = 0; i < Settings->Threads; i++) {
+    /** @brief the connections spread evenly, the first threads take more. */
+    const int Connections = Settings->Connections / Settings->Threads +
+                            (i < Settings->Connections % Settings->Threads);
+    Clients.push_back(std::make_unique<Client>(*Settings, Request,
+                                               Connections));
+  }
+
+  const auto Start = std::chrono::steady_clock::now();
+  const auto MeasureFrom = Start + Settings->Warmup;
+  const auto End = MeasureFrom + Settings->Duration;
+  std::vector<std::thread> Threads;
+  for (auto &Current : Clients) {
+    Threads.emplace_back(
+        [&Current, MeasureFrom, End] { Current->Run(MeasureFrom, End); });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+
+  std::vector<int64_t> Latencies;
+  uint64_t Errors = 0;
+  for (auto &Current : Clients) {
+    auto &Result = Current->GetResult();
+    Latencies.insert(Latencies.end(), Result.Latencies.begin(),
+                     Result.Latencies.end());
+    Errors += Result.Errors;
+  }
+  Json Output = {{"benchmark", "http"},
+                 {"label", Settings->Label},
+                 {"config",
+                  {{"in_process", Server != nullptr},
+                   {"server_threads",
+                    Server ? Server->GetThreadCount() : size_t{0}},
+                   {"client_threads", Settings->Threads},
+                   {"connections", Settings->Connections},
+                   {"method", Settings->Method},
+                   {"path", Settings->Path},
+                   {"duration_seconds", Settings->Duration.count()},
+                   {"warmup_seconds", Settings->Warmup.count()}}}};
+  Output["total"] = Summarize(Latencies, Errors, Settings->Duration);
+  Clients.clear();
+  if (Server) {
+    Server->Stop();
+  }
+
+  if (Settings->Output.empty()) {
+    std::cout << Output.dump(2) << '\n';
+  } else {
+    std::ofstream File(Settings->Output, std::ios::trunc);
+    File << Output.dump(2) << '\n';
+    if (!File) {
+      std::cerr << "can't write " << Settings->Output << '\n';
+      return 1;
+    }
+  }
+  return 0;
+}
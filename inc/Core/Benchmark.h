@@ -1,17 +1,29 @@
 #ifndef BENCHMARK_H
 #define BENCHMARK_H
 
-#include <chrono>
-#include <iostream>
+#include "Config/Logger.h"
+#include "Core/Profiler.h"
 
-class Benchmark {
-public:
-  static constexpr float ms = 0.001;
-  using Clock = std::chrono::high_resolution_clock;
-  using TimePoint = std::chrono::time_point<std::chrono::high_resolution_clock>;
+#include <string_view>
 
+/**
+ * @class Benchmark
+ * @brief times its scope on the profiler's clock and adds it to the
+ * profiler zone of its name, whether the profiler is enabled or not.
+ * @details the result is kept to the nanosecond, see Profiler::Report for
+ * the aggregate of every run. with counters it also reads the thread's
+ * hardware counters, the events the machine doesn't offer are left out.
+ */
+class Benchmark {
 public:
-  Benchmark() { m_StartPoint = Clock::now(); }
+  explicit Benchmark(std::string_view Name = "Benchmark",
+                     bool WithCounters = false)
+      : m_Zone(Profiler::GetZone(Name)), m_WithCounters(WithCounters) {
+    if (m_WithCounters) {
+      m_Counters = PerfCounters::ForThread().Read();
+    }
+    m_StartPoint = Profiler::Now();
+  }
   ~Benchmark() { Stop(); }
 
   Benchmark(const Benchmark &) = delete;
@@ -20,24 +32,40 @@ public:
   Benchmark(Benchmark &&) = delete;
   Benchmark &operator=(Benchmark &&) = delete;
 
-  float Stop() {
-    auto EndPoint = Clock::now();
-
-    auto Start =
-        std::chrono::time_point_cast<std::chrono::microseconds>(m_StartPoint)
-            .time_since_epoch()
-            .count();
-    auto End = std::chrono::time_point_cast<std::chrono::microseconds>(EndPoint)
-                   .time_since_epoch()
-                   .count();
-
-    auto Result = static_cast<float>(End - Start) * ms;
-    std::cout << "BENCHMARK RESULT -> " << Result << "ms\n";
-    return Result;
+  /**
+   * @brief ends the run, later calls return the same result.
+   * @return double the run in milliseconds.
+   */
+  double Stop() {
+    if (!m_Stopped) {
+      const uint64_t EndPoint = Profiler::Now();
+      if (m_WithCounters) {
+        m_Counters = PerfCounters::ForThread().Read() - m_Counters;
+        m_Zone.AddCounters(m_Counters);
+      }
+      Profiler::Record(m_Zone, m_StartPoint, EndPoint);
+      const uint64_t Nanoseconds =
+          Profiler::ToNanoseconds(EndPoint - m_StartPoint);
+      m_Result = static_cast<double>(Nanoseconds) / 1e6;
+      m_Stopped = true;
+      APP_DEBUG("BENCHMARK {} -> {}MS", m_Zone.GetName(), m_Result);
+    }
+    return m_Result;
   }
 
+  /**
+   * @brief the run's counters, after Stop and with counters.
+   * @return const PerfSample&
+   */
+  [[nodiscard]] const PerfSample &GetCounters() const { return m_Counters; }
+
 private:
-  TimePoint m_StartPoint;
+  ProfileZone &m_Zone;
+  bool m_WithCounters;
+  PerfSample m_Counters;
+  uint64_t m_StartPoint;
+  bool m_Stopped = false;
+  double m_Result = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,176 @@
+#ifndef GEO_POINT_H
+#define GEO_POINT_H
+
+#include "Geolocation.h"
+#include "PlusCodes/cellid.h"
+#include "PlusCodes/openlocationcode.h"
+
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+enum class GeoPointError : std::uint8_t {
+  NotFinite,
+  LatitudeOutOfRange,
+  LongitudeOutOfRange,
+};
+
+constexpr std::string_view GeoPointErrorToString(GeoPointError Error) {
+  switch (Error) {
+  case GeoPointError::NotFinite:
+    return "Coordinate Not Finite";
+  case GeoPointError::LatitudeOutOfRange:
+    return "Latitude Out Of Range";
+  case GeoPointError::LongitudeOutOfRange:
+    return "Longitude Out Of Range";
+  }
+  return "Unknown Geo Point Error";
+}
+
+/**
+ * @class GeoPoint
+ * @brief compact coordinate value for holding many points (a live map), 16
+ * bytes and trivially copyable.
+ * @details the coordinates are fixed point in 1e-7 degrees (~1cm) and the
+ * packed plus code cell is cached next to them, so no string or heap
+ * allocation is kept per point. the plus code string is only built when
+ * asked for. creation validates without throwing, use ToGeolocation for code
+ * that takes a Geolocation.
+ */
+class GeoPoint {
+public:
+  using Expected = std::expected<GeoPoint, GeoPointError>;
+
+  static constexpr double Scale = 1e7;
+  /**
+   * @brief code length of the cached cell, ~3.5m x 2.8m.
+   */
+  static constexpr size_t CellCodeLength =
+      openlocationcode::CellId::kMaxCodeLength;
+
+public:
+  /**
+   * @brief the point at (0, 0), its cell isn't cached.
+   */
+  constexpr GeoPoint() = default;
+
+  /**
+   * @brief validates the coordinates and caches the cell.
+   * @param Latitude degrees, -90 to 90.
+   * @param Longitude degrees, -180 to 180.
+   * @return Expected, the point or why the coordinates are rejected.
+   */
+  static constexpr Expected Create(double Latitude, double Longitude) {
+    if (!IsFinite(Latitude) || !IsFinite(Longitude)) {
+      return std::unexpected(GeoPointError::NotFinite);
+    }
+    if (Latitude < -90.0 || Latitude > 90.0) {
+      return std::unexpected(GeoPointError::LatitudeOutOfRange);
+    }
+    if (Longitude < -180.0 || Longitude > 180.0) {
+      return std::unexpected(GeoPointError::LongitudeOutOfRange);
+    }
+    return GeoPoint(Round(Latitude), Round(Longitude));
+  }
+
+  /**
+   * @brief validates fixed point coordinates (1e-7 degrees) and caches the
+   * cell.
+   * @param LatitudeE7
+   * @param LongitudeE7
+   * @return Expected
+   */
+  static constexpr Expected FromE7(int32_t LatitudeE7, int32_t LongitudeE7) {
+    if (LatitudeE7 < -900'000'000 || LatitudeE7 > 900'000'000) {
+      return std::unexpected(GeoPointError::LatitudeOutOfRange);
+    }
+    if (LongitudeE7 < -1'800'000'000 || LongitudeE7 > 1'800'000'000) {
+      return std::unexpected(GeoPointError::LongitudeOutOfRange);
+    }
+    return GeoPoint(LatitudeE7, LongitudeE7);
+  }
+
+  [[nodiscard]] constexpr int32_t GetLatitudeE7() const {
+    return m_LatitudeE7;
+  }
+  [[nodiscard]] constexpr int32_t GetLongitudeE7() const {
+    return m_LongitudeE7;
+  }
+  [[nodiscard]] constexpr double GetLatitude() const {
+    return m_LatitudeE7 / Scale;
+  }
+  [[nodiscard]] constexpr double GetLongitude() const {
+    return m_LongitudeE7 / Scale;
+  }
+  [[nodiscard]] constexpr openlocationcode::LatLng ToLatLng() const {
+    return {GetLatitude(), GetLongitude()};
+  }
+
+  /**
+   * @brief the cached cell, computed when the point wasn't created through
+   * Create/FromE7.
+   * @return openlocationcode::CellId
+   */
+  [[nodiscard]] constexpr openlocationcode::CellId GetCellId() const {
+    if (m_Cell != 0) {
+      return openlocationcode::CellId(m_Cell);
+    }
+    return openlocationcode::CellId::FromLatLng(ToLatLng(), CellCodeLength);
+  }
+
+  /**
+   * @brief the plus code, built from the cached cell when the length allows.
+   * @param CodeLength
+   * @return openlocationcode::CodeBuffer
+   */
+  [[nodiscard]] constexpr openlocationcode::CodeBuffer
+  GetPlusCode(size_t CodeLength = openlocationcode::internal::kPairCodeLength)
+      const {
+    if (CodeLength <= CellCodeLength &&
+        (CodeLength % 2 == 0 ||
+         CodeLength > openlocationcode::internal::kPairCodeLength)) {
+      return GetCellId().parent(CodeLength).ToCode();
+    }
+    return openlocationcode::Encode(ToLatLng(), CodeLength);
+  }
+
+  /**
+   * @brief converts to the Geolocation the rest of the code takes.
+   * @return Geolocation
+   */
+  [[nodiscard]] Geolocation ToGeolocation() const {
+    return {GetLatitude(), GetLongitude()};
+  }
+
+  friend constexpr bool operator==(const GeoPoint &Lhs, const GeoPoint &Rhs) {
+    return Lhs.m_LatitudeE7 == Rhs.m_LatitudeE7 &&
+           Lhs.m_LongitudeE7 == Rhs.m_LongitudeE7;
+  }
+
+private:
+  constexpr GeoPoint(int32_t LatitudeE7, int32_t LongitudeE7)
+      : m_LatitudeE7(LatitudeE7), m_LongitudeE7(LongitudeE7),
+        m_Cell(openlocationcode::CellId::FromLatLng(ToLatLng(), CellCodeLength)
+                   .id()) {}
+
+  static constexpr bool IsFinite(double Value) {
+    return Value == Value && Value != std::numeric_limits<double>::infinity() &&
+           Value != -std::numeric_limits<double>::infinity();
+  }
+
+  static constexpr int32_t Round(double Degrees) {
+    return static_cast<int32_t>(Degrees * Scale + (Degrees < 0 ? -0.5 : 0.5));
+  }
+
+private:
+  int32_t m_LatitudeE7{0};
+  int32_t m_LongitudeE7{0};
+  uint64_t m_Cell{0};
+};
+
+static_assert(sizeof(GeoPoint) == 16);
+static_assert(std::is_trivially_copyable_v<GeoPoint>);
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef GEOLOCATION_H
 #define GEOLOCATION_H
 
+#include "PlusCodes/cellid.h"
 #include "PlusCodes/openlocationcode.h"
 
 #include <string>
@@ -19,6 +20,12 @@ public:
   ~Geolocation() = default;
 
   [[nodiscard]] const std::string GetPlusCode() const;
+  /**
+   * @brief packed 64-bit form of the plus code, for keys and bigint columns.
+   * @return openlocationcode::CellId
+   */
+  [[nodiscard]] openlocationcode::CellId GetCellId() const;
+
   [[nodiscard]] const std::string GetCoordinatesString() const;
   [[nodiscard]] const std::pair<double, double> GetCoordinates() const;
 
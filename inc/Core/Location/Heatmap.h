@@ -0,0 +1,143 @@
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include "GeoPoint.h"
+#include "PlusCodes/cellid.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+struct HeatmapOptions {
+  /**
+   * @brief code length events are counted at, 1 to 12. 10 gives ~14m cells,
+   * 8 ~275m cells.
+   */
+  size_t CodeLength = 10;
+  /**
+   * @brief the window moves a bucket at a time, events are kept for
+   * BucketWidth * BucketCount (10 minutes by default) after a cell's newest
+   * event.
+   */
+  std::chrono::seconds BucketWidth{10};
+  size_t BucketCount = 60;
+  size_t ShardCount = 16;
+};
+
+/**
+ * @class Heatmap
+ * @brief live activity per plus code cell (address logs, gps pings), counted
+ * and summed over a sliding time window.
+ * @details time is cut in buckets and every cell keeps its non empty buckets
+ * oldest first. recording adds to the newest bucket, or appends one and drops
+ * the buckets that left the window, so events fall out without a sweep and a
+ * cell seen once costs a single bucket. cells are spread over
+ * shards by id, each behind its own mutex, so concurrent writers to
+ * different cells rarely wait on each other and a snapshot only holds one
+ * shard at a time, ingestion keeps going on the rest. the shards keep cells
+ * in id order, the descendants of a cell are one id range, which makes
+ * rollups into parent cells a range walk.
+ */
+class Heatmap {
+public:
+  using Clock = std::chrono::system_clock;
+  using TimePoint = Clock::time_point;
+  using CellId = openlocationcode::CellId;
+
+  struct Cell {
+    CellId Id;
+    uint64_t Count;
+    double Sum;
+  };
+
+public:
+  explicit Heatmap(HeatmapOptions Options = {});
+
+  Heatmap(const Heatmap &) = delete;
+  Heatmap &operator=(const Heatmap &) = delete;
+
+  /**
+   * @brief adds an event to the cell holding the point.
+   * @param Point
+   * @param Value summed per cell, 1 counts events.
+   * @param Time when the event happened.
+   * @return true, false if the event is older than the kept window.
+   */
+  bool Record(const GeoPoint &Point, double Value = 1,
+              TimePoint Time = Clock::now());
+  bool Record(const openlocationcode::LatLng &Location, double Value = 1,
+              TimePoint Time = Clock::now());
+  /**
+   * @brief adds an event to a cell, cells longer than the heatmap code length
+   * are counted in their parent.
+   */
+  bool Record(CellId Id, double Value, TimePoint Time);
+
+  /**
+   * @brief the events of a cell and its descendants in the window ending at
+   * Now.
+   * @param Id a cell of any length.
+   * @param Window clamped to the kept window.
+   * @param Now
+   * @return Cell
+   */
+  [[nodiscard]] Cell Get(CellId Id, std::chrono::seconds Window,
+                         TimePoint Now = Clock::now()) const;
+
+  /**
+   * @brief every cell with events in the window, sorted by id.
+   * @param Window
+   * @param Now
+   * @return std::vector<Cell>
+   */
+  [[nodiscard]] std::vector<Cell> Snapshot(std::chrono::seconds Window,
+                                           TimePoint Now = Clock::now()) const;
+
+  /**
+   * @brief merges cells into their parents of the given code length.
+   * @param Cells sorted by id, like Snapshot returns them.
+   * @param CodeLength
+   * @return std::vector<Cell>, sorted by id.
+   */
+  [[nodiscard]] static std::vector<Cell> Rollup(const std::vector<Cell> &Cells,
+                                                size_t CodeLength);
+
+  /**
+   * @brief drops the cells without events in the kept window.
+   * @param Now
+   * @return size_t, the number of cells dropped.
+   */
+  size_t Prune(TimePoint Now = Clock::now());
+
+  [[nodiscard]] size_t CellCount() const;
+  [[nodiscard]] const HeatmapOptions &GetOptions() const { return m_Options; }
+
+private:
+  struct Bucket {
+    int64_t Epoch;
+    uint64_t Count;
+    double Sum;
+  };
+
+  struct alignas(64) Shard {
+    mutable std::mutex Mutex;
+    std::map<uint64_t, std::vector<Bucket>> Cells;
+  };
+
+  [[nodiscard]] int64_t EpochOf(TimePoint Time) const;
+  [[nodiscard]] int64_t BucketsIn(std::chrono::seconds Window) const;
+  [[nodiscard]] size_t ShardOf(uint64_t Id) const;
+  /**
+   * @brief the events of the buckets in (Now - Buckets, Now].
+   */
+  static void AddWindow(const std::vector<Bucket> &CellBuckets, int64_t Now,
+                        int64_t Buckets, Cell &Total);
+
+private:
+  HeatmapOptions m_Options;
+  std::vector<Shard> m_Shards;
+};
+
+#endif
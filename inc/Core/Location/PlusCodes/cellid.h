@@ -0,0 +1,263 @@
+#ifndef LOCATION_OPENLOCATIONCODE_CELLID_H
+#define LOCATION_OPENLOCATIONCODE_CELLID_H
+// A CellId packs a full Open Location Code into a single 64-bit integer, for
+// use as a fixed-size key in hash maps, sorted arrays and bigint columns.
+//
+// Each code digit is stored as its alphabet position (0-19) in a 5-bit group,
+// most significant digit first. Pair digits alternate latitude and longitude
+// and grid digits combine a row and a column, so the groups interleave the
+// latitude and longitude indices. A single sentinel bit follows the last
+// digit, which encodes the code length (the same trick S2 cell ids use):
+//
+//   digit 0 | digit 1 | ... | digit n-1 | 1 | 0 ... 0
+//   63..59    58..54          ...         63 - 5n
+//
+// This gives the following properties:
+//  - Numeric order is the order of the codes, a Z-order curve over the Plus
+//    Code grid, so nearby cells mostly have nearby ids.
+//  - The parent cell is found by clearing the low digit groups and moving the
+//    sentinel up, without decoding.
+//  - All descendants of a cell lie in [range_min(), range_max()], so prefix
+//    queries become integer range queries.
+//  - The first latitude digit is at most 8, so bit 63 is never set by a cell
+//    with at least one digit and their ids keep their order when stored as a
+//    signed 64-bit integer. Only Root() sets it, as its sentinel.
+//
+// 12 digits (about 3.5 x 2.8 metres at the equator, more than enough for an
+// address) is the longest code that fits. Longer codes are truncated.
+
+#include "openlocationcode.h"
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace openlocationcode {
+
+class CellId {
+ public:
+  // Number of bits used by each code digit.
+  static constexpr size_t kBitsPerDigit = 5;
+  // The longest code that can be packed.
+  static constexpr size_t kMaxCodeLength = 12;
+
+  // The default CellId is invalid.
+  constexpr CellId() = default;
+  constexpr explicit CellId(uint64_t id) : id_(id) {}
+
+  // The cell containing every other cell (code length 0).
+  static constexpr CellId Root() { return CellId(uint64_t{1} << 63); }
+
+  // Returns the cell of the given code length containing the location. Code
+  // lengths are clamped and rounded the same way Encode does, and to at most
+  // kMaxCodeLength.
+  static constexpr CellId FromLatLng(const LatLng &location,
+                                     size_t code_length) {
+    return FromCode(Encode(location, std::min(code_length, kMaxCodeLength)));
+  }
+  static constexpr CellId FromLatLng(const LatLng &location) {
+    return FromLatLng(location, internal::kPairCodeLength);
+  }
+
+  // Returns the cell for a full code, or an invalid CellId if the code is not
+  // a valid full code. Padding is dropped and digits past kMaxCodeLength are
+  // ignored.
+  static constexpr CellId FromCode(std::string_view code) {
+    if (!IsFull(code)) {
+      return CellId();
+    }
+    uint64_t id = 0;
+    size_t length = 0;
+    for (char c : code) {
+      if (c == internal::kSeparator) {
+        continue;
+      }
+      if (c == internal::kPaddingCharacter || length == kMaxCodeLength) {
+        break;
+      }
+      id |= static_cast<uint64_t>(internal::get_alphabet_position(c))
+            << DigitShift(length);
+      length++;
+    }
+    return CellId(id | LsbForLength(length));
+  }
+
+  constexpr uint64_t id() const { return id_; }
+
+  // True for the cell with no digits.
+  constexpr bool is_root() const { return id_ == Root().id_; }
+
+  // True if the id has a sentinel in a legal position and every digit decodes
+  // to a legal location.
+  constexpr bool is_valid() const {
+    if (id_ == 0) {
+      return false;
+    }
+    const int trailing = std::countr_zero(id_);
+    if ((63 - trailing) % kBitsPerDigit != 0 ||
+        static_cast<size_t>(63 - trailing) / kBitsPerDigit > kMaxCodeLength) {
+      return false;
+    }
+    for (size_t i = 0; i < code_length(); i++) {
+      if (digit(i) >= static_cast<int>(internal::kEncodingBase)) {
+        return false;
+      }
+    }
+    // The same latitude and longitude bounds IsFull checks.
+    return !(code_length() > 0 && digit(0) * internal::kEncodingBase >=
+                                      internal::kLatitudeMaxDegrees * 2) &&
+           !(code_length() > 1 && digit(1) * internal::kEncodingBase >=
+                                      internal::kLongitudeMaxDegrees * 2);
+  }
+
+  // Number of code digits in the cell.
+  constexpr size_t code_length() const {
+    return static_cast<size_t>(63 - std::countr_zero(id_)) / kBitsPerDigit;
+  }
+
+  // Alphabet position of the i-th digit.
+  constexpr int digit(size_t i) const {
+    return static_cast<int>((id_ >> DigitShift(i)) & kDigitMask);
+  }
+
+  // The sentinel bit.
+  constexpr uint64_t lsb() const { return id_ & (~id_ + 1); }
+
+  // The enclosing cell with the given (shorter or equal) code length.
+  constexpr CellId parent(size_t code_length) const {
+    const uint64_t new_lsb = LsbForLength(code_length);
+    return CellId((id_ & ~(new_lsb | (new_lsb - 1))) | new_lsb);
+  }
+  // The enclosing cell one digit up. The root is its own parent.
+  constexpr CellId parent() const {
+    return is_root() ? *this : parent(code_length() - 1);
+  }
+
+  // The cell one digit down with the given alphabet position. A cell of
+  // kMaxCodeLength has no room for another digit and is its own child.
+  constexpr CellId child(int position) const {
+    const size_t length = code_length();
+    if (length == kMaxCodeLength) {
+      return *this;
+    }
+    return CellId((id_ & ~lsb()) |
+                  static_cast<uint64_t>(position) << DigitShift(length) |
+                  LsbForLength(length + 1));
+  }
+
+  // Every descendant of this cell (and the cell itself) has an id within
+  // [range_min(), range_max()], and the ranges of consecutive siblings are
+  // contiguous.
+  constexpr uint64_t range_min() const { return id_ - lsb(); }
+  constexpr uint64_t range_max() const { return id_ + (lsb() - 1); }
+
+  constexpr bool contains(const CellId &other) const {
+    return other.id_ >= range_min() && other.id_ <= range_max();
+  }
+
+  // The code of the cell. Cells shorter than the separator position are
+  // padded, so even lengths up to 8 and lengths 10 to 12 give valid codes.
+  constexpr CodeBuffer ToCode() const {
+    const size_t length = code_length();
+    CodeBuffer code;
+    for (size_t i = 0; i < internal::kSeparatorPosition; i++) {
+      code.push_back(i < length ? internal::kAlphabet[digit(i)]
+                                : internal::kPaddingCharacter);
+    }
+    code.push_back(internal::kSeparator);
+    for (size_t i = internal::kSeparatorPosition; i < length; i++) {
+      code.push_back(internal::kAlphabet[digit(i)]);
+    }
+    return code;
+  }
+
+  // The area of the cell. Unlike Decode this also handles odd lengths below
+  // 10, where the last latitude digit has no longitude digit.
+  constexpr CodeArea ToArea() const {
+    // Work in units of the finest grid step, like Decode, to stay exact. A
+    // step is the span of the last digit seen on that axis, or the whole
+    // axis before the first one.
+    int64_t lat_units = 0;
+    int64_t lng_units = 0;
+    int64_t lat_step = static_cast<int64_t>(
+        internal::kLatitudeMaxDegrees * 2 * internal::kGridLatPrecisionInverse);
+    int64_t lng_step = static_cast<int64_t>(
+        internal::kLongitudeMaxDegrees * 2 *
+        internal::kGridLngPrecisionInverse);
+    const size_t length = code_length();
+    for (size_t i = 0; i < length; i++) {
+      const int d = digit(i);
+      if (i < internal::kPairCodeLength) {
+        // The first pair digits span kEncodingBase degrees.
+        if (i % 2 == 0) {
+          lat_step = i == 0 ? static_cast<int64_t>(
+                                  internal::kEncodingBase *
+                                  internal::kGridLatPrecisionInverse)
+                            : lat_step / internal::kEncodingBase;
+          lat_units += d * lat_step;
+        } else {
+          lng_step = i == 1 ? static_cast<int64_t>(
+                                  internal::kEncodingBase *
+                                  internal::kGridLngPrecisionInverse)
+                            : lng_step / internal::kEncodingBase;
+          lng_units += d * lng_step;
+        }
+      } else {
+        lat_step /= internal::kGridRows;
+
+        lng_step /= internal::kGridColumns;
+        lat_units += (d / internal::kGridColumns) * lat_step;
+        lng_units += (d % internal::kGridColumns) * lng_step;
+      }
+    }
+    const double lat_lo = static_cast<double>(lat_units) /
+                              internal::kGridLatPrecisionInverse -
+                          internal::kLatitudeMaxDegrees;
+    const double lng_lo = static_cast<double>(lng_units) /
+                              internal::kGridLngPrecisionInverse -
+                          internal::kLongitudeMaxDegrees;
+    const double lat_hi =
+        std::min(static_cast<double>(lat_units + lat_step) /
+                         internal::kGridLatPrecisionInverse -
+                     internal::kLatitudeMaxDegrees,
+                 internal::kLatitudeMaxDegrees);
+    const double lng_hi =
+        std::min(static_cast<double>(lng_units + lng_step) /
+                         internal::kGridLngPrecisionInverse -
+                     internal::kLongitudeMaxDegrees,
+                 internal::kLongitudeMaxDegrees);
+    return CodeArea(internal::round_double(lat_lo * 1e14) / 1e14,
+                    internal::round_double(lng_lo * 1e14) / 1e14,
+                    internal::round_double(lat_hi * 1e14) / 1e14,
+                    internal::round_double(lng_hi * 1e14) / 1e14, length);
+  }
+
+  friend constexpr auto operator<=>(const CellId &, const CellId &) = default;
+
+  // The sentinel bit for a cell with the given code length.
+  static constexpr uint64_t LsbForLength(size_t code_length) {
+    return uint64_t{1} << (63 - code_length * kBitsPerDigit);
+  }
+
+ private:
+  static constexpr uint64_t kDigitMask = (uint64_t{1} << kBitsPerDigit) - 1;
+
+  static constexpr size_t DigitShift(size_t i) {
+    return 64 - (i + 1) * kBitsPerDigit;
+  }
+
+  uint64_t id_ = 0;
+};
+
+}  // namespace openlocationcode
+
+template <> struct std::hash<openlocationcode::CellId> {
+  size_t operator()(const openlocationcode::CellId &cell) const noexcept {
+    // The low bits are mostly zero, fold the high half in.
+    const uint64_t id = cell.id();
+    return static_cast<size_t>(id ^ (id >> 29) ^ (id >> 41));
+  }
+};
+
+#endif  // LOCATION_OPENLOCATIONCODE_CELLID_H
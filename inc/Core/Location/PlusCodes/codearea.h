@@ -1,6 +1,7 @@
 #ifndef LOCATION_OPENLOCATIONCODE_CODEAREA_H
 #define LOCATION_OPENLOCATIONCODE_CODEAREA_H
 
+#include <algorithm>
 #include <cstdlib>
 
 namespace openlocationcode {
@@ -12,14 +13,27 @@ struct LatLng {
 
 class CodeArea {
  public:
-  CodeArea(double latitude_lo, double longitude_lo, double latitude_hi,
-           double longitude_hi, size_t code_length);
-  double GetLatitudeLo() const;
-  double GetLongitudeLo() const;
-  double GetLatitudeHi() const;
-  double GetLongitudeHi() const;
-  size_t GetCodeLength() const;
-  LatLng GetCenter() const;
+  constexpr CodeArea(double latitude_lo, double longitude_lo,
+                     double latitude_hi, double longitude_hi,
+                     size_t code_length)
+      : latitude_lo_(latitude_lo), longitude_lo_(longitude_lo),
+        latitude_hi_(latitude_hi), longitude_hi_(longitude_hi),
+        code_length_(code_length) {}
+  constexpr double GetLatitudeLo() const { return latitude_lo_; }
+  constexpr double GetLongitudeLo() const { return longitude_lo_; }
+  constexpr double GetLatitudeHi() const { return latitude_hi_; }
+  constexpr double GetLongitudeHi() const { return longitude_hi_; }
+  constexpr size_t GetCodeLength() const { return code_length_; }
+  constexpr LatLng GetCenter() const {
+    constexpr double kLatitudeMaxDegrees = 90;
+    constexpr double kLongitudeMaxDegrees = 180;
+    const double latitude_center = std::min(
+        latitude_lo_ + (latitude_hi_ - latitude_lo_) / 2, kLatitudeMaxDegrees);
+    const double longitude_center =
+        std::min(longitude_lo_ + (longitude_hi_ - longitude_lo_) / 2,
+                 kLongitudeMaxDegrees);
+    return {latitude_center, longitude_center};
+  }
 
  private:
   double latitude_lo_;
@@ -31,4 +45,4 @@ class CodeArea {
 
 }  // namespace openlocationcode
 
-#endif  // LOCATION_OPENLOCATIONCODE_CODEAREA_H_
\ No newline at end of file
+#endif  // LOCATION_OPENLOCATIONCODE_CODEAREA_H_
@@ -0,0 +1,126 @@
+#ifndef LOCATION_OPENLOCATIONCODE_COVERING_H
+#define LOCATION_OPENLOCATIONCODE_COVERING_H
+// Cell coverings turn a region (a latitude/longitude rectangle or a circle)
+// into a small set of CellIds whose union contains it. Since all descendants
+// of a cell lie in [range_min(), range_max()], a covering becomes a handful
+// of integer ranges, which a sorted array or a btree index over packed cell
+// ids (for example a bigint column) answers with range scans.
+//
+// A covering is a superset of the region, callers filter the candidates it
+// returns with the exact test.
+
+#include "cellid.h"
+#include "codearea.h"
+
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+namespace openlocationcode {
+
+// Mean radius of the earth in metres.
+inline constexpr double kEarthRadiusMeters = 6371008.8;
+
+// Great circle (haversine) distance between two locations in metres.
+inline double DistanceMeters(const LatLng &from, const LatLng &to) {
+  constexpr double kRadians = std::numbers::pi / 180;
+  const double sin_lat = std::sin((to.latitude - from.latitude) * kRadians / 2);
+  const double sin_lng =
+      std::sin((to.longitude - from.longitude) * kRadians / 2);
+  const double h = sin_lat * sin_lat + std::cos(from.latitude * kRadians) *
+                                           std::cos(to.latitude * kRadians) *
+                                           sin_lng * sin_lng;
+  return 2 * kEarthRadiusMeters * std::asin(std::min(1.0, std::sqrt(h)));
+}
+
+// A region a covering can be computed for. Both tests may be conservative:
+// MayIntersect may return true for an area that only comes close, and
+// Contains may return false for an area that is inside.
+class Region {
+ public:
+  virtual ~Region() = default;
+
+  // False only if no point of the area is in the region.
+  virtual bool MayIntersect(const CodeArea &area) const = 0;
+  // True only if every point of the area is in the region.
+  virtual bool Contains(const CodeArea &area) const = 0;
+};
+
+// A latitude/longitude rectangle. A low longitude greater than the high one
+// describes a rectangle crossing the antimeridian, which is stored with the
+// high longitude past 180 so that hi().longitude - lo().longitude is always
+// the width.
+class LatLngRect : public Region {
+ public:
+  LatLngRect(const LatLng &lo, const LatLng &hi);
+
+  bool MayIntersect(const CodeArea &area) const override;
+  bool Contains(const CodeArea &area) const override;
+
+  bool Contains(const LatLng &location) const;
+
+  const LatLng &lo() const { return lo_; }
+  const LatLng &hi() const { return hi_; }
+  // True if the rectangle crosses the antimeridian.
+  bool is_inverted() const {
+    return hi_.longitude > internal::kLongitudeMaxDegrees;
+  }
+
+ private:
+  LatLng lo_;
+  LatLng hi_;
+};
+
+// The locations within a distance of a center (a spherical cap).
+class Cap : public Region {
+ public:
+  Cap(const LatLng &center, double radius_meters);
+
+  bool MayIntersect(const CodeArea &area) const override;
+  bool Contains(const CodeArea &area) const override;
+
+  bool Contains(const LatLng &location) const;
+
+  const LatLng &center() const { return center_; }
+  double radius_meters() const { return radius_meters_; }
+
+  // The smallest rectangle containing the cap.
+  LatLngRect GetBound() const;
+
+ private:
+  LatLng center_;
+  double radius_meters_;
+};
+
+// A closed range of CellId ids.
+struct CellRange {
+  uint64_t min;
+  uint64_t max;
+
+  friend constexpr bool operator==(const CellRange &,
+                                   const CellRange &) = default;
+};
+
+struct CoveringOptions {
+  // The covering has at most this many cells, unless the region needs more
+  // cells of length 1 and 2 than that.
+  size_t max_cells = 8;
+  // Cells are not refined past this code length.
+  size_t max_code_length = CellId::kMaxCodeLength;
+};
+
+// Returns cells whose union contains the region, sorted by id and without
+// overlaps. Starting from the whole globe, the largest cell that is not
+// inside the region is replaced by its children (one digit down) that may
+// intersect it, for as long as the covering stays within max_cells.
+std::vector<CellId> GetCovering(const Region &region,
+                                const CoveringOptions &options = {});
+
+// Returns the id ranges of the cells, sorted and with contiguous ranges
+// merged.
+std::vector<CellRange> GetRanges(const std::vector<CellId> &cells);
+
+}  // namespace openlocationcode
+
+#endif  // LOCATION_OPENLOCATIONCODE_COVERING_H
@@ -0,0 +1,439 @@
+#ifndef LOCATION_OPENLOCATIONCODE_OPENLOCATIONCODE_INL_H
+#define LOCATION_OPENLOCATIONCODE_OPENLOCATIONCODE_INL_H
+// Constexpr definitions for openlocationcode.h. Only include that header.
+//
+// The <cmath> functions used by the reference implementation (pow, floor,
+// round, fabs) are not constexpr before C++23, so the helpers below replace
+// them with exact equivalents for the ranges the algorithm uses.
+
+#include <algorithm>
+
+namespace openlocationcode {
+namespace internal {
+
+// Raises a number to an integer exponent, handling negative exponents.
+constexpr double pow_neg(double base, int exponent) {
+  double result = 1;
+  for (int i = 0; i < (exponent < 0 ? -exponent : exponent); i++) {
+    result *= base;
+  }
+  return exponent < 0 ? 1 / result : result;
+}
+
+constexpr double abs_double(double value) {
+  return value < 0 ? -value : value;
+}
+
+// Rounds half away from zero, matching std::round. Values of 2^52 and above
+// are already integral.
+constexpr double round_double(double value) {
+  constexpr double kIntegral = 4503599627370496.0;
+  if (!(value < kIntegral && value > -kIntegral)) {
+    return value;
+  }
+  auto truncated = static_cast<int64_t>(value);
+  const double fraction = value - static_cast<double>(truncated);
+  if (fraction >= 0.5) {
+    truncated++;
+  } else if (fraction <= -0.5) {
+    truncated--;
+  }
+  return static_cast<double>(truncated);
+}
+
+// Compute the latitude precision value for a given code length. Lengths <= 10
+// have the same precision for latitude and longitude, but lengths > 10 have
+// different precisions due to the grid method having fewer columns than rows.
+constexpr double compute_precision_for_length(int code_length) {
+  if (code_length <= 10) {
+    return pow_neg(kEncodingBase, (code_length / -2) + 2);
+  }
+  return pow_neg(kEncodingBase, -3) / pow_neg(5, code_length - 10);
+}
+
+// Returns the position of a char in the encoding alphabet, or -1 if invalid.
+constexpr int get_alphabet_position(char c) {
+  // We use a lookup table for performance reasons (e.g. over std::find).
+  if (c >= 'C' && c <= 'X')
+    return kPositionLUT[c - 'C'];
+  if (c >= 'c' && c <= 'x')
+    return kPositionLUT[c - 'c'];
+  if (c >= '2' && c <= '9')
+    return c - '2';
+  return -1;
+}
+
+// Normalize a longitude into the range -180 to 180, not including 180.
+constexpr double normalize_longitude(double longitude_degrees) {
+  while (longitude_degrees < -kLongitudeMaxDegrees) {
+    longitude_degrees = longitude_degrees + 360;
+  }
+  while (longitude_degrees >= kLongitudeMaxDegrees) {
+    longitude_degrees = longitude_degrees - 360;
+  }
+  return longitude_degrees;
+}
+
+// Adjusts 90 degree latitude to be lower so that a legal OLC code can be
+// generated.
+constexpr double adjust_latitude(double latitude_degrees, size_t code_length) {
+  latitude_degrees = std::min(90.0, std::max(-90.0, latitude_degrees));
+
+  if (latitude_degrees < kLatitudeMaxDegrees) {
+    return latitude_degrees;
+  }
+  // Subtract half the code precision to get the latitude into the code
+  // area.
+  double precision = compute_precision_for_length((int)code_length);
+  return latitude_degrees - precision / 2;
+}
+
+// Copies the code into clean_code without the separator, stopping at the first
+// padding character (unless the code starts with one). Writes at most
+// clean_code.size() characters and returns the full cleaned length.
+template <size_t N>
+constexpr size_t clean_code_chars(std::string_view code,
+                                  std::array<char, N> &clean_code) {
+  size_t length = 0;
+  bool keep_padding = false;
+  for (char c : code) {
+    if (c == kSeparator) {
+      continue;
+    }
+    if (c == kPaddingCharacter) {
+      if (length == 0) {
+        keep_padding = true;
+      } else if (!keep_padding) {
+        break;
+      }
+    }
+    if (length < N) {
+      clean_code[length] = c;
+    }
+    length++;
+  }
+  return length;
+}
+
+} // namespace internal
+
+constexpr CodeBuffer Encode(const LatLng &location, size_t code_length) {
+  // Limit the maximum number of digits in the code.
+  code_length = std::min(code_length, internal::kMaximumDigitCount);
+  // Ensure the length is valid.
+  code_length = std::max(code_length, internal::kMinimumDigitCount);
+  if (code_length < internal::kPairCodeLength && code_length % 2 == 1) {
+    code_length = code_length + 1;
+  }
+  // Adjust latitude and longitude so that they are normalized/clipped.
+  double latitude = internal::adjust_latitude(location.latitude, code_length);
+  double longitude = internal::normalize_longitude(location.longitude);
+  // Room for the code digits. The separator is inserted when copying out.
+  std::array<char, internal::kMaximumDigitCount> digits{};
+
+  // Compute the code.
+  // This approach converts each value to an integer after multiplying it by
+  // the final precision. This allows us to use only integer operations, so
+  // avoiding any accumulation of floating point representation errors.
+
+  // Multiply values by their precision and convert to positive without any
+  // floating point operations.
+  auto lat_val = static_cast<int64_t>(internal::kLatitudeMaxDegrees *
+                                      internal::kGridLatPrecisionInverse);
+  auto lng_val = static_cast<int64_t>(internal::kLongitudeMaxDegrees *
+                                      internal::kGridLngPrecisionInverse);
+  lat_val = static_cast<int64_t>(
+      static_cast<double>(lat_val) +
+      latitude * internal::kGridLatPrecisionInverse);
+  lng_val = static_cast<int64_t>(
+      static_cast<double>(lng_val) +
+      longitude * internal::kGridLngPrecisionInverse);
+
+  size_t pos = internal::kMaximumDigitCount - 1;
+  // Compute the grid part of the code if necessary.
+  if (code_length > internal::kPairCodeLength) {
+    for (size_t i = 0; i < internal::kGridCodeLength; i++) {
+      int lat_digit = lat_val % internal::kGridRows;
+      int lng_digit = lng_val % internal::kGridColumns;
+      int ndx = lat_digit * internal::kGridColumns + lng_digit;
+      digits[pos--] = internal::kAlphabet[ndx];
+      // Note! Integer division.
+      lat_val /= internal::kGridRows;
+      lng_val /= internal::kGridColumns;
+    }
+  } else {
+    lat_val /= static_cast<int64_t>(
+        internal::ipow(internal::kGridRows, internal::kGridCodeLength));
+    lng_val /= static_cast<int64_t>(
+        internal::ipow(internal::kGridColumns, internal::kGridCodeLength));
+  }
+  pos = internal::kPairCodeLength - 1;
+  // Compute the pair section of the code.
+  for (size_t i = 0; i < internal::kPairCodeLength / 2; i++) {
+    int lat_ndx = lat_val % internal::kEncodingBase;
+    int lng_ndx = lng_val % internal::kEncodingBase;
+    digits[pos--] = internal::kAlphabet[lng_ndx];
+    digits[pos--] = internal::kAlphabet[lat_ndx];
+    // Note! Integer division.
+    lat_val /= internal::kEncodingBase;
+    lng_val /= internal::kEncodingBase;
+  }
+
+  // Add the required padding characters.
+  for (size_t i = code_length; i < internal::kSeparatorPosition; i++) {
+    digits[i] = internal::kPaddingCharacter;
+  }
+  // Copy out the digits up to the separator, the separator, and whatever
+  // follows it.
+  CodeBuffer code;
+  for (size_t i = 0; i < internal::kSeparatorPosition; i++) {
+    code.push_back(digits[i]);
+  }
+  code.push_back(internal::kSeparator);
+  for (size_t i = internal::kSeparatorPosition; i < code_length; i++) {
+    code.push_back(digits[i]);
+  }
+  return code;
+}
+
+constexpr CodeBuffer Encode(const LatLng &location) {
+  return Encode(location, internal::kPairCodeLength);
+}
+
+constexpr CodeArea Decode(std::string_view code) {
+  std::array<char, internal::kMaximumDigitCount> clean_code{};
+  // Constrain to the maximum length.
+  const size_t clean_size = std::min(internal::kMaximumDigitCount,
+                                     internal::clean_code_chars(code, clean_code));
+  // Initialise the values for each section. We work them out as integers and
+  // convert them to floats at the end.
+  int normal_lat =
+      -internal::kLatitudeMaxDegrees * internal::kPairPrecisionInverse;
+  int normal_lng =
+      -internal::kLongitudeMaxDegrees * internal::kPairPrecisionInverse;
+  int extra_lat = 0;
+  int extra_lng = 0;
+  // How many digits do we have to process?
+  size_t digits = std::min(internal::kPairCodeLength, clean_size);
+  // Define the place value for the most significant pair.
+  int pv = internal::ipow(internal::kEncodingBase,
+                          internal::kPairCodeLength / 2 - 1);
+  for (size_t i = 0; i + 1 < digits; i += 2) {
+    normal_lat += internal::get_alphabet_position(clean_code[i]) * pv;
+    normal_lng += internal::get_alphabet_position(clean_code[i + 1]) * pv;
+    if (i + 2 < digits) {
+      pv /= internal::kEncodingBase;
+    }
+  }
+  // Convert the place value to a float in degrees.
+  double lat_precision = (double)pv / internal::kPairPrecisionInverse;
+  double lng_precision = (double)pv / internal::kPairPrecisionInverse;
+  // Process any extra precision digits.
+  if (clean_size > internal::kPairCodeLength) {
+    // Initialise the place values for the grid.
+    int row_pv =
+        internal::ipow(internal::kGridRows, internal::kGridCodeLength - 1);
+    int col_pv =
+        internal::ipow(internal::kGridColumns, internal::kGridCodeLength - 1);
+    // How many digits do we have to process?
+    digits = clean_size;
+    for (size_t i = internal::kPairCodeLength; i < digits; i++) {
+      int dval = internal::get_alphabet_position(clean_code[i]);
+      int row = dval / internal::kGridColumns;
+      int col = dval % internal::kGridColumns;
+      extra_lat += row * row_pv;
+      extra_lng += col * col_pv;
+      if (i < digits - 1) {
+        row_pv /= internal::kGridRows;
+        col_pv /= internal::kGridColumns;
+      }
+    }
+    // Adjust the precisions from the integer values to degrees.
+    lat_precision = (double)row_pv / internal::kGridLatPrecisionInverse;
+    lng_precision = (double)col_pv / internal::kGridLngPrecisionInverse;
+  }
+  // Merge the values from the normal and extra precision parts of the code.
+  // Everything is ints so they all need to be cast to floats.
+  double lat = (double)normal_lat / internal::kPairPrecisionInverse +
+               (double)extra_lat / internal::kGridLatPrecisionInverse;
+  double lng = (double)normal_lng / internal::kPairPrecisionInverse +
+               (double)extra_lng / internal::kGridLngPrecisionInverse;
+  // Round everything off to 14 places.
+  return CodeArea(internal::round_double(lat * 1e14) / 1e14,
+                  internal::round_double(lng * 1e14) / 1e14,
+                  internal::round_double((lat + lat_precision) * 1e14) / 1e14,
+                  internal::round_double((lng + lng_precision) * 1e14) / 1e14,
+                  clean_size);
+}
+
+constexpr CodeBuffer Shorten(std::string_view code,
+                             const LatLng &reference_location) {
+  if (!IsFull(code)) {
+    return CodeBuffer(code);
+  }
+  if (code.find(internal::kPaddingCharacter) != std::string_view::npos) {
+    return CodeBuffer(code);
+  }
+  CodeArea code_area = Decode(code);
+  LatLng center = code_area.GetCenter();
+  // Ensure that latitude and longitude are valid.
+  double latitude =
+      internal::adjust_latitude(reference_location.latitude, CodeLength(code));
+  double longitude = internal::normalize_longitude(reference_location.longitude);
+  // How close are the latitude and longitude to the code center.
+  double range = std::max(internal::abs_double(center.latitude - latitude),
+                          internal::abs_double(center.longitude - longitude));
+  const double safety_factor = 0.3;
+  const int removal_lengths[3] = {8, 6, 4};
+  for (int removal_length : removal_lengths) {
+    // Check if we're close enough to shorten. The range must be less than 1/2
+    // the resolution to shorten at all, and we want to allow some safety, so
+    // use 0.3 instead of 0.5 as a multiplier.
+    double area_edge =
+        internal::compute_precision_for_length(removal_length) * safety_factor;
+    if (range < area_edge) {
+      return CodeBuffer(code.substr(removal_length));
+    }
+  }
+  return CodeBuffer(code);
+}
+
+constexpr CodeBuffer RecoverNearest(std::string_view short_code,
+                                    const LatLng &reference_location) {
+  if (!IsShort(short_code)) {
+    CodeBuffer code;
+    for (char c : short_code) {
+      code.push_back(c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A')
+                                          : c);
+    }
+    return code;
+  }
+  // Ensure that latitude and longitude are valid.
+  double latitude = internal::adjust_latitude(reference_location.latitude,
+                                              CodeLength(short_code));
+  double longitude = internal::normalize_longitude(reference_location.longitude);
+  // Compute the number of digits we need to recover.
+  size_t padding_length =
+      internal::kSeparatorPosition - short_code.find(internal::kSeparator);
+  // The resolution (height and width) of the padded area in degrees.
+  double resolution = internal::pow_neg(
+      internal::kEncodingBase, 2 - static_cast<int>(padding_length / 2));
+  // Distance from the center to an edge (in degrees).
+  double half_res = resolution / 2.0;
+  // Use the reference location to pad the supplied short code and decode it.
+  // Decode only reads the first kMaximumDigitCount digits, which always fit in
+  // the buffer as short codes hold no padding.
+  LatLng latlng = {latitude, longitude};
+  CodeBuffer padded_code(Encode(latlng).view().substr(0, padding_length));
+  for (char c : short_code) {
+    padded_code.push_back(c);
+  }
+  CodeArea code_rect = Decode(padded_code);
+  // How many degrees latitude is the code from the reference? If it is more
+  // than half the resolution, we need to move it north or south but keep it
+  // within -90 to 90 degrees.
+  double center_lat = code_rect.GetCenter().latitude;
+  double center_lng = code_rect.GetCenter().longitude;
+  if (latitude + half_res < center_lat &&
+      center_lat - resolution > -internal::kLatitudeMaxDegrees) {
+    // If the proposed code is more than half a cell north of the reference
+    // location, it's too far, and the best match will be one cell south.
+    center_lat -= resolution;
+  } else if (latitude - half_res > center_lat &&
+             center_lat + resolution < internal::kLatitudeMaxDegrees) {
+    // If the proposed code is more than half a cell south of the reference
+    // location, it's too far, and the best match will be one cell north.
+    center_lat += resolution;
+  }
+  // How many degrees longitude is the code from the reference?
+  if (longitude + half_res < center_lng) {
+    center_lng -= resolution;
+  } else if (longitude - half_res > center_lng) {
+    center_lng += resolution;
+  }
+  LatLng center_latlng = {center_lat, center_lng};
+  return Encode(center_latlng, CodeLength(short_code) + padding_length);
+}
+
+constexpr CodeType Classify(std::string_view code) {
+  size_t separatorPos = std::string_view::npos;
+  size_t paddingStart = std::string_view::npos;
+  for (size_t i = 0; i < code.size(); i++) {
+    const char c = code[i];
+    if (c == internal::kSeparator) {
+      // There must only be one separator.
+      if (separatorPos != std::string_view::npos) {
+        return CodeType::kInvalid;
+      }
+      separatorPos = i;
+    } else if (c == internal::kPaddingCharacter) {
+      if (paddingStart == std::string_view::npos) {
+        paddingStart = i;
+      }
+    } else if (internal::get_alphabet_position(c) < 0) {
+      return CodeType::kInvalid;
+    } else if (paddingStart != std::string_view::npos) {
+      // Padding runs up to the separator and ends the code, no digit can
+      // follow it.
+      return CodeType::kInvalid;
+    }
+  }
+  // The separator is required, and can't be the only character.
+  if (separatorPos == std::string_view::npos || code.size() == 1) {
+    return CodeType::kInvalid;
+  }
+  // Is the separator in an illegal position?
+  if (separatorPos > internal::kSeparatorPosition || separatorPos % 2 == 1) {
+    return CodeType::kInvalid;
+  }
+  if (paddingStart != std::string_view::npos) {
+    // Short codes cannot have padding, and the first padding character needs
+    // to be in an odd position.
+    if (separatorPos < internal::kSeparatorPosition || paddingStart == 0 ||
+        paddingStart % 2 == 1) {
+      return CodeType::kInvalid;
+    }
+    // Padded codes must not have anything after the separator.
+    if (code.size() > separatorPos + 1) {
+      return CodeType::kInvalid;
+    }
+  }
+  // If there are characters after the separator, make sure there isn't just
+  // one of them (not legal).
+  if (code.size() - separatorPos - 1 == 1) {
+    return CodeType::kInvalid;
+  }
+  // If there are less characters than expected before the separator.
+  if (separatorPos < internal::kSeparatorPosition) {
+    return CodeType::kShort;
+  }
+  // Work out what the first latitude and longitude characters indicate.
+  if (internal::get_alphabet_position(code[0]) * internal::kEncodingBase >=
+          internal::kLatitudeMaxDegrees * 2 ||
+      internal::get_alphabet_position(code[1]) * internal::kEncodingBase >=
+          internal::kLongitudeMaxDegrees * 2) {
+    return CodeType::kOutOfRange;
+  }
+  return CodeType::kFull;
+}
+
+constexpr bool IsValid(std::string_view code) {
+  return Classify(code) != CodeType::kInvalid;
+}
+
+constexpr bool IsShort(std::string_view code) {
+  return Classify(code) == CodeType::kShort;
+}
+
+constexpr bool IsFull(std::string_view code) {
+  return Classify(code) == CodeType::kFull;
+}
+
+constexpr size_t CodeLength(std::string_view code) {
+  std::array<char, 0> discard{};
+  return internal::clean_code_chars(code, discard);
+}
+
+} // namespace openlocationcode
+
+#endif // LOCATION_OPENLOCATIONCODE_OPENLOCATIONCODE_INL_H
@@ -8,14 +8,147 @@
 // The codes can be easily read and remembered, and truncating codes enlarges
 // the area they represent, meaning that where extreme accuracy is not required
 // the codes can be shortened.
+//
+// Every function in this header is constexpr and works on std::string_view
+// inputs and fixed-size CodeBuffer outputs, so encoding and decoding never
+// touch the heap. CodeBuffer converts implicitly to std::string for callers
+// that want to keep one.
 
 #include "codearea.h"
 
-#include <string>
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
 
 namespace openlocationcode {
 
+namespace internal {
+// The separator character is used to identify strings as OLC codes.
+inline constexpr char kSeparator = '+';
+// Provides the position of the separator.
+inline constexpr size_t kSeparatorPosition = 8;
+// Padding is used when less precise codes are desired.
+inline constexpr char kPaddingCharacter = '0';
+// The alphabet of the codes.
+inline constexpr char kAlphabet[] = "23456789CFGHJMPQRVWX";
+// The number base used for the encoding.
+inline constexpr size_t kEncodingBase = 20;
+// Defines the maximum number of digits in a code (excluding separator). Codes
+// with this length have a precision of less than 1e-10 cm at the equator.
+// Roughly 1 x 0.5 cm.
+inline constexpr size_t kMaximumDigitCount = 15;
+// Defines the minimum number of digits in a code.
+inline constexpr size_t kMinimumDigitCount = 2;
+// How many characters use the pair algorithm.
+inline constexpr size_t kPairCodeLength = 10;
+// How many characters use the grid algorithm.
+inline constexpr size_t kGridCodeLength = kMaximumDigitCount - kPairCodeLength;
+// Number of columns in the grid refinement method.
+inline constexpr size_t kGridColumns = 4;
+// Number of rows in the grid refinement method.
+inline constexpr size_t kGridRows = kEncodingBase / kGridColumns;
+// Latitude bounds are -kLatitudeMaxDegrees degrees and +kLatitudeMaxDegrees
+// degrees which we transpose to 0 and 180 degrees.
+inline constexpr double kLatitudeMaxDegrees = 90;
+// Longitude bounds are -kLongitudeMaxDegrees degrees and +kLongitudeMaxDegrees
+// degrees which we transpose to 0 and 360.
+inline constexpr double kLongitudeMaxDegrees = 180;
+// Lookup table of the alphabet positions of characters 'C' through 'X',
+// inclusive. A value of -1 means the character isn't part of the alphabet.
+inline constexpr std::array<int, 'X' - 'C' + 1> kPositionLUT = {
+    8,  -1, -1, 9,  10, 11, -1, 12, -1, -1, 13,
+    -1, -1, 14, 15, 16, -1, -1, -1, 17, 18, 19};
+
+// Integer power of an integer base, evaluated at compile time.
+constexpr size_t ipow(size_t base, size_t exponent) {
+  size_t result = 1;
+  for (size_t i = 0; i < exponent; i++) {
+    result *= base;
+  }
+  return result;
+}
+
+// Largest exponent such that base ^ exponent does not exceed value.
+constexpr size_t ilog(size_t value, size_t base) {
+  size_t exponent = 0;
+  for (size_t power = base; power <= value; power *= base) {
+    exponent++;
+  }
+  return exponent;
+}
+
+// Gives the exponent used for the first pair, the encoding base exponent
+// necessary to represent 360 degrees.
+inline constexpr size_t kInitialExponent = ilog(360, kEncodingBase);
+// Size of the initial grid in degrees. This is the size of the area represented
+// by a 10 character code, and is kEncodingBase ^ (2 - kPairCodeLength / 2).
+inline constexpr double kGridSizeDegrees =
+    1.0 / ipow(kEncodingBase, kPairCodeLength / 2 - (kInitialExponent + 1));
+// Inverse (1/) of the precision of the final pair digits in degrees. (20^3)
+inline constexpr size_t kPairPrecisionInverse = 8000;
+// Inverse (1/) of the precision of the final grid digits in degrees.
+// (Latitude and longitude are different.)
+inline constexpr double kGridLatPrecisionInverse =
+    kPairPrecisionInverse * ipow(kGridRows, kGridCodeLength);
+inline constexpr double kGridLngPrecisionInverse =
+    kPairPrecisionInverse * ipow(kGridColumns, kGridCodeLength);
+
+static_assert(kInitialExponent == 1);
+static_assert(kGridSizeDegrees == 1.0 / kPairPrecisionInverse);
+} // namespace internal
+
+// Fixed-capacity, heap-free storage for a code. The capacity covers the
+// maximum number of digits plus the separator; longer inputs are truncated,
+// which only drops digits past kMaximumDigitCount that carry no precision.
+class CodeBuffer {
+ public:
+  static constexpr size_t kCapacity = internal::kMaximumDigitCount + 1;
+
+  constexpr CodeBuffer() = default;
+  constexpr explicit CodeBuffer(std::string_view code) {
+    for (char c : code) {
+      push_back(c);
+    }
+  }
+
+  constexpr const char *data() const { return chars_.data(); }
+  constexpr size_t size() const { return size_; }
+  constexpr bool empty() const { return size_ == 0; }
+  constexpr const char *begin() const { return chars_.data(); }
+  constexpr const char *end() const { return chars_.data() + size_; }
+  constexpr char operator[](size_t i) const { return chars_[i]; }
+
+  constexpr void push_back(char c) {
+    if (size_ < kCapacity) {
+      chars_[size_++] = c;
+    }
+  }
+
+  constexpr std::string_view view() const { return {chars_.data(), size_}; }
+  constexpr operator std::string_view() const { return view(); }
+  std::string str() const { return std::string(view()); }
+  operator std::string() const { return str(); }
+
+  friend constexpr bool operator==(const CodeBuffer &lhs,
+                                   const CodeBuffer &rhs) {
+    return lhs.view() == rhs.view();
+  }
+  friend constexpr bool operator==(const CodeBuffer &lhs,
+                                   std::string_view rhs) {
+    return lhs.view() == rhs;
+  }
+  friend std::ostream &operator<<(std::ostream &os, const CodeBuffer &code) {
+    return os << code.view();
+  }
+
+ private:
+  std::array<char, kCapacity> chars_{};
+  uint8_t size_ = 0;
+};
+
 // Encodes a pair of coordinates and return an Open Location Code representing a
 // rectangle that encloses the coordinates. The accuracy of the code is
 // controlled by the code length.
@@ -23,17 +156,17 @@ namespace openlocationcode {
 // Returns an Open Location Code with code_length significant digits. The string
 // returned may be one character longer if it includes a separator character
 // for formatting.
-std::string Encode(const LatLng &location, size_t code_length);
+constexpr CodeBuffer Encode(const LatLng &location, size_t code_length);
 
 // Encodes a pair of coordinates and return an Open Location Code representing a
 // rectangle that encloses the coordinates. The accuracy of the code is
 // sufficient to represent a building such as a house, and is approximately
 // 13x13 meters at Earth's equator.
-std::string Encode(const LatLng &location);
+constexpr CodeBuffer Encode(const LatLng &location);
 
 // Decodes an Open Location Code and returns a rectangle that describes the area
 // represented by the code.
-CodeArea Decode(const std::string &code);
+constexpr CodeArea Decode(std::string_view code);
 
 // Removes characters from the start of an OLC code.
 // This uses a reference location to determine how many initial characters
@@ -47,7 +180,8 @@ CodeArea Decode(const std::string &code);
 //
 // If the code isn't a valid full code or is padded, it cannot be shortened and
 // the code is returned as-is.
-std::string Shorten(const std::string &code, const LatLng &reference_location);
+constexpr CodeBuffer Shorten(std::string_view code,
+                             const LatLng &reference_location);
 
 // Recovers the nearest matching code to a specified location.
 // Given a short Open Location Code of between four and seven characters,
@@ -55,20 +189,38 @@ std::string Shorten(const std::string &code, const LatLng &reference_location);
 //
 // If the code isn't a valid short code, it cannot be recovered and the code
 // is returned as-is.
-std::string RecoverNearest(const std::string &short_code,
-                           const LatLng &reference_location);
+constexpr CodeBuffer RecoverNearest(std::string_view short_code,
+                                    const LatLng &reference_location);
 
 // Returns the number of valid Open Location Code characters in a string. This
 // excludes invalid characters and separators.
-size_t CodeLength(const std::string &code);
+constexpr size_t CodeLength(std::string_view code);
+
+// What a string is as an Open Location Code.
+enum class CodeType : uint8_t {
+  // Not a valid code.
+  kInvalid,
+  // A valid short code, with less than eight digits before the separator.
+  kShort,
+  // A valid full code.
+  kFull,
+  // A valid code with eight digits before the separator, whose first two
+  // digits decode past 90 degrees latitude or 180 degrees longitude. It is
+  // neither short nor full.
+  kOutOfRange,
+};
+
+// Classifies a code in a single pass over its characters. IsValid, IsShort
+// and IsFull are all answered by this.
+constexpr CodeType Classify(std::string_view code);
 
 // Determines if a code is valid and can be decoded.
 // The empty string is a valid code, but whitespace included in a code is not
 // valid.
-bool IsValid(const std::string &code);
+constexpr bool IsValid(std::string_view code);
 
 // Determines if a code is a valid short code.
-bool IsShort(const std::string &code);
+constexpr bool IsShort(std::string_view code);
 
 // Determines if a code is a valid full Open Location Code.
 //
@@ -77,39 +229,10 @@ bool IsShort(const std::string &code);
 // and also that the latitude and longitude values are legal. If the prefix
 // character is present, it must be the first character. If the separator
 // character is present, it must be after four characters.
-bool IsFull(const std::string &code);
-
-namespace internal {
-// The separator character is used to identify strings as OLC codes.
-extern const char kSeparator;
-// Provides the position of the separator.
-extern const size_t kSeparatorPosition;
-// Defines the maximum number of digits in a code (excluding separator). Codes
-// with this length have a precision of less than 1e-10 cm at the equator.
-extern const size_t kMaximumDigitCount;
-// Padding is used when less precise codes are desired.
-extern const char kPaddingCharacter;
-// The alphabet of the codes.
-extern const char kAlphabet[];
-// Lookup table of the alphabet positions of characters 'C' through 'X',
-// inclusive. A value of -1 means the character isn't part of the alphabet.
-// extern const int kPositionLUT['X' - 'C' + 1];
-extern const std::array<int, 'X' - 'C' + 1> kPositionLUT;
-// The number base used for the encoding.
-extern const size_t kEncodingBase;
-// How many characters use the pair algorithm.
-extern const size_t kPairCodeLength;
-// Number of columns in the grid refinement method.
-extern const size_t kGridColumns;
-// Number of rows in the grid refinement method.
-extern const size_t kGridRows;
-// Gives the exponent used for the first pair.
-extern const size_t kInitialExponent;
-// Size of the initial grid in degrees. This is the size of the area represented
-// by a 10 character code, and is kEncodingBase ^ (2 - kPairCodeLength / 2).
-extern const double kGridSizeDegrees;
-} // namespace internal
+constexpr bool IsFull(std::string_view code);
 
 } // namespace openlocationcode
 
-#endif // LOCATION_OPENLOCATIONCODE_OPENLOCATIONCODE_H_
\ No newline at end of file
+#include "openlocationcode-inl.h"
+
+#endif // LOCATION_OPENLOCATIONCODE_OPENLOCATIONCODE_H_
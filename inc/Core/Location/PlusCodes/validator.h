@@ -0,0 +1,31 @@
+#ifndef LOCATION_OPENLOCATIONCODE_VALIDATOR_H
+#define LOCATION_OPENLOCATIONCODE_VALIDATOR_H
+// Bulk classification of client submitted codes. Every code Encode produces
+// fits in 16 characters, so each one is loaded into a single vector register
+// and its characters are checked against the alphabet with two nibble
+// lookups (SSSE3 on x86, NEON on AArch64), leaving only the separator and
+// padding positions to check in scalar code. Longer codes, and targets
+// without either instruction set, fall back to Classify.
+
+#include "openlocationcode.h"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openlocationcode {
+
+// Classifies each code into types, which must hold at least codes.size()
+// entries. The results are the same as Classify.
+void ClassifyBatch(std::span<const std::string_view> codes,
+                   std::span<CodeType> types);
+void ClassifyBatch(std::span<const std::string> codes,
+                   std::span<CodeType> types);
+
+std::vector<CodeType> ClassifyBatch(std::span<const std::string_view> codes);
+std::vector<CodeType> ClassifyBatch(std::span<const std::string> codes);
+
+}  // namespace openlocationcode
+
+#endif  // LOCATION_OPENLOCATIONCODE_VALIDATOR_H
@@ -0,0 +1,529 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "PlusCodes/covering.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class SpatialIndex
+ * @brief in-memory grid of points bucketed by plus code cell, answers k nearest
+ * and within radius queries without scanning every point.
+ * @details the cells are the plus code cells of the given (pair) code length,
+ * 6 gives ~5.5km cells and 8 (the default) ~275m cells, pick the length where
+ * a cell holds a handful of points for the data's density. the cells are
+ * grouped in blocks, the cells of the code two digits shorter, so sparse
+ * areas are skipped a block at a time. queries walk the blocks around the
+ * query point, visit the cells closest first and stop as soon as no unvisited
+ * cell can hold a closer point. not synchronized, guard it with a shared mutex
+ * when it is written while being read.
+ * @tparam KeyType identifies a point (address id), needs operator==.
+ */
+template <typename KeyType> class SpatialIndex {
+public:
+  using LatLng = openlocationcode::LatLng;
+
+  struct Entry {
+    KeyType Key;
+    LatLng Location;
+  };
+
+  struct Result {
+    KeyType Key;
+    LatLng Location;
+    double Distance; /* meters */
+  };
+
+  static constexpr double EarthRadiusMeters =
+      openlocationcode::kEarthRadiusMeters;
+
+public:
+  /**
+   * @brief Construct a new Spatial Index object
+   * @param CodeLength plus code length of the cells, even and between 2 and
+   * 10.
+   */
+  explicit SpatialIndex(size_t CodeLength = 8)
+      : m_CodeLength(std::clamp<size_t>(CodeLength + CodeLength % 2, 2, 10)),
+        m_CellGrid(MakeGrid(m_CodeLength)),
+        m_BlockGrid(MakeGrid(m_CodeLength == 2 ? 2 : m_CodeLength - 2)) {}
+
+  /**
+   * @brief replaces the index content with the given entries, groups them by
+   * cell first so every bucket is allocated once.
+   * @param Entries
+   */
+  void BulkLoad(std::vector<Entry> Entries) {
+    Clear();
+    std::vector<std::pair<uint64_t, size_t>> Order;
+    Order.reserve(Entries.size());
+    for (size_t i = 0; i < Entries.size(); i++) {
+      Order.emplace_back(CellKey(Entries[i].Location), i);
+    }
+    std::sort(Order.begin(), Order.end());
+
+    size_t Distinct = 0;
+    for (size_t i = 0; i < Order.size(); i++) {
+      Distinct += (i == 0 || Order[i].first != Order[i - 1].first);
+    }
+    m_Cells.reserve(Distinct);
+    for (size_t Begin = 0, End = 0; Begin < Order.size(); Begin = End) {
+      while (End < Order.size() && Order[End].first == Order[Begin].first) {
+        End++;
+      }
+      const uint64_t Cell = Order[Begin].first;
+      auto &Bucket = m_Cells[Cell];
+      Bucket.reserve(End - Begin);
+      for (size_t i = Begin; i < End; i++) {
+        Bucket.push_back(std::move(Entries[Order[i].second]));
+      }
+      m_Blocks[BlockKey(Cell)].push_back(Cell);
+    }
+    m_Size = Entries.size();
+  }
+
+  /**
+   * @brief adds a point.
+   * @param Key
+   * @param Location
+   */
+  void Insert(KeyType Key, const LatLng &Location) {
+    const uint64_t Cell = CellKey(Location);
+    auto &Bucket = m_Cells[Cell];
+    if (Bucket.empty()) {
+      m_Blocks[BlockKey(Cell)].push_back(Cell);
+    }
+    Bucket.push_back({std::move(Key), Location});
+    m_Size++;
+  }
+
+  /**
+   * @brief removes a point, the location is the one it was inserted with.
+   * @param Key
+   * @param Location
+   * @return bool, false if the point isn't in the index.
+   */
+  bool Remove(const KeyType &Key, const LatLng &Location) {
+    const uint64_t Cell = CellKey(Location);
+    auto Found = m_Cells.find(Cell);
+    if (Found == m_Cells.end()) {
+      return false;
+    }
+    auto &Bucket = Found->second;
+    auto It = std::find_if(Bucket.begin(), Bucket.end(),
+                           [&Key](const Entry &E) { return E.Key == Key; });
+    if (It == Bucket.end()) {
+      return false;
+    }
+    *It = std::move(Bucket.back());
+    Bucket.pop_back();
+    m_Size--;
+    if (Bucket.empty()) {
+      m_Cells.erase(Found);
+      auto Block = m_Blocks.find(BlockKey(Cell));
+      auto &Cells = Block->second;
+      *std::find(Cells.begin(), Cells.end(), Cell) = Cells.back();
+      Cells.pop_back();
+      if (Cells.empty()) {
+        m_Blocks.erase(Block);
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief the K closest points, closest first.
+   * @param Query
+   * @param K
+   * @return std::vector<Result>
+   */
+  [[nodiscard]] std::vector<Result> Nearest(const LatLng &Query,
+                                            size_t K) const {
+    auto Closer = [](const Result &Lhs, const Result &Rhs) {
+      return Lhs.Distance < Rhs.Distance;
+    };
+    std::priority_queue<Result, std::vector<Result>, decltype(Closer)> Best(
+        Closer);
+    auto Worst = [&]() {
+      return Best.size() < K ? std::numeric_limits<double>::infinity()
+                             : Best.top().Distance;
+    };
+    auto Consider = [&](const Entry &E) {
+      double D = Distance(Query, E.Location);
+      if (Best.size() < K) {
+        Best.push({E.Key, E.Location, D});
+      } else if (D < Best.top().Distance) {
+        Best.pop();
+        Best.push({E.Key, E.Location, D});
+      }
+    };
+
+    /**
+     * @brief cells of the visited blocks that may hold a closer point, scanned
+     * closest first so the K-th distance shrinks early.
+     */
+    std::vector<std::pair<double, uint64_t>> Candidates;
+    auto VisitBlock = [&](const std::vector<uint64_t> &Cells) {
+      for (uint64_t Cell : Cells) {
+        double Bound = CellLowerBound(Query, Cell);
+        if (Bound <= Worst()) {
+          Candidates.emplace_back(Bound, Cell);
+        }
+      }
+    };
+    auto ScanCandidates = [&]() {
+      std::sort(Candidates.begin(), Candidates.end());
+      for (const auto &[Bound, Cell] : Candidates) {
+        if (Bound > Worst()) {
+          break;
+        }
+        const auto &Bucket = m_Cells.find(Cell)->second;
+        std::for_each(Bucket.begin(), Bucket.end(), Consider);
+      }
+      Candidates.clear();
+    };
+
+    if (K == 0 || m_Size == 0) {
+      return {};
+    }
+    const auto [Row, Col] = CellOf(m_BlockGrid, Query);
+    for (int64_t Ring = 0;; Ring++) {
+      if (RingLowerBound(Query, Row, Col, Ring) > Worst()) {
+        break;
+      }
+      /**
+       * @brief once the ring wraps around the globe or has more blocks than
+       * the index holds, finish with the blocks outside the visited square.
+       */
+      if (2 * Ring + 1 > m_BlockGrid.Cols ||
+          static_cast<size_t>(8 * Ring) > m_Blocks.size()) {
+        for (const auto &[Block, Cells] : m_Blocks) {
+          if (ChebyshevDistance(m_BlockGrid, Block, Row, Col) >= Ring) {
+            VisitBlock(Cells);
+          }
+        }
+        ScanCandidates();
+        break;
+      }
+      ForEachRingCell(m_BlockGrid, Row, Col, Ring, [&](uint64_t Key) {
+        auto Block = m_Blocks.find(Key);
+        if (Block != m_Blocks.end()) {
+          VisitBlock(Block->second);
+        }
+      });
+      ScanCandidates();
+    }
+
+    std::vector<Result> Results(Best.size());
+    for (auto It = Results.rbegin(); It != Results.rend(); ++It) {
+      *It = Best.top();
+      Best.pop();
+    }
+    return Results;
+  }
+
+  /**
+   * @brief every point within the radius, closest first.
+   * @param Query
+   * @param RadiusMeters
+   * @return std::vector<Result>
+   */
+  [[nodiscard]] std::vector<Result> WithinRadius(const LatLng &Query,
+                                                 double RadiusMeters) const {
+    std::vector<Result> Results;
+    auto Consider = [&](const Entry &E) {
+      double D = Distance(Query, E.Location);
+      if (D <= RadiusMeters) {
+        Results.push_back({E.Key, E.Location, D});
+      }
+    };
+    auto ScanCell = [&](uint64_t Cell) {
+      auto Found = m_Cells.find(Cell);
+      if (Found != m_Cells.end()) {
+        std::for_each(Found->second.begin(), Found->second.end(), Consider);
+      }
+    };
+
+    if (RadiusMeters < 0 || m_Size == 0) {
+      return Results;
+    }
+    /**
+     * @brief collect the blocks the radius reaches, then either look up every
+     * cell under the radius or go through the cells the blocks hold, whichever
+     * is fewer.
+     */
+    const Window Blocks = WindowOf(m_BlockGrid, Query, RadiusMeters);
+    std::vector<const std::vector<uint64_t> *> Reached;
+    size_t ReachedCells = 0;
+    if (Blocks.Count() > m_Blocks.size()) {
+      for (const auto &[Block, Cells] : m_Blocks) {
+        Reached.push_back(&Cells);
+        ReachedCells += Cells.size();
+      }
+    } else {
+      Blocks.ForEach(m_BlockGrid, [&](uint64_t Key) {
+        auto Block = m_Blocks.find(Key);
+        if (Block != m_Blocks.end()) {
+          Reached.push_back(&Block->second);
+          ReachedCells += Block->second.size();
+        }
+      });
+    }
+
+    const Window Cells = WindowOf(m_CellGrid, Query, RadiusMeters);
+    if (Cells.Count() <= ReachedCells) {
+      Cells.ForEach(m_CellGrid, ScanCell);
+    } else {
+      for (const auto *Block : Reached) {
+        for (uint64_t Cell : *Block) {
+          if (CellLowerBound(Query, Cell) <= RadiusMeters) {
+            ScanCell(Cell);
+          }
+        }
+      }
+    }
+
+    std::sort(Results.begin(), Results.end(),
+              [](const Result &Lhs, const Result &Rhs) {
+                return Lhs.Distance < Rhs.Distance;
+              });
+    return Results;
+  }
+
+  /**
+   * @brief great circle (haversine) distance in meters.
+   * @param From
+   * @param To
+   * @return double
+   */
+  static double Distance(const LatLng &From, const LatLng &To) {
+    return openlocationcode::DistanceMeters(From, To);
+  }
+
+  [[nodiscard]] size_t Size() const { return m_Size; }
+  [[nodiscard]] size_t CellCount() const { return m_Cells.size(); }
+  [[nodiscard]] size_t GetCodeLength() const { return m_CodeLength; }
+
+  void Clear() {
+    m_Cells.clear();
+    m_Blocks.clear();
+    m_Size = 0;
+  }
+
+private:
+  static constexpr double Radians = std::numbers::pi / 180;
+
+  /**
+   * @brief rows and columns of the plus code cells of one code length, row 0
+   * is at the south pole and column 0 at the antimeridian.
+   */
+  struct Grid {
+    double Degrees;
+    int64_t Rows;
+    int64_t Cols;
+  };
+
+  /**
+   * @brief the rows and columns a radius around a point reaches, all the
+   * columns when it reaches a pole or wraps around.
+   */
+  struct Window {
+    int64_t RowBegin;
+    int64_t RowEnd;
+    int64_t ColBegin;
+    int64_t ColEnd;
+
+    [[nodiscard]] size_t Count() const {
+      return static_cast<size_t>((RowEnd - RowBegin + 1) *
+                                 (ColEnd - ColBegin + 1));
+    }
+
+    template <typename Func>
+    void ForEach(const Grid &Level, Func &&Visit) const {
+      for (int64_t R = RowBegin; R <= RowEnd; R++) {
+        for (int64_t C = ColBegin; C <= ColEnd; C++) {
+          Visit(PackKey(R, WrapCol(Level, C)));
+        }
+      }
+    }
+  };
+
+  static Grid MakeGrid(size_t CodeLength) {
+    double Degrees = openlocationcode::internal::compute_precision_for_length(
+        static_cast<int>(CodeLength));
+    return {Degrees, std::llround(180 / Degrees), std::llround(360 / Degrees)};
+  }
+
+  static std::pair<int64_t, int64_t> CellOf(const Grid &Level,
+                                            const LatLng &Location) {
+    double Latitude = std::clamp(Location.latitude, -90.0, 90.0);
+    double Longitude =
+        openlocationcode::internal::normalize_longitude(Location.longitude);
+    auto Row = static_cast<int64_t>((Latitude + 90) / Level.Degrees);
+    auto Col = static_cast<int64_t>((Longitude + 180) / Level.Degrees);
+    return {std::min(Row, Level.Rows - 1), WrapCol(Level, Col)};
+  }
+
+  [[nodiscard]] uint64_t CellKey(const LatLng &Location) const {
+    auto [Row, Col] = CellOf(m_CellGrid, Location);
+    return PackKey(Row, Col);
+  }
+
+  [[nodiscard]] uint64_t BlockKey(uint64_t Cell) const {
+    const int64_t Factor = m_CellGrid.Cols / m_BlockGrid.Cols;
+    return PackKey(RowOf(Cell) / Factor, ColOf(Cell) / Factor);
+  }
+
+  static uint64_t PackKey(int64_t Row, int64_t Col) {
+    return static_cast<uint64_t>(Row) << 32 | static_cast<uint64_t>(Col);
+  }
+  static int64_t RowOf(uint64_t Key) { return static_cast<int64_t>(Key >> 32); }
+  static int64_t ColOf(uint64_t Key) {
+    return static_cast<int64_t>(Key & 0xFFFFFFFF);
+  }
+
+  static int64_t WrapCol(const Grid &Level, int64_t Col) {
+    return ((Col % Level.Cols) + Level.Cols) % Level.Cols;
+  }
+
+  static int64_t ChebyshevDistance(const Grid &Level, uint64_t Key,
+                                   int64_t Row, int64_t Col) {
+    int64_t DRow = std::abs(RowOf(Key) - Row);
+    int64_t DCol = std::abs(ColOf(Key) - Col);
+    return std::max(DRow, std::min(DCol, Level.Cols - DCol));
+  }
+
+  template <typename Func>
+  static void ForEachRingCell(const Grid &Level, int64_t Row, int64_t Col,
+                              int64_t Ring, Func &&Visit) {
+    for (int64_t DRow = -Ring; DRow <= Ring; DRow++) {
+      int64_t R = Row + DRow;
+      if (R < 0 || R >= Level.Rows) {
+        continue;
+      }
+      int64_t Step = (DRow == -Ring || DRow == Ring) ? 1 : 2 * Ring;
+      for (int64_t DCol = -Ring; DCol <= Ring; DCol += Step) {
+        Visit(PackKey(R, WrapCol(Level, Col + DCol)));
+      }
+    }
+  }
+
+  static Window WindowOf(const Grid &Level, const LatLng &Query,
+                         double RadiusMeters) {
+    const auto [Row, Col] = CellOf(Level, Query);
+    const double Angle = RadiusMeters / EarthRadiusMeters;
+    const double AngleDegrees = Angle / Radians;
+    const auto RowSpan =
+        static_cast<int64_t>(std::ceil(AngleDegrees / Level.Degrees));
+    Window Result{std::max<int64_t>(Row - RowSpan, 0),
+                  std::min(Row + RowSpan, Level.Rows - 1), 0, Level.Cols - 1};
+    if (std::abs(Query.latitude) + AngleDegrees < 90 &&
+        Angle < std::numbers::pi / 2) {
+      /**
+       * @brief the widest longitude difference on the circle.
+       */
+      double LngDegrees =
+          std::asin(std::sin(Angle) / std::cos(Query.latitude * Radians)) /
+          Radians;
+      auto ColSpan =
+          static_cast<int64_t>(std::ceil(LngDegrees / Level.Degrees));
+      if (2 * ColSpan + 1 < Level.Cols) {
+        Result.ColBegin = Col - ColSpan;
+        Result.ColEnd = Col + ColSpan;
+      }
+    }
+    return Result;
+  }
+
+  /**
+   * @brief meters between the query and any point that is either LatGap
+   * degrees of latitude away, or LngGap degrees of longitude away and no
+   * further than MaxLatitude from the equator (like the query).
+   */
+  static double GapLowerBound(double LatGap, double LngGap,
+                              double MaxLatitude) {
+    double LngAngle =
+        2 * std::asin(std::max(0.0, std::cos(std::min(MaxLatitude, 90.0) *
+                                             Radians)) *
+                      std::sin(std::min(LngGap, 180.0) * Radians / 2));
+    return EarthRadiusMeters * std::min(LatGap * Radians, LngAngle);
+  }
+
+  /**
+   * @brief lower bound in meters on the distance from the query to any point
+   * in a cell, zero when the query is inside it.
+   */
+  [[nodiscard]] double CellLowerBound(const LatLng &Query,
+                                      uint64_t Cell) const {
+    const double Degrees = m_CellGrid.Degrees;
+    const double LatLo = static_cast<double>(RowOf(Cell)) * Degrees - 90;
+    const double LatHi = LatLo + Degrees;
+    const double LngLo = static_cast<double>(ColOf(Cell)) * Degrees - 180;
+    const double LngHi = LngLo + Degrees;
+    const double Longitude =
+        openlocationcode::internal::normalize_longitude(Query.longitude);
+
+    double LatGap =
+        std::max({0.0, LatLo - Query.latitude, Query.latitude - LatHi});
+    double LatBound = LatGap * Radians * EarthRadiusMeters;
+    if (Longitude >= LngLo && Longitude <= LngHi) {
+      return LatBound;
+    }
+    double LngGap = std::min(std::fmod(LngLo - Longitude + 360, 360),
+                             std::fmod(Longitude - LngHi + 360, 360));
+    double MaxLatitude =
+        std::max({std::abs(Query.latitude), std::abs(LatLo), std::abs(LatHi)});
+    return std::max(LatBound,
+                    GapLowerBound(std::numeric_limits<double>::infinity(),
+                                  LngGap, MaxLatitude));
+  }
+
+  /**
+   * @brief lower bound in meters on the distance from the query to any point
+   * in a block Ring or more blocks away, that is outside the square of blocks
+   * visited so far. such a point is either past the square's latitude edges,
+   * or between them and past its longitude edges.
+   */
+  [[nodiscard]] double RingLowerBound(const LatLng &Query, int64_t Row,
+                                      int64_t Col, int64_t Ring) const {
+    if (Ring == 0) {
+      return 0;
+    }
+    constexpr double Infinity = std::numeric_limits<double>::infinity();
+    const double Degrees = m_BlockGrid.Degrees;
+    const double LatLo = static_cast<double>(Row - Ring + 1) * Degrees - 90;
+    const double LatHi = static_cast<double>(Row + Ring) * Degrees - 90;
+    const double LngLo = static_cast<double>(Col - Ring + 1) * Degrees - 180;
+    const double LngHi = static_cast<double>(Col + Ring) * Degrees - 180;
+    const double Longitude =
+        openlocationcode::internal::normalize_longitude(Query.longitude);
+
+    double LatGap = std::min(LatLo <= -90 ? Infinity : Query.latitude - LatLo,
+                             LatHi >= 90 ? Infinity : LatHi - Query.latitude);
+    double LngGap = LngHi - LngLo >= 360
+                        ? Infinity
+                        : std::min(Longitude - LngLo, LngHi - Longitude);
+    return GapLowerBound(std::max(LatGap, 0.0), std::max(LngGap, 0.0),
+                         std::max(std::abs(LatLo), std::abs(LatHi)));
+  }
+
+private:
+  size_t m_CodeLength;
+  Grid m_CellGrid;
+  Grid m_BlockGrid;
+  size_t m_Size{0};
+  std::unordered_map<uint64_t, std::vector<Entry>> m_Cells;
+  /**
+   * @brief the non-empty cells of each block.
+   */
+  std::unordered_map<uint64_t, std::vector<uint64_t>> m_Blocks;
+};
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @class Counter
+ * @brief a value that only goes up, one relaxed atomic add per update.
+ */
+class Counter {
+public:
+  void Increment(uint64_t Amount = 1) {
+    m_Value.fetch_add(Amount, std::memory_order_relaxed);
+  }
+  [[nodiscard]] uint64_t Get() const {
+    return m_Value.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint64_t> m_Value{0};
+};
+
+/**
+ * @class Gauge
+ * @brief a value that goes up and down.
+ */
+class Gauge {
+public:
+  void Set(double Value) { m_Value.store(Value, std::memory_order_relaxed); }
+  void Add(double Amount) {
+    m_Value.fetch_add(Amount, std::memory_order_relaxed);
+  }
+  [[nodiscard]] double Get() const {
+    return m_Value.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<double> m_Value{0};
+};
+
+/**
+ * @class Histogram
+ * @brief observations counted in fixed buckets, Prometheus style.
+ * @details a bucket's counter is bumped per observation, the cumulative
+ * counts Prometheus wants are summed when rendering.
+ */
+class Histogram {
+public:
+  /**
+   * @brief 100us to 10s, for latencies in seconds.
+   */
+  static std::vector<double> LatencyBounds() {
+    return {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+            0.05,   0.1,     0.25,   0.5,   1,      2.5,   5,    10};
+  }
+
+public:
+  /**
+   * @param Bounds the buckets' upper bounds, ascending. +Inf is implied.
+   */
+  explicit Histogram(std::vector<double> Bounds);
+
+  void Observe(double Value);
+
+  [[nodiscard]] const std::vector<double> &GetBounds() const {
+    return m_Bounds;
+  }
+  /**
+   * @brief observations per bucket, not cumulative, the last one is +Inf.
+   */
+  [[nodiscard]] std::vector<uint64_t> GetBucketCounts() const;
+  [[nodiscard]] uint64_t GetCount() const {
+    return m_Count.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] double GetSum() const {
+    return m_Sum.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::vector<double> m_Bounds;
+  std::unique_ptr<std::atomic<uint64_t>[]> m_Buckets;
+  std::atomic<uint64_t> m_Count{0};
+  std::atomic<double> m_Sum{0};
+};
+
+/**
+ * @class Metrics
+ * @brief the process wide metrics registry, rendered in the Prometheus text
+ * exposition format.
+ * @details metrics are registered once by name and labels and the returned
+ * reference is kept by the caller, registering locks, updating never does.
+ * the same name and labels always return the same metric. values that
+ * already live elsewhere (QueryStats, LogRateLimiter) are read when rendering
+ * through collectors instead of being copied on every update.
+ */
+class Metrics {
+public:
+  enum class Type { Counter, Gauge, Histogram };
+
+  /**
+   * @brief appends families to a render, with WriteHeader and WriteSample.
+   */
+  using Collector = std::function<void(std::string &Out)>;
+
+public:
+  static Counter &GetCounter(const std::string &Name, const std::string &Help,
+                             const MetricLabels &Labels = {});
+  static Gauge &GetGauge(const std::string &Name, const std::string &Help,
+                         const MetricLabels &Labels = {});
+  /**
+   * @brief the bounds of the first registration of a name are kept.
+   */
+  static Histogram &
+  GetHistogram(const std::string &Name, const std::string &Help,
+               const MetricLabels &Labels = {},
+               std::vector<double> Bounds = Histogram::LatencyBounds());
+
+  /**
+   * @brief adds a collector called on every render, after the registered
+   * metrics.
+   * @param Name replaces an earlier collector of the same name.
+   * @param Collect
+   */
+  static void AddCollector(const std::string &Name, Collector Collect);
+  static void RemoveCollector(const std::string &Name);
+
+  /**
+   * @brief every metric in the Prometheus text format (version 0.0.4).
+   * @return std::string
+   */
+  [[nodiscard]] static std::string Render();
+
+  static void WriteHeader(std::string &Out, std::string_view Name, Type Kind,
+                          std::string_view Help);
+  static void WriteSample(std::string &Out, std::string_view Name,
+                          const MetricLabels &Labels, double Value);
+  /**
+   * @brief {name="value",...}, values escaped, empty for no labels.
+   */
+  [[nodiscard]] static std::string FormatLabels(const MetricLabels &Labels);
+
+private:
+  struct Family {
+    Type Kind;
+    std::string Help;
+    /** @brief by formatted labels. */
+    std::map<std::string, std::unique_ptr<Counter>> Counters;
+    std::map<std::string, std::unique_ptr<Gauge>> Gauges;
+    std::map<std::string, std::unique_ptr<Histogram>> Histograms;
+  };
+
+  static Family &GetFamily(const std::string &Name, Type Kind,
+                           const std::string &Help);
+
+private:
+  static std::mutex s_Mutex;
+  static std::map<std::string, Family> s_Families;
+  static std::map<std::string, Collector> s_Collectors;
+};
+
+#endif
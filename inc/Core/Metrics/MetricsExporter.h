@@ -0,0 +1,75 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief metrics exporter settings, the "METRICS" section of config.json.
+ */
+struct MetricsOptions {
+  /**
+   * @brief file rewritten with the metrics every Interval (a node exporter
+   * textfile), empty for none.
+   */
+  std::string Path;
+  std::chrono::seconds Interval{15};
+  /**
+   * @brief serves the metrics over http on 127.0.0.1, 0 for none.
+   */
+  uint16_t Port = 0;
+};
+
+/**
+ * @class MetricsExporter
+ * @brief publishes Metrics::Render while alive, to a file and or a loopback
+ * port for Prometheus to scrape.
+ * @details the file is written to a temporary next to it and renamed, a
+ * reader never sees half a render. the http side is one thread answering
+ * every request with the metrics, it only listens on loopback, anything
+ * further is left to a proxy.
+ */
+class MetricsExporter {
+public:
+  explicit MetricsExporter(const MetricsOptions &Options);
+  /**
+   * @brief stops the threads, the file keeps its last render.
+   */
+  ~MetricsExporter();
+
+  MetricsExporter(const MetricsExporter &) = delete;
+  MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+  /**
+   * @brief the port the server listens on, 0 without a server.
+   * @return uint16_t
+   */
+  [[nodiscard]] uint16_t GetPort() const { return m_Port; }
+
+  /**
+   * @brief writes the file now.
+   * @return true, false if there's no file or it couldn't be written.
+   */
+  bool WriteFile();
+
+private:
+  void RunWriter();
+  void RunServer();
+
+private:
+  MetricsOptions m_Options;
+  std::atomic<bool> m_Running{true};
+  std::mutex m_Mutex;
+  std::condition_variable m_Wakeup;
+  int m_Socket{-1};
+  uint16_t m_Port{0};
+  std::thread m_Writer;
+  std::thread m_Server;
+};
+
+#endif
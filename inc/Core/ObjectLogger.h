@@ -1,31 +1,212 @@
 #ifndef OBJECT_LOGGER_H
 #define OBJECT_LOGGER_H
 
+#include "../Config/DatabasePool.h"
+#include "../Models/BaseLogModel.h"
+#include "Metrics/Metrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
-// TODO: write this into database, when accessible.
+/**
+ * @brief the log_level enum of the database.
+ */
+enum class ObjectLogLevel : uint8_t { Debug, Info, Warn, Error, Crit };
 
 /**
- * @brief wont be done now, not until we figure out elastic search and kibana structure.
- * add this to LogModel!
+ * @brief where an entity kind's entries go, its log table and the column
+ * holding the entity id. without a column the id leads the message.
  */
+enum class ObjectLogTarget : uint8_t { Address, Business, Count };
+
+struct ObjectLogOptions {
+  /**
+   * @brief entries the queue holds, rounded up to a power of two. a full
+   * queue drops the entry instead of blocking the producer.
+   */
+  size_t Capacity = 1 << 16;
+  /**
+   * @brief entries per insert, at most. three parameters an entry, postgres
+   * takes 65535 a statement.
+   */
+  size_t BatchSize = 512;
+  /**
+   * @brief how long an entry waits for its batch to fill.
+   */
+  std::chrono::milliseconds FlushInterval{100};
+};
+
+/**
+ * @class ObjectLogPipeline
+ * @brief the entity loggers' entries, queued by any thread and written to
+ * the log tables in batches by one thread.
+ * @details the queue is a bounded lock-free ring (Vyukov's), a producer
+ * claims a slot with one compare and swap and moves its entry in, it never
+ * locks, allocates or waits for the database. the writer takes the entries
+ * in the order their slots were claimed and inserts them in that order, one
+ * insert per table per batch, so an entity's entries keep the order they
+ * were logged in (by logid). when a batch insert fails the rows are retried
+ * one by one, an entity id the table refuses loses only its own entries.
+ */
+class ObjectLogPipeline {
+public:
+  /**
+   * @brief starts the writer thread.
+   * @param Pool borrowed from for every batch, must outlive the pipeline.
+   * @param Options
+   */
+  explicit ObjectLogPipeline(DatabasePool &Pool,
+                             const ObjectLogOptions &Options = {});
+  /**
+   * @brief writes the queued entries and stops the writer.
+   */
+  ~ObjectLogPipeline();
+
+  ObjectLogPipeline(const ObjectLogPipeline &) = delete;
+  ObjectLogPipeline &operator=(const ObjectLogPipeline &) = delete;
+
+  /**
+   * @brief queues an entry, never blocks.
+   * @param Target
+   * @param EntityID shared by the entity's logger, copying it is a reference
+   * count.
+   * @param Level
+   * @param Message
+   * @return false if the queue was full and the entry dropped.
+   */
+  bool Push(ObjectLogTarget Target,
+            const std::shared_ptr<const std::string> &EntityID,
+            ObjectLogLevel Level, std::string &&Message);
+
+  /**
+   * @brief waits until the entries queued before the call are written, or
+   * failed to be.
+   */
+  void Flush();
+
+  [[nodiscard]] uint64_t GetDropped() const {
+    return m_Dropped.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] uint64_t GetFailed() const {
+    return m_Failed.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Entry {
+    ObjectLogTarget Target;
+    ObjectLogLevel Level;
+    std::shared_ptr<const std::string> EntityID;
+    std::string Message;
+  };
+
+  struct alignas(64) Slot {
+    /**
+     * @brief the position the slot can be claimed at, that position + 1
+     * once its entry is in.
+     */
+    std::atomic<size_t> Sequence;
+    Entry Data;
+  };
+
+  /**
+   * @brief moves the next entry out, false if none is ready.
+   */
+  bool Pop(Entry &Taken);
+  void RunWriter();
+  void Write(std::vector<Entry> &Batch);
+  void WriteTarget(SharedManager &Manager, ObjectLogTarget Target,
+                   const std::vector<const Entry *> &Entries);
+
+private:
+  ObjectLogOptions m_Options;
+  DatabasePool &m_Pool;
+  AddressLogModel m_AddressLog;
+  LogModel m_Log;
 
+  std::unique_ptr<Slot[]> m_Slots;
+  size_t m_Mask;
+  alignas(64) std::atomic<size_t> m_Tail{0};
+  /** @brief the writer's alone. */
+  alignas(64) size_t m_Head{0};
+  alignas(64) std::atomic<uint64_t> m_Dropped{0};
+  std::atomic<uint64_t> m_Failed{0};
+
+  /** @brief process wide, every pipeline adds to the same metrics. */
+  Counter &m_WrittenCounter = Metrics::GetCounter(
+      "liveview_object_log_entries_total", "Entity log entries by outcome.",
+      {{"result", "written"}});
+  Counter &m_DroppedCounter = Metrics::GetCounter(
+      "liveview_object_log_entries_total", "Entity log entries by outcome.",
+      {{"result", "dropped"}});
+  Counter &m_FailedCounter = Metrics::GetCounter(
+      "liveview_object_log_entries_total", "Entity log entries by outcome.",
+      {{"result", "failed"}});
+
+  std::atomic<bool> m_Running{true};
+  std::mutex m_Mutex;
+  std::condition_variable m_Wakeup;
+  std::condition_variable m_Flushed;
+  /** @brief the queue positions written so far, under m_Mutex. */
+  size_t m_Written{0};
+  size_t m_FlushRequest{0};
+  std::thread m_Writer;
+};
+
+/**
+ * @class InstanceLogger
+ * @brief an entity's logger, tags its entries with the entity's id.
+ */
 class InstanceLogger {
 public:
-	virtual ~InstanceLogger();
-	virtual void log(std::string &&data) = 0;
+  virtual ~InstanceLogger();
+
+  virtual void log(std::string &&data) = 0;
+  virtual void log(ObjectLogLevel Level, std::string &&data) = 0;
+
+  [[nodiscard]] const std::string &GetEntityID() const { return *m_EntityID; }
+
+protected:
+  InstanceLogger(ObjectLogPipeline &Pipeline, std::string &&EntityID);
+
+protected:
+  ObjectLogPipeline &m_Pipeline;
+  std::shared_ptr<const std::string> m_EntityID;
 };
 
+/**
+ * @class AddressLogger
+ * @brief writes to AddressLog, EntityID is the address' addressid.
+ */
 class AddressLogger final : public InstanceLogger {
 public:
-	void log(std::string &&data) override;
+  AddressLogger(ObjectLogPipeline &Pipeline, std::string AddressID)
+      : InstanceLogger(Pipeline, std::move(AddressID)) {}
+
+  void log(std::string &&data) override;
+  void log(ObjectLogLevel Level, std::string &&data) override;
 };
 
+/**
+ * @class BusinessLogger
+ * @brief businesses have no table yet, their entries go to Log with the
+ * business id leading the message.
+ */
 class BusinessLogger final : public InstanceLogger {
 public:
-	void log(std::string &&data) override;
+  BusinessLogger(ObjectLogPipeline &Pipeline, std::string BusinessID)
+      : InstanceLogger(Pipeline, std::move(BusinessID)) {}
+
+  void log(std::string &&data) override;
+  void log(ObjectLogLevel Level, std::string &&data) override;
 };
 
-// TODO: street, road, business loggers..
+// TODO: street, road loggers..
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,107 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+enum class PerfEvent : uint8_t {
+  Cycles,
+  Instructions,
+  CacheMisses,
+  BranchMisses,
+  ContextSwitches,
+  Count
+};
+
+/**
+ * @brief the counters' values at one point, or the difference of two.
+ */
+struct PerfSample {
+  static constexpr size_t Size = static_cast<size_t>(PerfEvent::Count);
+
+  std::array<uint64_t, Size> Values{};
+  /**
+   * @brief bit i is set when event i was counted.
+   */
+  uint32_t Valid = 0;
+
+  [[nodiscard]] bool Has(PerfEvent Event) const {
+    return (Valid >> static_cast<size_t>(Event)) & 1;
+  }
+  [[nodiscard]] uint64_t Get(PerfEvent Event) const {
+    return Values[static_cast<size_t>(Event)];
+  }
+
+  /**
+   * @brief the events counted between Begin and this, valid in both.
+   */
+  [[nodiscard]] PerfSample operator-(const PerfSample &Begin) const {
+    PerfSample Delta;
+    Delta.Valid = Valid & Begin.Valid;
+    for (size_t i = 0; i < Size; i++) {
+      if ((Delta.Valid >> i) & 1) {
+        Delta.Values[i] = Values[i] >= Begin.Values[i]
+                              ? Values[i] - Begin.Values[i]
+                              : 0;
+      }
+    }
+    return Delta;
+  }
+};
+
+/**
+ * @class PerfCounters
+ * @brief the calling thread's hardware counters, read through Linux
+ * perf_event_open.
+ * @details the events are opened once per thread as one group, so a Read is
+ * a single read(2) and the events are counted over the same instructions.
+ * user space only, which kernel.perf_event_paranoid up to 2 allows. an event
+ * the kernel, cpu or sandbox doesn't offer is left out of the samples (a vm
+ * without a virtual PMU has none of the hardware ones), context switches
+ * fall back to getrusage. when the pmu multiplexes the group the values are
+ * scaled to the time it was enabled.
+ */
+class PerfCounters {
+public:
+  /**
+   * @brief the calling thread's counters, opened on first use.
+   * @return PerfCounters&
+   */
+  static PerfCounters &ForThread();
+  static std::string_view Name(PerfEvent Event);
+
+public:
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  /**
+   * @brief whether any event is counted.
+   */
+  [[nodiscard]] bool IsAvailable() const { return m_Available != 0; }
+  [[nodiscard]] bool Has(PerfEvent Event) const {
+    return (m_Available >> static_cast<size_t>(Event)) & 1;
+  }
+
+  /**
+   * @brief the events' current values, subtract two reads for a scope's.
+   * @return PerfSample
+   */
+  [[nodiscard]] PerfSample Read() const;
+
+private:
+  PerfCounters();
+
+private:
+  int m_Leader{-1};
+  std::vector<int> m_Descriptors;
+  /** @brief the events in the group's read order. */
+  std::vector<PerfEvent> m_GroupOrder;
+  bool m_RusageSwitches{false};
+  uint32_t m_Available{0};
+};
+
+#endif
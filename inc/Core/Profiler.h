@@ -0,0 +1,291 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "Core/PerfCounters.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class ProfilerClock {
+  Steady,
+  /**
+   * @brief the cpu's timestamp counter, cheaper to read than steady_clock.
+   * only used when it is invariant (x86), otherwise Steady is.
+   */
+  Tsc
+};
+
+/**
+ * @brief profiler settings, the "PROFILING" section of config.json.
+ */
+struct ProfilerOptions {
+  bool Enabled = false;
+  /**
+   * @brief where WriteTrace writes the chrome trace, empty to not record
+   * the zones' timeline at all.
+   */
+  std::string TracePath;
+  ProfilerClock Clock = ProfilerClock::Steady;
+  /**
+   * @brief read the hardware counters in PROFILE_ZONE_COUNTERS zones.
+   */
+  bool HardwareCounters = false;
+};
+
+/**
+ * @brief the aggregate of one zone.
+ */
+struct ProfileZoneStats {
+  std::string Name;
+  uint64_t Count = 0;
+  std::chrono::nanoseconds Total{0};
+  std::chrono::nanoseconds Mean{0};
+  std::chrono::nanoseconds P50{0};
+  std::chrono::nanoseconds P99{0};
+  std::chrono::nanoseconds Max{0};
+  /**
+   * @brief the events summed over the runs that counted them, CounterRuns
+   * per event.
+   */
+  PerfSample Counters;
+  std::array<uint64_t, PerfSample::Size> CounterRuns{};
+
+  /**
+   * @brief the event's mean per counted run, 0 when it wasn't counted.
+   */
+  [[nodiscard]] double PerRun(PerfEvent Event) const {
+    const auto Runs = CounterRuns[static_cast<size_t>(Event)];
+    return Runs == 0 ? 0
+                     : static_cast<double>(Counters.Get(Event)) /
+                           static_cast<double>(Runs);
+  }
+};
+
+/**
+ * @class ProfileZone
+ * @brief a named code region's durations, aggregated with relaxed atomics.
+ * @details durations are counted in a log linear histogram, four buckets
+ * per power of two nanoseconds, so a quantile is off by at most a quarter.
+ */
+class ProfileZone {
+public:
+  static constexpr size_t BucketCount = 160;
+
+public:
+  explicit ProfileZone(std::string Name) : m_Name(std::move(Name)) {}
+
+  ProfileZone(const ProfileZone &) = delete;
+  ProfileZone &operator=(const ProfileZone &) = delete;
+
+  void Add(uint64_t Nanoseconds);
+  /**
+   * @brief adds a run's counters, the events in Delta.Valid.
+   */
+  void AddCounters(const PerfSample &Delta);
+  [[nodiscard]] const std::string &GetName() const { return m_Name; }
+  [[nodiscard]] ProfileZoneStats GetStats() const;
+  void Reset();
+
+  [[nodiscard]] static size_t BucketIndex(uint64_t Nanoseconds);
+  [[nodiscard]] static uint64_t BucketUpperBound(size_t Index);
+
+private:
+  std::string m_Name;
+  std::atomic<uint64_t> m_Count{0};
+  std::atomic<uint64_t> m_Total{0};
+  std::atomic<uint64_t> m_Max{0};
+  std::array<std::atomic<uint64_t>, BucketCount> m_Buckets{};
+  std::array<std::atomic<uint64_t>, PerfSample::Size> m_Counters{};
+  std::array<std::atomic<uint64_t>, PerfSample::Size> m_CounterRuns{};
+};
+
+/**
+ * @class Profiler
+ * @brief the process wide zone registry, aggregates and chrome trace.
+ * @details zones are looked up by name once and kept, PROFILE_ZONE keeps its
+ * zone in a function local static. recording a zone is two clock reads and
+ * a few relaxed atomic adds, plus an append to the thread's own trace buffer
+ * when tracing. disabled at runtime a zone costs one relaxed load, and
+ * without ENABLE_PROFILING the macros compile to nothing.
+ */
+class Profiler {
+public:
+  /**
+   * @brief trace events kept per thread, later ones are counted as dropped.
+   */
+  static constexpr size_t MaxTraceEvents = size_t{1} << 18;
+
+public:
+  /**
+   * @brief applies the options and resets every zone, call it before any
+   * zone runs, the clock's ticks don't mix.
+   * @param Options
+   */
+  static void Init(const ProfilerOptions &Options);
+
+  [[nodiscard]] static bool IsEnabled() {
+    return s_Enabled.load(std::memory_order_relaxed);
+  }
+  static void SetEnabled(bool Enabled) {
+    s_Enabled.store(Enabled, std::memory_order_relaxed);
+  }
+  [[nodiscard]] static bool IsTracing() {
+    return s_Tracing.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] static bool IsCounting() {
+    return s_Counting.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief the zone of a name, created on first use. the reference stays
+   * valid for the process' lifetime.
+   * @param Name
+   * @return ProfileZone&
+   */
+  static ProfileZone &GetZone(std::string_view Name);
+
+  /**
+   * @brief the current time in the clock's ticks.
+   * @return uint64_t
+   */
+  [[nodiscard]] static uint64_t Now();
+  [[nodiscard]] static uint64_t ToNanoseconds(uint64_t Ticks);
+
+  /**
+   * @brief adds a run of Zone from Begin to End, in ticks.
+   */
+  static void Record(ProfileZone &Zone, uint64_t Begin, uint64_t End);
+
+  /**
+   * @brief every zone that ran, slowest in total first.
+   * @return std::vector<ProfileZoneStats>
+   */
+  [[nodiscard]] static std::vector<ProfileZoneStats> Snapshot();
+  /**
+   * @brief one line per zone, count, mean, p50, p99 and max, and the
+   * counters per run when counted.
+   * @return std::string
+   */
+  [[nodiscard]] static std::string Report();
+
+  /**
+   * @brief the recorded zones as chrome trace event json, for
+   * chrome://tracing or ui.perfetto.dev.
+   * @return std::string
+   */
+  [[nodiscard]] static std::string TraceToJson();
+  /**
+   * @brief writes TraceToJson to Path, or the options' TracePath.
+   * @return true, false when there's no path or it couldn't be written.
+   */
+  static bool WriteTrace(const std::string &Path = {});
+
+  /**
+   * @brief zeroes the zones and clears the trace, zones stay registered.
+   */
+  static void Reset();
+
+private:
+  struct TraceEvent {
+    const ProfileZone *Zone;
+    uint64_t Begin;
+    uint64_t End;
+  };
+
+  struct ThreadTrace {
+    uint32_t ThreadId;
+    std::mutex Mutex;
+    std::vector<TraceEvent> Events;
+    uint64_t Dropped = 0;
+  };
+
+  static ThreadTrace &GetThreadTrace();
+  static bool CalibrateTsc();
+
+private:
+  static std::atomic<bool> s_Enabled;
+  static std::atomic<bool> s_Tracing;
+  static std::atomic<bool> s_Counting;
+  static std::atomic<bool> s_UseTsc;
+  static std::atomic<uint64_t> s_Epoch;
+  static double s_NanosecondsPerTick;
+  static std::string s_TracePath;
+
+  static std::mutex s_Mutex;
+  static std::map<std::string, std::unique_ptr<ProfileZone>, std::less<>>
+      s_Zones;
+  static std::vector<std::shared_ptr<ThreadTrace>> s_Traces;
+};
+
+/**
+ * @class ProfileScope
+ * @brief records its zone from construction to destruction, when the
+ * profiler was enabled at construction.
+ * @details with counters, and the profiler counting, the thread's hardware
+ * counters are read around the clock reads, outside the timed region.
+ */
+class ProfileScope {
+public:
+  explicit ProfileScope(ProfileZone &Zone, bool WithCounters = false)
+      : m_Zone(Zone), m_Active(Profiler::IsEnabled()),
+        m_Counting(m_Active && WithCounters && Profiler::IsCounting()) {
+    if (m_Counting) {
+      m_CountersBegin = PerfCounters::ForThread().Read();
+    }
+    m_Begin = m_Active ? Profiler::Now() : 0;
+  }
+  ~ProfileScope() {
+    if (m_Active) {
+      const uint64_t End = Profiler::Now();
+      if (m_Counting) {
+        m_Zone.AddCounters(PerfCounters::ForThread().Read() - m_CountersBegin);
+      }
+      Profiler::Record(m_Zone, m_Begin, End);
+    }
+  }
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+  ProfileZone &m_Zone;
+  bool m_Active;
+  bool m_Counting;
+  uint64_t m_Begin;
+  PerfSample m_CountersBegin;
+};
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief profiles the rest of the enclosing scope under Name.
+ */
+#ifdef ENABLE_PROFILING
+#define PROFILE_ZONE_IMPL(Name, WithCounters)                                  \
+  static ProfileZone &PROFILE_CONCAT(ProfileZone_, __LINE__) =                 \
+      Profiler::GetZone(Name);                                                 \
+  ProfileScope PROFILE_CONCAT(ProfileScope_, __LINE__) {                       \
+    PROFILE_CONCAT(ProfileZone_, __LINE__), WithCounters                       \
+  }
+#define PROFILE_ZONE(Name) PROFILE_ZONE_IMPL(Name, false)
+/**
+ * @brief PROFILE_ZONE with the hardware counters, see PerfCounters.
+ */
+#define PROFILE_ZONE_COUNTERS(Name) PROFILE_ZONE_IMPL(Name, true)
+#else
+#define PROFILE_ZONE(Name) (void)0
+#define PROFILE_ZONE_COUNTERS(Name) (void)0
+#endif
+
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+
+#endif
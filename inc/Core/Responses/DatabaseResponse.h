@@ -4,38 +4,83 @@
 #include "Response.h"
 
 /**
- * @warning
- * not needed right now, basic pqxx::result solves everything, class is no longer needed and useless.
+ * @class DBResponse
+ * @brief a query's result with what it cost, for diagnostics.
+ * @details the rows, the affected rows and the bytes of the fields' values,
+ * the time the connection spent executing the query (sending it until the
+ * result arrived, libpq doesn't separate the server's share) and the time
+ * reading every field of the result took here, with the backend pid of the
+ * connection that served it. DatabaseManager::Diagnose builds one around a
+ * query, the queries themselves keep returning a plain pqxx::result.
  */
-
 class DBResponse : public Response<pqxx::result> {
 public:
-  explicit DBResponse(const pqxx::result &ResponseData);
-  explicit DBResponse(pqxx::result &&ResponseData);
+  explicit DBResponse(const pqxx::result &ResponseData,
+                      std::chrono::nanoseconds ExecutionTime = {},
+                      int BackendPid = 0, bool Failed = false);
+  explicit DBResponse(pqxx::result &&ResponseData,
+                      std::chrono::nanoseconds ExecutionTime = {},
+                      int BackendPid = 0, bool Failed = false);
 
   [[nodiscard]] inline std::string GetResponseQuery() const override {
     return m_ResponseData.query();
   }
+  /**
+   * @brief the payload, the bytes of every field's value.
+   * @return const size_t
+   */
   [[nodiscard]] inline const size_t GetResponseSize() const override {
     return m_ResponseSize;
   }
 
+  [[nodiscard]] size_t GetRowCount() const { return m_RowCount; }
+  [[nodiscard]] size_t GetAffectedRows() const { return m_AffectedRows; }
+  [[nodiscard]] std::chrono::nanoseconds GetExecutionTime() const {
+    return m_ExecutionTime;
+  }
+  [[nodiscard]] std::chrono::nanoseconds GetDecodeTime() const {
+    return m_DecodeTime;
+  }
+  /**
+   * @brief the connection's server process, 0 when unknown.
+   * @return int
+   */
+  [[nodiscard]] int GetBackendPid() const { return m_BackendPid; }
+  /**
+   * @brief the query failed, the result is the empty one returned instead.
+   * @return bool
+   */
+  [[nodiscard]] bool IsFailed() const { return m_Failed; }
+
   pqxx::result &GetResponseData() { return m_ResponseData; }
 
+  /**
+   * @brief one line with the envelope's fields, for the logs.
+   * @return std::string
+   */
+  [[nodiscard]] std::string Summary() const;
+
   void RunBenchmark(std::function<void()> Func) override;
   const std::string ResponseType() override {
     return "Response Type: Database";
   }
 
 private:
-  size_t m_ResponseSize;
+  /**
+   * @brief reads every field once, counting the rows and payload and timing
+   * the read as the decode time.
+   */
+  void Measure();
+
+private:
   pqxx::result m_ResponseData;
+  size_t m_ResponseSize{0};
+  size_t m_RowCount{0};
+  size_t m_AffectedRows{0};
+  std::chrono::nanoseconds m_ExecutionTime;
+  std::chrono::nanoseconds m_DecodeTime{0};
+  int m_BackendPid;
+  bool m_Failed;
 };
 
-/**
- * @brief
- * DBResponse x = Manager->AddModel; -> copy ctor
- * return DBReponse(CreateTable(Args...)); -> ctor
- */
-
 #endif
\ No newline at end of file
@@ -0,0 +1,308 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "Metrics/Metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class DatabaseManager;
+class DatabasePool;
+
+struct SchedulerOptions {
+  /** @brief the workers, 0 for the hardware's threads. */
+  size_t Threads = 0;
+  /**
+   * @brief the jobs a worker's deque holds before it grows, rounded up to a
+   * power of two.
+   */
+  size_t DequeCapacity = 256;
+};
+
+/**
+ * @class Scheduler
+ * @brief runs jobs on a fixed set of workers, each with its own deque. a
+ * worker pushes and pops the jobs it submits at the back of its deque, the
+ * idle ones steal from the front of the others'. jobs submitted from other
+ * threads go through one shared queue.
+ * @details the deques are Chase-Lev's (Lê et al.'s C11 version), the owner
+ * never locks and a thief takes a job with one compare and swap. a grown
+ * deque's old buffers are kept until the scheduler goes, a thief may still
+ * read them. a worker without jobs spins over the others' deques for a
+ * moment, then sleeps until a job is submitted. a job's exception is logged
+ * and dropped, TaskGroup is how to get it back.
+ */
+class Scheduler {
+public:
+  using Job = std::move_only_function<void()>;
+
+public:
+  explicit Scheduler(const SchedulerOptions &Options = {});
+  /**
+   * @brief runs the jobs already submitted, then stops the workers. nothing
+   * may be submitted once it started.
+   */
+  ~Scheduler();
+
+  Scheduler(const Scheduler &) = delete;
+  Scheduler &operator=(const Scheduler &) = delete;
+
+  /**
+   * @brief the process' scheduler, made on first use with the hardware's
+   * threads.
+   * @return Scheduler&
+   */
+  static Scheduler &Global();
+
+  /**
+   * @brief queues a job, on the calling worker's deque when it is one of
+   * this scheduler's.
+   * @param Work
+   */
+  void Submit(Job &&Work);
+
+  /**
+   * @brief runs one job the calling thread finds, its own deque first when
+   * it is a worker, then the shared queue, then another worker's deque.
+   * @return false if there was none.
+   */
+  bool RunPending();
+
+  [[nodiscard]] size_t GetThreadCount() const { return m_Workers.size(); }
+  /**
+   * @brief whether the calling thread is one of this scheduler's workers.
+   * @return bool
+   */
+  [[nodiscard]] bool IsWorkerThread() const;
+
+private:
+  friend class TaskGroup;
+
+  /**
+   * @class WorkDeque
+   * @brief one worker's jobs, Push and Pop are its alone, Steal anyone's.
+   */
+  class WorkDeque {
+  public:
+    explicit WorkDeque(size_t Capacity);
+    ~WorkDeque();
+
+    void Push(Job *Work);
+    Job *Pop();
+    /**
+     * @return nullptr when empty, or when another thief won the job.
+     */
+    Job *Steal();
+    [[nodiscard]] bool IsEmpty() const {
+      return m_Bottom.load(std::memory_order_acquire) <=
+             m_Top.load(std::memory_order_acquire);
+    }
+
+  private:
+    struct Buffer {
+      explicit Buffer(size_t Size)
+          : Mask(Size - 1), Slots(new std::atomic<Job *>[Size]) {}
+
+      [[nodiscard]] Job *Get(int64_t Index) const {
+        return Slots[static_cast<size_t>(Index) & Mask].load(
+            std::memory_order_relaxed);
+      }
+      void Put(int64_t Index, Job *Work) {
+        Slots[static_cast<size_t>(Index) & Mask].store(
+            Work, std::memory_order_relaxed);
+      }
+
+      size_t Mask;
+      std::unique_ptr<std::atomic<Job *>[]> Slots;
+    };
+
+    Buffer *Grow(Buffer *Current, int64_t Top, int64_t Bottom);
+
+  private:
+    alignas(64) std::atomic<int64_t> m_Top{0};
+    alignas(64) std::atomic<int64_t> m_Bottom{0};
+    std::atomic<Buffer *> m_Buffer;
+    /** @brief the owner's alone, every buffer the deque had. */
+    std::vector<std::unique_ptr<Buffer>> m_Buffers;
+  };
+
+  struct Worker {
+    explicit Worker(size_t Capacity) : Deque(Capacity) {}
+
+    WorkDeque Deque;
+    std::thread Thread;
+    /** @brief counted by the worker, added to the metrics when it idles. */
+    uint64_t Executed = 0;
+    uint64_t Stolen = 0;
+  };
+
+  void Run(size_t Index);
+  Job *FindWork();
+  void Execute(Job *Work);
+  /**
+   * @brief whether any queue has a job, what a thread rechecks before it
+   * sleeps.
+   */
+  [[nodiscard]] bool HasWork() const;
+  /**
+   * @brief sleeps until a job is submitted, or Pending reaches zero when
+   * given.
+   */
+  void Park(const std::atomic<size_t> *Pending);
+  /**
+   * @brief wakes one sleeper, or all of them.
+   */
+  void Wake(bool All);
+
+private:
+  std::vector<std::unique_ptr<Worker>> m_Workers;
+
+  std::mutex m_InjectedMutex;
+  std::deque<Job *> m_Injected;
+  std::atomic<size_t> m_InjectedCount{0};
+
+  std::mutex m_SleepMutex;
+  std::condition_variable m_SleepCondition;
+  /** @brief bumped under m_SleepMutex by every wake up. */
+  uint64_t m_Epoch = 0;
+  std::atomic<size_t> m_Sleeping{0};
+  std::atomic<bool> m_Stopping{false};
+
+  /** @brief process wide, every scheduler adds to the same metrics. */
+  Counter &m_JobsCounter = Metrics::GetCounter(
+      "liveview_scheduler_jobs_total", "Jobs the schedulers ran.");
+  Counter &m_StealsCounter =
+      Metrics::GetCounter("liveview_scheduler_steals_total",
+                          "Jobs taken from another worker's deque.");
+};
+
+/**
+ * @class TaskGroup
+ * @brief jobs that are waited for together, they may add more jobs to
+ * their group.
+ * @details Wait runs jobs while the group's aren't done, on a worker its
+ * own deque first, where the jobs it just added are, so a job waiting on a
+ * group doesn't hold its worker idle. the first exception a job throws is
+ * rethrown by Wait.
+ */
+class TaskGroup {
+public:
+  using ConnectionJob =
+      std::move_only_function<void(std::shared_ptr<DatabaseManager> &)>;
+
+public:
+  explicit TaskGroup(Scheduler &Owner = Scheduler::Global());
+  /**
+   * @brief waits for the jobs, their exception is dropped unless Wait was
+   * called.
+   */
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  template <typename Func> void Run(Func &&Work) {
+    m_State->Pending.fetch_add(1, std::memory_order_relaxed);
+    m_Scheduler.Submit(
+        [State = m_State, Work = std::forward<Func>(Work)]() mutable {
+          State->Capture(Work);
+          State->Finish();
+        });
+  }
+
+  /**
+   * @brief runs Work with a connection borrowed from Pool and returns it
+   * after. while the pool has none the job is parked in the pool, not on a
+   * worker, and submitted when a connection comes back (DatabasePool's
+   * Borrow), so at most the pool's size of workers wait on the database.
+   * @param Pool must outlive the group's Wait.
+   * @param Work
+   */
+  void RunWithConnection(DatabasePool &Pool, ConnectionJob &&Work);
+
+  /**
+   * @brief returns once every job of the group ran, running jobs itself
+   * meanwhile.
+   */
+  void Wait();
+
+private:
+  struct State {
+    explicit State(Scheduler &Owner) : Owner(Owner) {}
+
+    template <typename Func> void Capture(Func &&Work) {
+      try {
+        Work();
+      } catch (...) {
+        std::lock_guard Lock{Mutex};
+        if (!Exception) {
+          Exception = std::current_exception();
+        }
+      }
+    }
+    /**
+     * @brief the job is done, the last one wakes the waiters.
+     */
+    void Finish();
+
+    Scheduler &Owner;
+    std::atomic<size_t> Pending{0};
+    std::mutex Mutex;
+    std::exception_ptr Exception;
+  };
+
+  Scheduler &m_Scheduler;
+  /** @brief shared with the jobs, the last one may finish after Wait. */
+  std::shared_ptr<State> m_State;
+};
+
+namespace Detail {
+template <typename Func>
+void SplitRange(TaskGroup &Group, size_t First, size_t Last, size_t Grain,
+                Func &Body) {
+  while (Last - First > Grain) {
+    const size_t Middle = First + (Last - First) / 2;
+    Group.Run([&Group, Middle, Last, Grain, &Body] {
+      SplitRange(Group, Middle, Last, Grain, Body);
+    });
+    Last = Middle;
+  }
+  Body(First, Last);
+}
+} // namespace Detail
+
+/**
+ * @brief calls Body(Begin, End) over [First, Last) in chunks of at most
+ * Grain indexes, concurrently on the scheduler's workers and the caller.
+ * @details the range is halved lazily, a job keeps the lower half and
+ * submits the upper one, so idle workers steal the largest chunks left.
+ * @param Owner
+ * @param First
+ * @param Last
+ * @param Grain 0 for about eight chunks a worker.
+ * @param Body called concurrently, must be thread safe.
+ */
+template <typename Func>
+void ParallelFor(Scheduler &Owner, size_t First, size_t Last, size_t Grain,
+                 Func &&Body) {
+  if (First >= Last) {
+    return;
+  }
+  if (Grain == 0) {
+    Grain = std::max<size_t>(1, (Last - First) / (Owner.GetThreadCount() * 8));
+  }
+  TaskGroup Group{Owner};
+  Detail::SplitRange(Group, First, Last, Grain, Body);
+  Group.Wait();
+}
+
+#endif
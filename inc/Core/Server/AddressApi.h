@@ -0,0 +1,64 @@
+#ifndef ADDRESS_API_H
+#define ADDRESS_API_H
+
+#include "../../Config/Config.h"
+#include "../../Config/DatabasePool.h"
+#include "../../Models/AddressModel.h"
+#include "../../Models/BaseLogModel.h"
+#include "../ObjectLogger.h"
+#include "HttpServer.h"
+
+/**
+ * @class AddressApi
+ * @brief the json endpoints over the address models.
+ * @details
+ *   GET    /health
+ *   POST   /addresses            the address' fields, 201 {"addressid"}
+ *   GET    /addresses?name=&number=
+ *   GET    /addresses/nearby?latitude=&longitude=&radius=  (meters)
+ *   GET    /addresses/{id}
+ *   PUT    /addresses/{id}       the fields to change, PATCH alike
+ *   DELETE /addresses/{id}
+ *   GET    /addresses/{id}/logs  in the order written
+ *   POST   /addresses/{id}/logs  {"level", "message"}, 202
+ *   POST   /logs                 {"source", "level", "message"}, 202
+ * a handler checks a connection out of the pool for its queries and returns
+ * it before answering, reads in the interactive lane and writes in the
+ * write one. a checkout the pool sheds answers 503. log entries go through
+ * the pipeline, they're accepted once queued, a full queue answers 503.
+ */
+class AddressApi {
+public:
+  AddressApi(DatabasePool &Pool, ObjectLogPipeline &Pipeline);
+
+  /**
+   * @brief adds the routes to a server that hasn't started.
+   * @param Server
+   */
+  void Register(HttpServer &Server);
+
+private:
+  void AddAddress(const HttpRequest &Request, HttpResponse &Response);
+  void GetAddress(const HttpRequest &Request, HttpResponse &Response);
+  void FindAddress(const HttpRequest &Request, HttpResponse &Response);
+  void FindNearby(const HttpRequest &Request, HttpResponse &Response);
+  void UpdateAddress(const HttpRequest &Request, HttpResponse &Response);
+  void DeleteAddress(const HttpRequest &Request, HttpResponse &Response);
+  void GetAddressLogs(const HttpRequest &Request, HttpResponse &Response);
+  void AddAddressLog(const HttpRequest &Request, HttpResponse &Response);
+  void AddLog(const HttpRequest &Request, HttpResponse &Response);
+
+  /**
+   * @brief queues the body's "level" and "message" for the entity.
+   */
+  void QueueLog(ObjectLogTarget Target, std::string EntityID,
+                const Json &Body, HttpResponse &Response);
+
+private:
+  DatabasePool &m_Pool;
+  ObjectLogPipeline &m_Pipeline;
+  UniquePtrModel<AddressModel> m_Address;
+  UniquePtrModel<AddressLogModel> m_AddressLog;
+};
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef HTTP_H
+#define HTTP_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+enum class HttpMethod : uint8_t {
+  Get,
+  Head,
+  Post,
+  Put,
+  Patch,
+  Delete,
+  Options,
+  Unknown
+};
+
+enum class HttpParseStatus : uint8_t {
+  Complete,
+  Incomplete,
+  Invalid,
+  TooLarge
+};
+
+struct HttpHeader {
+  std::string_view Name;
+  std::string_view Value;
+};
+
+/**
+ * @brief one HTTP/1.x request, every view points into the connection's read
+ * buffer and is valid until the connection reads again.
+ * @details parsing copies nothing, a connection parses into the same
+ * request over and over.
+ */
+struct HttpRequest {
+  static constexpr size_t MaxHeaders = 32;
+  static constexpr size_t MaxParams = 4;
+
+  HttpMethod Method = HttpMethod::Unknown;
+  std::string_view Target;
+  std::string_view Path;
+  /** @brief what follows the '?', not decoded. */
+  std::string_view Query;
+  std::string_view Body;
+  /** @brief HTTP/1.1 keeps the connection by default, HTTP/1.0 doesn't. */
+  bool KeepAlive = true;
+  std::array<HttpHeader, MaxHeaders> Headers;
+  size_t HeaderCount = 0;
+  /** @brief the path segments the route's "{}" matched, in order. */
+  std::array<std::string_view, MaxParams> Params;
+  size_t ParamCount = 0;
+
+  /**
+   * @brief parses the request at the start of Buffer. bodies need a
+   * Content-Length, chunked requests are Invalid.
+   * @param Buffer
+   * @param Request
+   * @param Consumed the request's length, its headers and body, when
+   * Complete.
+   * @param MaxSize requests longer, or with more than MaxHeaders headers,
+   * are TooLarge.
+   * @return HttpParseStatus
+   */
+  static HttpParseStatus Parse(std::string_view Buffer, HttpRequest &Request,
+                               size_t &Consumed, size_t MaxSize);
+
+  /**
+   * @brief percent and '+' decoding, for query values only, a '+' in a
+   * path segment is a plus and not a space.
+   * @param Text
+   * @return std::string
+   */
+  [[nodiscard]] static std::string Decode(std::string_view Text);
+
+  /**
+   * @brief a header's value, the name is matched case insensitively.
+   * @param Name
+   * @return std::string_view, empty when missing.
+   */
+  [[nodiscard]] std::string_view Header(std::string_view Name) const;
+  /**
+   * @brief a query parameter's raw value, see Decode.
+   * @param Name
+   * @return std::string_view, empty when missing.
+   */
+  [[nodiscard]] std::string_view QueryParameter(std::string_view Name) const;
+  [[nodiscard]] std::string_view Param(size_t Index) const {
+    return Index < ParamCount ? Params[Index] : std::string_view{};
+  }
+};
+
+/**
+ * @brief what a handler answers, a connection reuses it so the body keeps
+ * its capacity between requests.
+ */
+struct HttpResponse {
+  int Status = 200;
+  std::string_view ContentType = "application/json";
+  std::string Body;
+
+  void Clear() {
+    Status = 200;
+    ContentType = "application/json";
+    Body.clear();
+  }
+
+  /**
+   * @brief a json {"error": Message} body.
+   * @param ErrorStatus
+   * @param Message
+   */
+  void Error(int ErrorStatus, std::string_view Message);
+
+  /**
+   * @brief appends the status line, the headers and the body (not for HEAD).
+   * @param Output
+   * @param KeepAlive
+   * @param Head
+   */
+  void AppendTo(std::string &Output, bool KeepAlive, bool Head) const;
+
+  [[nodiscard]] static std::string_view Reason(int Status);
+};
+
+#endif
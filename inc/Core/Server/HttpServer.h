@@ -0,0 +1,138 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include "../Metrics/Metrics.h"
+#include "Http.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief http server settings, the "SERVER" section of config.json.
+ */
+struct HttpServerOptions {
+  /** @brief dotted ipv4 address to listen on. */
+  std::string Address = "127.0.0.1";
+  /** @brief 0 picks a free port, see HttpServer::GetPort. */
+  uint16_t Port = 8080;
+  /** @brief event loops, one per core when 0. */
+  size_t Threads = 0;
+  /** @brief pins loop i to core i. */
+  bool PinThreads = false;
+  /**
+   * @brief a request's headers and body together, a larger one is answered
+   * with 413 and its connection closed.
+   */
+  size_t MaxRequestSize = 1 << 20;
+  /** @brief open connections per loop, more are closed on accept. */
+  size_t MaxConnections = 4096;
+  /** @brief connections idle this long are closed. */
+  std::chrono::seconds IdleTimeout{30};
+};
+
+/**
+ * @class HttpServer
+ * @brief an HTTP/1.1 server with keep-alive and pipelining, an epoll loop per
+ * core.
+ * @details every loop has its own SO_REUSEPORT listener on the port, the
+ * kernel spreads the connections between them and a connection stays on the
+ * loop that accepted it, the loops share nothing but the routes. a
+ * connection's buffers, the request and the response are reused from one
+ * request to the next and closed connections are kept for new ones, a
+ * request is parsed into views over the read buffer. handlers run on the
+ * loop, a blocking handler (a query) holds the loop's other connections, so
+ * the loops should be about as many as the pool's connections.
+ */
+class HttpServer {
+public:
+  using Handler = std::function<void(const HttpRequest &, HttpResponse &)>;
+
+public:
+  explicit HttpServer(HttpServerOptions Options);
+  /**
+   * @brief stops the loops.
+   */
+  ~HttpServer();
+
+  HttpServer(const HttpServer &) = delete;
+  HttpServer &operator=(const HttpServer &) = delete;
+
+  /**
+   * @brief adds a route before Start, routes are tried in the order added.
+   * a "{}" segment matches any one segment, see HttpRequest::Param. HEAD
+   * requests take the GET routes.
+   * @param Method
+   * @param Pattern "/addresses/{}/logs"
+   * @param Callback
+   */
+  void Route(HttpMethod Method, std::string_view Pattern, Handler Callback);
+
+  /**
+   * @brief listens and starts the loops.
+   * @return false if the address couldn't be listened on.
+   */
+  bool Start();
+  /**
+   * @brief stops the loops and closes their connections, waits for the
+   * handlers that are running.
+   */
+  void Stop();
+
+  /**
+   * @brief the port listened on, 0 before Start.
+   * @return uint16_t
+   */
+  [[nodiscard]] uint16_t GetPort() const { return m_Port; }
+  [[nodiscard]] size_t GetThreadCount() const { return m_Loops.size(); }
+
+  /**
+   * @brief routes a parsed request and runs its handler, 404 or 405 when
+   * nothing matches and 500 when the handler throws.
+   * @param Request its Params are filled from the route.
+   * @param Response
+   */
+  void Dispatch(HttpRequest &Request, HttpResponse &Response) const;
+
+private:
+  struct RouteEntry {
+    HttpMethod Method;
+    std::vector<std::string> Segments;
+    Handler Callback;
+  };
+
+  class Loop;
+
+  /**
+   * @brief whether the path's segments match the route's, filling Params.
+   */
+  static bool Match(const RouteEntry &Entry, std::string_view Path,
+                    HttpRequest &Request);
+
+private:
+  HttpServerOptions m_Options;
+  std::vector<RouteEntry> m_Routes;
+  std::vector<std::unique_ptr<Loop>> m_Loops;
+  std::vector<std::thread> m_Threads;
+  uint16_t m_Port{0};
+
+  Counter &m_RequestsCounter =
+      Metrics::GetCounter("liveview_http_requests_total",
+                          "Requests answered by the http server.");
+  Counter &m_ErrorsCounter = Metrics::GetCounter(
+      "liveview_http_errors_total",
+      "Requests the http server answered with a 5xx status.");
+  Histogram &m_RequestHistogram =
+      Metrics::GetHistogram("liveview_http_request_seconds",
+                            "Time the http handlers took per request.");
+  Gauge &m_ConnectionsGauge =
+      Metrics::GetGauge("liveview_http_connections",
+                        "Connections open on the http server.");
+};
+
+#endif
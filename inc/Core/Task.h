@@ -0,0 +1,280 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename T = void> class Task;
+
+namespace Detail {
+/**
+ * @brief what every task's promise shares, the coroutine awaiting it and
+ * the exception it ended with.
+ */
+class TaskPromiseBase {
+public:
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    /**
+     * @brief symmetric transfer to the awaiting coroutine, a chain of tasks
+     * finishing doesn't grow the stack.
+     */
+    template <typename Promise>
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<Promise> Handle) const noexcept {
+      return Handle.promise().m_Continuation;
+    }
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+  void unhandled_exception() noexcept {
+    m_Exception = std::current_exception();
+  }
+
+  void SetContinuation(std::coroutine_handle<> Continuation) noexcept {
+    m_Continuation = Continuation;
+  }
+  void Rethrow() const {
+    if (m_Exception) {
+      std::rethrow_exception(m_Exception);
+    }
+  }
+
+private:
+  std::coroutine_handle<> m_Continuation = std::noop_coroutine();
+  std::exception_ptr m_Exception;
+};
+
+template <typename T> class TaskPromise : public TaskPromiseBase {
+public:
+  Task<T> get_return_object() noexcept;
+  template <typename U> void return_value(U &&Value) {
+    m_Value.emplace(std::forward<U>(Value));
+  }
+  T TakeValue() {
+    Rethrow();
+    return std::move(*m_Value);
+  }
+
+private:
+  std::optional<T> m_Value;
+};
+
+template <> class TaskPromise<void> : public TaskPromiseBase {
+public:
+  Task<void> get_return_object() noexcept;
+  void return_void() const noexcept {}
+  void TakeValue() const { Rethrow(); }
+};
+
+/**
+ * @brief a fire and forget coroutine, starts at once and frees itself when
+ * done. it must not throw.
+ */
+struct Detached {
+  struct promise_type {
+    Detached get_return_object() const noexcept { return {}; }
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+    void return_void() const noexcept {}
+    void unhandled_exception() const noexcept { std::terminate(); }
+  };
+};
+} // namespace Detail
+
+/**
+ * @class Task
+ * @brief a lazy coroutine, it starts when awaited and resumes its awaiter
+ * when done, on the thread it finished on. the value, or the exception it
+ * threw, goes to the awaiter.
+ * @details a task awaiting an AsyncDatabase query continues on the
+ * database's loop thread, it shouldn't block there. SyncWait is how code
+ * outside a coroutine waits for one.
+ */
+template <typename T> class [[nodiscard]] Task {
+public:
+  using promise_type = Detail::TaskPromise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Task() = default;
+  explicit Task(Handle Coroutine) : m_Coroutine(Coroutine) {}
+  ~Task() {
+    if (m_Coroutine) {
+      m_Coroutine.destroy();
+    }
+  }
+
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+
+  Task(Task &&other) noexcept
+      : m_Coroutine(std::exchange(other.m_Coroutine, {})) {}
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      if (m_Coroutine) {
+        m_Coroutine.destroy();
+      }
+      m_Coroutine = std::exchange(other.m_Coroutine, {});
+    }
+    return *this;
+  }
+
+  [[nodiscard]] bool IsDone() const {
+    return !m_Coroutine || m_Coroutine.done();
+  }
+
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      Handle Coroutine;
+
+      bool await_ready() const noexcept { return Coroutine.done(); }
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<> Awaiting) const noexcept {
+        Coroutine.promise().SetContinuation(Awaiting);
+        return Coroutine;
+      }
+      T await_resume() const { return Coroutine.promise().TakeValue(); }
+    };
+    return Awaiter{m_Coroutine};
+  }
+
+  /**
+   * @brief awaits the task finishing without taking its value or exception,
+   * a later co_await of the task takes them.
+   */
+  auto WhenDone() noexcept {
+    struct Awaiter {
+      Handle Coroutine;
+
+      bool await_ready() const noexcept { return Coroutine.done(); }
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<> Awaiting) const noexcept {
+        Coroutine.promise().SetContinuation(Awaiting);
+        return Coroutine;
+      }
+      void await_resume() const noexcept {}
+    };
+    return Awaiter{m_Coroutine};
+  }
+
+private:
+  Handle m_Coroutine;
+};
+
+namespace Detail {
+template <typename T> Task<T> TaskPromise<T>::get_return_object() noexcept {
+  return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+  return Task<void>{
+      std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+}
+
+/**
+ * @brief the promise is the frame's own, the waiting thread may go on the
+ * moment its value is set.
+ */
+template <typename T>
+Detached Fulfil(Task<T> &Awaited, std::promise<T> Result) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(Awaited);
+      Result.set_value();
+    } else {
+      Result.set_value(co_await std::move(Awaited));
+    }
+  } catch (...) {
+    Result.set_exception(std::current_exception());
+  }
+}
+
+/**
+ * @brief counts the tasks of a WhenAll down, the last one to finish resumes
+ * the awaiter. it starts at one more than the tasks so none can resume it
+ * before it suspended.
+ */
+class WhenAllLatch {
+public:
+  explicit WhenAllLatch(size_t Tasks) : m_Count(Tasks + 1) {}
+
+  bool await_ready() const noexcept { return false; }
+  bool await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+    m_Awaiting = Awaiting;
+    return m_Count.fetch_sub(1, std::memory_order_acq_rel) > 1;
+  }
+  void await_resume() const noexcept {}
+
+  void Arrive() noexcept {
+    if (m_Count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      m_Awaiting.resume();
+    }
+  }
+
+private:
+  std::atomic<size_t> m_Count;
+  std::coroutine_handle<> m_Awaiting;
+};
+
+template <typename T>
+Detached ArriveWhenDone(Task<T> &Child, WhenAllLatch &Latch) {
+  co_await Child.WhenDone();
+  Latch.Arrive();
+}
+} // namespace Detail
+
+/**
+ * @brief blocks the calling thread until the task finishes.
+ * @tparam T
+ * @param Awaited
+ * @return T, or rethrows the task's exception.
+ */
+template <typename T> T SyncWait(Task<T> Awaited) {
+  std::promise<T> Result;
+  auto Future = Result.get_future();
+  Detail::Fulfil(Awaited, std::move(Result));
+  return Future.get();
+}
+
+/**
+ * @brief starts every task, they run concurrently as far as what they await
+ * allows, and finishes when all did.
+ * @param Tasks
+ * @return Task<std::vector<T>> the values in the tasks' order, the first
+ * exception in that order is rethrown instead.
+ */
+template <typename T>
+Task<std::vector<T>> WhenAll(std::vector<Task<T>> Tasks) {
+  Detail::WhenAllLatch Latch{Tasks.size()};
+  for (auto &Child : Tasks) {
+    Detail::ArriveWhenDone(Child, Latch);
+  }
+  co_await Latch;
+  std::vector<T> Values;
+  Values.reserve(Tasks.size());
+  for (auto &Child : Tasks) {
+    Values.push_back(co_await std::move(Child));
+  }
+  co_return Values;
+}
+
+inline Task<> WhenAll(std::vector<Task<>> Tasks) {
+  Detail::WhenAllLatch Latch{Tasks.size()};
+  for (auto &Child : Tasks) {
+    Detail::ArriveWhenDone(Child, Latch);
+  }
+  co_await Latch;
+  for (auto &Child : Tasks) {
+    co_await std::move(Child);
+  }
+}
+
+#endif
@@ -4,8 +4,13 @@
 #include "../Core/Address/Address.h"
 #include "../Core/Address/Common/Addresses.h"
 #include "../Core/Address/Common/Countries.h"
+#include "../Core/Location/PlusCodes/covering.h"
+#include "../Core/Location/SpatialIndex.h"
 #include "Model.h"
 
+#include <limits>
+#include <vector>
+
 class AddressModel final {
   /**
    * @brief in here we need to init a logger for a certain address!
@@ -19,7 +24,8 @@ public:
   [[nodiscard]] const std::string &GetTableName() const { return m_TableName; }
 
   /**
-   * @brief add record to Address table.
+   * @brief add record to Address table, the pluscell is filled from the
+   * latitude and longitude when given.
    * @param Manager
    * @param Fields
    * @return pqxx::result
@@ -43,7 +49,9 @@ public:
   }
 
   /**
-   * @brief update a record in the Address table.
+   * @brief update a record in the Address table, the pluscell follows the
+   * latitude and longitude. when only one of them is updated the other is
+   * read from the record first, the condition has to match a single one.
    * @tparam T
    * @param Manager
    * @param Fields
@@ -52,8 +60,12 @@ public:
    * @return pqxx::result
    */
   template <typename T>
-  pqxx::result Update(SharedManager &Manager, const StringUnMap &Fields,
+  pqxx::result Update(SharedManager &Manager, StringUnMap Fields,
                       const std::string &Condition, T &&arg) {
+    if (!CompleteCoordinates(Manager, Fields, Condition, arg) ||
+        !SetPlusCell(Fields)) {
+      return {};
+    }
     pqxx::params params;
     if (Fields.size() == 1) {
       auto field = Fields.begin();
@@ -93,7 +105,92 @@ public:
    */
   Address GetAddressData(SharedManager &Manager, const std::string &ID);
 
+  /**
+   * @brief bulk load the addresses that have coordinates into a spatial index,
+   * keyed by addressid. replaces the index content.
+   * @param Manager
+   * @param Index
+   * @return size_t, number of addresses loaded.
+   */
+  size_t LoadSpatialIndex(SharedManager &Manager,
+                          SpatialIndex<std::string> &Index);
+
+  /**
+   * @brief the addresses inside a box, the south west longitude is greater
+   * than the north east one when the box crosses the antimeridian. the box is
+   * covered with plus code cells and fetched by pluscell ranges in one query.
+   * @param Manager
+   * @param SouthWest
+   * @param NorthEast
+   * @return pqxx::result
+   */
+  pqxx::result GetAddressesInBox(SharedManager &Manager,
+                                 const openlocationcode::LatLng &SouthWest,
+                                 const openlocationcode::LatLng &NorthEast);
+
+  /**
+   * @brief the addresses within a radius (meters) of a center, fetched like
+   * GetAddressesInBox.
+   * @param Manager
+   * @param Center
+   * @param RadiusMeters
+   * @return pqxx::result
+   */
+  pqxx::result GetAddressesWithinRadius(SharedManager &Manager,
+                                        const openlocationcode::LatLng &Center,
+                                        double RadiusMeters);
+
 private:
+  /**
+   * @brief sets pluscell when the fields hold a latitude and a longitude.
+   * @param Fields
+   * @return bool, false if the coordinates can't be parsed.
+   */
+  static bool SetPlusCell(StringUnMap &Fields);
+
+  /**
+   * @brief adds the stored latitude or longitude when the fields hold only
+   * the other one, so SetPlusCell gets both.
+   * @tparam T
+   * @param Manager
+   * @param Fields
+   * @param Condition
+   * @param arg
+   * @return bool, false if the record can't be read or isn't the only one.
+   */
+  template <typename T>
+  bool CompleteCoordinates(SharedManager &Manager, StringUnMap &Fields,
+                           const std::string &Condition, const T &arg) {
+    const bool Latitude = Fields.contains("latitude");
+    if (Latitude == Fields.contains("longitude")) {
+      return true;
+    }
+    auto Stored = Manager->GetModelData(m_TableName, Condition, arg);
+    if (Manager->LastQueryFailed()) {
+      return false;
+    }
+    if (Stored.size() > 1) {
+      APP_ERROR("ADDRESS COORDINATES ERROR - {} RECORDS FOR ONE COORDINATE",
+                Stored.size());
+      return false;
+    }
+    const char *Missing = Latitude ? "longitude" : "latitude";
+    /** @brief no record to update, or it has no coordinates to complete. */
+    if (Stored.empty() || Stored[0][Missing].is_null()) {
+      return true;
+    }
+    Fields[Missing] = Stored[0][Missing].c_str();
+    return true;
+  }
+
+  /**
+   * @brief the pluscell ranges covering a region.
+   * @param Region
+   * @return std::vector<std::pair<int64_t, int64_t>>
+   */
+  static std::vector<std::pair<int64_t, int64_t>>
+  PlusCellRanges(const openlocationcode::Region &Region);
+
   std::string m_TableName;
 };
 
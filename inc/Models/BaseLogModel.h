@@ -12,6 +12,18 @@ public:
   [[nodiscard]] const std::string &GetTableName() const { return m_TableName; }
 
   pqxx::result Add(SharedManager &Manager, const StringUnMap &Fields);
+  /**
+   * @brief adds several records in one insert, in order.
+   * @param Manager
+   * @param Columns
+   * @param RowCount
+   * @param Params Columns.size() values per record, one record after the
+   * other.
+   * @return pqxx::result
+   */
+  pqxx::result AddRows(SharedManager &Manager,
+                       const std::vector<std::string> &Columns,
+                       size_t RowCount, const pqxx::params &Params);
 
 private:
   std::string m_TableName;
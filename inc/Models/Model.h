@@ -20,8 +20,29 @@ public:
     return m_Schemes;
   }
 
+  /**
+   * @brief the indexed fields of each model.
+   * @return const std::map<std::string, std::vector<std::string>>&
+   */
+  [[nodiscard]] const std::map<std::string, std::vector<std::string>> &
+  GetIndexes() const {
+    return m_Indexes;
+  }
+
+  /**
+   * @brief the fields each model gained after its table was first created,
+   * added to existing tables that miss them.
+   * @return const std::map<std::string, std::vector<std::string>>&
+   */
+  [[nodiscard]] const std::map<std::string, std::vector<std::string>> &
+  GetMigrations() const {
+    return m_Migrations;
+  }
+
 private:
   std::map<std::string, SchemeMap> m_Schemes;
+  std::map<std::string, std::vector<std::string>> m_Indexes;
+  std::map<std::string, std::vector<std::string>> m_Migrations;
 };
 } // namespace Model
 
@@ -4,7 +4,11 @@
 #include "Config/Config.h"
 #include "Config/DatabasePool.h"
 #include "Core/Benchmark.h"
+#include "Core/ObjectLogger.h"
+#include "Core/Server/AddressApi.h"
 #include "Models/AddressModel.h"
 #include "Models/BaseLogModel.h"
 
+#include <csignal>
+
 #endif
\ No newline at end of file
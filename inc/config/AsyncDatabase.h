@@ -0,0 +1,367 @@
+#ifndef ASYNC_DATABASE_H
+#define ASYNC_DATABASE_H
+
+#include "../Core/Metrics/Metrics.h"
+#include "../Core/Task.h"
+#include "DatabaseQueries.h"
+
+#include <libpq-fe.h>
+
+#include <charconv>
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class AsyncParams
+ * @brief a statement's parameters in postgres' text format, what
+ * pqxx::params is to the blocking path.
+ */
+class AsyncParams {
+public:
+  AsyncParams() = default;
+  template <typename... Args>
+    requires(sizeof...(Args) > 0 &&
+             !(std::is_same_v<std::remove_cvref_t<Args>, AsyncParams> || ...))
+  explicit AsyncParams(Args &&...args) {
+    (Append(std::forward<Args>(args)), ...);
+  }
+
+  void Append(std::string Value) {
+    m_Values.push_back(std::move(Value));
+    m_IsNull.push_back(false);
+  }
+  void Append(std::string_view Value) { Append(std::string(Value)); }
+  void Append(const char *Value) { Append(std::string(Value)); }
+  void Append(bool Value) { Append(std::string(Value ? "true" : "false")); }
+  template <typename T>
+    requires std::is_arithmetic_v<T>
+  void Append(T Value) {
+    char Buffer[32];
+    const auto Converted = std::to_chars(Buffer, Buffer + 32, Value);
+    Append(std::string(Buffer, Converted.ptr));
+  }
+  void Append(std::nullopt_t) {
+    m_Values.emplace_back();
+    m_IsNull.push_back(true);
+  }
+  template <typename T> void Append(const std::optional<T> &Value) {
+    if (Value) {
+      Append(*Value);
+    } else {
+      Append(std::nullopt);
+    }
+  }
+  void Append(const AsyncParams &Params) {
+    m_Values.insert(m_Values.end(), Params.m_Values.begin(),
+                    Params.m_Values.end());
+    m_IsNull.insert(m_IsNull.end(), Params.m_IsNull.begin(),
+                    Params.m_IsNull.end());
+  }
+
+  [[nodiscard]] size_t Size() const { return m_Values.size(); }
+  /**
+   * @brief the values as PQsendQueryParams takes them, valid until the
+   * params change.
+   */
+  [[nodiscard]] const char *const *GetValues();
+
+private:
+  std::vector<std::string> m_Values;
+  std::vector<bool> m_IsNull;
+  std::vector<const char *> m_Pointers;
+};
+
+/**
+ * @class AsyncResult
+ * @brief owns a statement's PGresult. a failed statement, or one that
+ * never reached the server, has its error and no rows.
+ */
+class AsyncResult {
+public:
+  AsyncResult() = default;
+  explicit AsyncResult(PGresult *Result);
+  /**
+   * @brief a failure without a result, the error's message.
+   */
+  static AsyncResult Failure(std::string Error);
+
+  [[nodiscard]] bool IsFailed() const { return !m_Error.empty(); }
+  [[nodiscard]] const std::string &GetError() const { return m_Error; }
+  [[nodiscard]] bool IsEmpty() const { return GetRowCount() == 0; }
+  [[nodiscard]] int GetRowCount() const {
+    return m_Result ? PQntuples(m_Result.get()) : 0;
+  }
+  [[nodiscard]] int GetColumnCount() const {
+    return m_Result ? PQnfields(m_Result.get()) : 0;
+  }
+  [[nodiscard]] std::string_view GetColumnName(int Column) const;
+  /**
+   * @return int, -1 when the result has no such column.
+   */
+  [[nodiscard]] int GetColumnIndex(const std::string &Name) const;
+  /**
+   * @brief the value in postgres' text format, empty for null.
+   */
+  [[nodiscard]] std::string_view GetValue(int Row, int Column) const;
+  [[nodiscard]] std::string_view GetValue(int Row,
+                                          const std::string &Column) const {
+    return GetValue(Row, GetColumnIndex(Column));
+  }
+  [[nodiscard]] bool IsNull(int Row, int Column) const;
+  /**
+   * @brief the rows an insert, update or delete touched.
+   */
+  [[nodiscard]] size_t GetAffectedRows() const;
+
+private:
+  struct ResultDeleter {
+    void operator()(PGresult *Result) const { PQclear(Result); }
+  };
+
+  std::unique_ptr<PGresult, ResultDeleter> m_Result;
+  std::string m_Error;
+};
+
+class AsyncDatabase;
+
+/**
+ * @class AsyncQuery
+ * @brief the awaitable of one statement, co_await gives its AsyncResult. it
+ * runs on the first free connection and the awaiting coroutine resumes on
+ * the database's loop thread.
+ * @details the loop points at the query while it runs, it lives in the
+ * awaiting coroutine's frame and can't be moved.
+ */
+class [[nodiscard]] AsyncQuery {
+public:
+  AsyncQuery(AsyncDatabase &Database, std::string_view TableName,
+             std::string Query, AsyncParams Params)
+      : m_Database(Database), m_TableName(TableName),
+        m_Query(std::move(Query)), m_Params(std::move(Params)) {}
+
+  AsyncQuery(const AsyncQuery &) = delete;
+  AsyncQuery &operator=(const AsyncQuery &) = delete;
+
+  bool await_ready() const noexcept { return false; }
+  /**
+   * @return false, not suspending, when the database stopped or the
+   * statement is empty (nothing to insert), which has no rows.
+   */
+  bool await_suspend(std::coroutine_handle<> Awaiting);
+  AsyncResult await_resume() { return std::move(m_Result); }
+
+private:
+  friend class AsyncDatabase;
+
+  AsyncDatabase &m_Database;
+  std::string m_TableName;
+  std::string m_Query;
+  AsyncParams m_Params;
+  AsyncResult m_Result;
+  std::coroutine_handle<> m_Awaiting;
+  std::chrono::steady_clock::time_point m_Begin;
+  uint64_t m_QueryHash = 0;
+  int64_t m_FlightBegin = 0;
+};
+
+/**
+ * @class AsyncDatabase
+ * @brief the row operations of DatabaseManager as awaitables, over
+ * connections in libpq's non-blocking mode that one epoll thread drives.
+ * @details every connection runs one statement at a time, a coroutine
+ * awaiting several queries (WhenAll) keeps as many connections busy, the
+ * rest wait in order for one to free. the tables are made, altered and
+ * dropped by DatabaseManager, this path only reads and writes rows. errors
+ * are logged and come back as a failed AsyncResult. a broken connection is
+ * reset once, polled from the same epoll set so the loop keeps serving the
+ * others, and a statement handed to it waits for the reset. the queries are
+ * recorded in QueryStats and the query metrics like the blocking ones, they
+ * aren't sampled for plans.
+ */
+class AsyncDatabase {
+public:
+  static constexpr int DefaultConnections = 10;
+
+public:
+  /**
+   * @brief connects, blocking, then starts the loop thread.
+   * @param ConnectionString
+   * @param Connections at least one.
+   */
+  explicit AsyncDatabase(const std::string &ConnectionString,
+                         int Connections = DefaultConnections);
+  /**
+   * @brief finishes the queries already submitted, then stops the loop and
+   * closes the connections. it must not be destroyed from a coroutine it
+   * resumed.
+   */
+  ~AsyncDatabase();
+
+  AsyncDatabase(const AsyncDatabase &) = delete;
+  AsyncDatabase &operator=(const AsyncDatabase &) = delete;
+
+  /**
+   * @brief true when every connection is up.
+   * @return bool
+   */
+  [[nodiscard]] bool IsDatabaseConnected() const;
+  [[nodiscard]] size_t GetConnectionCount() const {
+    return m_Connections.size();
+  }
+
+  /**
+   * @brief runs any statement, with $1... bound to Params.
+   * @param TableName what QueryStats records the statement under.
+   * @param Statement
+   * @param Params
+   * @return AsyncQuery
+   */
+  AsyncQuery Query(std::string_view TableName, std::string Statement,
+                   AsyncParams Params = {}) {
+    return AsyncQuery{*this, TableName, std::move(Statement),
+                      std::move(Params)};
+  }
+
+  AsyncQuery GetModelData(const std::string &ModelName) {
+    return Query(ModelName, DatabaseQueries::SelectAll(ModelName));
+  }
+  template <typename T>
+  AsyncQuery GetModelData(const std::string &ModelName,
+                          const std::string &FieldName, T &&arg) {
+    return Query(ModelName, DatabaseQueries::SelectWhere(ModelName, FieldName),
+                 AsyncParams{std::forward<T>(arg)});
+  }
+  template <typename... Args>
+  AsyncQuery GetModelDataArgs(const std::string &ModelName,
+                              const std::string &FirstFieldName,
+                              const std::string &SecondFieldName,
+                              Args &&...arg) {
+    return Query(ModelName,
+                 DatabaseQueries::SelectWhere(ModelName, FirstFieldName,
+                                              SecondFieldName),
+                 AsyncParams{std::forward<Args>(arg)...});
+  }
+  /**
+   * @brief see DatabaseManager::GetModelDataInRanges.
+   */
+  AsyncQuery
+  GetModelDataInRanges(const std::string &ModelName,
+                       const std::string &FieldName,
+                       const std::vector<std::pair<int64_t, int64_t>> &Ranges,
+                       std::string_view Condition = {},
+                       const AsyncParams &Params = {});
+  AsyncQuery InsertInto(const std::string &ModelName,
+                        const StringUnMap &Fields);
+  AsyncQuery InsertRows(const std::string &ModelName,
+                        const std::vector<std::string> &Columns,
+                        size_t RowCount, AsyncParams Params);
+  AsyncQuery UpdateColumn(const std::string &ModelName,
+                          std::string_view FieldName,
+                          std::string_view Condition, AsyncParams Params) {
+    return Query(ModelName,
+                 DatabaseQueries::UpdateColumn(ModelName, FieldName, Condition),
+                 std::move(Params));
+  }
+  AsyncQuery UpdateColumns(const std::string &ModelName,
+                           const StringUnMap &Fields,
+                           std::string_view Condition, AsyncParams Params) {
+    return Query(ModelName,
+                 DatabaseQueries::UpdateColumns(ModelName, Fields, Condition),
+                 std::move(Params));
+  }
+  AsyncQuery DeleteRecord(const std::string &ModelName,
+                          std::string_view Condition, AsyncParams Params) {
+    return Query(ModelName, DatabaseQueries::DeleteRecord(ModelName, Condition),
+                 std::move(Params));
+  }
+
+private:
+  friend class AsyncQuery;
+
+  struct Connection {
+    PGconn *Handle = nullptr;
+    int Socket = -1;
+    /** @brief the statement it runs, null when free. */
+    AsyncQuery *Running = nullptr;
+    /** @brief libpq has unsent bytes, the loop waits for EPOLLOUT. */
+    bool Writing = false;
+    /** @brief reconnecting, the socket's events go to PollReset. */
+    bool Resetting = false;
+  };
+
+  /**
+   * @brief hands the query to the loop, false once it stopped.
+   */
+  bool Submit(AsyncQuery *Pending);
+  void Run();
+  /**
+   * @brief puts the connection's socket in the epoll set, readable.
+   */
+  void Register(size_t Index);
+  void Watch(size_t Index, bool Writing);
+  /**
+   * @brief starts waiting queries on the free connections.
+   */
+  void Dispatch();
+  void Send(size_t Index, AsyncQuery *Pending);
+  void Transmit(size_t Index);
+  void Flush(size_t Index);
+  void Read(size_t Index);
+  /**
+   * @brief frees the connection and resumes its query's coroutine.
+   */
+  void Complete(size_t Index);
+  /**
+   * @brief fails the running query, if any, and resets a connection that
+   * broke while it was up. a failed reset isn't reset again here, the next
+   * statement on the connection starts another one.
+   */
+  void Fail(size_t Index, std::string_view Where);
+  /**
+   * @brief starts reconnecting, the connection leaves the free ones until
+   * PollReset ends it.
+   */
+  void Reset(size_t Index);
+  /**
+   * @brief advances the reset, on its end re-registers the socket and sends
+   * the statement waiting for it, or frees the connection.
+   */
+  void PollReset(size_t Index);
+  /**
+   * @brief the reset's socket in the epoll set, libpq may change it between
+   * polls.
+   */
+  bool WatchReset(size_t Index, bool Writing);
+  void EndReset(size_t Index, bool Connected);
+
+private:
+  std::vector<Connection> m_Connections;
+  /** @brief the loop's alone. */
+  std::vector<size_t> m_Free;
+  std::deque<AsyncQuery *> m_Waiting;
+  size_t m_Running = 0;
+
+  std::mutex m_Mutex;
+  /** @brief submitted from other threads, under m_Mutex. */
+  std::vector<AsyncQuery *> m_Submitted;
+  bool m_Stopping = false;
+
+  int m_Epoll = -1;
+  int m_Wakeup = -1;
+  std::thread m_Loop;
+
+  Gauge &m_InFlight = Metrics::GetGauge(
+      "liveview_db_async_queries_in_flight",
+      "Statements running on the async connections.");
+};
+
+#endif
@@ -1,7 +1,13 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include "Config/DatabasePool.h"
 #include "Config/Logger.h"
+#include "Config/QueryPlans.h"
+#include "Config/SingleFlight.h"
+#include "Core/Metrics/MetricsExporter.h"
+#include "Core/Profiler.h"
+#include "Core/Server/HttpServer.h"
 
 #include <exception>
 #include <filesystem>
@@ -21,6 +27,61 @@ public:
   TestDatabaseToString(const std::filesystem::path &Path);
   [[nodiscard]] static std::string
   LoggingPathToString(const std::filesystem::path &Path);
+  /**
+   * @brief the "LOGGING" section, missing keys keep the LoggerOptions defaults.
+   * @param Path
+   * @return LoggerOptions
+   */
+  [[nodiscard]] static LoggerOptions
+  LoggingOptions(const std::filesystem::path &Path);
+  /**
+   * @brief the "METRICS" section, missing keys keep the MetricsOptions
+   * defaults.
+   * @param Path
+   * @return MetricsOptions
+   */
+  [[nodiscard]] static MetricsOptions
+  MetricsExporterOptions(const std::filesystem::path &Path);
+  /**
+   * @brief the "PROFILING" section, missing keys keep the ProfilerOptions
+   * defaults.
+   * @param Path
+   * @return ProfilerOptions
+   */
+  [[nodiscard]] static ProfilerOptions
+  ProfilingOptions(const std::filesystem::path &Path);
+  /**
+   * @brief the "QUERY_PLANS" section, missing keys keep the QueryPlanOptions
+   * defaults.
+   * @param Path
+   * @return QueryPlanOptions
+   */
+  [[nodiscard]] static QueryPlanOptions
+  QueryPlanCaptureOptions(const std::filesystem::path &Path);
+  /**
+   * @brief the "SINGLE_FLIGHT" section, missing keys keep the
+   * SingleFlightOptions defaults.
+   * @param Path
+   * @return SingleFlightOptions
+   */
+  [[nodiscard]] static SingleFlightOptions
+  ReadCoalescingOptions(const std::filesystem::path &Path);
+  /**
+   * @brief the "POOL" section, a lane's missing keys keep the
+   * CheckoutOptions defaults.
+   * @param Path
+   * @return CheckoutOptions
+   */
+  [[nodiscard]] static CheckoutOptions
+  PoolCheckoutOptions(const std::filesystem::path &Path);
+  /**
+   * @brief the "SERVER" section, missing keys keep the HttpServerOptions
+   * defaults.
+   * @param Path
+   * @return HttpServerOptions
+   */
+  [[nodiscard]] static HttpServerOptions
+  ServerOptions(const std::filesystem::path &Path);
 };
 
 #endif
\ No newline at end of file
@@ -45,6 +45,31 @@ public:
     return m_DatabaseConnection.connection_string();
   }
 
+  /**
+   * @brief the query functions log errors and return an empty result, this
+   * tells the two apart for the last query.
+   * @return bool
+   */
+  [[nodiscard]] inline bool LastQueryFailed() const {
+    return m_LastQueryFailed;
+  }
+  /**
+   * @brief how long the last query's exec took, sending it until libpq
+   * handed back the whole result.
+   * @return std::chrono::nanoseconds
+   */
+  [[nodiscard]] inline std::chrono::nanoseconds LastQueryTime() const {
+    return m_LastQueryTime;
+  }
+  /**
+   * @brief the server process serving the connection, as in
+   * pg_stat_activity.
+   * @return int
+   */
+  [[nodiscard]] inline int GetBackendPid() const {
+    return m_DatabaseConnection.backendpid();
+  }
+
 private:
   friend class DatabaseManager;
 
@@ -66,16 +91,28 @@ private:
    */
   template <typename... Args>
   pqxx::result CrQuery(const std::string &Query, Args &&...args) {
+    m_LastQueryFailed = true;
+    m_LastQueryTime = std::chrono::nanoseconds(0);
     if (!IsDatabaseConnected()) {
-      APP_ERROR("CRQUERY(PF) - QUERY ERROR - DATABASE CONNECTION ERROR");
+      APP_ERROR_LIMITED(
+          "CRQUERY(PF) - QUERY ERROR - DATABASE CONNECTION ERROR");
       return {};
     }
+    const uint64_t QueryHash = std::hash<std::string>{}(Query);
+    const int64_t Begin =
+        FlightRecorder::Record(FlightEvent::QueryBegin, QueryHash);
     try {
-      return m_DatabaseNonTransaction.exec_params(Query,
-                                                  std::forward<Args>(args)...);
+      auto Result = m_DatabaseNonTransaction.exec_params(
+          Query, std::forward<Args>(args)...);
+      const int64_t Elapsed = FlightRecorder::Now() - Begin;
+      FlightRecorder::Record(FlightEvent::QueryEnd, QueryHash, Elapsed);
+      m_LastQueryTime = std::chrono::nanoseconds(Elapsed);
+      m_LastQueryFailed = false;
+      return Result;
     } catch (const std::exception &e) {
-      APP_ERROR("CRQUERY(PF) - QUERY EXECUTION ERROR - " +
-                std::string(e.what()));
+      FlightRecorder::Record(FlightEvent::QueryError, QueryHash);
+      APP_ERROR_LIMITED("CRQUERY(PF) - QUERY EXECUTION ERROR - {}",
+                        e.what());
       return {};
     }
   }
@@ -88,9 +125,22 @@ private:
    */
   pqxx::result WQuery(const std::string &Query);
 
+  /**
+   * @brief a result shared by another connection's statement stands for
+   * this one's last query.
+   * @param Failed
+   * @param Time
+   */
+  void SetLastQuery(bool Failed, std::chrono::nanoseconds Time) {
+    m_LastQueryFailed = Failed;
+    m_LastQueryTime = Time;
+  }
+
 private:
   pqxx::connection m_DatabaseConnection;
   pqxx::nontransaction m_DatabaseNonTransaction;
+  bool m_LastQueryFailed{false};
+  std::chrono::nanoseconds m_LastQueryTime{0};
 };
 
 #endif
\ No newline at end of file
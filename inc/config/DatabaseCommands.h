@@ -22,8 +22,11 @@ enum class DatabaseFieldCommands : std::uint8_t {
   VarChar100Field,
   VarChar100NotNullField,
   SerialPrimaryKeyField,
+  BigSerialPrimaryKeyField,
   TimestampField,
   LogEnumNotNullField,
+  DoublePrecisionField,
+  BigIntField,
 
   FkAddress,
 };
@@ -38,6 +41,7 @@ enum class DatabaseQueryCommands : std::uint8_t {
 
   CreateTable,
   CreateTableIfNotExists,
+  CreateIndex,
 
   UpdateAdd,
   UpdateDropColumn,
@@ -60,9 +64,13 @@ const std::unordered_map<DatabaseFieldCommands, std::string>
         {DatabaseFieldCommands::VarChar100NotNullField,
          "varchar(100) not null"},
         {DatabaseFieldCommands::SerialPrimaryKeyField, "serial primary key"},
+        {DatabaseFieldCommands::BigSerialPrimaryKeyField,
+         "bigserial primary key"},
         {DatabaseFieldCommands::TimestampField,
          "timestamp default current_timestamp "},
         {DatabaseFieldCommands::LogEnumNotNullField, "log_level not null"},
+        {DatabaseFieldCommands::DoublePrecisionField, "double precision"},
+        {DatabaseFieldCommands::BigIntField, "bigint"},
 
         {DatabaseFieldCommands::FkAddress,
          "constraint fkaddress foreign key (addressid) references "
@@ -80,6 +88,7 @@ const std::unordered_map<DatabaseQueryCommands, std::string>
         {DatabaseQueryCommands::CreateTable, "create table "},
         {DatabaseQueryCommands::CreateTableIfNotExists,
          "create table if not exists "},
+        {DatabaseQueryCommands::CreateIndex, "create index if not exists "},
 
         {DatabaseQueryCommands::UpdateAdd, "add "},
         {DatabaseQueryCommands::UpdateDropColumn, "drop column "},
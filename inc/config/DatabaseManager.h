@@ -1,15 +1,23 @@
 #ifndef DATABASE_MANAGER_H
 #define DATABASE_MANAGER_H
 
+#include "../Core/Responses/DatabaseResponse.h"
 #include "../Core/UUID.h"
 #include "Database.h"
 #include "DatabaseCommands.h"
+#include "DatabaseQueries.h"
 #include "Logger.h"
+#include "QueryPlans.h"
+#include "QueryStats.h"
+#include "SingleFlight.h"
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 /**
  * @class DatabaseManager
@@ -50,6 +58,14 @@ public:
   [[nodiscard]] inline std::string GetConnectionString() const {
     return m_DatabaseManager->GetConnectionString();
   }
+  /**
+   * @brief the queries log errors and return an empty result, this tells the
+   * two apart for the last one.
+   * @return bool
+   */
+  [[nodiscard]] inline bool LastQueryFailed() const {
+    return m_DatabaseManager->LastQueryFailed();
+  }
 
   /**
    * @brief Inits the database timezone.
@@ -125,6 +141,33 @@ public:
     return GetTableData(ModelName, FirstFieldName, SecondFieldName,
                         std::forward<Args>(arg)...);
   }
+  /**
+   * @brief Get the Model Data whose field falls in any of the closed ranges,
+   * one query the field's index answers with range scans.
+   * @param ModelName
+   * @param FieldName
+   * @param Ranges [min, max] pairs.
+   * @param Condition optional, anded to the ranges. its placeholders continue
+   * after the range bounds, from $(2 * Ranges.size() + 1).
+   * @param Params the Condition's params.
+   * @return pqxx::result
+   */
+  pqxx::result
+  GetModelDataInRanges(const std::string &ModelName,
+                       const std::string &FieldName,
+                       const std::vector<std::pair<int64_t, int64_t>> &Ranges,
+                       std::string_view Condition = {},
+                       const pqxx::params &Params = {});
+  /**
+   * @brief add a field to an existing table, unless it already has it.
+   * @param ModelName
+   * @param FieldName
+   * @param FieldType
+   * @return pqxx::result
+   */
+  pqxx::result AddMissingColumn(const std::string &ModelName,
+                                const std::string &FieldName,
+                                const std::string &FieldType);
   /**
    * @brief add fields to an existing table.
    * @param ModelName string, name of the model/table.
@@ -152,6 +195,14 @@ public:
   pqxx::result AlterColumn(const std::string &ModelName,
                            const std::string &FieldName,
                            const std::string &NewFieldType);
+  /**
+   * @brief create an index on a field of an existing table, if missing.
+   * @param ModelName
+   * @param FieldName
+   * @return pqxx::result
+   */
+  pqxx::result AddIndex(const std::string &ModelName,
+                        const std::string &FieldName);
   /**
    * @brief inserts data to the table's database.
    * @param ModelName
@@ -160,6 +211,18 @@ public:
    */
   pqxx::result InsertInto(const std::string &ModelName,
                           const StringUnMap &Fields);
+  /**
+   * @brief inserts several rows to the table in one statement, in order.
+   * @param ModelName
+   * @param Columns the columns every row fills.
+   * @param RowCount
+   * @param Params the rows' values one row after the other, Columns.size()
+   * per row.
+   * @return pqxx::result
+   */
+  pqxx::result InsertRows(const std::string &ModelName,
+                          const std::vector<std::string> &Columns,
+                          size_t RowCount, const pqxx::params &Params);
   /**
    * @brief updates the table's field value with a specific condition.
    * @param ModelName
@@ -195,7 +258,69 @@ public:
                             std::string_view Condition,
                             const pqxx::params &Params);
 
+  /**
+   * @brief runs Query, a call of this manager's or of a model's with it, and
+   * wraps its result with the rows, payload, times and connection of the
+   * statement. opt in, the queries don't measure their results otherwise.
+   * @details the times and failure are the last statement's when Query runs
+   * several.
+   * @tparam Func returns pqxx::result.
+   * @param Query
+   * @return DBResponse
+   */
+  template <typename Func> DBResponse Diagnose(Func &&Query) {
+    pqxx::result Result = std::invoke(std::forward<Func>(Query));
+    DBResponse Response{std::move(Result), m_DatabaseManager->LastQueryTime(),
+                        m_DatabaseManager->GetBackendPid(),
+                        m_DatabaseManager->LastQueryFailed()};
+    APP_DEBUG("QUERY RESPONSE - {}", Response.Summary());
+    return Response;
+  }
+
+  /**
+   * @brief adds an execution to QueryStats and the query metrics, what
+   * every statement of the managers and of AsyncDatabase ends with.
+   * @param TableName
+   * @param Query
+   * @param Elapsed
+   * @param Failed
+   */
+  static void RecordQuery(std::string_view TableName, std::string_view Query,
+                          std::chrono::nanoseconds Elapsed, bool Failed);
+
 private:
+  /**
+   * @brief times a query into QueryStats when it goes out of scope, failed if
+   * the connection says so or an exception left the query.
+   */
+  class QueryTimer {
+  public:
+    QueryTimer(const DatabaseManager &Manager, std::string_view TableName,
+               std::string_view Query)
+        : m_Manager(Manager), m_TableName(TableName), m_Query(Query),
+          m_Begin(std::chrono::steady_clock::now()) {}
+    ~QueryTimer();
+
+    QueryTimer(const QueryTimer &) = delete;
+    QueryTimer &operator=(const QueryTimer &) = delete;
+
+    /**
+     * @brief sampled for a plan, the parameters have to be kept.
+     */
+    [[nodiscard]] bool IsSampled() const { return m_Sampled; }
+    template <typename... Args> void KeepParams(const Args &...args) {
+      (m_Params.append(args), ...);
+    }
+
+  private:
+    const DatabaseManager &m_Manager;
+    std::string_view m_TableName;
+    std::string_view m_Query;
+    std::chrono::steady_clock::time_point m_Begin;
+    bool m_Sampled = QueryPlans::ShouldSample();
+    pqxx::params m_Params;
+  };
+
   /**
    * @brief private database CRD related methods, they connect only with the
    * model editor above and in DatabaseModel.
@@ -208,19 +333,45 @@ private:
   template <typename... Args>
   pqxx::result MCrQuery(const std::string &TableName, const std::string &Query,
                         Args &&...args) {
+    QueryTimer Timer{*this, TableName, Query};
+    if (Timer.IsSampled()) {
+      Timer.KeepParams(args...);
+    }
     try {
       pqxx::result Response =
           m_DatabaseManager->CrQuery(Query, std::forward<Args>(args)...);
       return Response;
     } catch (pqxx::sql_error const &e) {
-      APP_ERROR("MCRQUERY(PF) ERROR AT TABLE - " + TableName + " " +
-                std::string(e.what()));
+      APP_ERROR("MCRQUERY(PF) ERROR AT TABLE - {} {}", TableName, e.what());
       return {};
     } catch (std::exception const &e) {
-      APP_ERROR("MCRQUERY(PF) GENERAL ERROR - " + std::string(e.what()));
+      APP_ERROR("MCRQUERY(PF) GENERAL ERROR - {}", e.what());
       return {};
     }
   }
+  /**
+   * @brief MCrQuery for the reads, identical ones running at the same time
+   * share one execution (SingleFlight). a follower's connection takes the
+   * leader's failure and time as its last query's.
+   */
+  template <typename... Args>
+  pqxx::result MCrRead(const std::string &TableName, const std::string &Query,
+                       Args &&...args) {
+    if (!SingleFlight::IsEnabled()) {
+      return MCrQuery(TableName, Query, std::forward<Args>(args)...);
+    }
+    auto Shared =
+        SingleFlight::Run(SingleFlight::MakeKey(Query, args...), [&] {
+          SingleFlight::Outcome Current;
+          Current.Result =
+              MCrQuery(TableName, Query, std::forward<Args>(args)...);
+          Current.Failed = m_DatabaseManager->LastQueryFailed();
+          Current.Elapsed = m_DatabaseManager->LastQueryTime();
+          return Current;
+        });
+    m_DatabaseManager->SetLastQuery(Shared.Failed, Shared.Elapsed);
+    return std::move(Shared.Result);
+  }
   pqxx::result MWQuery(const std::string &TableName, const std::string &Query);
   pqxx::result CreateTable(const std::string &TableName,
                            const StringUnMap &TableFields);
@@ -228,17 +379,12 @@ private:
   template <typename T>
   pqxx::result GetTableData(const std::string &TableName,
                             const std::string &TableFieldName, T &&arg) {
-    std::string query;
-    query.append(DatabaseCommandToString(DatabaseQueryCommands::SelectAll))
-        .append(TableName)
-        .append(" where ")
-        .append(TableFieldName)
-        .append("=$1");
+    const auto query = DatabaseQueries::SelectWhere(TableName, TableFieldName);
     try {
-      return MCrQuery(TableName, query, std::forward<T>(arg));
+      return MCrRead(TableName, query, std::forward<T>(arg));
     } catch (const std::exception &e) {
-      APP_ERROR("ERROR AT GETTABLEDATA2 FUNCTION - " + TableName + " - " +
-                std::string(e.what()));
+      APP_ERROR("ERROR AT GETTABLEDATA2 FUNCTION - {} - {}", TableName,
+                e.what());
       return {};
     }
   }
@@ -247,20 +393,13 @@ private:
                             const std::string &FirstTableFieldName,
                             const std::string &SecondTableFieldName,
                             Args &&...args) {
-    std::string query;
-    query.append(DatabaseCommandToString(DatabaseQueryCommands::SelectAll))
-        .append(TableName)
-        .append(" where ")
-        .append(FirstTableFieldName)
-        .append("=$1")
-        .append(" and ")
-        .append(SecondTableFieldName)
-        .append("=$2");
+    const auto query = DatabaseQueries::SelectWhere(
+        TableName, FirstTableFieldName, SecondTableFieldName);
     try {
-      return MCrQuery(TableName, query, std::forward<Args>(args)...);
+      return MCrRead(TableName, query, std::forward<Args>(args)...);
     } catch (const std::exception &e) {
-      APP_ERROR("ERROR AT GETTABLEDATA3 FUNCTION - " + TableName + " - " +
-                std::string(e.what()));
+      APP_ERROR("ERROR AT GETTABLEDATA3 FUNCTION - {} - {}", TableName,
+                e.what());
       return {};
     }
   }
@@ -1,11 +1,72 @@
 #ifndef DATABASEPOOL_H
 #define DATABASEPOOL_H
 
+#include "../Core/Metrics/Metrics.h"
 #include "../Models/Model.h"
 #include "DatabaseManager.h"
 
+#include <array>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <functional>
+#include <optional>
 #include <queue>
+#include <string_view>
+
+/**
+ * @brief the checkout lanes, a returned connection goes to the first lane
+ * with a waiter, in this order.
+ */
+enum class CheckoutPriority : std::uint8_t {
+  /** @brief reads a user is waiting on. */
+  Interactive,
+  Write,
+  /** @brief logging and maintenance. */
+  Background,
+  Count,
+};
+
+enum class CheckoutError : std::uint8_t {
+  /** @brief too many waiters ahead, shed without waiting. */
+  QueueFull,
+  /** @brief the deadline passed before a connection came back. */
+  Timeout,
+};
+
+constexpr std::string_view CheckoutErrorToString(CheckoutError Error) {
+  switch (Error) {
+  case CheckoutError::QueueFull:
+    return "Checkout Queue Full";
+  case CheckoutError::Timeout:
+    return "Checkout Timed Out";
+  }
+  return "Unknown Checkout Error";
+}
+
+struct CheckoutLimits {
+  /**
+   * @brief the waiters served before a new one, of its lane and the lanes
+   * ahead of it, from which it's shed at once.
+   */
+  size_t MaxQueued;
+  /** @brief the longest a checkout waits, an earlier deadline wins. */
+  std::chrono::milliseconds MaxWait;
+};
+
+/**
+ * @brief checkout admission settings, the "POOL" section of config.json.
+ * @details the lower lanes count the waiters ahead of them too, so they're
+ * shed first as the queue grows.
+ */
+struct CheckoutOptions {
+  std::array<CheckoutLimits, static_cast<size_t>(CheckoutPriority::Count)>
+      Lanes{{{64, std::chrono::milliseconds(250)},
+             {128, std::chrono::milliseconds(2000)},
+             {256, std::chrono::milliseconds(10000)}}};
+};
 
 /**
  * @class DatabasePool
@@ -14,12 +75,22 @@
  */
 
 class DatabasePool {
+public:
+  static constexpr int DefaultPoolSize = 10;
+  static constexpr size_t Lanes = static_cast<size_t>(CheckoutPriority::Count);
+
+  using Checkout = std::expected<SharedManager, CheckoutError>;
+
 public:
   /**
    * @brief Construct a new Database Pool object
    * @param DatabaseConnectionString
+   * @param PoolSize the connections opened up front, at least one.
+   * @param Options the checkout lanes' limits.
    */
-  DatabasePool(std::string &&DatabaseConnectionString);
+  DatabasePool(std::string &&DatabaseConnectionString,
+               int PoolSize = DefaultPoolSize,
+               const CheckoutOptions &Options = {});
   ~DatabasePool();
 
   /**
@@ -29,10 +100,41 @@ public:
   void InitModels();
 
   /**
-   * @brief Get the Manager Connection object
+   * @brief Get the Manager Connection object, waits as long as it takes in
+   * its lane and is never shed.
+   * @param Priority
    * @return SharedManager
    */
-  [[nodiscard]] SharedManager GetManagerConnection();
+  [[nodiscard]] SharedManager
+  GetManagerConnection(CheckoutPriority Priority = CheckoutPriority::Write);
+  /**
+   * @brief checks out a connection within the lane's limits, waiting up to
+   * its MaxWait.
+   * @param Priority
+   * @return Checkout the connection, QueueFull when shed or Timeout.
+   */
+  [[nodiscard]] Checkout CheckoutConnection(CheckoutPriority Priority);
+  /**
+   * @brief CheckoutConnection that gives up at Deadline, or the lane's
+   * MaxWait if sooner. a passed deadline only takes a free connection.
+   * @param Priority
+   * @param Deadline
+   * @return Checkout
+   */
+  [[nodiscard]] Checkout
+  CheckoutConnection(CheckoutPriority Priority,
+                     std::chrono::steady_clock::time_point Deadline);
+  /**
+   * @brief borrows without waiting, Ready gets a connection at once when
+   * one is free, else the next one returned on the returning thread. Ready
+   * must not block and the connection has to be given back.
+   * @details queued in the lane, before the threads blocked in it. never
+   * shed, the scheduler's jobs are parked here.
+   * @param Ready
+   * @param Priority
+   */
+  void Borrow(std::move_only_function<void(SharedManager)> &&Ready,
+              CheckoutPriority Priority = CheckoutPriority::Write);
   /**
    * @brief return the connection
    * @param Connection
@@ -70,6 +172,12 @@ public:
    * @return int
    */
   [[nodiscard]] int GetCurrentPoolSize();
+  /**
+   * @brief the checkouts and borrowers waiting in a lane.
+   * @param Priority
+   * @return size_t
+   */
+  [[nodiscard]] size_t GetWaitingCount(CheckoutPriority Priority);
   /**
    * @brief Get the Connection String object
    * @return const std::string&
@@ -88,16 +196,65 @@ public:
    */
   std::string SingularConsumption(SharedManager &Connection);
 
+private:
+  /**
+   * @brief a thread blocked in a lane, on its stack. ReturnConnection hands
+   * it the connection under m_PoolMutex.
+   */
+  struct Waiter {
+    std::condition_variable Ready;
+    SharedManager Connection;
+    bool Served = false;
+  };
+
+  /**
+   * @brief takes a free connection or waits in the lane, without a deadline
+   * nor shedding when none is given.
+   */
+  Checkout Acquire(CheckoutPriority Priority,
+                   std::optional<std::chrono::steady_clock::time_point>
+                       Deadline);
+  /**
+   * @brief the waiters a new one in Lane is served after, under
+   * m_PoolMutex.
+   */
+  [[nodiscard]] size_t GetQueuedAhead(size_t Lane) const;
+
 private:
   std::mutex m_PoolMutex;
   std::mutex m_StatsMutex;
-  std::condition_variable m_PoolConditionVariable;
 
 private:
-  const int m_DatabasePoolSize{10};
+  const int m_DatabasePoolSize;
   Model::Schemes m_ModelSchemes;
   std::string m_DatabaseString;
+  CheckoutOptions m_Options;
   std::queue<SharedManager> m_DatabasePool;
+  /**
+   * @brief per lane, Borrow's callers and the blocked threads waiting for a
+   * connection, under m_PoolMutex. the pool only keeps a free connection
+   * when they're all empty.
+   */
+  std::array<std::deque<std::move_only_function<void(SharedManager)>>, Lanes>
+      m_Borrowers;
+  std::array<std::deque<Waiter *>, Lanes> m_Waiters;
+  size_t m_ConnectionCount{0};
+
+private:
+  /** @brief process wide, every pool adds to the same metrics. */
+  Gauge &m_ConnectionsGauge = Metrics::GetGauge(
+      "liveview_pool_connections", "Connections held by the database pools.");
+  Gauge &m_AvailableGauge =
+      Metrics::GetGauge("liveview_pool_available_connections",
+                        "Connections waiting in the pools to be borrowed.");
+  Counter &m_BorrowsCounter = Metrics::GetCounter(
+      "liveview_pool_borrows_total", "Connections borrowed from the pools.");
+  Counter &m_WaitsCounter =
+      Metrics::GetCounter("liveview_pool_waits_total",
+                          "Borrows that found the pool empty and waited.");
+  Histogram &m_WaitHistogram =
+      Metrics::GetHistogram("liveview_pool_wait_seconds",
+                            "Time a borrow waited for a connection.");
 };
 
 #endif
\ No newline at end of file
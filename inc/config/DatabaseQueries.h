@@ -0,0 +1,64 @@
+#ifndef DATABASE_QUERIES_H
+#define DATABASE_QUERIES_H
+
+#include "Database.h"
+#include "DatabaseCommands.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class DatabaseQueries
+ * @brief builds the statements of the row operations, DatabaseManager and
+ * AsyncDatabase run the same ones.
+ * @details the placeholders follow the order the fields are given in, for
+ * a StringUnMap its iteration order, the params are appended walking the
+ * same map.
+ */
+class DatabaseQueries {
+public:
+  [[nodiscard]] static std::string SelectAll(std::string_view TableName);
+  /**
+   * @brief "select * from TableName where FieldName=$1".
+   */
+  [[nodiscard]] static std::string SelectWhere(std::string_view TableName,
+                                               std::string_view FieldName);
+  /**
+   * @brief "... where FirstFieldName=$1 and SecondFieldName=$2".
+   */
+  [[nodiscard]] static std::string
+  SelectWhere(std::string_view TableName, std::string_view FirstFieldName,
+              std::string_view SecondFieldName);
+  /**
+   * @brief the field between $1 and $2, or $3 and $4..., anded with
+   * Condition when given.
+   */
+  [[nodiscard]] static std::string
+  SelectInRanges(std::string_view TableName, std::string_view FieldName,
+                 size_t RangeCount, std::string_view Condition);
+  [[nodiscard]] static std::string InsertInto(std::string_view TableName,
+                                              const StringUnMap &Fields);
+  [[nodiscard]] static std::string
+  InsertRows(std::string_view TableName,
+             const std::vector<std::string> &Columns, size_t RowCount);
+  /**
+   * @brief "update TableName set FieldName=$1 where Condition=$2".
+   */
+  [[nodiscard]] static std::string UpdateColumn(std::string_view TableName,
+                                                std::string_view FieldName,
+                                                std::string_view Condition);
+  /**
+   * @brief the fields from $1 on, the condition's value last.
+   */
+  [[nodiscard]] static std::string UpdateColumns(std::string_view TableName,
+                                                 const StringUnMap &Fields,
+                                                 std::string_view Condition);
+  /**
+   * @brief "delete from TableName where Condition=$1".
+   */
+  [[nodiscard]] static std::string DeleteRecord(std::string_view TableName,
+                                                std::string_view Condition);
+};
+
+#endif
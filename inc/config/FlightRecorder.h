@@ -0,0 +1,223 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief what was recorded, the id stored with every event. new events go at
+ * the end, before Count, dumps keep their names so old files still decode.
+ */
+enum class FlightEvent : uint16_t {
+  Mark,
+  LogError,
+  Crash,
+  QueryBegin,
+  QueryEnd,
+  QueryError,
+  PoolAcquire,
+  PoolRelease,
+  Count,
+};
+
+/**
+ * @brief the name of an event and how its two arguments read, written into
+ * every dump for the decoder.
+ */
+struct FlightEventType {
+  std::array<char, 24> Name;
+  std::array<char, 40> Format;
+};
+
+constexpr std::array<FlightEventType,
+                     static_cast<size_t>(FlightEvent::Count)>
+    FlightEventTypes{{
+        {"MARK", "arg0={} arg1={}"},
+        {"LOG ERROR", "level={}"},
+        {"CRASH", "signal={}"},
+        {"QUERY BEGIN", "query={:x}"},
+        {"QUERY END", "query={:x} duration_ns={}"},
+        {"QUERY ERROR", "query={:x}"},
+        {"POOL ACQUIRE", "wait_ns={} available={}"},
+        {"POOL RELEASE", "available={}"},
+    }};
+
+/**
+ * @brief why a dump was written, stored in its header.
+ */
+enum class FlightDumpReason : uint32_t { Manual, Error, Crash };
+
+/**
+ * @brief flight recorder settings, filled by Logger::Init from its options.
+ */
+struct FlightRecorderOptions {
+  /**
+   * @brief directory of the error and crash dumps, like LoggerOptions::Path.
+   */
+  std::string Path;
+  bool DumpOnCrash = true;
+  bool DumpOnError = true;
+  /**
+   * @brief an error storm writes one dump per interval, not one per error.
+   */
+  std::chrono::seconds ErrorDumpInterval{10};
+};
+
+/**
+ * @class FlightRecorder
+ * @brief the last few thousand events of every thread kept in memory, for
+ * post mortem tracing where flushing log lines would be too slow to leave on.
+ * @details each thread writes compact binary events (a timestamp, an id and
+ * two integer arguments) into its own ring, no locks and no formatting, the
+ * oldest events are overwritten. a slot is guarded by a sequence word (a
+ * seqlock with one writer), so a dump can read the rings while threads keep
+ * recording and skips the slots torn under it. dumps are written on demand,
+ * on errors logged through Logger, and from the crash signal handlers, the
+ * dump path only uses async signal safe calls. tools/FlightDecoder turns a
+ * dump into text.
+ */
+class FlightRecorder {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /** @brief events kept per thread, a power of two. */
+  static constexpr size_t Capacity = 4096;
+  static constexpr size_t MaxThreads = 256;
+
+  /**
+   * @brief the dump file layout, a FileHeader, FileHeader::EventTypes
+   * FlightEventType entries, then per thread a ThreadHeader followed by
+   * ThreadHeader::Count events.
+   */
+  struct FileHeader {
+    std::array<char, 8> Magic;
+    uint32_t Version;
+    uint32_t EventTypes;
+    /** @brief the clocks when the dump was written, to place the events. */
+    int64_t SteadyNs;
+    int64_t SystemNs;
+    uint32_t ProcessId;
+    FlightDumpReason Reason;
+    uint32_t Signal;
+    uint32_t ThreadCount;
+  };
+
+  struct ThreadHeader {
+    uint32_t ThreadId;
+    uint32_t Count;
+  };
+
+  struct Event {
+    int64_t Timestamp;
+    uint16_t Id;
+    /** @brief set on slots that were being written during the dump. */
+    uint16_t Torn;
+    uint32_t Reserved;
+    uint64_t Args[2];
+  };
+
+  static constexpr std::array<char, 8> Magic{'L', 'V', 'F', 'L',
+                                             'I', 'G', 'H', 'T'};
+  static constexpr uint32_t Version = 1;
+
+public:
+  /**
+   * @brief sets where dumps go and installs the crash handlers, recording
+   * works without it.
+   * @param Options
+   */
+  static void Init(const FlightRecorderOptions &Options);
+
+  /**
+   * @brief records an event in the calling thread's ring.
+   * @param Id
+   * @param Arg0
+   * @param Arg1
+   * @return int64_t, the event's timestamp, lets callers time spans without
+   * reading the clock again.
+   */
+  static int64_t Record(FlightEvent Id, uint64_t Arg0 = 0, uint64_t Arg1 = 0) {
+    const int64_t Timestamp = Now();
+    Ring *Current = t_Ring != nullptr ? t_Ring : AttachThread();
+    if (Current == nullptr) {
+      return Timestamp;
+    }
+    const uint64_t Index = Current->Head.load(std::memory_order_relaxed);
+    Current->Head.store(Index + 1, std::memory_order_relaxed);
+    Slot &Target = Current->Slots[Index & (Capacity - 1)];
+
+    /** @brief zero marks the slot as being written, readers skip it. */
+    Target.Sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Target.Timestamp.store(Timestamp, std::memory_order_relaxed);
+    Target.Args[0].store(Arg0, std::memory_order_relaxed);
+    Target.Args[1].store(Arg1, std::memory_order_relaxed);
+    Target.Sequence.store(((Index + 1) << 16) | static_cast<uint16_t>(Id),
+                          std::memory_order_release);
+    return Timestamp;
+  }
+
+  /**
+   * @brief writes every thread's events to a file, async signal safe.
+   * @param Path
+   * @param Reason
+   * @param Signal
+   * @return true, false if the file couldn't be written.
+   */
+  static bool Dump(const char *Path,
+                   FlightDumpReason Reason = FlightDumpReason::Manual,
+                   int Signal = 0);
+  static bool Dump(const std::string &Path) { return Dump(Path.c_str()); }
+
+  /**
+   * @brief writes the error dump of the Init directory, at most once per
+   * ErrorDumpInterval.
+   * @return true if a dump was written.
+   */
+  static bool DumpOnError();
+
+  static int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now().time_since_epoch())
+        .count();
+  }
+
+private:
+  struct Slot {
+    /** @brief (index + 1) << 16 | event id once written, 0 while writing. */
+    std::atomic<uint64_t> Sequence{0};
+    std::atomic<int64_t> Timestamp{0};
+    std::atomic<uint64_t> Args[2]{};
+  };
+
+  struct alignas(64) Ring {
+    /** @brief events written so far, only the owning thread stores it. */
+    std::atomic<uint64_t> Head{0};
+    std::atomic<uint32_t> ThreadId{0};
+    /** @brief the thread exited, another one may take the ring over. */
+    std::atomic<bool> Retired{false};
+    Slot Slots[Capacity];
+  };
+
+  /**
+   * @brief the first event of a thread, claims a ring.
+   * @return Ring*, null when every ring is taken by a live thread.
+   */
+  static Ring *AttachThread();
+  static void DetachThread();
+  static void OnCrash(int Signal);
+
+private:
+  static inline thread_local Ring *t_Ring = nullptr;
+  static std::array<std::atomic<Ring *>, MaxThreads> s_Rings;
+};
+
+static_assert(sizeof(FlightRecorder::FileHeader) == 48);
+static_assert(sizeof(FlightRecorder::Event) == 32);
+static_assert(sizeof(FlightEventType) == 64);
+
+#endif
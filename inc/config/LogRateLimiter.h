@@ -0,0 +1,88 @@
+#ifndef LOG_RATE_LIMITER_H
+#define LOG_RATE_LIMITER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @class LogRateLimiter
+ * @brief token bucket for one log call site, keeps message storms out of the
+ * log files.
+ * @details the bucket holds Burst messages and refills at PerSecond. it is
+ * kept as the time the bucket will be full again (the GCRA form of a token
+ * bucket), so Allow is a single compare and swap and never locks. what gets
+ * suppressed is counted, reported by a summary line at most every
+ * SummaryInterval, and per key (the format string) totals are kept for
+ * metrics instead of log lines.
+ */
+class LogRateLimiter {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr double DefaultPerSecond = 10;
+  static constexpr double DefaultBurst = 20;
+  static constexpr std::chrono::seconds SummaryInterval{10};
+
+  struct Summary {
+    uint64_t Suppressed;
+    std::chrono::seconds Period;
+  };
+
+  struct Counters {
+    std::string Key;
+    uint64_t Emitted;
+    uint64_t Suppressed;
+  };
+
+public:
+  LogRateLimiter(std::string Key, double PerSecond = DefaultPerSecond,
+                 double Burst = DefaultBurst);
+  ~LogRateLimiter();
+
+  LogRateLimiter(const LogRateLimiter &) = delete;
+  LogRateLimiter &operator=(const LogRateLimiter &) = delete;
+
+  /**
+   * @brief takes a token.
+   * @param Now
+   * @return true when the message may be logged, false when it is suppressed.
+   */
+  bool Allow(Clock::time_point Now = Clock::now());
+
+  /**
+   * @brief the messages suppressed since the last summary, once every
+   * SummaryInterval. one caller gets it when several race.
+   * @param Now
+   * @return std::optional<Summary>
+   */
+  std::optional<Summary> TakeSummary(Clock::time_point Now = Clock::now());
+
+  [[nodiscard]] const std::string &GetKey() const { return m_Key; }
+  [[nodiscard]] Counters GetCounters() const;
+
+  /**
+   * @brief the counters of every live call site.
+   * @return std::vector<Counters>
+   */
+  [[nodiscard]] static std::vector<Counters> GetAllCounters();
+
+private:
+  static int64_t Nanoseconds(Clock::time_point Time);
+
+private:
+  std::string m_Key;
+  int64_t m_IntervalNs;
+  int64_t m_BurstNs;
+  /** @brief when the bucket is full again, ns since the clock epoch. */
+  std::atomic<int64_t> m_FullAt{0};
+  std::atomic<int64_t> m_LastSummary;
+  std::atomic<uint64_t> m_Pending{0};
+  std::atomic<uint64_t> m_Emitted{0};
+  std::atomic<uint64_t> m_Suppressed{0};
+};
+
+#endif
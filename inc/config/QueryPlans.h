@@ -0,0 +1,196 @@
+#ifndef QUERY_PLANS_H
+#define QUERY_PLANS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <pqxx/pqxx>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief plan capture settings, the "QUERY_PLANS" section of config.json.
+ */
+struct QueryPlanOptions {
+  /**
+   * @brief statements at least this long get their plan captured, zero
+   * turns capturing off.
+   */
+  std::chrono::microseconds Threshold{0};
+  /**
+   * @brief the fraction of statements sampled, 0 to 1. only sampled ones
+   * keep a copy of their parameters to explain with.
+   */
+  double SampleRate = 0.1;
+  /**
+   * @brief fingerprints kept, the least recently captured goes first.
+   */
+  size_t MaxPlans = 128;
+  /**
+   * @brief captures waiting for the side connection, more are dropped.
+   */
+  size_t MaxPending = 16;
+  /**
+   * @brief a fingerprint's plan is captured again after this long at most.
+   */
+  std::chrono::seconds RecaptureInterval{60};
+  /**
+   * @brief the explain's statement_timeout, it runs the statement again.
+   */
+  std::chrono::milliseconds Timeout{10000};
+};
+
+/**
+ * @brief the last plan captured for one fingerprint.
+ */
+struct QueryPlan {
+  std::string Fingerprint;
+  std::string Table;
+  /** @brief the sampled execution that tripped the threshold. */
+  std::chrono::nanoseconds Elapsed{0};
+  /** @brief the explain's own "Execution Time", zero when not analyzed. */
+  std::chrono::nanoseconds ExecutionTime{0};
+  /** @brief explained with ANALYZE, only read-only statements are. */
+  bool Analyzed = false;
+  std::chrono::system_clock::time_point Captured;
+  uint64_t Captures = 0;
+  /** @brief the relations the plan scans sequentially. */
+  std::vector<std::string> SeqScans;
+  /** @brief EXPLAIN (ANALYZE, BUFFERS, FORMAT JSON) output. */
+  std::string Plan;
+};
+
+/**
+ * @class QueryPlans
+ * @brief captures the plans of sampled slow statements, kept in memory by
+ * fingerprint.
+ * @details DatabaseManager asks ShouldSample before a statement and keeps a
+ * copy of its parameters when told to, if the statement then takes at
+ * least the threshold it's handed to Submit. one thread explains the
+ * submitted statements on its own connection, inside a read-only
+ * transaction it rolls back. only read-only statements are explained with
+ * ANALYZE, run again. an insert, update or delete is only planned, running
+ * it again would hit its unique keys, lock live rows and advance its
+ * sequences. ddl isn't explained. a plan with a sequential
+ * scan is logged with the relation. a static class like QueryStats.
+ */
+class QueryPlans {
+public:
+  /**
+   * @brief applies the options and starts the capturing thread when the
+   * threshold is set.
+   * @param Options
+   */
+  static void Init(const QueryPlanOptions &Options);
+  /**
+   * @brief stops the capturing thread, pending captures are dropped. the
+   * plans stay queryable.
+   */
+  static void Shutdown();
+
+  /**
+   * @brief whether the statement about to run is sampled, a relaxed load
+   * when capturing is off.
+   * @return bool
+   */
+  [[nodiscard]] static bool ShouldSample();
+  [[nodiscard]] static std::chrono::microseconds GetThreshold() {
+    return std::chrono::microseconds(
+        s_ThresholdUs.load(std::memory_order_relaxed));
+  }
+
+  /**
+   * @brief queues a sampled statement that took at least the threshold.
+   * @param ConnectionString the database the statement ran on.
+   * @param Table
+   * @param Query
+   * @param Params the statement's parameters.
+   * @param Elapsed
+   */
+  static void Submit(std::string ConnectionString, std::string_view Table,
+                     std::string_view Query, pqxx::params &&Params,
+                     std::chrono::nanoseconds Elapsed);
+
+  /**
+   * @brief waits until the captures queued before the call are done.
+   */
+  static void Flush();
+
+  /**
+   * @brief every captured plan, the latest first.
+   * @return std::vector<QueryPlan>
+   */
+  [[nodiscard]] static std::vector<QueryPlan> Snapshot();
+  /**
+   * @brief the plan captured for a fingerprint, see QueryStats::Fingerprint.
+   * @param Fingerprint
+   * @return std::optional<QueryPlan>
+   */
+  [[nodiscard]] static std::optional<QueryPlan>
+  Find(std::string_view Fingerprint);
+  /**
+   * @brief one line per plan, its fingerprint, times and sequential scans.
+   * @return std::string
+   */
+  [[nodiscard]] static std::string Report();
+  static void Reset();
+
+  /**
+   * @brief the relations a json plan scans sequentially, in plan order.
+   * @param Plan
+   * @return std::vector<std::string>
+   */
+  [[nodiscard]] static std::vector<std::string>
+  ParseSeqScans(std::string_view Plan);
+  /**
+   * @brief whether a statement only reads, a select, values or a with that
+   * has no insert, update, delete or merge in it.
+   * @param Query
+   * @return bool
+   */
+  [[nodiscard]] static bool IsReadOnly(std::string_view Query);
+
+private:
+  struct Request {
+    std::string ConnectionString;
+    std::string Fingerprint;
+    std::string Table;
+    std::string Query;
+    pqxx::params Params;
+    std::chrono::nanoseconds Elapsed;
+  };
+
+  static void Run();
+  /**
+   * @brief explains on Connection, opened again when the request is for
+   * another database.
+   */
+  static void Capture(Request &Current,
+                      std::unique_ptr<pqxx::connection> &Connection,
+                      std::string &ConnectedTo);
+  static void Store(QueryPlan &&Plan);
+
+private:
+  static std::atomic<int64_t> s_ThresholdUs;
+  static std::atomic<double> s_SampleRate;
+  static QueryPlanOptions s_Options;
+
+  static std::mutex s_Mutex;
+  static std::condition_variable s_Wakeup;
+  static std::condition_variable s_Idle;
+  static std::deque<Request> s_Pending;
+  static bool s_Capturing;
+  static bool s_Running;
+  static std::thread s_Thread;
+  static std::unordered_map<std::string, QueryPlan> s_Plans;
+};
+
+#endif
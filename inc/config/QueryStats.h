@@ -0,0 +1,116 @@
+#ifndef QUERY_STATS_H
+#define QUERY_STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief the aggregated executions of one statement shape.
+ * @details Buckets is a latency histogram, bucket i counts the executions
+ * under 2^i microseconds, the last one everything slower.
+ */
+struct QueryStatsEntry {
+  static constexpr size_t BucketCount = 26;
+
+  std::string Fingerprint;
+  std::string Table;
+  uint64_t Count = 0;
+  uint64_t Errors = 0;
+  uint64_t Slow = 0;
+  std::chrono::nanoseconds Total{0};
+  std::chrono::nanoseconds Max{0};
+  std::array<uint64_t, BucketCount> Buckets{};
+
+  [[nodiscard]] std::chrono::nanoseconds Mean() const {
+    return Count == 0 ? std::chrono::nanoseconds(0)
+                      : Total / static_cast<int64_t>(Count);
+  }
+  /**
+   * @brief the latency Percentile percent of the executions finish under, the
+   * upper bound of its histogram bucket (at most Max).
+   * @param Percentile 0 to 100.
+   * @return std::chrono::nanoseconds
+   */
+  [[nodiscard]] std::chrono::nanoseconds Quantile(double Percentile) const;
+};
+
+/**
+ * @class QueryStats
+ * @brief times every statement DatabaseManager executes, grouped by
+ * fingerprint.
+ * @details the fingerprint is the statement with its literals and
+ * placeholders replaced by ?, lowercased and with whitespace collapsed, so
+ * the executions of one operation over the same table and columns share it
+ * whatever their parameters. statements at or over the slow query threshold
+ * are written to the slow query log as their fingerprint, parameters never
+ * reach it. a static class like Logger, every connection of the pool feeds
+ * the same stats.
+ */
+class QueryStats {
+public:
+  /**
+   * @brief fingerprints kept, later new shapes are counted under one
+   * "other" entry so generated statements can't grow the map unbounded.
+   */
+  static constexpr size_t MaxFingerprints = 1024;
+  static constexpr std::string_view OtherFingerprint = "other";
+
+public:
+  /**
+   * @brief adds an execution.
+   * @param Table
+   * @param Query the executed statement.
+   * @param Elapsed
+   * @param Failed
+   */
+  static void Record(std::string_view Table, std::string_view Query,
+                     std::chrono::nanoseconds Elapsed, bool Failed);
+
+  /**
+   * @brief every fingerprint's aggregate, slowest in total first.
+   * @return std::vector<QueryStatsEntry>
+   */
+  [[nodiscard]] static std::vector<QueryStatsEntry> Snapshot();
+  /**
+   * @brief one line per fingerprint, count, errors and latencies.
+   * @return std::string
+   */
+  [[nodiscard]] static std::string Report();
+  static void Reset();
+
+  /**
+   * @brief statements at least this long go to the slow query log, zero
+   * turns it off.
+   * @param Threshold
+   */
+  static void SetSlowQueryThreshold(std::chrono::milliseconds Threshold);
+  [[nodiscard]] static std::chrono::milliseconds GetSlowQueryThreshold();
+
+  /**
+   * @brief the statement with literals, $n placeholders and numbers replaced
+   * by ?, lowercased, whitespace collapsed.
+   * @param Query
+   * @return std::string
+   */
+  [[nodiscard]] static std::string Fingerprint(std::string_view Query);
+
+  /**
+   * @brief exports the per fingerprint counts through Metrics, read when the
+   * metrics are rendered.
+   */
+  static void RegisterMetrics();
+
+private:
+  static std::mutex s_Mutex;
+  static std::unordered_map<std::string, QueryStatsEntry> s_Entries;
+  static std::atomic<int64_t> s_SlowQueryThresholdMs;
+};
+
+#endif
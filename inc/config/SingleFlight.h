@@ -0,0 +1,173 @@
+#ifndef SINGLE_FLIGHT_H
+#define SINGLE_FLIGHT_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <pqxx/pqxx>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+/**
+ * @brief read coalescing settings, the "SINGLE_FLIGHT" section of
+ * config.json.
+ */
+struct SingleFlightOptions {
+  /** @brief off, every read runs its own statement. */
+  bool Enabled = true;
+};
+
+/**
+ * @class SingleFlight
+ * @brief identical reads running at the same time share one execution, the
+ * first caller (the leader) runs the statement and the others with the same
+ * key wait for its result instead of running it again.
+ * @details a flight only lives while its statement runs, nothing is cached
+ * after it lands. every statement that isn't a select bumps an epoch when it
+ * completes (DatabaseManager's RecordQuery) and a read only joins a flight
+ * started in the current epoch, so a read that follows a write never gets a
+ * result from before it. the keys are the statement and its parameters, the
+ * process talks to one database. a static class like QueryStats.
+ */
+class SingleFlight {
+public:
+  /**
+   * @brief what the leader's statement left on its connection, copied to
+   * the followers' ones. pqxx::result is shared, copying it doesn't copy
+   * the rows.
+   */
+  struct Outcome {
+    pqxx::result Result;
+    bool Failed = true;
+    std::chrono::nanoseconds Elapsed{0};
+  };
+
+public:
+  static void Init(const SingleFlightOptions &Options);
+  [[nodiscard]] static bool IsEnabled() {
+    return s_Enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief the statement and its parameters, each one length prefixed so
+   * ("ab", "c") and ("a", "bc") differ.
+   * @tparam Args strings, numbers, or what pqxx::to_string takes.
+   * @param Query
+   * @param args
+   * @return std::string
+   */
+  template <typename... Args>
+  [[nodiscard]] static std::string MakeKey(std::string_view Query,
+                                           const Args &...args) {
+    std::string Key;
+    AppendKey(Key, Query);
+    (AppendKey(Key, ToKeyPart(args)), ...);
+    return Key;
+  }
+
+  /**
+   * @brief runs Execute, or waits for the flight with the same key that is
+   * already running in this epoch and returns its outcome.
+   * @tparam Func returns Outcome, an exception fails the followers and is
+   * rethrown to the leader alone.
+   * @param Key see MakeKey.
+   * @param Execute
+   * @return Outcome
+   */
+  template <typename Func>
+  static Outcome Run(const std::string &Key, Func &&Execute) {
+    if (!IsEnabled()) {
+      return Execute();
+    }
+    bool Leader = false;
+    auto Current = Join(Key, Leader);
+    if (!Leader) {
+      return Wait(*Current);
+    }
+    Outcome Result;
+    try {
+      Result = Execute();
+    } catch (...) {
+      Land(Key, Current, {});
+      throw;
+    }
+    Land(Key, Current, Result);
+    return Result;
+  }
+
+  /**
+   * @brief a write completed, the flights running now don't take new
+   * followers.
+   */
+  static void Invalidate() { s_Epoch.fetch_add(1, std::memory_order_acq_rel); }
+
+  /** @brief reads served by another caller's execution. */
+  [[nodiscard]] static uint64_t GetCoalesced();
+  /** @brief reads that ran their statement, as leaders. */
+  [[nodiscard]] static uint64_t GetExecuted();
+  /** @brief flights running now. */
+  [[nodiscard]] static size_t GetInFlight();
+
+private:
+  struct Flight {
+    explicit Flight(uint64_t Epoch) : Epoch(Epoch) {}
+
+    const uint64_t Epoch;
+    std::mutex Mutex;
+    std::condition_variable Landed;
+    bool Done = false;
+    Outcome Result;
+  };
+
+  /** @brief keys are spread over shards, each one with its own lock. */
+  struct Shard {
+    std::mutex Mutex;
+    std::unordered_map<std::string, std::shared_ptr<Flight>> Flights;
+  };
+
+  static constexpr size_t SHARDS = 16;
+
+  template <typename T> static decltype(auto) ToKeyPart(const T &Value) {
+    if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+      return std::string_view(Value);
+    } else if constexpr (std::is_same_v<T, bool>) {
+      return std::string_view(Value ? "t" : "f");
+    } else if constexpr (std::is_arithmetic_v<T>) {
+      return std::to_string(Value);
+    } else {
+      return pqxx::to_string(Value);
+    }
+  }
+  static void AppendKey(std::string &Key, std::string_view Part) {
+    Key.append(std::to_string(Part.size())).push_back(':');
+    Key.append(Part);
+  }
+
+  static Shard &GetShard(const std::string &Key);
+  /**
+   * @brief the key's flight of this epoch, Leader tells whether the caller
+   * started it.
+   */
+  static std::shared_ptr<Flight> Join(const std::string &Key, bool &Leader);
+  static Outcome Wait(Flight &Current);
+  /**
+   * @brief hands the outcome to the followers, the key is free for the next
+   * flight before they wake.
+   */
+  static void Land(const std::string &Key,
+                   const std::shared_ptr<Flight> &Current,
+                   const Outcome &Result);
+
+private:
+  static std::atomic<bool> s_Enabled;
+  static std::atomic<uint64_t> s_Epoch;
+  static std::array<Shard, SHARDS> s_Shards;
+};
+
+#endif
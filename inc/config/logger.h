@@ -1,11 +1,54 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include "FlightRecorder.h"
+#include "LogRateLimiter.h"
+
+#include <chrono>
 #include <memory>
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/spdlog.h>
 #include <string>
 
+/**
+ * @brief what an async logger does when its queue is full.
+ * @details Block waits for room on the caller's thread, Drop never waits and
+ * overwrites the oldest queued message, counted by Logger::GetDroppedCount.
+ */
+enum class LogOverflowPolicy { Block, Drop };
+
+/**
+ * @brief logger settings, the "LOGGING" section of config.json.
+ */
+struct LoggerOptions {
+  std::string Path;
+  /**
+   * @brief log calls only format and enqueue the message, a background pool
+   * writes them to the files.
+   */
+  bool Async = false;
+  size_t QueueSize = 8192;
+  size_t ThreadCount = 1;
+  LogOverflowPolicy Overflow = LogOverflowPolicy::Block;
+  /**
+   * @brief file writes are buffered and flushed every FlushInterval, and right
+   * away for messages at FlushLevel and above.
+   */
+  std::chrono::seconds FlushInterval{1};
+  spdlog::level::level_enum FlushLevel = spdlog::level::warn;
+  /**
+   * @brief the flight recorder dumps to Path on crash signals and on logged
+   * errors.
+   */
+  bool FlightDumps = true;
+  /**
+   * @brief statements at least this long are written to slow.log, zero turns
+   * it off. see QueryStats.
+   */
+  std::chrono::milliseconds SlowQueryThreshold{200};
+};
+
 /**
  * @class Logger
  * @brief A static class (singleton) for initializing and accessing application
@@ -15,50 +58,193 @@
 class Logger {
 public:
   /**
-   * @brief Initialize the logger with the given path.
+   * @brief Initialize the logger with the given path, synchronous and flushing
+   * every message.
    * @param path the directory path to store the log files, if empty, defaults
    * to "../backend-logs/".
    */
   static void Init(const std::string &path);
+  /**
+   * @brief Initialize the logger with the given options.
+   * @param Options
+   */
+  static void Init(const LoggerOptions &Options);
+  /**
+   * @brief flushes and stops the loggers, waits for the async queue to drain.
+   */
+  static void Shutdown();
+
   static std::shared_ptr<spdlog::logger> &GetAppLogger() { return s_AppLogger; }
   static std::shared_ptr<spdlog::logger> &GetSystemLogger() { return s_SystemLogger; }
+  /**
+   * @brief the slow query log, slow.log next to the others.
+   * @return std::shared_ptr<spdlog::logger>&
+   */
+  static std::shared_ptr<spdlog::logger> &GetSlowQueryLogger() {
+    return s_SlowQueryLogger;
+  }
+  /**
+   * @brief messages dropped by a full async queue, since Init.
+   * @return size_t
+   */
+  static size_t GetDroppedCount();
 
 private:
   static std::shared_ptr<spdlog::logger> s_AppLogger;
   static std::shared_ptr<spdlog::logger> s_SystemLogger;
+  static std::shared_ptr<spdlog::logger> s_SlowQueryLogger;
+  static std::shared_ptr<spdlog::details::thread_pool> s_ThreadPool;
 };
 
 /**
- * @brief Via CMakeLists.txt at root directory.
+ * @brief statements below this level are compiled out, the SPDLOG_LEVEL_*
+ * values (0 trace to 6 off). Via CMakeLists.txt at root directory.
+ */
+#ifndef LOG_ACTIVE_LEVEL
+#define LOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+/**
+ * @brief takes a format string and its arguments,
+ * APP_INFO("DATA INSERTED TO TABLE - {}", ModelName). the arguments are only
+ * evaluated and formatted when the logger's level lets the message through,
+ * a disabled statement costs a branch.
+ */
+#define LOGGER_CALL(LOGGER, LEVEL, ...)                                        \
+  do {                                                                         \
+    auto &CallLogger = (LOGGER);                                               \
+    if (CallLogger && CallLogger->should_log(LEVEL)) {                         \
+      CallLogger->log(LEVEL, __VA_ARGS__);                                     \
+    }                                                                          \
+  } while (0)
+
+/**
+ * @brief LOGGER_CALL behind a token bucket per call site, for messages that
+ * repeat on hot paths. suppressed messages are counted (see
+ * LogRateLimiter::GetAllCounters) and summed up in one line at most every
+ * LogRateLimiter::SummaryInterval.
  */
-#ifdef ENABLE_LOGGING
-#define APP_INFO(...) Logger::GetAppLogger()->info(__VA_ARGS__)
-#define APP_TRACE(...) Logger::GetAppLogger()->trace(__VA_ARGS__)
-#define APP_DEBUG(...) Logger::GetAppLogger()->debug(__VA_ARGS__)
-#define APP_ERROR(...) Logger::GetAppLogger()->error(__VA_ARGS__)
-#define APP_WARNING(...) Logger::GetAppLogger()->warn(__VA_ARGS__)
-#define APP_CRITICAL(...) Logger::GetAppLogger()->critical(__VA_ARGS__)
-
-#define SYSTEM_INFO(...) Logger::GetSystemLogger()->info(__VA_ARGS__)
-#define SYSTEM_TRACE(...) Logger::GetSystemLogger()->trace(__VA_ARGS__)
-#define SYSTEM_DEBUG(...) Logger::GetSystemLogger()->debug(__VA_ARGS__)
-#define SYSTEM_ERROR(...) Logger::GetSystemLogger()->error(__VA_ARGS__)
-#define SYSTEM_WARNING(...) Logger::GetSystemLogger()->warn(__VA_ARGS__)
-#define SYSTEM_CRITICAL(...) Logger::GetSystemLogger()->critical(__VA_ARGS__)
+#define LOGGER_CALL_LIMITED(LOGGER, LEVEL, FORMAT, ...)                        \
+  do {                                                                         \
+    auto &CallLogger = (LOGGER);                                               \
+    if (CallLogger && CallLogger->should_log(LEVEL)) {                         \
+      static LogRateLimiter CallLimiter(FORMAT);                               \
+      if (CallLimiter.Allow()) {                                               \
+        if (auto Summary = CallLimiter.TakeSummary()) {                        \
+          CallLogger->log(LEVEL,                                               \
+                          "SUPPRESSED {} SIMILAR MESSAGES IN LAST {}s - {}",   \
+                          Summary->Suppressed, Summary->Period.count(),        \
+                          FORMAT);                                             \
+        }                                                                      \
+        CallLogger->log(LEVEL, FORMAT __VA_OPT__(, ) __VA_ARGS__);             \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+/**
+ * @brief ENABLE_LOGGING via CMakeLists.txt at root directory.
+ */
+#if defined(ENABLE_LOGGING) && LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define APP_TRACE(...)                                                         \
+  LOGGER_CALL(Logger::GetAppLogger(), spdlog::level::trace, __VA_ARGS__)
+#define SYSTEM_TRACE(...)                                                      \
+  LOGGER_CALL(Logger::GetSystemLogger(), spdlog::level::trace, __VA_ARGS__)
+#define APP_TRACE_LIMITED(...)                                                 \
+  LOGGER_CALL_LIMITED(Logger::GetAppLogger(), spdlog::level::trace, __VA_ARGS__)
+#define SYSTEM_TRACE_LIMITED(...)                                              \
+  LOGGER_CALL_LIMITED(Logger::GetSystemLogger(), spdlog::level::trace,         \
+                      __VA_ARGS__)
+#else
+#define APP_TRACE(...) (void)0
+#define SYSTEM_TRACE(...) (void)0
+#define APP_TRACE_LIMITED(...) (void)0
+#define SYSTEM_TRACE_LIMITED(...) (void)0
+#endif
+
+#if defined(ENABLE_LOGGING) && LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define APP_DEBUG(...)                                                         \
+  LOGGER_CALL(Logger::GetAppLogger(), spdlog::level::debug, __VA_ARGS__)
+#define SYSTEM_DEBUG(...)                                                      \
+  LOGGER_CALL(Logger::GetSystemLogger(), spdlog::level::debug, __VA_ARGS__)
+#define APP_DEBUG_LIMITED(...)                                                 \
+  LOGGER_CALL_LIMITED(Logger::GetAppLogger(), spdlog::level::debug, __VA_ARGS__)
+#define SYSTEM_DEBUG_LIMITED(...)                                              \
+  LOGGER_CALL_LIMITED(Logger::GetSystemLogger(), spdlog::level::debug,         \
+                      __VA_ARGS__)
 #else
-#define APP_INFO(...) (void)0
-#define APP_TRACE(...) (void)0 
 #define APP_DEBUG(...) (void)0
-#define APP_ERROR(...) (void)0
-#define APP_WARNING(...) (void)0
-#define APP_CRITICAL(...) (void)0
+#define SYSTEM_DEBUG(...) (void)0
+#define APP_DEBUG_LIMITED(...) (void)0
+#define SYSTEM_DEBUG_LIMITED(...) (void)0
+#endif
 
+#if defined(ENABLE_LOGGING) && LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define APP_INFO(...)                                                          \
+  LOGGER_CALL(Logger::GetAppLogger(), spdlog::level::info, __VA_ARGS__)
+#define SYSTEM_INFO(...)                                                       \
+  LOGGER_CALL(Logger::GetSystemLogger(), spdlog::level::info, __VA_ARGS__)
+#define APP_INFO_LIMITED(...)                                                  \
+  LOGGER_CALL_LIMITED(Logger::GetAppLogger(), spdlog::level::info, __VA_ARGS__)
+#define SYSTEM_INFO_LIMITED(...)                                               \
+  LOGGER_CALL_LIMITED(Logger::GetSystemLogger(), spdlog::level::info,          \
+                      __VA_ARGS__)
+#else
+#define APP_INFO(...) (void)0
 #define SYSTEM_INFO(...) (void)0
-#define SYSTEM_TRACE(...) (void)0
-#define SYSTEM_DEBUG(...) (void)0
-#define SYSTEM_ERROR(...) (void)0
+#define APP_INFO_LIMITED(...) (void)0
+#define SYSTEM_INFO_LIMITED(...) (void)0
+#endif
+
+#if defined(ENABLE_LOGGING) && LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define APP_WARNING(...)                                                       \
+  LOGGER_CALL(Logger::GetAppLogger(), spdlog::level::warn, __VA_ARGS__)
+#define SYSTEM_WARNING(...)                                                    \
+  LOGGER_CALL(Logger::GetSystemLogger(), spdlog::level::warn, __VA_ARGS__)
+#define APP_WARNING_LIMITED(...)                                               \
+  LOGGER_CALL_LIMITED(Logger::GetAppLogger(), spdlog::level::warn, __VA_ARGS__)
+#define SYSTEM_WARNING_LIMITED(...)                                            \
+  LOGGER_CALL_LIMITED(Logger::GetSystemLogger(), spdlog::level::warn,          \
+                      __VA_ARGS__)
+#else
+#define APP_WARNING(...) (void)0
 #define SYSTEM_WARNING(...) (void)0
+#define APP_WARNING_LIMITED(...) (void)0
+#define SYSTEM_WARNING_LIMITED(...) (void)0
+#endif
+
+#if defined(ENABLE_LOGGING) && LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define APP_ERROR(...)                                                         \
+  LOGGER_CALL(Logger::GetAppLogger(), spdlog::level::err, __VA_ARGS__)
+#define SYSTEM_ERROR(...)                                                      \
+  LOGGER_CALL(Logger::GetSystemLogger(), spdlog::level::err, __VA_ARGS__)
+#define APP_ERROR_LIMITED(...)                                                 \
+  LOGGER_CALL_LIMITED(Logger::GetAppLogger(), spdlog::level::err, __VA_ARGS__)
+#define SYSTEM_ERROR_LIMITED(...)                                              \
+  LOGGER_CALL_LIMITED(Logger::GetSystemLogger(), spdlog::level::err,           \
+                      __VA_ARGS__)
+#else
+#define APP_ERROR(...) (void)0
+#define SYSTEM_ERROR(...) (void)0
+#define APP_ERROR_LIMITED(...) (void)0
+#define SYSTEM_ERROR_LIMITED(...) (void)0
+#endif
+
+#if defined(ENABLE_LOGGING) && LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
+#define APP_CRITICAL(...)                                                      \
+  LOGGER_CALL(Logger::GetAppLogger(), spdlog::level::critical, __VA_ARGS__)
+#define SYSTEM_CRITICAL(...)                                                   \
+  LOGGER_CALL(Logger::GetSystemLogger(), spdlog::level::critical, __VA_ARGS__)
+#define APP_CRITICAL_LIMITED(...)                                              \
+  LOGGER_CALL_LIMITED(Logger::GetAppLogger(), spdlog::level::critical,         \
+                      __VA_ARGS__)
+#define SYSTEM_CRITICAL_LIMITED(...)                                           \
+  LOGGER_CALL_LIMITED(Logger::GetSystemLogger(), spdlog::level::critical,      \
+                      __VA_ARGS__)
+#else
+#define APP_CRITICAL(...) (void)0
 #define SYSTEM_CRITICAL(...) (void)0
+#define APP_CRITICAL_LIMITED(...) (void)0
+#define SYSTEM_CRITICAL_LIMITED(...) (void)0
 #endif
 
 #endif
\ No newline at end of file
@@ -26,6 +26,10 @@ Geolocation::Geolocation(double Latitude, double Longitude)
 }
 
 const std::string Geolocation::GetPlusCode() const { return m_PlusCode; }
+openlocationcode::CellId Geolocation::GetCellId() const {
+  return openlocationcode::CellId::FromCode(m_PlusCode);
+}
+
 const std::string Geolocation::GetCoordinatesString() const {
   return "Latitude: " + std::to_string(m_Latitude) +
          " Longitude: " + std::to_string(m_Longitude);
@@ -0,0 +1,179 @@
+#include "../../../inc/Core/Location/Heatmap.h"
+
+#include <algorithm>
+
+Heatmap::Heatmap(HeatmapOptions Options)
+    : m_Options(Options), m_Shards(std::max<size_t>(Options.ShardCount, 1)) {
+  m_Options.CodeLength =
+      std::clamp<size_t>(m_Options.CodeLength, 1, CellId::kMaxCodeLength);
+  m_Options.BucketWidth =
+      std::max(m_Options.BucketWidth, std::chrono::seconds(1));
+  m_Options.BucketCount = std::max<size_t>(m_Options.BucketCount, 1);
+  m_Options.ShardCount = m_Shards.size();
+}
+
+bool Heatmap::Record(const GeoPoint &Point, double Value, TimePoint Time) {
+  return Record(Point.GetCellId(), Value, Time);
+}
+
+bool Heatmap::Record(const openlocationcode::LatLng &Location, double Value,
+                     TimePoint Time) {
+  return Record(CellId::FromLatLng(Location, m_Options.CodeLength), Value,
+                Time);
+}
+
+bool Heatmap::Record(CellId Id, double Value, TimePoint Time) {
+  if (!Id.is_valid()) {
+    return false;
+  }
+  if (Id.code_length() > m_Options.CodeLength) {
+    Id = Id.parent(m_Options.CodeLength);
+  }
+  const int64_t Epoch = EpochOf(Time);
+  const auto Kept = static_cast<int64_t>(m_Options.BucketCount);
+  auto &CurrentShard = m_Shards[ShardOf(Id.id())];
+
+  std::lock_guard<std::mutex> Lock(CurrentShard.Mutex);
+  auto &Buckets = CurrentShard.Cells[Id.id()];
+  if (Buckets.empty() || Buckets.back().Epoch < Epoch) {
+    /** @brief the window moved, drop what left it before appending. */
+    auto Expired = std::find_if(
+        Buckets.begin(), Buckets.end(),
+        [Epoch, Kept](const Bucket &Slot) { return Slot.Epoch > Epoch - Kept; });
+    Buckets.erase(Buckets.begin(), Expired);
+    Buckets.push_back({Epoch, 1, Value});
+    return true;
+  }
+  if (Epoch <= Buckets.back().Epoch - Kept) {
+    return false;
+  }
+  /** @brief a late event, rare enough to take the sorted insert. */
+  auto It = std::lower_bound(
+      Buckets.begin(), Buckets.end(), Epoch,
+      [](const Bucket &Slot, int64_t Value) { return Slot.Epoch < Value; });
+  if (It == Buckets.end() || It->Epoch != Epoch) {
+    It = Buckets.insert(It, {Epoch, 0, 0});
+  }
+  It->Count++;
+  It->Sum += Value;
+  return true;
+}
+
+Heatmap::Cell Heatmap::Get(CellId Id, std::chrono::seconds Window,
+                           TimePoint Now) const {
+  Cell Total{Id, 0, 0};
+  const int64_t Epoch = EpochOf(Now);
+  const int64_t Buckets = BucketsIn(Window);
+
+  if (Id.code_length() >= m_Options.CodeLength) {
+    const uint64_t Key = Id.parent(m_Options.CodeLength).id();
+    const auto &CurrentShard = m_Shards[ShardOf(Key)];
+    std::lock_guard<std::mutex> Lock(CurrentShard.Mutex);
+    if (auto It = CurrentShard.Cells.find(Key);
+        It != CurrentShard.Cells.end()) {
+      AddWindow(It->second, Epoch, Buckets, Total);
+    }
+    return Total;
+  }
+  for (const auto &CurrentShard : m_Shards) {
+    std::lock_guard<std::mutex> Lock(CurrentShard.Mutex);
+    for (auto It = CurrentShard.Cells.lower_bound(Id.range_min());
+         It != CurrentShard.Cells.end() && It->first <= Id.range_max(); ++It) {
+      AddWindow(It->second, Epoch, Buckets, Total);
+    }
+  }
+  return Total;
+}
+
+std::vector<Heatmap::Cell> Heatmap::Snapshot(std::chrono::seconds Window,
+                                             TimePoint Now) const {
+  const int64_t Epoch = EpochOf(Now);
+  const int64_t Buckets = BucketsIn(Window);
+  std::vector<Cell> Cells;
+  for (const auto &CurrentShard : m_Shards) {
+    std::lock_guard<std::mutex> Lock(CurrentShard.Mutex);
+    for (const auto &[Key, CellBuckets] : CurrentShard.Cells) {
+      Cell Total{CellId(Key), 0, 0};
+      AddWindow(CellBuckets, Epoch, Buckets, Total);
+      if (Total.Count != 0) {
+        Cells.push_back(Total);
+      }
+    }
+  }
+  /** @brief each shard is in order, only the shards need merging. */
+  std::sort(Cells.begin(), Cells.end(),
+            [](const Cell &Lhs, const Cell &Rhs) { return Lhs.Id < Rhs.Id; });
+  return Cells;
+}
+
+std::vector<Heatmap::Cell> Heatmap::Rollup(const std::vector<Cell> &Cells,
+                                           size_t CodeLength) {
+  std::vector<Cell> Parents;
+  for (const auto &Child : Cells) {
+    const CellId Parent = Child.Id.code_length() > CodeLength
+                              ? Child.Id.parent(CodeLength)
+                              : Child.Id;
+    /** @brief sorted children of a parent are next to each other. */
+    if (!Parents.empty() && Parents.back().Id == Parent) {
+      Parents.back().Count += Child.Count;
+      Parents.back().Sum += Child.Sum;
+    } else {
+      Parents.push_back({Parent, Child.Count, Child.Sum});
+    }
+  }
+  return Parents;
+}
+
+size_t Heatmap::Prune(TimePoint Now) {
+  const int64_t Oldest =
+      EpochOf(Now) - static_cast<int64_t>(m_Options.BucketCount);
+  size_t Dropped = 0;
+  for (auto &CurrentShard : m_Shards) {
+    std::lock_guard<std::mutex> Lock(CurrentShard.Mutex);
+    Dropped += std::erase_if(CurrentShard.Cells, [Oldest](const auto &Entry) {
+      return Entry.second.empty() || Entry.second.back().Epoch <= Oldest;
+    });
+  }
+  return Dropped;
+}
+
+size_t Heatmap::CellCount() const {
+  size_t Count = 0;
+  for (const auto &CurrentShard : m_Shards) {
+    std::lock_guard<std::mutex> Lock(CurrentShard.Mutex);
+    Count += CurrentShard.Cells.size();
+  }
+  return Count;
+}
+
+int64_t Heatmap::EpochOf(TimePoint Time) const {
+  return std::chrono::floor<std::chrono::seconds>(Time.time_since_epoch())
+             .count() /
+         m_Options.BucketWidth.count();
+}
+
+int64_t Heatmap::BucketsIn(std::chrono::seconds Window) const {
+  const int64_t Buckets =
+      (Window.count() + m_Options.BucketWidth.count() - 1) /
+      m_Options.BucketWidth.count();
+  return std::clamp<int64_t>(Buckets, 1,
+                             static_cast<int64_t>(m_Options.BucketCount));
+}
+
+size_t Heatmap::ShardOf(uint64_t Id) const {
+  /** @brief spreads neighbouring cells, a busy area uses every shard. */
+  return static_cast<size_t>((Id * 0x9E3779B97F4A7C15ULL) >> 32) %
+         m_Shards.size();
+}
+
+void Heatmap::AddWindow(const std::vector<Bucket> &CellBuckets, int64_t Now,
+                        int64_t Buckets, Cell &Total) {
+  /** @brief newest first, the rest of the buckets are older. */
+  for (auto It = CellBuckets.rbegin();
+       It != CellBuckets.rend() && It->Epoch > Now - Buckets; ++It) {
+    if (It->Epoch <= Now) {
+      Total.Count += It->Count;
+      Total.Sum += It->Sum;
+    }
+  }
+}
@@ -0,0 +1,216 @@
+#include "../../../../inc/Core/Location/PlusCodes/covering.h"
+#include "../../../../inc/Core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace openlocationcode {
+namespace {
+
+constexpr double kRadians = std::numbers::pi / 180;
+
+// Degrees east from longitude to reach the target, in [0, 360).
+double EastwardDegrees(double from, double to) {
+  const double degrees = std::fmod(to - from, 360.0);
+  return degrees < 0 ? degrees + 360 : degrees;
+}
+
+// True if the longitude lies in [lo, hi], where hi may be past the
+// antimeridian (lo <= hi <= lo + 360).
+bool LongitudeInInterval(double longitude, double lo, double hi) {
+  return hi - lo >= 360 || EastwardDegrees(lo, longitude) <= hi - lo;
+}
+
+// Orders the covering queue so the largest (shortest) cells come first.
+struct LongerCode {
+  bool operator()(const CellId &lhs, const CellId &rhs) const {
+    return lhs.code_length() > rhs.code_length() ||
+           (lhs.code_length() == rhs.code_length() && lhs > rhs);
+  }
+};
+
+}  // namespace
+
+LatLngRect::LatLngRect(const LatLng &lo, const LatLng &hi)
+    : lo_({std::clamp(lo.latitude, -internal::kLatitudeMaxDegrees,
+                      internal::kLatitudeMaxDegrees),
+           internal::normalize_longitude(lo.longitude)}),
+      hi_({std::clamp(hi.latitude, -internal::kLatitudeMaxDegrees,
+                      internal::kLatitudeMaxDegrees),
+           0}) {
+  // Keep the high longitude east of the low one, so the width is a plain
+  // difference even across the antimeridian.
+  hi_.longitude = hi.longitude - lo.longitude >= 360
+                      ? lo_.longitude + 360
+                      : lo_.longitude + EastwardDegrees(lo.longitude,
+                                                        hi.longitude);
+}
+
+bool LatLngRect::MayIntersect(const CodeArea &area) const {
+  if (area.GetLatitudeLo() > hi_.latitude ||
+      area.GetLatitudeHi() < lo_.latitude) {
+    return false;
+  }
+  // The intervals overlap if either one holds the start of the other.
+  return LongitudeInInterval(area.GetLongitudeLo(), lo_.longitude,
+                             hi_.longitude) ||
+         LongitudeInInterval(lo_.longitude, area.GetLongitudeLo(),
+                             area.GetLongitudeHi());
+}
+
+bool LatLngRect::Contains(const CodeArea &area) const {
+  if (area.GetLatitudeLo() < lo_.latitude ||
+      area.GetLatitudeHi() > hi_.latitude) {
+    return false;
+  }
+  return EastwardDegrees(lo_.longitude, area.GetLongitudeLo()) +
+             (area.GetLongitudeHi() - area.GetLongitudeLo()) <=
+         hi_.longitude - lo_.longitude;
+}
+
+bool LatLngRect::Contains(const LatLng &location) const {
+  return location.latitude >= lo_.latitude &&
+         location.latitude <= hi_.latitude &&
+         LongitudeInInterval(location.longitude, lo_.longitude, hi_.longitude);
+}
+
+Cap::Cap(const LatLng &center, double radius_meters)
+    : center_({center.latitude,
+               internal::normalize_longitude(center.longitude)}),
+      radius_meters_(radius_meters) {}
+
+bool Cap::MayIntersect(const CodeArea &area) const {
+  // A lower bound on the distance to the area: a point of the area is at
+  // least the latitude gap away, and at least the longitude gap away along
+  // the parallel furthest from the equator.
+  const double lat_gap =
+      std::max({0.0, area.GetLatitudeLo() - center_.latitude,
+                center_.latitude - area.GetLatitudeHi()});
+  double bound = lat_gap * kRadians * kEarthRadiusMeters;
+  if (!LongitudeInInterval(center_.longitude, area.GetLongitudeLo(),
+                           area.GetLongitudeHi())) {
+    const double lng_gap =
+        std::min(EastwardDegrees(center_.longitude, area.GetLongitudeLo()),
+                 EastwardDegrees(area.GetLongitudeHi(), center_.longitude));
+    const double max_latitude = std::min(
+        internal::kLatitudeMaxDegrees,
+        std::max({std::abs(center_.latitude), std::abs(area.GetLatitudeLo()),
+                  std::abs(area.GetLatitudeHi())}));
+    const double lng_angle =
+        2 * std::asin(std::cos(max_latitude * kRadians) *
+                      std::sin(std::min(lng_gap, 180.0) * kRadians / 2));
+    bound = std::max(bound, lng_angle * kEarthRadiusMeters);
+  }
+  return bound <= radius_meters_;
+}
+
+bool Cap::Contains(const CodeArea &area) const {
+  // The furthest point of a small area is one of its corners. Larger areas
+  // are not claimed, they just get refined.
+  if (area.GetLatitudeHi() - area.GetLatitudeLo() > 45 ||
+      area.GetLongitudeHi() - area.GetLongitudeLo() > 45) {
+    return false;
+  }
+  for (double latitude : {area.GetLatitudeLo(), area.GetLatitudeHi()}) {
+    for (double longitude : {area.GetLongitudeLo(), area.GetLongitudeHi()}) {
+      if (DistanceMeters(center_, {latitude, longitude}) > radius_meters_) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool Cap::Contains(const LatLng &location) const {
+  return DistanceMeters(center_, location) <= radius_meters_;
+}
+
+LatLngRect Cap::GetBound() const {
+  const double angle = radius_meters_ / kEarthRadiusMeters;
+  const double angle_degrees = angle / kRadians;
+  const double lat_lo = center_.latitude - angle_degrees;
+  const double lat_hi = center_.latitude + angle_degrees;
+  if (lat_lo <= -internal::kLatitudeMaxDegrees ||
+      lat_hi >= internal::kLatitudeMaxDegrees ||
+      angle >= std::numbers::pi / 2) {
+    // The cap holds a pole, every longitude is reached.
+    return LatLngRect({lat_lo, -internal::kLongitudeMaxDegrees},
+                      {lat_hi, internal::kLongitudeMaxDegrees});
+  }
+  const double lng_degrees =
+      std::asin(std::sin(angle) / std::cos(center_.latitude * kRadians)) /
+      kRadians;
+  if (lng_degrees >= internal::kLongitudeMaxDegrees) {
+    return LatLngRect({lat_lo, -internal::kLongitudeMaxDegrees},
+                      {lat_hi, internal::kLongitudeMaxDegrees});
+  }
+  return LatLngRect({lat_lo, center_.longitude - lng_degrees},
+                    {lat_hi, center_.longitude + lng_degrees});
+}
+
+std::vector<CellId> GetCovering(const Region &region,
+                                const CoveringOptions &options) {
+  PROFILE_ZONE_COUNTERS("openlocationcode::GetCovering");
+  const size_t max_code_length =
+      std::min(options.max_code_length, CellId::kMaxCodeLength);
+  std::vector<CellId> covering;
+  std::priority_queue<CellId, std::vector<CellId>, LongerCode> queue;
+  queue.push(CellId::Root());
+
+  std::vector<CellId> children;
+  while (!queue.empty()) {
+    const CellId cell = queue.top();
+    queue.pop();
+    if (cell.code_length() >= max_code_length ||
+        region.Contains(cell.ToArea())) {
+      covering.push_back(cell);
+      continue;
+    }
+    children.clear();
+    for (int position = 0;
+         position < static_cast<int>(internal::kEncodingBase); position++) {
+      const CellId child = cell.child(position);
+      if (child.is_valid() && region.MayIntersect(child.ToArea())) {
+        children.push_back(child);
+      }
+    }
+    // The whole globe is always refined, otherwise stop refining this cell
+    // once its children would not fit.
+    if (cell != CellId::Root() &&
+        covering.size() + queue.size() + children.size() > options.max_cells) {
+      covering.push_back(cell);
+      continue;
+    }
+    for (const CellId &child : children) {
+      queue.push(child);
+    }
+  }
+  std::sort(covering.begin(), covering.end());
+  return covering;
+}
+
+std::vector<CellRange> GetRanges(const std::vector<CellId> &cells) {
+  PROFILE_ZONE_COUNTERS("openlocationcode::GetRanges");
+  std::vector<CellRange> ranges;
+  ranges.reserve(cells.size());
+  for (const CellId &cell : cells) {
+    ranges.push_back({cell.range_min(), cell.range_max()});
+  }
+  std::sort(ranges.begin(), ranges.end(),
+            [](const CellRange &lhs, const CellRange &rhs) {
+              return lhs.min < rhs.min;
+            });
+  std::vector<CellRange> merged;
+  for (const CellRange &range : ranges) {
+    if (!merged.empty() && (merged.back().max == ~uint64_t{0} ||
+                            range.min <= merged.back().max + 1)) {
+      merged.back().max = std::max(merged.back().max, range.max);
+    } else {
+      merged.push_back(range);
+    }
+  }
+  return merged;
+}
+
+}  // namespace openlocationcode
@@ -0,0 +1,175 @@
+#include "../../../../inc/Core/Location/PlusCodes/validator.h"
+#include "../../../../inc/Core/Profiler.h"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define OPENLOCATIONCODE_VECTOR_CLASSIFY
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define OPENLOCATIONCODE_VECTOR_CLASSIFY
+#endif
+
+namespace openlocationcode {
+namespace {
+
+#ifdef OPENLOCATIONCODE_VECTOR_CLASSIFY
+// Codes up to this many characters are classified with vector instructions.
+constexpr size_t kVectorWidth = 16;
+
+// The characters of a code as bit masks, bit i standing for code[i].
+struct CharacterMasks {
+  uint32_t separators;
+  uint32_t padding;
+  // Characters that are neither a digit, the separator nor padding.
+  uint32_t invalid;
+};
+
+// A character is allowed if the entries for its low and high nibble share a
+// bit. Each bit is one group of allowed characters:
+//   0x01 '+'        0x02 '0'         0x04 '2'-'9'
+//   0x08 'C' 'F' 'G' 'H' 'J' 'M' and their lower case
+//   0x10 'P' 'Q' 'R' 'V' 'W' 'X' and their lower case
+alignas(16) constexpr uint8_t kLowNibbleClasses[16] = {
+    0x12, 0x10, 0x14, 0x0C, 0x04, 0x04, 0x1C, 0x1C,
+    0x1C, 0x04, 0x08, 0x01, 0x00, 0x08, 0x00, 0x00};
+alignas(16) constexpr uint8_t kHighNibbleClasses[16] = {
+    0x00, 0x00, 0x01, 0x06, 0x08, 0x10, 0x08, 0x10,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+#if defined(__SSSE3__)
+CharacterMasks GetMasks(const uint8_t *chars) {
+  const __m128i input =
+      _mm_load_si128(reinterpret_cast<const __m128i *>(chars));
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  const __m128i low = _mm_and_si128(input, nibble);
+  const __m128i high = _mm_and_si128(_mm_srli_epi16(input, 4), nibble);
+  const __m128i classes = _mm_and_si128(
+      _mm_shuffle_epi8(
+          _mm_load_si128(reinterpret_cast<const __m128i *>(kLowNibbleClasses)),
+          low),
+      _mm_shuffle_epi8(
+          _mm_load_si128(reinterpret_cast<const __m128i *>(kHighNibbleClasses)),
+          high));
+  return {
+      static_cast<uint32_t>(_mm_movemask_epi8(
+          _mm_cmpeq_epi8(input, _mm_set1_epi8(internal::kSeparator)))),
+      static_cast<uint32_t>(_mm_movemask_epi8(
+          _mm_cmpeq_epi8(input, _mm_set1_epi8(internal::kPaddingCharacter)))),
+      static_cast<uint32_t>(_mm_movemask_epi8(
+          _mm_cmpeq_epi8(classes, _mm_setzero_si128())))};
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+// NEON has no movemask, each lane keeps its own bit and the halves are
+// summed.
+uint32_t MoveMask(uint8x16_t lanes) {
+  alignas(16) constexpr uint8_t kBits[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                             1, 2, 4, 8, 16, 32, 64, 128};
+  const uint8x16_t bits = vandq_u8(lanes, vld1q_u8(kBits));
+  return vaddv_u8(vget_low_u8(bits)) |
+         (static_cast<uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+}
+
+CharacterMasks GetMasks(const uint8_t *chars) {
+  const uint8x16_t input = vld1q_u8(chars);
+  const uint8x16_t nibble = vdupq_n_u8(0x0F);
+  const uint8x16_t classes =
+      vandq_u8(vqtbl1q_u8(vld1q_u8(kLowNibbleClasses), vandq_u8(input, nibble)),
+               vqtbl1q_u8(vld1q_u8(kHighNibbleClasses), vshrq_n_u8(input, 4)));
+  return {MoveMask(vceqq_u8(input, vdupq_n_u8(internal::kSeparator))),
+          MoveMask(vceqq_u8(input, vdupq_n_u8(internal::kPaddingCharacter))),
+          MoveMask(vceqzq_u8(classes))};
+}
+#endif
+
+// The checks of Classify, on the masks of a code of at most kVectorWidth
+// characters.
+CodeType ClassifyMasks(std::string_view code, const CharacterMasks &masks) {
+  const size_t size = code.size();
+  const uint32_t in_code = (uint32_t{1} << size) - 1;
+  const uint32_t separators = masks.separators & in_code;
+  const uint32_t padding = masks.padding & in_code;
+  // There must be exactly one separator, and no other character.
+  if ((masks.invalid & in_code) != 0 || std::popcount(separators) != 1 ||
+      size == 1) {
+    return CodeType::kInvalid;
+  }
+  const size_t separator_pos = std::countr_zero(separators);
+  if (separator_pos > internal::kSeparatorPosition || separator_pos % 2 == 1) {
+    return CodeType::kInvalid;
+  }
+  if (padding != 0) {
+    const size_t padding_start = std::countr_zero(padding);
+    // Only padding may follow the first padding character, up to a final
+    // separator, and it must start at an even position of a full code.
+    const uint32_t digits = in_code & ~separators & ~padding;
+    if ((digits >> padding_start) != 0 ||
+        separator_pos < internal::kSeparatorPosition || padding_start == 0 ||
+        padding_start % 2 == 1 || size > separator_pos + 1) {
+      return CodeType::kInvalid;
+    }
+  }
+  if (size - separator_pos - 1 == 1) {
+    return CodeType::kInvalid;
+  }
+  if (separator_pos < internal::kSeparatorPosition) {
+    return CodeType::kShort;
+  }
+  if (internal::get_alphabet_position(code[0]) * internal::kEncodingBase >=
+          internal::kLatitudeMaxDegrees * 2 ||
+      internal::get_alphabet_position(code[1]) * internal::kEncodingBase >=
+          internal::kLongitudeMaxDegrees * 2) {
+    return CodeType::kOutOfRange;
+  }
+  return CodeType::kFull;
+}
+#endif
+
+CodeType ClassifyOne(std::string_view code) {
+#ifdef OPENLOCATIONCODE_VECTOR_CLASSIFY
+  if (!code.empty() && code.size() <= kVectorWidth) {
+    // Copied so the load never reads past the end of the string, the zero
+    // filled tail is masked off.
+    alignas(16) uint8_t chars[kVectorWidth] = {};
+    std::memcpy(chars, code.data(), code.size());
+    return ClassifyMasks(code, GetMasks(chars));
+  }
+#endif
+  return Classify(code);
+}
+
+template <typename Code>
+void ClassifyAll(std::span<const Code> codes, std::span<CodeType> types) {
+  PROFILE_ZONE_COUNTERS("openlocationcode::ClassifyBatch");
+  for (size_t i = 0; i < codes.size(); i++) {
+    types[i] = ClassifyOne(codes[i]);
+  }
+}
+
+}  // namespace
+
+void ClassifyBatch(std::span<const std::string_view> codes,
+                   std::span<CodeType> types) {
+  ClassifyAll(codes, types);
+}
+
+void ClassifyBatch(std::span<const std::string> codes,
+                   std::span<CodeType> types) {
+  ClassifyAll(codes, types);
+}
+
+std::vector<CodeType> ClassifyBatch(std::span<const std::string_view> codes) {
+  std::vector<CodeType> types(codes.size());
+  ClassifyAll(codes, std::span<CodeType>(types));
+  return types;
+}
+
+std::vector<CodeType> ClassifyBatch(std::span<const std::string> codes) {
+  std::vector<CodeType> types(codes.size());
+  ClassifyAll(codes, std::span<CodeType>(types));
+  return types;
+}
+
+}  // namespace openlocationcode
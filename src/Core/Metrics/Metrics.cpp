@@ -0,0 +1,230 @@
+#include "../../../inc/Core/Metrics/Metrics.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+std::mutex Metrics::s_Mutex;
+std::map<std::string, Metrics::Family> Metrics::s_Families;
+std::map<std::string, Metrics::Collector> Metrics::s_Collectors;
+
+namespace {
+std::string_view TypeToString(Metrics::Type Kind) {
+  switch (Kind) {
+  case Metrics::Type::Counter:
+    return "counter";
+  case Metrics::Type::Gauge:
+    return "gauge";
+  case Metrics::Type::Histogram:
+    return "histogram";
+  }
+  return "untyped";
+}
+
+void AppendValue(std::string &Out, double Value) {
+  if (std::isnan(Value)) {
+    Out.append("NaN");
+  } else if (std::isinf(Value)) {
+    Out.append(Value > 0 ? "+Inf" : "-Inf");
+  } else {
+    char Buffer[32];
+    auto [End, Error] = std::to_chars(Buffer, Buffer + sizeof(Buffer), Value);
+    Out.append(Buffer, End);
+  }
+}
+
+/** @brief the labels with le added, for a histogram bucket line. */
+std::string WithBound(const std::string &Labels, double Bound) {
+  std::string Result =
+      Labels.empty() ? "{" : Labels.substr(0, Labels.size() - 1) + ",";
+  Result.append("le=\"");
+  AppendValue(Result, Bound);
+  Result.append("\"}");
+  return Result;
+}
+} // namespace
+
+Histogram::Histogram(std::vector<double> Bounds)
+    : m_Bounds(std::move(Bounds)),
+      m_Buckets(std::make_unique<std::atomic<uint64_t>[]>(m_Bounds.size() +
+                                                          1)) {
+  std::sort(m_Bounds.begin(), m_Bounds.end());
+}
+
+void Histogram::Observe(double Value) {
+  const auto Bucket = static_cast<size_t>(
+      std::lower_bound(m_Bounds.begin(), m_Bounds.end(), Value) -
+      m_Bounds.begin());
+  m_Buckets[Bucket].fetch_add(1, std::memory_order_relaxed);
+  m_Count.fetch_add(1, std::memory_order_relaxed);
+  m_Sum.fetch_add(Value, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> Histogram::GetBucketCounts() const {
+  std::vector<uint64_t> Counts(m_Bounds.size() + 1);
+  for (size_t i = 0; i < Counts.size(); i++) {
+    Counts[i] = m_Buckets[i].load(std::memory_order_relaxed);
+  }
+  return Counts;
+}
+
+Metrics::Family &Metrics::GetFamily(const std::string &Name, Type Kind,
+                                    const std::string &Help) {
+  auto [It, Inserted] = s_Families.try_emplace(Name);
+  if (Inserted) {
+    It->second.Kind = Kind;
+    It->second.Help = Help;
+  } else if (It->second.Kind != Kind) {
+    throw std::invalid_argument("Metric " + Name +
+                                " Registered With Another Type.");
+  }
+  return It->second;
+}
+
+Counter &Metrics::GetCounter(const std::string &Name, const std::string &Help,
+                             const MetricLabels &Labels) {
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  auto &Slot =
+      GetFamily(Name, Type::Counter, Help).Counters[FormatLabels(Labels)];
+  if (!Slot) {
+    Slot = std::make_unique<Counter>();
+  }
+  return *Slot;
+}
+
+Gauge &Metrics::GetGauge(const std::string &Name, const std::string &Help,
+                         const MetricLabels &Labels) {
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  auto &Slot = GetFamily(Name, Type::Gauge, Help).Gauges[FormatLabels(Labels)];
+  if (!Slot) {
+    Slot = std::make_unique<Gauge>();
+  }
+  return *Slot;
+}
+
+Histogram &Metrics::GetHistogram(const std::string &Name,
+                                 const std::string &Help,
+                                 const MetricLabels &Labels,
+                                 std::vector<double> Bounds) {
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  auto &CurrentFamily = GetFamily(Name, Type::Histogram, Help);
+  if (!CurrentFamily.Histograms.empty()) {
+    Bounds = CurrentFamily.Histograms.begin()->second->GetBounds();
+  }
+  auto &Slot = CurrentFamily.Histograms[FormatLabels(Labels)];
+  if (!Slot) {
+    Slot = std::make_unique<Histogram>(std::move(Bounds));
+  }
+  return *Slot;
+}
+
+void Metrics::AddCollector(const std::string &Name, Collector Collect) {
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  s_Collectors[Name] = std::move(Collect);
+}
+
+void Metrics::RemoveCollector(const std::string &Name) {
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  s_Collectors.erase(Name);
+}
+
+std::string Metrics::Render() {
+  std::string Out;
+  std::vector<Collector> Collectors;
+  {
+    std::lock_guard<std::mutex> Lock(s_Mutex);
+    for (const auto &[Name, CurrentFamily] : s_Families) {
+      WriteHeader(Out, Name, CurrentFamily.Kind, CurrentFamily.Help);
+      for (const auto &[Labels, Value] : CurrentFamily.Counters) {
+        Out.append(Name).append(Labels).append(" ");
+        Out.append(std::to_string(Value->Get())).append("\n");
+      }
+      for (const auto &[Labels, Value] : CurrentFamily.Gauges) {
+        Out.append(Name).append(Labels).append(" ");
+        AppendValue(Out, Value->Get());
+        Out.append("\n");
+      }
+      for (const auto &[Labels, Value] : CurrentFamily.Histograms) {
+        const auto &Bounds = Value->GetBounds();
+        const auto Counts = Value->GetBucketCounts();
+        uint64_t Cumulative = 0;
+        for (size_t i = 0; i < Counts.size(); i++) {
+          Cumulative += Counts[i];
+          const double Bound = i < Bounds.size()
+                                   ? Bounds[i]
+                                   : std::numeric_limits<double>::infinity();
+          Out.append(Name).append("_bucket").append(WithBound(Labels, Bound));
+          Out.append(" ").append(std::to_string(Cumulative)).append("\n");
+        }
+        Out.append(Name).append("_sum").append(Labels).append(" ");
+        AppendValue(Out, Value->GetSum());
+        Out.append("\n");
+        /** @brief the +Inf bucket, _count must agree with it. */
+        Out.append(Name).append("_count").append(Labels).append(" ");
+        Out.append(std::to_string(Cumulative)).append("\n");
+      }
+    }
+    for (const auto &[Name, Collect] : s_Collectors) {
+      Collectors.push_back(Collect);
+    }
+  }
+  /** @brief outside the lock, collectors take their sources' locks. */
+  for (const auto &Collect : Collectors) {
+    Collect(Out);
+  }
+  return Out;
+}
+
+void Metrics::WriteHeader(std::string &Out, std::string_view Name, Type Kind,
+                          std::string_view Help) {
+  Out.append("# HELP ").append(Name).append(" ");
+  for (char c : Help) {
+    if (c == '\\') {
+      Out.append("\\\\");
+    } else if (c == '\n') {
+      Out.append("\\n");
+    } else {
+      Out.push_back(c);
+    }
+  }
+  Out.append("\n# TYPE ")
+      .append(Name)
+      .append(" ")
+      .append(TypeToString(Kind))
+      .append("\n");
+}
+
+void Metrics::WriteSample(std::string &Out, std::string_view Name,
+                          const MetricLabels &Labels, double Value) {
+  Out.append(Name).append(FormatLabels(Labels)).append(" ");
+  AppendValue(Out, Value);
+  Out.append("\n");
+}
+
+std::string Metrics::FormatLabels(const MetricLabels &Labels) {
+  if (Labels.empty()) {
+    return {};
+  }
+  std::string Result = "{";
+  for (const auto &[Key, Value] : Labels) {
+    if (Result.size() > 1) {
+      Result.push_back(',');
+    }
+    Result.append(Key).append("=\"");
+    for (char c : Value) {
+      if (c == '\\' || c == '"') {
+        Result.push_back('\\');
+        Result.push_back(c);
+      } else if (c == '\n') {
+        Result.append("\\n");
+      } else {
+        Result.push_back(c);
+      }
+    }
+    Result.push_back('"');
+  }
+  Result.push_back('}');
+  return Result;
+}
@@ -0,0 +1,138 @@
+#include "../../../inc/Core/Metrics/MetricsExporter.h"
+#include "../../../inc/Config/Logger.h"
+#include "../../../inc/Core/Metrics/Metrics.h"
+
+#include <arpa/inet.h>
+#include <filesystem>
+#include <fstream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+MetricsExporter::MetricsExporter(const MetricsOptions &Options)
+    : m_Options(Options) {
+  if (m_Options.Port != 0) {
+    m_Socket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int Reuse = 1;
+    setsockopt(m_Socket, SOL_SOCKET, SO_REUSEADDR, &Reuse, sizeof(Reuse));
+    sockaddr_in Address{};
+    Address.sin_family = AF_INET;
+    Address.sin_port = htons(m_Options.Port);
+    Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (m_Socket < 0 ||
+        bind(m_Socket, reinterpret_cast<sockaddr *>(&Address),
+             sizeof(Address)) != 0 ||
+        listen(m_Socket, 16) != 0) {
+      APP_ERROR("METRICS EXPORTER - CAN'T LISTEN ON PORT {}", m_Options.Port);
+      if (m_Socket >= 0) {
+        close(m_Socket);
+      }
+      m_Socket = -1;
+    } else {
+      m_Port = m_Options.Port;
+      m_Server = std::thread(&MetricsExporter::RunServer, this);
+    }
+  }
+  if (!m_Options.Path.empty()) {
+    m_Writer = std::thread(&MetricsExporter::RunWriter, this);
+  }
+  APP_INFO("METRICS EXPORTER CREATED - FILE: {} PORT: {}", m_Options.Path,
+           m_Port);
+}
+
+MetricsExporter::~MetricsExporter() {
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    m_Running = false;
+  }
+  m_Wakeup.notify_all();
+  if (m_Writer.joinable()) {
+    m_Writer.join();
+  }
+  if (m_Server.joinable()) {
+    m_Server.join();
+  }
+  if (m_Socket >= 0) {
+    close(m_Socket);
+  }
+}
+
+bool MetricsExporter::WriteFile() {
+  if (m_Options.Path.empty()) {
+    return false;
+  }
+  const std::string Temporary = m_Options.Path + ".tmp";
+  {
+    std::ofstream File(Temporary, std::ios::trunc);
+    File << Metrics::Render();
+    if (!File) {
+      APP_ERROR_LIMITED("METRICS EXPORTER - CAN'T WRITE {}", Temporary);
+      return false;
+    }
+  }
+  std::error_code Error;
+  std::filesystem::rename(Temporary, m_Options.Path, Error);
+  if (Error) {
+    APP_ERROR_LIMITED("METRICS EXPORTER - CAN'T RENAME TO {} - {}",
+                      m_Options.Path, Error.message());
+    return false;
+  }
+  return true;
+}
+
+void MetricsExporter::RunWriter() {
+  std::unique_lock<std::mutex> Lock(m_Mutex);
+  while (m_Running) {
+    Lock.unlock();
+    WriteFile();
+    Lock.lock();
+    m_Wakeup.wait_for(Lock, m_Options.Interval, [this] { return !m_Running; });
+  }
+}
+
+void MetricsExporter::RunServer() {
+  pollfd Listener{m_Socket, POLLIN, 0};
+  while (m_Running) {
+    /** @brief wakes up now and then to notice the destructor. */
+    if (poll(&Listener, 1, 200) <= 0) {
+      continue;
+    }
+    const int Client = accept4(m_Socket, nullptr, nullptr, SOCK_CLOEXEC);
+    if (Client < 0) {
+      continue;
+    }
+    /** @brief the request isn't looked at, only read up to its end. */
+    timeval Timeout{1, 0};
+    setsockopt(Client, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof(Timeout));
+    std::string Request;
+    char Buffer[1024];
+    while (Request.find("\r\n\r\n") == std::string::npos &&
+           Request.size() < 8192) {
+      const ssize_t Read = recv(Client, Buffer, sizeof(Buffer), 0);
+      if (Read <= 0) {
+        break;
+      }
+      Request.append(Buffer, static_cast<size_t>(Read));
+    }
+
+    const std::string Body = Metrics::Render();
+    std::string Response;
+    Response.append("HTTP/1.1 200 OK\r\n")
+        .append("Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n")
+        .append("Content-Length: ")
+        .append(std::to_string(Body.size()))
+        .append("\r\nConnection: close\r\n\r\n")
+        .append(Body);
+    size_t Sent = 0;
+    while (Sent < Response.size()) {
+      const ssize_t Written = send(Client, Response.data() + Sent,
+                                   Response.size() - Sent, MSG_NOSIGNAL);
+      if (Written <= 0) {
+        break;
+      }
+      Sent += static_cast<size_t>(Written);
+    }
+    close(Client);
+  }
+}
@@ -0,0 +1,266 @@
+#include "../../inc/Core/ObjectLogger.h"
+#include "../../inc/Core/Profiler.h"
+
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+/** @brief logmsg is a varchar(100). */
+constexpr size_t MessageCharacters = 100;
+constexpr size_t MaxBatchSize = 65535 / 3;
+
+std::string_view LevelToString(ObjectLogLevel Level) {
+  switch (Level) {
+  case ObjectLogLevel::Debug:
+    return "DEBUG";
+  case ObjectLogLevel::Info:
+    return "INFO";
+  case ObjectLogLevel::Warn:
+    return "WARN";
+  case ObjectLogLevel::Error:
+    return "ERROR";
+  case ObjectLogLevel::Crit:
+    return "CRIT";
+  }
+  return "INFO";
+}
+
+/**
+ * @brief the message cut to the column's characters, on a utf-8 character
+ * boundary.
+ */
+std::string FitMessage(std::string_view Message) {
+  size_t Characters = 0;
+  for (size_t i = 0; i < Message.size(); i++) {
+    const auto Byte = static_cast<unsigned char>(Message[i]);
+    if ((Byte & 0xC0) != 0x80 && Characters++ == MessageCharacters) {
+      return std::string(Message.substr(0, i));
+    }
+  }
+  return std::string(Message);
+}
+} // namespace
+
+ObjectLogPipeline::ObjectLogPipeline(DatabasePool &Pool,
+                                     const ObjectLogOptions &Options)
+    : m_Options(Options), m_Pool(Pool) {
+  if (m_Options.BatchSize == 0 || m_Options.BatchSize > MaxBatchSize) {
+    APP_CRITICAL("OBJECT LOG PIPELINE ERROR - BATCH SIZE {}",
+                 m_Options.BatchSize);
+    throw std::invalid_argument("Object Log Batch Size Out Of Range.");
+  }
+  const size_t Capacity = std::bit_ceil(std::max<size_t>(Options.Capacity, 2));
+  m_Slots = std::make_unique<Slot[]>(Capacity);
+  for (size_t i = 0; i < Capacity; i++) {
+    m_Slots[i].Sequence.store(i, std::memory_order_relaxed);
+  }
+  m_Mask = Capacity - 1;
+  m_Writer = std::thread([this] { RunWriter(); });
+  APP_INFO("OBJECT LOG PIPELINE STARTED - CAPACITY {} - BATCH {}", Capacity,
+           m_Options.BatchSize);
+}
+
+ObjectLogPipeline::~ObjectLogPipeline() {
+  {
+    std::scoped_lock<std::mutex> lock(m_Mutex);
+    m_Running.store(false, std::memory_order_release);
+  }
+  m_Wakeup.notify_all();
+  if (m_Writer.joinable()) {
+    m_Writer.join();
+  }
+  APP_INFO("OBJECT LOG PIPELINE STOPPED - DROPPED {} - FAILED {}",
+           GetDropped(), GetFailed());
+}
+
+bool ObjectLogPipeline::Push(ObjectLogTarget Target,
+                             const std::shared_ptr<const std::string> &EntityID,
+                             ObjectLogLevel Level, std::string &&Message) {
+  size_t Position = m_Tail.load(std::memory_order_relaxed);
+  Slot *Claimed = nullptr;
+  while (Claimed == nullptr) {
+    Slot &Current = m_Slots[Position & m_Mask];
+    const size_t Sequence = Current.Sequence.load(std::memory_order_acquire);
+    const auto Difference = static_cast<std::ptrdiff_t>(Sequence - Position);
+    if (Difference == 0) {
+      if (m_Tail.compare_exchange_weak(Position, Position + 1,
+                                       std::memory_order_relaxed)) {
+        Claimed = &Current;
+      }
+    } else if (Difference < 0) {
+      /** @brief the writer hasn't taken this slot's last lap entry, full. */
+      m_Dropped.fetch_add(1, std::memory_order_relaxed);
+      m_DroppedCounter.Increment();
+      APP_WARNING_LIMITED("OBJECT LOG PIPELINE FULL - ENTRY DROPPED");
+      return false;
+    } else {
+      Position = m_Tail.load(std::memory_order_relaxed);
+    }
+  }
+  Claimed->Data.Target = Target;
+  Claimed->Data.Level = Level;
+  Claimed->Data.EntityID = EntityID;
+  Claimed->Data.Message = std::move(Message);
+  Claimed->Sequence.store(Position + 1, std::memory_order_release);
+  return true;
+}
+
+bool ObjectLogPipeline::Pop(Entry &Taken) {
+  Slot &Current = m_Slots[m_Head & m_Mask];
+  if (Current.Sequence.load(std::memory_order_acquire) != m_Head + 1) {
+    return false;
+  }
+  Taken = std::move(Current.Data);
+  Current.Sequence.store(m_Head + m_Mask + 1, std::memory_order_release);
+  m_Head++;
+  return true;
+}
+
+void ObjectLogPipeline::Flush() {
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  const size_t Target = m_Tail.load(std::memory_order_acquire);
+  m_FlushRequest = std::max(m_FlushRequest, Target);
+  m_Wakeup.notify_all();
+  m_Flushed.wait(lock, [this, Target] { return m_Written >= Target; });
+}
+
+void ObjectLogPipeline::RunWriter() {
+  std::vector<Entry> Batch;
+  Batch.reserve(m_Options.BatchSize);
+  auto Deadline = std::chrono::steady_clock::now();
+  while (true) {
+    const bool WasEmpty = Batch.empty();
+    Entry Taken;
+    while (Batch.size() < m_Options.BatchSize && Pop(Taken)) {
+      Batch.push_back(std::move(Taken));
+    }
+    const auto Now = std::chrono::steady_clock::now();
+    if (WasEmpty && !Batch.empty()) {
+      Deadline = Now + m_Options.FlushInterval;
+    }
+    const bool Stopping = !m_Running.load(std::memory_order_acquire);
+    bool FlushWanted = false;
+    {
+      std::scoped_lock<std::mutex> lock(m_Mutex);
+      FlushWanted = m_FlushRequest > m_Written;
+    }
+
+    if (Batch.size() == m_Options.BatchSize ||
+        (!Batch.empty() && (Now >= Deadline || Stopping || FlushWanted))) {
+      const size_t Count = Batch.size();
+      Write(Batch);
+      Batch.clear();
+      {
+        std::scoped_lock<std::mutex> lock(m_Mutex);
+        m_Written += Count;
+      }
+      m_Flushed.notify_all();
+      continue;
+    }
+    if (Stopping && m_Head == m_Tail.load(std::memory_order_acquire)) {
+      break;
+    }
+    if (Stopping || FlushWanted) {
+      /** @brief a producer claimed a slot and is moving its entry in. */
+      std::this_thread::yield();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Wakeup.wait_until(
+        lock, Batch.empty() ? Now + m_Options.FlushInterval : Deadline, [this] {
+          return m_FlushRequest > m_Written ||
+                 !m_Running.load(std::memory_order_relaxed);
+        });
+  }
+}
+
+void ObjectLogPipeline::Write(std::vector<Entry> &Batch) {
+  PROFILE_ZONE("ObjectLogPipeline::Write");
+  std::array<std::vector<const Entry *>,
+             static_cast<size_t>(ObjectLogTarget::Count)>
+      Targets;
+  for (const auto &Current : Batch) {
+    Targets[static_cast<size_t>(Current.Target)].push_back(&Current);
+  }
+  /** @brief behind the reads and writes, and never shed. */
+  auto Manager = m_Pool.GetManagerConnection(CheckoutPriority::Background);
+  for (size_t i = 0; i < Targets.size(); i++) {
+    if (!Targets[i].empty()) {
+      WriteTarget(Manager, static_cast<ObjectLogTarget>(i), Targets[i]);
+    }
+  }
+  m_Pool.ReturnConnection(Manager);
+}
+
+void ObjectLogPipeline::WriteTarget(SharedManager &Manager,
+                                    ObjectLogTarget Target,
+                                    const std::vector<const Entry *> &Entries) {
+  const bool Address = Target == ObjectLogTarget::Address;
+  auto &Model = Address ? m_AddressLog.GetModel() : m_Log.GetModel();
+  static const std::vector<std::string> AddressColumns = {
+      "addressid", "loglevel", "logmsg"};
+  static const std::vector<std::string> LogColumns = {"loglevel", "logmsg"};
+  const auto &Columns = Address ? AddressColumns : LogColumns;
+
+  auto AppendRow = [Address](pqxx::params &Params, const Entry &Row) {
+    if (Address) {
+      Params.append(*Row.EntityID);
+      Params.append(std::string(LevelToString(Row.Level)));
+      Params.append(FitMessage(Row.Message));
+    } else {
+      Params.append(std::string(LevelToString(Row.Level)));
+      Params.append(FitMessage(*Row.EntityID + " " + Row.Message));
+    }
+  };
+
+  pqxx::params Params;
+  for (const Entry *Row : Entries) {
+    AppendRow(Params, *Row);
+  }
+  Model->AddRows(Manager, Columns, Entries.size(), Params);
+  if (!Manager->LastQueryFailed()) {
+    m_WrittenCounter.Increment(Entries.size());
+    return;
+  }
+
+  /** @brief one bad row fails the insert, keep the others. */
+  APP_WARNING_LIMITED("OBJECT LOG BATCH FAILED - {} - RETRYING {} ROWS",
+                      Model->GetTableName(), Entries.size());
+  for (const Entry *Row : Entries) {
+    pqxx::params RowParams;
+    AppendRow(RowParams, *Row);
+    Model->AddRows(Manager, Columns, 1, RowParams);
+    if (Manager->LastQueryFailed()) {
+      m_Failed.fetch_add(1, std::memory_order_relaxed);
+      m_FailedCounter.Increment();
+    } else {
+      m_WrittenCounter.Increment();
+    }
+  }
+}
+
+InstanceLogger::InstanceLogger(ObjectLogPipeline &Pipeline,
+                               std::string &&EntityID)
+    : m_Pipeline(Pipeline),
+      m_EntityID(std::make_shared<const std::string>(std::move(EntityID))) {}
+
+InstanceLogger::~InstanceLogger() = default;
+
+void AddressLogger::log(std::string &&data) {
+  log(ObjectLogLevel::Info, std::move(data));
+}
+
+void AddressLogger::log(ObjectLogLevel Level, std::string &&data) {
+  m_Pipeline.Push(ObjectLogTarget::Address, m_EntityID, Level,
+                  std::move(data));
+}
+
+void BusinessLogger::log(std::string &&data) {
+  log(ObjectLogLevel::Info, std::move(data));
+}
+
+void BusinessLogger::log(ObjectLogLevel Level, std::string &&data) {
+  m_Pipeline.Push(ObjectLogTarget::Business, m_EntityID, Level,
+                  std::move(data));
+}
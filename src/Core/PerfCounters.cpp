@@ -0,0 +1,149 @@
+#include "../../inc/Core/PerfCounters.h"
+#include "../../inc/Config/Logger.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef __linux__
+struct EventConfig {
+  uint32_t Type;
+  uint64_t Config;
+};
+
+constexpr std::array<EventConfig, PerfSample::Size> EventConfigs = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+}};
+
+int OpenEvent(const EventConfig &Event, int Leader, bool ExcludeKernel) {
+  perf_event_attr Attributes{};
+  Attributes.size = sizeof(Attributes);
+  Attributes.type = Event.Type;
+  Attributes.config = Event.Config;
+  Attributes.exclude_kernel = ExcludeKernel;
+  Attributes.exclude_hv = 1;
+  Attributes.read_format = PERF_FORMAT_GROUP |
+                           PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &Attributes, 0, -1,
+                                  Leader, PERF_FLAG_FD_CLOEXEC));
+}
+#endif
+
+/** @brief the first thread to find counters missing says why, once. */
+std::atomic<bool> s_Reported{false};
+} // namespace
+
+std::string_view PerfCounters::Name(PerfEvent Event) {
+  switch (Event) {
+  case PerfEvent::Cycles:
+    return "cycles";
+  case PerfEvent::Instructions:
+    return "instructions";
+  case PerfEvent::CacheMisses:
+    return "cache_misses";
+  case PerfEvent::BranchMisses:
+    return "branch_misses";
+  case PerfEvent::ContextSwitches:
+    return "context_switches";
+  case PerfEvent::Count:
+    break;
+  }
+  return "unknown";
+}
+
+PerfCounters &PerfCounters::ForThread() {
+  thread_local PerfCounters t_Counters;
+  return t_Counters;
+}
+
+PerfCounters::PerfCounters() {
+#ifdef __linux__
+  int Error = 0;
+  for (size_t i = 0; i < PerfSample::Size; i++) {
+    const auto Event = static_cast<PerfEvent>(i);
+    /**
+     * @brief a switch happens in the kernel, excluding it would count none.
+     * when kernel events aren't allowed getrusage stands in.
+     */
+    const bool Switches = Event == PerfEvent::ContextSwitches;
+    const int Descriptor = OpenEvent(EventConfigs[i], m_Leader, !Switches);
+    if (Descriptor < 0 && Switches) {
+      m_RusageSwitches = true;
+      m_Available |= 1u << i;
+      continue;
+    }
+    if (Descriptor < 0) {
+      Error = errno;
+      continue;
+    }
+    if (m_Leader < 0) {
+      m_Leader = Descriptor;
+    }
+    m_Descriptors.push_back(Descriptor);
+    m_GroupOrder.push_back(Event);
+    m_Available |= 1u << i;
+  }
+  if (Error != 0 && !s_Reported.exchange(true)) {
+    APP_WARNING("PERF COUNTERS - SOME EVENTS UNAVAILABLE - {}",
+                std::strerror(Error));
+  }
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (int Descriptor : m_Descriptors) {
+    close(Descriptor);
+  }
+#endif
+}
+
+PerfSample PerfCounters::Read() const {
+  PerfSample Sample;
+#ifdef __linux__
+  if (m_Leader >= 0) {
+    /** @brief nr, time enabled, time running, then a value per event. */
+    std::array<uint64_t, 3 + PerfSample::Size> Buffer{};
+    const ssize_t BytesRead = read(m_Leader, Buffer.data(), sizeof(Buffer));
+    const uint64_t Enabled = Buffer[1];
+    const uint64_t Running = Buffer[2];
+    if (BytesRead >= static_cast<ssize_t>(3 * sizeof(uint64_t)) &&
+        Buffer[0] == m_GroupOrder.size() && Running != 0) {
+      const double Scale =
+          static_cast<double>(Enabled) / static_cast<double>(Running);
+      for (size_t i = 0; i < m_GroupOrder.size(); i++) {
+        const auto Index = static_cast<size_t>(m_GroupOrder[i]);
+        Sample.Values[Index] =
+            Running == Enabled
+                ? Buffer[3 + i]
+                : static_cast<uint64_t>(static_cast<double>(Buffer[3 + i]) *
+                                        Scale);
+        Sample.Valid |= 1u << Index;
+      }
+    }
+  }
+  if (m_RusageSwitches) {
+    rusage Usage{};
+    if (getrusage(RUSAGE_THREAD, &Usage) == 0) {
+      const auto Index = static_cast<size_t>(PerfEvent::ContextSwitches);
+      Sample.Values[Index] =
+          static_cast<uint64_t>(Usage.ru_nvcsw + Usage.ru_nivcsw);
+      Sample.Valid |= 1u << Index;
+    }
+  }
+#endif
+  return Sample;
+}
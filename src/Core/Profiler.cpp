@@ -0,0 +1,391 @@
+#include "../../inc/Core/Profiler.h"
+#include "../../inc/Config/Logger.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+std::atomic<bool> Profiler::s_Enabled{false};
+std::atomic<bool> Profiler::s_Tracing{false};
+std::atomic<bool> Profiler::s_Counting{false};
+std::atomic<bool> Profiler::s_UseTsc{false};
+std::atomic<uint64_t> Profiler::s_Epoch{0};
+double Profiler::s_NanosecondsPerTick = 1;
+std::string Profiler::s_TracePath;
+
+std::mutex Profiler::s_Mutex;
+std::map<std::string, std::unique_ptr<ProfileZone>, std::less<>>
+    Profiler::s_Zones;
+std::vector<std::shared_ptr<Profiler::ThreadTrace>> Profiler::s_Traces;
+
+namespace {
+std::string ToMicroseconds(std::chrono::nanoseconds Duration) {
+  return std::to_string(
+             std::chrono::duration_cast<std::chrono::microseconds>(Duration)
+                 .count()) +
+         "us";
+}
+
+/** @brief chrome wants microseconds, kept to the nanosecond. */
+void AppendMicroseconds(std::string &Out, uint64_t Nanoseconds) {
+  const std::string Fraction = std::to_string(Nanoseconds % 1000);
+  Out.append(std::to_string(Nanoseconds / 1000))
+      .append(".")
+      .append(3 - Fraction.size(), '0')
+      .append(Fraction);
+}
+
+void AppendJsonString(std::string &Out, std::string_view Value) {
+  static constexpr char Hex[] = "0123456789abcdef";
+  Out.push_back('"');
+  for (char c : Value) {
+    if (c == '"' || c == '\\') {
+      Out.push_back('\\');
+      Out.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      Out.append("\\u00");
+      Out.push_back(Hex[(c >> 4) & 0xf]);
+      Out.push_back(Hex[c & 0xf]);
+    } else {
+      Out.push_back(c);
+    }
+  }
+  Out.push_back('"');
+}
+} // namespace
+
+size_t ProfileZone::BucketIndex(uint64_t Nanoseconds) {
+  if (Nanoseconds < 4) {
+    return Nanoseconds;
+  }
+  const auto Exponent = static_cast<size_t>(std::bit_width(Nanoseconds) - 1);
+  const size_t Sub = (Nanoseconds >> (Exponent - 2)) & 3;
+  return std::min(4 * (Exponent - 1) + Sub, BucketCount - 1);
+}
+
+uint64_t ProfileZone::BucketUpperBound(size_t Index) {
+  if (Index < 4) {
+    return Index;
+  }
+  const size_t Exponent = Index / 4 + 1;
+  const uint64_t Lower = (4 + Index % 4) << (Exponent - 2);
+  return Lower + (uint64_t{1} << (Exponent - 2)) - 1;
+}
+
+void ProfileZone::Add(uint64_t Nanoseconds) {
+  m_Count.fetch_add(1, std::memory_order_relaxed);
+  m_Total.fetch_add(Nanoseconds, std::memory_order_relaxed);
+  m_Buckets[BucketIndex(Nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+  uint64_t Max = m_Max.load(std::memory_order_relaxed);
+  while (Nanoseconds > Max &&
+         !m_Max.compare_exchange_weak(Max, Nanoseconds,
+                                      std::memory_order_relaxed)) {
+  }
+}
+
+void ProfileZone::AddCounters(const PerfSample &Delta) {
+  for (size_t i = 0; i < PerfSample::Size; i++) {
+    if ((Delta.Valid >> i) & 1) {
+      m_Counters[i].fetch_add(Delta.Values[i], std::memory_order_relaxed);
+      m_CounterRuns[i].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+ProfileZoneStats ProfileZone::GetStats() const {
+  ProfileZoneStats Stats;
+  Stats.Name = m_Name;
+  std::array<uint64_t, BucketCount> Buckets;
+  uint64_t Count = 0;
+  for (size_t i = 0; i < BucketCount; i++) {
+    Buckets[i] = m_Buckets[i].load(std::memory_order_relaxed);
+    Count += Buckets[i];
+  }
+  /** @brief the buckets are the count a concurrent Add agrees with. */
+  Stats.Count = Count;
+  Stats.Total =
+      std::chrono::nanoseconds(m_Total.load(std::memory_order_relaxed));
+  Stats.Max = std::chrono::nanoseconds(m_Max.load(std::memory_order_relaxed));
+  for (size_t i = 0; i < PerfSample::Size; i++) {
+    Stats.CounterRuns[i] = m_CounterRuns[i].load(std::memory_order_relaxed);
+    if (Stats.CounterRuns[i] != 0) {
+      Stats.Counters.Values[i] = m_Counters[i].load(std::memory_order_relaxed);
+      Stats.Counters.Valid |= 1u << i;
+    }
+  }
+  if (Count == 0) {
+    return Stats;
+  }
+  Stats.Mean = Stats.Total / static_cast<int64_t>(Count);
+
+  auto Quantile = [&](double Percentile) {
+    const auto Target = static_cast<uint64_t>(
+        std::max(1.0, static_cast<double>(Count) * Percentile / 100));
+    uint64_t Seen = 0;
+    for (size_t i = 0; i < BucketCount; i++) {
+      Seen += Buckets[i];
+      if (Seen >= Target) {
+        return std::min<std::chrono::nanoseconds>(
+            Stats.Max, std::chrono::nanoseconds(BucketUpperBound(i)));
+      }
+    }
+    return Stats.Max;
+  };
+  Stats.P50 = Quantile(50);
+  Stats.P99 = Quantile(99);
+  return Stats;
+}
+
+void ProfileZone::Reset() {
+  m_Count.store(0, std::memory_order_relaxed);
+  m_Total.store(0, std::memory_order_relaxed);
+  m_Max.store(0, std::memory_order_relaxed);
+  for (auto &Bucket : m_Buckets) {
+    Bucket.store(0, std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < PerfSample::Size; i++) {
+    m_Counters[i].store(0, std::memory_order_relaxed);
+    m_CounterRuns[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void Profiler::Init(const ProfilerOptions &Options) {
+  s_Enabled.store(false, std::memory_order_relaxed);
+  const bool UseTsc = Options.Clock == ProfilerClock::Tsc && CalibrateTsc();
+  if (Options.Clock == ProfilerClock::Tsc && !UseTsc) {
+    APP_WARNING("PROFILER - NO INVARIANT TSC, USING STEADY CLOCK");
+  }
+  s_UseTsc.store(UseTsc, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> Lock(s_Mutex);
+    s_TracePath = Options.TracePath;
+  }
+  Reset();
+  s_Tracing.store(!Options.TracePath.empty(), std::memory_order_relaxed);
+  s_Counting.store(Options.HardwareCounters, std::memory_order_relaxed);
+  if (Options.HardwareCounters && !PerfCounters::ForThread().IsAvailable()) {
+    APP_WARNING("PROFILER - NO HARDWARE COUNTERS, ZONES ARE ONLY TIMED");
+  }
+  s_Enabled.store(Options.Enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::CalibrateTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int Eax = 0, Ebx = 0, Ecx = 0, Edx = 0;
+  if (!__get_cpuid(0x80000007, &Eax, &Ebx, &Ecx, &Edx) ||
+      (Edx & (1u << 8)) == 0) {
+    return false;
+  }
+  using Clock = std::chrono::steady_clock;
+  const auto SteadyBegin = Clock::now();
+  const uint64_t TscBegin = __rdtsc();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const auto SteadyEnd = Clock::now();
+  const uint64_t TscEnd = __rdtsc();
+  if (TscEnd <= TscBegin) {
+    return false;
+  }
+  s_NanosecondsPerTick =
+      static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              SteadyEnd - SteadyBegin)
+                              .count()) /
+      static_cast<double>(TscEnd - TscBegin);
+  return true;
+#else
+  return false;
+#endif
+}
+
+ProfileZone &Profiler::GetZone(std::string_view Name) {
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  auto It = s_Zones.find(Name);
+  if (It == s_Zones.end()) {
+    It = s_Zones
+             .emplace(std::string(Name),
+                      std::make_unique<ProfileZone>(std::string(Name)))
+             .first;
+  }
+  return *It->second;
+}
+
+uint64_t Profiler::Now() {
+#if defined(__x86_64__) || defined(__i386__)
+  if (s_UseTsc.load(std::memory_order_relaxed)) {
+    return __rdtsc();
+  }
+#endif
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+uint64_t Profiler::ToNanoseconds(uint64_t Ticks) {
+  if (!s_UseTsc.load(std::memory_order_relaxed)) {
+    return Ticks;
+  }
+  return static_cast<uint64_t>(static_cast<double>(Ticks) *
+                               s_NanosecondsPerTick);
+}
+
+Profiler::ThreadTrace &Profiler::GetThreadTrace() {
+  /**
+   * @brief shared with s_Traces, a thread's events outlive it until the
+   * trace is written.
+   */
+  thread_local std::shared_ptr<ThreadTrace> t_Trace;
+  if (!t_Trace) {
+    auto Trace = std::make_shared<ThreadTrace>();
+    std::lock_guard<std::mutex> Lock(s_Mutex);
+    Trace->ThreadId = static_cast<uint32_t>(s_Traces.size() + 1);
+    s_Traces.push_back(Trace);
+    t_Trace = std::move(Trace);
+  }
+  return *t_Trace;
+}
+
+void Profiler::Record(ProfileZone &Zone, uint64_t Begin, uint64_t End) {
+  Zone.Add(ToNanoseconds(End > Begin ? End - Begin : 0));
+  if (IsTracing()) {
+    auto &Trace = GetThreadTrace();
+    std::lock_guard<std::mutex> Lock(Trace.Mutex);
+    if (Trace.Events.size() < MaxTraceEvents) {
+      Trace.Events.push_back({&Zone, Begin, End});
+    } else {
+      Trace.Dropped++;
+    }
+  }
+}
+
+std::vector<ProfileZoneStats> Profiler::Snapshot() {
+  std::vector<ProfileZoneStats> Stats;
+  {
+    std::lock_guard<std::mutex> Lock(s_Mutex);
+    for (const auto &[Name, Zone] : s_Zones) {
+      auto ZoneStats = Zone->GetStats();
+      if (ZoneStats.Count != 0) {
+        Stats.push_back(std::move(ZoneStats));
+      }
+    }
+  }
+  std::sort(Stats.begin(), Stats.end(),
+            [](const ProfileZoneStats &Lhs, const ProfileZoneStats &Rhs) {
+              return Lhs.Total > Rhs.Total;
+            });
+  return Stats;
+}
+
+std::string Profiler::Report() {
+  std::string Status;
+  for (const auto &Stats : Snapshot()) {
+    Status.append("count=")
+        .append(std::to_string(Stats.Count))
+        .append(" mean=")
+        .append(ToMicroseconds(Stats.Mean))
+        .append(" p50=")
+        .append(ToMicroseconds(Stats.P50))
+        .append(" p99=")
+        .append(ToMicroseconds(Stats.P99))
+        .append(" max=")
+        .append(ToMicroseconds(Stats.Max))
+        .append(" total=")
+        .append(ToMicroseconds(Stats.Total));
+    for (size_t i = 0; i < PerfSample::Size; i++) {
+      const auto Event = static_cast<PerfEvent>(i);
+      if (Stats.Counters.Has(Event)) {
+        Status.append(" ")
+            .append(PerfCounters::Name(Event))
+            .append("=")
+            .append(std::to_string(
+                static_cast<uint64_t>(Stats.PerRun(Event))));
+      }
+    }
+    if (Stats.Counters.Has(PerfEvent::Cycles) &&
+        Stats.Counters.Has(PerfEvent::Instructions) &&
+        Stats.PerRun(PerfEvent::Cycles) > 0) {
+      const double Ipc = Stats.PerRun(PerfEvent::Instructions) /
+                         Stats.PerRun(PerfEvent::Cycles);
+      Status.append(" ipc=").append(std::to_string(Ipc).substr(0, 4));
+    }
+    Status.append(" ")
+        .append(Stats.Name)
+        .append("\n");
+  }
+  return Status;
+}
+
+std::string Profiler::TraceToJson() {
+  const uint64_t Epoch = s_Epoch.load(std::memory_order_relaxed);
+  std::string Out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool First = true;
+  uint64_t Dropped = 0;
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  for (const auto &Trace : s_Traces) {
+    std::lock_guard<std::mutex> TraceLock(Trace->Mutex);
+    Dropped += Trace->Dropped;
+    for (const auto &Event : Trace->Events) {
+      if (Event.Begin < Epoch) {
+        continue;
+      }
+      if (!First) {
+        Out.push_back(',');
+      }
+      First = false;
+      Out.append("\n{\"name\":");
+      AppendJsonString(Out, Event.Zone->GetName());
+      Out.append(",\"cat\":\"liveview\",\"ph\":\"X\",\"ts\":");
+      AppendMicroseconds(Out, ToNanoseconds(Event.Begin - Epoch));
+      Out.append(",\"dur\":");
+      AppendMicroseconds(Out, ToNanoseconds(Event.End > Event.Begin
+                                                ? Event.End - Event.Begin
+                                                : 0));
+      Out.append(",\"pid\":1,\"tid\":")
+          .append(std::to_string(Trace->ThreadId))
+          .append("}");
+    }
+  }
+  Out.append("\n]}\n");
+  if (Dropped != 0) {
+    APP_WARNING("PROFILER - {} TRACE EVENTS DROPPED, PER THREAD LIMIT {}",
+                Dropped, MaxTraceEvents);
+  }
+  return Out;
+}
+
+bool Profiler::WriteTrace(const std::string &Path) {
+  std::string TracePath = Path;
+  if (TracePath.empty()) {
+    std::lock_guard<std::mutex> Lock(s_Mutex);
+    TracePath = s_TracePath;
+  }
+  if (TracePath.empty()) {
+    return false;
+  }
+  std::ofstream File(TracePath, std::ios::trunc);
+  File << TraceToJson();
+  if (!File) {
+    APP_ERROR("PROFILER - CAN'T WRITE TRACE {}", TracePath);
+    return false;
+  }
+  APP_INFO("PROFILER - TRACE WRITTEN TO {}", TracePath);
+  return true;
+}
+
+void Profiler::Reset() {
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  for (const auto &[Name, Zone] : s_Zones) {
+    Zone->Reset();
+  }
+  for (const auto &Trace : s_Traces) {
+    std::lock_guard<std::mutex> TraceLock(Trace->Mutex);
+    Trace->Events.clear();
+    Trace->Dropped = 0;
+  }
+  s_Epoch.store(Now(), std::memory_order_relaxed);
+}
@@ -2,18 +2,65 @@
 
 template <typename ResType> Response<ResType>::~Response() {}
 
-DBResponse::DBResponse(const pqxx::result &ResponseData)
-    : m_ResponseData{ResponseData}, m_ResponseSize{sizeof(ResponseData)} {
-  APP_INFO("Response Size -> " + std::to_string(m_ResponseSize));
+DBResponse::DBResponse(const pqxx::result &ResponseData,
+                       std::chrono::nanoseconds ExecutionTime, int BackendPid,
+                       bool Failed)
+    : m_ResponseData{ResponseData}, m_ExecutionTime{ExecutionTime},
+      m_BackendPid{BackendPid}, m_Failed{Failed} {
+  Measure();
 }
 
-DBResponse::DBResponse(pqxx::result &&ResponseData)
-    : m_ResponseData{std::move(ResponseData)},
-      m_ResponseSize{sizeof(ResponseData)} {
-  APP_INFO("Response Size -> " + std::to_string(m_ResponseSize));
+DBResponse::DBResponse(pqxx::result &&ResponseData,
+                       std::chrono::nanoseconds ExecutionTime, int BackendPid,
+                       bool Failed)
+    : m_ResponseData{std::move(ResponseData)}, m_ExecutionTime{ExecutionTime},
+      m_BackendPid{BackendPid}, m_Failed{Failed} {
+  Measure();
+}
+
+void DBResponse::Measure() {
+  const auto Begin = std::chrono::steady_clock::now();
+  size_t Bytes = 0;
+  for (const auto &Row : m_ResponseData) {
+    for (const auto &Field : Row) {
+      if (!Field.is_null()) {
+        Bytes += Field.view().size();
+      }
+    }
+  }
+  m_DecodeTime = std::chrono::steady_clock::now() - Begin;
+  m_ResponseSize = Bytes;
+  m_RowCount = static_cast<size_t>(m_ResponseData.size());
+  m_AffectedRows = static_cast<size_t>(m_ResponseData.affected_rows());
+}
+
+std::string DBResponse::Summary() const {
+  auto ToMicroseconds = [](std::chrono::nanoseconds Duration) {
+    return std::to_string(
+               std::chrono::duration_cast<std::chrono::microseconds>(Duration)
+                   .count()) +
+           "us";
+  };
+  std::string Status;
+  Status.append("rows=")
+      .append(std::to_string(m_RowCount))
+      .append(" affected=")
+      .append(std::to_string(m_AffectedRows))
+      .append(" bytes=")
+      .append(std::to_string(m_ResponseSize))
+      .append(" execution=")
+      .append(ToMicroseconds(m_ExecutionTime))
+      .append(" decode=")
+      .append(ToMicroseconds(m_DecodeTime))
+      .append(" backend=")
+      .append(std::to_string(m_BackendPid));
+  if (m_Failed) {
+    Status.append(" failed");
+  }
+  return Status;
 }
 
 void DBResponse::RunBenchmark(std::function<void()> Func) {
-  Benchmark here;
+  Benchmark Run{"DBResponse::RunBenchmark"};
   Func();
 }
\ No newline at end of file
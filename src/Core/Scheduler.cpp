@@ -0,0 +1,333 @@
+#include "../../inc/Core/Scheduler.h"
+#include "../../inc/Config/DatabasePool.h"
+#include "../../inc/Config/Logger.h"
+
+#include <bit>
+
+namespace {
+/** @brief rounds over the other deques before an idle worker sleeps. */
+constexpr int SpinRounds = 32;
+
+struct WorkerContext {
+  const Scheduler *Owner = nullptr;
+  size_t Index = 0;
+};
+
+thread_local WorkerContext t_Worker;
+
+/**
+ * @brief xorshift, where a thief starts looking.
+ */
+size_t NextVictim() {
+  thread_local uint64_t t_Seed =
+      std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+  t_Seed ^= t_Seed << 13;
+  t_Seed ^= t_Seed >> 7;
+  t_Seed ^= t_Seed << 17;
+  return static_cast<size_t>(t_Seed);
+}
+} // namespace
+
+Scheduler::WorkDeque::WorkDeque(size_t Capacity) {
+  m_Buffers.push_back(
+      std::make_unique<Buffer>(std::bit_ceil(std::max<size_t>(Capacity, 2))));
+  m_Buffer.store(m_Buffers.back().get(), std::memory_order_relaxed);
+}
+
+Scheduler::WorkDeque::~WorkDeque() {
+  while (Job *Left = Pop()) {
+    delete Left;
+  }
+}
+
+void Scheduler::WorkDeque::Push(Job *Work) {
+  const int64_t Bottom = m_Bottom.load(std::memory_order_relaxed);
+  const int64_t Top = m_Top.load(std::memory_order_acquire);
+  Buffer *Current = m_Buffer.load(std::memory_order_relaxed);
+  if (Bottom - Top > static_cast<int64_t>(Current->Mask)) {
+    Current = Grow(Current, Top, Bottom);
+  }
+  Current->Put(Bottom, Work);
+  /** @brief a thief acquiring the new bottom sees the job. */
+  m_Bottom.store(Bottom + 1, std::memory_order_release);
+}
+
+Scheduler::Job *Scheduler::WorkDeque::Pop() {
+  const int64_t Bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+  Buffer *Current = m_Buffer.load(std::memory_order_relaxed);
+  m_Bottom.store(Bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t Top = m_Top.load(std::memory_order_relaxed);
+  if (Top > Bottom) {
+    m_Bottom.store(Bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  Job *Work = Current->Get(Bottom);
+  if (Top == Bottom) {
+    /** @brief the last job, a thief may be taking it too. */
+    if (!m_Top.compare_exchange_strong(Top, Top + 1,
+                                       std::memory_order_seq_cst,
+                                       std::memory_order_relaxed)) {
+      Work = nullptr;
+    }
+    m_Bottom.store(Bottom + 1, std::memory_order_relaxed);
+  }
+  return Work;
+}
+
+Scheduler::Job *Scheduler::WorkDeque::Steal() {
+  int64_t Top = m_Top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const int64_t Bottom = m_Bottom.load(std::memory_order_acquire);
+  if (Top >= Bottom) {
+    return nullptr;
+  }
+  Job *Work = m_Buffer.load(std::memory_order_acquire)->Get(Top);
+  if (!m_Top.compare_exchange_strong(Top, Top + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  return Work;
+}
+
+Scheduler::WorkDeque::Buffer *
+Scheduler::WorkDeque::Grow(Buffer *Current, int64_t Top, int64_t Bottom) {
+  auto Grown = std::make_unique<Buffer>((Current->Mask + 1) * 2);
+  for (int64_t i = Top; i < Bottom; i++) {
+    Grown->Put(i, Current->Get(i));
+  }
+  Buffer *Next = Grown.get();
+  m_Buffers.push_back(std::move(Grown));
+  m_Buffer.store(Next, std::memory_order_release);
+  return Next;
+}
+
+Scheduler::Scheduler(const SchedulerOptions &Options) {
+  size_t Threads = Options.Threads;
+  if (Threads == 0) {
+    Threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  m_Workers.reserve(Threads);
+  for (size_t i = 0; i < Threads; i++) {
+    m_Workers.push_back(std::make_unique<Worker>(Options.DequeCapacity));
+  }
+  /** @brief every deque exists before a worker may steal from it. */
+  for (size_t i = 0; i < Threads; i++) {
+    m_Workers[i]->Thread = std::thread([this, i] { Run(i); });
+  }
+  APP_INFO("SCHEDULER STARTED - {} WORKERS", Threads);
+}
+
+Scheduler::~Scheduler() {
+  {
+    std::lock_guard Lock{m_SleepMutex};
+    m_Stopping.store(true);
+    m_Epoch++;
+  }
+  m_SleepCondition.notify_all();
+  for (auto &Current : m_Workers) {
+    if (Current->Thread.joinable()) {
+      Current->Thread.join();
+    }
+  }
+  for (Job *Left : m_Injected) {
+    delete Left;
+  }
+  APP_INFO("SCHEDULER STOPPED");
+}
+
+Scheduler &Scheduler::Global() {
+  static Scheduler s_Global;
+  return s_Global;
+}
+
+bool Scheduler::IsWorkerThread() const { return t_Worker.Owner == this; }
+
+void Scheduler::Submit(Job &&Work) {
+  auto *Queued = new Job(std::move(Work));
+  if (IsWorkerThread()) {
+    m_Workers[t_Worker.Index]->Deque.Push(Queued);
+  } else {
+    std::lock_guard Lock{m_InjectedMutex};
+    m_Injected.push_back(Queued);
+    m_InjectedCount.fetch_add(1, std::memory_order_release);
+  }
+  Wake(false);
+}
+
+bool Scheduler::RunPending() {
+  Job *Work = FindWork();
+  if (Work == nullptr) {
+    return false;
+  }
+  Execute(Work);
+  return true;
+}
+
+Scheduler::Job *Scheduler::FindWork() {
+  const bool Own = IsWorkerThread();
+  if (Own) {
+    if (Job *Work = m_Workers[t_Worker.Index]->Deque.Pop()) {
+      return Work;
+    }
+  }
+  if (m_InjectedCount.load(std::memory_order_acquire) > 0) {
+    std::lock_guard Lock{m_InjectedMutex};
+    if (!m_Injected.empty()) {
+      Job *Work = m_Injected.front();
+      m_Injected.pop_front();
+      m_InjectedCount.fetch_sub(1, std::memory_order_relaxed);
+      return Work;
+    }
+  }
+  const size_t Count = m_Workers.size();
+  const size_t Start = NextVictim();
+  for (size_t i = 0; i < Count; i++) {
+    const size_t Victim = (Start + i) % Count;
+    if (Own && Victim == t_Worker.Index) {
+      continue;
+    }
+    if (Job *Work = m_Workers[Victim]->Deque.Steal()) {
+      if (Own) {
+        m_Workers[t_Worker.Index]->Stolen++;
+      } else {
+        m_StealsCounter.Increment();
+      }
+      return Work;
+    }
+  }
+  return nullptr;
+}
+
+void Scheduler::Execute(Job *Work) {
+  std::unique_ptr<Job> Owned{Work};
+  try {
+    (*Owned)();
+  } catch (const std::exception &e) {
+    APP_ERROR("SCHEDULER JOB ERROR - {}", e.what());
+  } catch (...) {
+    APP_ERROR("SCHEDULER JOB ERROR - UNKNOWN EXCEPTION");
+  }
+  if (IsWorkerThread()) {
+    m_Workers[t_Worker.Index]->Executed++;
+  } else {
+    m_JobsCounter.Increment();
+  }
+}
+
+bool Scheduler::HasWork() const {
+  if (m_InjectedCount.load(std::memory_order_acquire) > 0) {
+    return true;
+  }
+  return std::ranges::any_of(m_Workers, [](const auto &Current) {
+    return !Current->Deque.IsEmpty();
+  });
+}
+
+void Scheduler::Run(size_t Index) {
+  t_Worker = {this, Index};
+  Worker &Self = *m_Workers[Index];
+  while (true) {
+    if (RunPending()) {
+      continue;
+    }
+    bool Found = false;
+    for (int Round = 0; Round < SpinRounds && !Found; Round++) {
+      std::this_thread::yield();
+      Found = RunPending();
+    }
+    if (Found) {
+      continue;
+    }
+    m_JobsCounter.Increment(std::exchange(Self.Executed, 0));
+    m_StealsCounter.Increment(std::exchange(Self.Stolen, 0));
+    if (m_Stopping.load(std::memory_order_acquire) && !HasWork()) {
+      return;
+    }
+    Park(nullptr);
+  }
+}
+
+void Scheduler::Park(const std::atomic<size_t> *Pending) {
+  uint64_t Epoch;
+  {
+    std::lock_guard Lock{m_SleepMutex};
+    Epoch = m_Epoch;
+  }
+  /**
+   * @brief announced before the recheck, a submitter either sees the
+   * sleeper and bumps the epoch or the sleeper sees its job.
+   */
+  m_Sleeping.fetch_add(1, std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const bool Ready =
+      HasWork() || m_Stopping.load(std::memory_order_acquire) ||
+      (Pending != nullptr && Pending->load(std::memory_order_acquire) == 0);
+  if (!Ready) {
+    std::unique_lock Lock{m_SleepMutex};
+    m_SleepCondition.wait(Lock, [&] { return m_Epoch != Epoch; });
+  }
+  m_Sleeping.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Scheduler::Wake(bool All) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_Sleeping.load(std::memory_order_seq_cst) == 0) {
+    return;
+  }
+  {
+    std::lock_guard Lock{m_SleepMutex};
+    m_Epoch++;
+  }
+  if (All) {
+    m_SleepCondition.notify_all();
+  } else {
+    m_SleepCondition.notify_one();
+  }
+}
+
+TaskGroup::TaskGroup(Scheduler &Owner)
+    : m_Scheduler(Owner), m_State(std::make_shared<State>(Owner)) {}
+
+TaskGroup::~TaskGroup() {
+  while (m_State->Pending.load(std::memory_order_acquire) != 0) {
+    if (!m_Scheduler.RunPending()) {
+      m_Scheduler.Park(&m_State->Pending);
+    }
+  }
+}
+
+void TaskGroup::State::Finish() {
+  if (Pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    Owner.Wake(true);
+  }
+}
+
+void TaskGroup::RunWithConnection(DatabasePool &Pool, ConnectionJob &&Work) {
+  m_State->Pending.fetch_add(1, std::memory_order_relaxed);
+  Pool.Borrow([State = m_State, &Pool,
+               Work = std::move(Work)](SharedManager Connection) mutable {
+    State->Owner.Submit([State, &Pool, Work = std::move(Work),
+                         Connection = std::move(Connection)]() mutable {
+      State->Capture([&] { Work(Connection); });
+      Pool.ReturnConnection(Connection);
+      State->Finish();
+    });
+  });
+}
+
+void TaskGroup::Wait() {
+  while (m_State->Pending.load(std::memory_order_acquire) != 0) {
+    if (!m_Scheduler.RunPending()) {
+      m_Scheduler.Park(&m_State->Pending);
+    }
+  }
+  std::exception_ptr Exception;
+  {
+    std::lock_guard Lock{m_State->Mutex};
+    Exception = std::exchange(m_State->Exception, nullptr);
+  }
+  if (Exception) {
+    std::rethrow_exception(Exception);
+  }
+}
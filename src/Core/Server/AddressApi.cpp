@@ -0,0 +1,482 @@
+#include "../../../inc/Core/Server/AddressApi.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <optional>
+#include <random>
+
+namespace {
+/** @brief the columns a request may set, addressid and pluscell are ours. */
+constexpr std::array<std::string_view, 7> AddressFields = {
+    "addressname", "addressnumber", "addresscity", "addressdistrict",
+    "country",     "latitude",      "longitude"};
+constexpr std::array<std::string_view, 3> RequiredFields = {
+    "addressname", "addressnumber", "addresscity"};
+constexpr double DefaultRadius = 1'000;
+constexpr double MaxRadius = 50'000;
+
+/**
+ * @class PooledManager
+ * @brief a connection checked out of the pool for a handler's scope, reads
+ * in the interactive lane and writes in the write one.
+ */
+class PooledManager {
+public:
+  PooledManager(DatabasePool &Pool, CheckoutPriority Priority)
+      : m_Pool(Pool), m_Checkout(Pool.CheckoutConnection(Priority)) {}
+  ~PooledManager() {
+    if (m_Checkout) {
+      m_Pool.ReturnConnection(*m_Checkout);
+    }
+  }
+
+  PooledManager(const PooledManager &) = delete;
+  PooledManager &operator=(const PooledManager &) = delete;
+
+  [[nodiscard]] SharedManager &Get() { return *m_Checkout; }
+
+  /**
+   * @brief answers 503 when the pool shed the checkout, there's no
+   * connection to Get then.
+   */
+  bool Rejected(HttpResponse &Response) {
+    if (m_Checkout) {
+      return false;
+    }
+    Response.Error(503, CheckoutErrorToString(m_Checkout.error()));
+    return true;
+  }
+
+  /**
+   * @brief answers 500 when the last query failed.
+   */
+  bool Failed(HttpResponse &Response) {
+    if (!(*m_Checkout)->LastQueryFailed()) {
+      return false;
+    }
+    Response.Error(500, "query failed");
+    return true;
+  }
+
+private:
+  DatabasePool &m_Pool;
+  DatabasePool::Checkout m_Checkout;
+};
+
+template <typename T> bool ParseNumber(std::string_view Text, T &Value) {
+  auto [End, Error] =
+      std::from_chars(Text.data(), Text.data() + Text.size(), Value);
+  return !Text.empty() && Error == std::errc{} &&
+         End == Text.data() + Text.size();
+}
+
+bool IsUUID(std::string_view Text) {
+  if (Text.size() != 36) {
+    return false;
+  }
+  for (size_t i = 0; i < Text.size(); i++) {
+    const bool Hyphen = i == 8 || i == 13 || i == 18 || i == 23;
+    if (Hyphen ? Text[i] != '-'
+               : !std::isxdigit(static_cast<unsigned char>(Text[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief a random (version 4) uuid, the id is known without reading the
+ * row back.
+ */
+std::string NewUUID() {
+  thread_local std::mt19937_64 t_Generator{std::random_device{}()};
+  std::array<uint8_t, 16> Bytes;
+  for (size_t i = 0; i < Bytes.size(); i += 8) {
+    const uint64_t Random = t_Generator();
+    for (size_t j = 0; j < 8; j++) {
+      Bytes[i + j] = static_cast<uint8_t>(Random >> (j * 8));
+    }
+  }
+  Bytes[6] = static_cast<uint8_t>((Bytes[6] & 0x0f) | 0x40);
+  Bytes[8] = static_cast<uint8_t>((Bytes[8] & 0x3f) | 0x80);
+
+  constexpr std::string_view Digits = "0123456789abcdef";
+  std::string ID;
+  ID.reserve(36);
+  for (size_t i = 0; i < Bytes.size(); i++) {
+    if (i == 4 || i == 6 || i == 8 || i == 10) {
+      ID.push_back('-');
+    }
+    ID.push_back(Digits[Bytes[i] >> 4]);
+    ID.push_back(Digits[Bytes[i] & 0x0f]);
+  }
+  return ID;
+}
+
+std::optional<ObjectLogLevel> ParseLevel(std::string_view Level) {
+  constexpr std::array<std::pair<std::string_view, ObjectLogLevel>, 5>
+      Levels = {{{"debug", ObjectLogLevel::Debug},
+                 {"info", ObjectLogLevel::Info},
+                 {"warn", ObjectLogLevel::Warn},
+                 {"error", ObjectLogLevel::Error},
+                 {"crit", ObjectLogLevel::Crit}}};
+  for (const auto &[Name, Value] : Levels) {
+    if (Level == Name) {
+      return Value;
+    }
+  }
+  return std::nullopt;
+}
+
+Json RowToJson(const pqxx::row &Row) {
+  Json Object = Json::object();
+  for (const auto &Field : Row) {
+    Object[Field.name()] =
+        Field.is_null() ? Json(nullptr) : Json(Field.c_str());
+  }
+  return Object;
+}
+
+Json RowsToJson(const pqxx::result &Result) {
+  Json Rows = Json::array();
+  for (const auto &Row : Result) {
+    Rows.push_back(RowToJson(Row));
+  }
+  return Rows;
+}
+
+/**
+ * @brief the body as a json object, answers 400 when it isn't one.
+ */
+std::optional<Json> ReadObject(const HttpRequest &Request,
+                               HttpResponse &Response) {
+  auto Body =
+      Json::parse(Request.Body.begin(), Request.Body.end(), nullptr, false);
+  if (Body.is_discarded() || !Body.is_object()) {
+    Response.Error(400, "expected a json object");
+    return std::nullopt;
+  }
+  return Body;
+}
+
+/**
+ * @brief the body's address fields as column values, answers 400 on an
+ * unknown field or a value of the wrong type.
+ */
+std::optional<StringUnMap> ReadFields(const HttpRequest &Request,
+                                      HttpResponse &Response) {
+  const auto Body = ReadObject(Request, Response);
+  if (!Body) {
+    return std::nullopt;
+  }
+  StringUnMap Fields;
+  for (const auto &Item : Body->items()) {
+    const auto &Key = Item.key();
+    const auto &Value = Item.value();
+    if (std::find(AddressFields.begin(), AddressFields.end(), Key) ==
+        AddressFields.end()) {
+      Response.Error(400, "unknown field " + Key);
+      return std::nullopt;
+    }
+    bool Valid = Value.is_string();
+    if (Key == "addressnumber") {
+      Valid = Value.is_number_integer();
+    } else if (Key == "latitude" || Key == "longitude") {
+      Valid = Value.is_number();
+    }
+    if (!Valid) {
+      Response.Error(400, "invalid " + Key);
+      return std::nullopt;
+    }
+    Fields[Key] = Value.is_string() ? Value.get<std::string>() : Value.dump();
+  }
+  return Fields;
+}
+
+/**
+ * @brief the request's address id, answers 400 when it isn't a uuid.
+ */
+std::optional<std::string> ReadID(const HttpRequest &Request,
+                                  HttpResponse &Response) {
+  const auto ID = Request.Param(0);
+  if (!IsUUID(ID)) {
+    Response.Error(400, "invalid address id");
+    return std::nullopt;
+  }
+  return std::string(ID);
+}
+} // namespace
+
+AddressApi::AddressApi(DatabasePool &Pool, ObjectLogPipeline &Pipeline)
+    : m_Pool(Pool), m_Pipeline(Pipeline),
+      m_Address(Pool.GetUniqueModelConnection<AddressModel>()),
+      m_AddressLog(Pool.GetUniqueModelConnection<AddressLogModel>()) {}
+
+void AddressApi::Register(HttpServer &Server) {
+  using Member = void (AddressApi::*)(const HttpRequest &, HttpResponse &);
+  auto Bind = [this](Member Callback) {
+    return [this, Callback](const HttpRequest &Request,
+                            HttpResponse &Response) {
+      (this->*Callback)(Request, Response);
+    };
+  };
+  Server.Route(HttpMethod::Get, "/health",
+               [](const HttpRequest &, HttpResponse &Response) {
+                 Response.Body = R"({"status":"ok"})";
+               });
+  Server.Route(HttpMethod::Post, "/addresses", Bind(&AddressApi::AddAddress));
+  Server.Route(HttpMethod::Get, "/addresses", Bind(&AddressApi::FindAddress));
+  /** @brief before "/addresses/{}", routes match in order. */
+  Server.Route(HttpMethod::Get, "/addresses/nearby",
+               Bind(&AddressApi::FindNearby));
+  Server.Route(HttpMethod::Get, "/addresses/{}",
+               Bind(&AddressApi::GetAddress));
+  Server.Route(HttpMethod::Put, "/addresses/{}",
+               Bind(&AddressApi::UpdateAddress));
+  Server.Route(HttpMethod::Patch, "/addresses/{}",
+               Bind(&AddressApi::UpdateAddress));
+  Server.Route(HttpMethod::Delete, "/addresses/{}",
+               Bind(&AddressApi::DeleteAddress));
+  Server.Route(HttpMethod::Get, "/addresses/{}/logs",
+               Bind(&AddressApi::GetAddressLogs));
+  Server.Route(HttpMethod::Post, "/addresses/{}/logs",
+               Bind(&AddressApi::AddAddressLog));
+  Server.Route(HttpMethod::Post, "/logs", Bind(&AddressApi::AddLog));
+}
+
+void AddressApi::AddAddress(const HttpRequest &Request,
+                            HttpResponse &Response) {
+  auto Fields = ReadFields(Request, Response);
+  if (!Fields) {
+    return;
+  }
+  for (std::string_view Required : RequiredFields) {
+    if (!Fields->contains(std::string(Required))) {
+      Response.Error(400, "missing " + std::string(Required));
+      return;
+    }
+  }
+  auto ID = NewUUID();
+  (*Fields)["addressid"] = ID;
+
+  PooledManager Manager{m_Pool, CheckoutPriority::Write};
+  if (Manager.Rejected(Response)) {
+    return;
+  }
+  if (m_Address->Add(Manager.Get(), std::move(*Fields)).affected_rows() ==
+      0) {
+    /** @brief the database failing isn't the client's input. */
+    if (Manager.Failed(Response)) {
+      return;
+    }
+    Response.Error(400, "address rejected");
+    return;
+  }
+  Response.Status = 201;
+  Response.Body = Json{{"addressid", std::move(ID)}}.dump();
+}
+
+void AddressApi::GetAddress(const HttpRequest &Request,
+                            HttpResponse &Response) {
+  const auto ID = ReadID(Request, Response);
+  if (!ID) {
+    return;
+  }
+  PooledManager Manager{m_Pool, CheckoutPriority::Interactive};
+  if (Manager.Rejected(Response)) {
+    return;
+  }
+  auto Result =
+      Manager.Get()->GetModelData(m_Address->GetTableName(), "addressid", *ID);
+  if (Manager.Failed(Response)) {
+    return;
+  }
+  if (Result.empty()) {
+    Response.Error(404, "address not found");
+    return;
+  }
+  Response.Body = RowToJson(Result[0]).dump();
+}
+
+void AddressApi::FindAddress(const HttpRequest &Request,
+                             HttpResponse &Response) {
+  const auto Name = HttpRequest::Decode(Request.QueryParameter("name"));
+  int Number = 0;
+  if (Name.empty() || !ParseNumber(Request.QueryParameter("number"), Number)) {
+    Response.Error(400, "expected name and number");
+    return;
+  }
+  PooledManager Manager{m_Pool, CheckoutPriority::Interactive};
+  if (Manager.Rejected(Response)) {
+    return;
+  }
+  auto Result = Manager.Get()->GetModelDataArgs(
+      m_Address->GetTableName(), "addressname", "addressnumber", Name, Number);
+  if (Manager.Failed(Response)) {
+    return;
+  }
+  Response.Body = RowsToJson(Result).dump();
+}
+
+void AddressApi::FindNearby(const HttpRequest &Request,
+                            HttpResponse &Response) {
+  openlocationcode::LatLng Center{};
+  double Radius = DefaultRadius;
+  const auto RadiusText = Request.QueryParameter("radius");
+  if (!ParseNumber(Request.QueryParameter("latitude"), Center.latitude) ||
+      !ParseNumber(Request.QueryParameter("longitude"), Center.longitude) ||
+      (!RadiusText.empty() && !ParseNumber(RadiusText, Radius)) ||
+      std::abs(Center.latitude) > 90 || std::abs(Center.longitude) > 180 ||
+      Radius <= 0 || Radius > MaxRadius) {
+    Response.Error(400, "expected latitude, longitude and radius");
+    return;
+  }
+  PooledManager Manager{m_Pool, CheckoutPriority::Interactive};
+  if (Manager.Rejected(Response)) {
+    return;
+  }
+  auto Result =
+      m_Address->GetAddressesWithinRadius(Manager.Get(), Center, Radius);
+  if (Manager.Failed(Response)) {
+    return;
+  }
+  Response.Body = RowsToJson(Result).dump();
+}
+
+void AddressApi::UpdateAddress(const HttpRequest &Request,
+                               HttpResponse &Response) {
+  const auto ID = ReadID(Request, Response);
+  if (!ID) {
+    return;
+  }
+  auto Fields = ReadFields(Request, Response);
+  if (!Fields) {
+    return;
+  }
+  if (Fields->empty()) {
+    Response.Error(400, "nothing to update");
+    return;
+  }
+  PooledManager Manager{m_Pool, CheckoutPriority::Write};
+  if (Manager.Rejected(Response)) {
+    return;
+  }
+  auto Result =
+      m_Address->Update(Manager.Get(), std::move(*Fields), "addressid", *ID);
+  if (Manager.Failed(Response)) {
+    return;
+  }
+  if (Result.affected_rows() == 0) {
+    Response.Error(404, "address not found");
+    return;
+  }
+  Response.Status = 204;
+}
+
+void AddressApi::DeleteAddress(const HttpRequest &Request,
+                               HttpResponse &Response) {
+  const auto ID = ReadID(Request, Response);
+  if (!ID) {
+    return;
+  }
+  PooledManager Manager{m_Pool, CheckoutPriority::Write};
+  if (Manager.Rejected(Response)) {
+    return;
+  }
+  auto Result = m_Address->Delete(Manager.Get(), "addressid", *ID);
+  if (Manager.Failed(Response)) {
+    return;
+  }
+  if (Result.affected_rows() == 0) {
+    Response.Error(404, "address not found");
+    return;
+  }
+  Response.Status = 204;
+}
+
+void AddressApi::GetAddressLogs(const HttpRequest &Request,
+                                HttpResponse &Response) {
+  const auto ID = ReadID(Request, Response);
+  if (!ID) {
+    return;
+  }
+  PooledManager Manager{m_Pool, CheckoutPriority::Interactive};
+  if (Manager.Rejected(Response)) {
+    return;
+  }
+  auto Result = Manager.Get()->GetModelData(
+      m_AddressLog->GetModel()->GetTableName(), "addressid", *ID);
+  if (Manager.Failed(Response)) {
+    return;
+  }
+  /** @brief logid orders the entries, a batch shares its timestamp. */
+  std::vector<std::pair<int64_t, Json>> Entries;
+  Entries.reserve(Result.size());
+  for (const auto &Row : Result) {
+    Entries.emplace_back(Row["logid"].as<int64_t>(), RowToJson(Row));
+  }
+  std::sort(Entries.begin(), Entries.end(),
+            [](const auto &Lhs, const auto &Rhs) {
+              return Lhs.first < Rhs.first;
+            });
+  Json Logs = Json::array();
+  for (auto &[LogID, Entry] : Entries) {
+    Logs.push_back(std::move(Entry));
+  }
+  Response.Body = Logs.dump();
+}
+
+void AddressApi::AddAddressLog(const HttpRequest &Request,
+                               HttpResponse &Response) {
+  auto ID = ReadID(Request, Response);
+  if (!ID) {
+    return;
+  }
+  const auto Body = ReadObject(Request, Response);
+  if (!Body) {
+    return;
+  }
+  QueueLog(ObjectLogTarget::Address, std::move(*ID), *Body, Response);
+}
+
+void AddressApi::AddLog(const HttpRequest &Request, HttpResponse &Response) {
+  const auto Body = ReadObject(Request, Response);
+  if (!Body) {
+    return;
+  }
+  const auto Source = Body->find("source");
+  if (Source == Body->end() || !Source->is_string() ||
+      Source->get_ref<const std::string &>().empty()) {
+    Response.Error(400, "expected a source");
+    return;
+  }
+  QueueLog(ObjectLogTarget::Business, Source->get<std::string>(), *Body,
+           Response);
+}
+
+void AddressApi::QueueLog(ObjectLogTarget Target, std::string EntityID,
+                          const Json &Body, HttpResponse &Response) {
+  const auto Message = Body.find("message");
+  const auto LevelName = Body.find("level");
+  std::optional<ObjectLogLevel> Level = ObjectLogLevel::Info;
+  if (LevelName != Body.end()) {
+    Level = LevelName->is_string()
+                ? ParseLevel(LevelName->get_ref<const std::string &>())
+                : std::nullopt;
+  }
+  if (Message == Body.end() || !Message->is_string() || !Level) {
+    Response.Error(400, "expected a message and a level");
+    return;
+  }
+  if (!m_Pipeline.Push(Target,
+                       std::make_shared<const std::string>(std::move(EntityID)),
+                       *Level, Message->get<std::string>())) {
+    Response.Error(503, "log queue full");
+    return;
+  }
+  Response.Status = 202;
+  Response.Body = R"({"queued":true})";
+}
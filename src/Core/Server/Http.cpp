@@ -0,0 +1,253 @@
+#include "../../../inc/Core/Server/Http.h"
+
+#include <algorithm>
+#include <charconv>
+#include <nlohmann/json.hpp>
+
+namespace {
+constexpr std::string_view LineEnd = "\r\n";
+constexpr std::string_view HeadersEnd = "\r\n\r\n";
+
+bool EqualsIgnoreCase(std::string_view Lhs, std::string_view Rhs) {
+  return Lhs.size() == Rhs.size() &&
+         std::equal(Lhs.begin(), Lhs.end(), Rhs.begin(), [](char L, char R) {
+           return (L | 0x20) == (R | 0x20);
+         });
+}
+
+std::string_view Trim(std::string_view Text) {
+  const size_t Start = Text.find_first_not_of(" \t");
+  if (Start == std::string_view::npos) {
+    return {};
+  }
+  return Text.substr(Start, Text.find_last_not_of(" \t") - Start + 1);
+}
+
+HttpMethod ParseMethod(std::string_view Method) {
+  constexpr std::array<std::pair<std::string_view, HttpMethod>, 7> Methods = {
+      {{"GET", HttpMethod::Get},
+       {"HEAD", HttpMethod::Head},
+       {"POST", HttpMethod::Post},
+       {"PUT", HttpMethod::Put},
+       {"PATCH", HttpMethod::Patch},
+       {"DELETE", HttpMethod::Delete},
+       {"OPTIONS", HttpMethod::Options}}};
+  for (const auto &[Name, Value] : Methods) {
+    if (Method == Name) {
+      return Value;
+    }
+  }
+  return HttpMethod::Unknown;
+}
+
+int HexValue(char Character) {
+  if (Character >= '0' && Character <= '9') {
+    return Character - '0';
+  }
+  if ((Character | 0x20) >= 'a' && (Character | 0x20) <= 'f') {
+    return (Character | 0x20) - 'a' + 10;
+  }
+  return -1;
+}
+
+void AppendNumber(std::string &Output, size_t Value) {
+  char Digits[20];
+  auto [End, Error] = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+  Output.append(Digits, End);
+}
+} // namespace
+
+HttpParseStatus HttpRequest::Parse(std::string_view Buffer,
+                                   HttpRequest &Request, size_t &Consumed,
+                                   size_t MaxSize) {
+  const size_t End = Buffer.find(HeadersEnd);
+  if (End == std::string_view::npos) {
+    return Buffer.size() > MaxSize ? HttpParseStatus::TooLarge
+                                   : HttpParseStatus::Incomplete;
+  }
+  if (End + HeadersEnd.size() > MaxSize) {
+    return HttpParseStatus::TooLarge;
+  }
+
+  /** @brief method, target and version, separated by single spaces. */
+  const auto Head = Buffer.substr(0, End);
+  size_t LineLength = Head.find(LineEnd);
+  const auto RequestLine = Head.substr(0, LineLength);
+  const size_t FirstSpace = RequestLine.find(' ');
+  const size_t SecondSpace = RequestLine.find(' ', FirstSpace + 1);
+  if (FirstSpace == std::string_view::npos ||
+      SecondSpace == std::string_view::npos) {
+    return HttpParseStatus::Invalid;
+  }
+  Request.Method = ParseMethod(RequestLine.substr(0, FirstSpace));
+  Request.Target =
+      RequestLine.substr(FirstSpace + 1, SecondSpace - FirstSpace - 1);
+  const auto Version = RequestLine.substr(SecondSpace + 1);
+  if (Request.Target.empty() || Request.Target.front() != '/') {
+    return HttpParseStatus::Invalid;
+  }
+  if (Version == "HTTP/1.1") {
+    Request.KeepAlive = true;
+  } else if (Version == "HTTP/1.0") {
+    Request.KeepAlive = false;
+  } else {
+    return HttpParseStatus::Invalid;
+  }
+  const size_t Question = Request.Target.find('?');
+  Request.Path = Request.Target.substr(0, Question);
+  Request.Query = Question == std::string_view::npos
+                      ? std::string_view{}
+                      : Request.Target.substr(Question + 1);
+
+  Request.HeaderCount = 0;
+  Request.ParamCount = 0;
+  size_t ContentLength = 0;
+  size_t Position =
+      LineLength == std::string_view::npos ? Head.size() : LineLength + 2;
+  while (Position < Head.size()) {
+    LineLength = Head.find(LineEnd, Position);
+    const auto Line = Head.substr(Position, LineLength == std::string_view::npos
+                                                ? std::string_view::npos
+                                                : LineLength - Position);
+    Position = LineLength == std::string_view::npos ? Head.size()
+                                                    : LineLength + 2;
+    const size_t Colon = Line.find(':');
+    if (Colon == 0 || Colon == std::string_view::npos) {
+      return HttpParseStatus::Invalid;
+    }
+    if (Request.HeaderCount == MaxHeaders) {
+      return HttpParseStatus::TooLarge;
+    }
+    auto &Header = Request.Headers[Request.HeaderCount++];
+    Header.Name = Line.substr(0, Colon);
+    Header.Value = Trim(Line.substr(Colon + 1));
+
+    if (EqualsIgnoreCase(Header.Name, "content-length")) {
+      auto [Last, Error] =
+          std::from_chars(Header.Value.data(),
+                          Header.Value.data() + Header.Value.size(),
+                          ContentLength);
+      if (Error != std::errc{} ||
+          Last != Header.Value.data() + Header.Value.size()) {
+        return HttpParseStatus::Invalid;
+      }
+    } else if (EqualsIgnoreCase(Header.Name, "transfer-encoding")) {
+      return HttpParseStatus::Invalid;
+    } else if (EqualsIgnoreCase(Header.Name, "connection")) {
+      if (EqualsIgnoreCase(Header.Value, "close")) {
+        Request.KeepAlive = false;
+      } else if (EqualsIgnoreCase(Header.Value, "keep-alive")) {
+        Request.KeepAlive = true;
+      }
+    }
+  }
+
+  const size_t BodyStart = End + HeadersEnd.size();
+  if (ContentLength > MaxSize - BodyStart) {
+    return HttpParseStatus::TooLarge;
+  }
+  if (Buffer.size() - BodyStart < ContentLength) {
+    return HttpParseStatus::Incomplete;
+  }
+  Request.Body = Buffer.substr(BodyStart, ContentLength);
+  Consumed = BodyStart + ContentLength;
+  return HttpParseStatus::Complete;
+}
+
+std::string HttpRequest::Decode(std::string_view Text) {
+  std::string Decoded;
+  Decoded.reserve(Text.size());
+  for (size_t i = 0; i < Text.size(); i++) {
+    if (Text[i] == '+') {
+      Decoded.push_back(' ');
+    } else if (Text[i] == '%' && i + 2 < Text.size() &&
+               HexValue(Text[i + 1]) >= 0 && HexValue(Text[i + 2]) >= 0) {
+      Decoded.push_back(static_cast<char>(HexValue(Text[i + 1]) * 16 +
+                                          HexValue(Text[i + 2])));
+      i += 2;
+    } else {
+      Decoded.push_back(Text[i]);
+    }
+  }
+  return Decoded;
+}
+
+std::string_view HttpRequest::Header(std::string_view Name) const {
+  for (size_t i = 0; i < HeaderCount; i++) {
+    if (EqualsIgnoreCase(Headers[i].Name, Name)) {
+      return Headers[i].Value;
+    }
+  }
+  return {};
+}
+
+std::string_view HttpRequest::QueryParameter(std::string_view Name) const {
+  auto Remaining = Query;
+  while (!Remaining.empty()) {
+    const size_t Ampersand = Remaining.find('&');
+    const auto Pair = Remaining.substr(0, Ampersand);
+    Remaining = Ampersand == std::string_view::npos
+                    ? std::string_view{}
+                    : Remaining.substr(Ampersand + 1);
+    const size_t Equals = Pair.find('=');
+    if (Pair.substr(0, Equals) == Name) {
+      return Equals == std::string_view::npos ? std::string_view{}
+                                              : Pair.substr(Equals + 1);
+    }
+  }
+  return {};
+}
+
+void HttpResponse::Error(int ErrorStatus, std::string_view Message) {
+  Status = ErrorStatus;
+  ContentType = "application/json";
+  Body = nlohmann::json{{"error", Message}}.dump();
+}
+
+void HttpResponse::AppendTo(std::string &Output, bool KeepAlive,
+                            bool Head) const {
+  Output.append("HTTP/1.1 ");
+  AppendNumber(Output, static_cast<size_t>(Status));
+  Output.append(" ")
+      .append(Reason(Status))
+      .append("\r\nContent-Type: ")
+      .append(ContentType)
+      .append("\r\nContent-Length: ");
+  AppendNumber(Output, Body.size());
+  Output.append(KeepAlive ? "\r\nConnection: keep-alive\r\n\r\n"
+                          : "\r\nConnection: close\r\n\r\n");
+  if (!Head) {
+    Output.append(Body);
+  }
+}
+
+std::string_view HttpResponse::Reason(int Status) {
+  switch (Status) {
+  case 200:
+    return "OK";
+  case 201:
+    return "Created";
+  case 202:
+    return "Accepted";
+  case 204:
+    return "No Content";
+  case 400:
+    return "Bad Request";
+  case 404:
+    return "Not Found";
+  case 405:
+    return "Method Not Allowed";
+  case 408:
+    return "Request Timeout";
+  case 409:
+    return "Conflict";
+  case 413:
+    return "Content Too Large";
+  case 500:
+    return "Internal Server Error";
+  case 503:
+    return "Service Unavailable";
+  default:
+    return "Unknown";
+  }
+}
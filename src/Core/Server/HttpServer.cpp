@@ -0,0 +1,495 @@
+#include "../../../inc/Core/Server/HttpServer.h"
+#include "../../../inc/Config/Logger.h"
+
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+constexpr size_t ReadChunk = 16 * 1024;
+constexpr int MaxEvents = 256;
+/** @brief epoll_wait's timeout, the idle connections are swept as often. */
+constexpr int SweepMilliseconds = 1000;
+/** @brief a closed connection kept for reuse keeps buffers up to this. */
+constexpr size_t KeptCapacity = 64 * 1024;
+constexpr std::string_view AnySegment = "{}";
+} // namespace
+
+/**
+ * @class HttpServer::Loop
+ * @brief one event loop, its listener, its epoll and its connections.
+ * @details connections are level triggered, a connection with a response
+ * left to send waits for EPOLLOUT only, it isn't read (so its pipelined
+ * requests aren't parsed) until the response is out. closed connections
+ * wait in m_Closed until the events polled with them are handled.
+ */
+class HttpServer::Loop {
+public:
+  Loop(const HttpServer &Server, const HttpServerOptions &Options)
+      : m_Server(Server), m_Options(Options) {}
+
+  ~Loop() {
+    for (auto &Current : m_Connections) {
+      close(Current->Socket);
+      m_Server.m_ConnectionsGauge.Add(-1);
+    }
+    for (int Descriptor : {m_Listener, m_Epoll, m_Wakeup}) {
+      if (Descriptor >= 0) {
+        close(Descriptor);
+      }
+    }
+  }
+
+  Loop(const Loop &) = delete;
+  Loop &operator=(const Loop &) = delete;
+
+  /**
+   * @brief listens on the address, a Port of 0 is replaced by the one
+   * picked.
+   */
+  bool Listen(uint16_t &Port) {
+    m_Listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    m_Epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_Wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_Listener < 0 || m_Epoll < 0 || m_Wakeup < 0) {
+      return false;
+    }
+    int Enable = 1;
+    setsockopt(m_Listener, SOL_SOCKET, SO_REUSEADDR, &Enable, sizeof(Enable));
+    setsockopt(m_Listener, SOL_SOCKET, SO_REUSEPORT, &Enable, sizeof(Enable));
+    sockaddr_in Address{};
+    Address.sin_family = AF_INET;
+    Address.sin_port = htons(Port);
+    socklen_t Length = sizeof(Address);
+    if (inet_pton(AF_INET, m_Options.Address.c_str(), &Address.sin_addr) !=
+            1 ||
+        bind(m_Listener, reinterpret_cast<sockaddr *>(&Address), Length) !=
+            0 ||
+        listen(m_Listener, SOMAXCONN) != 0 ||
+        getsockname(m_Listener, reinterpret_cast<sockaddr *>(&Address),
+                    &Length) != 0) {
+      return false;
+    }
+    Port = ntohs(Address.sin_port);
+
+    /** @brief the listener and the wakeup are told apart by their data. */
+    epoll_event Event{};
+    Event.events = EPOLLIN;
+    Event.data.ptr = nullptr;
+    if (epoll_ctl(m_Epoll, EPOLL_CTL_ADD, m_Listener, &Event) != 0) {
+      return false;
+    }
+    Event.data.ptr = &m_Wakeup;
+    return epoll_ctl(m_Epoll, EPOLL_CTL_ADD, m_Wakeup, &Event) == 0;
+  }
+
+  void Run() {
+    std::array<epoll_event, MaxEvents> Events;
+    auto LastSweep = std::chrono::steady_clock::now();
+    while (m_Running.load(std::memory_order_relaxed)) {
+      const int Count =
+          epoll_wait(m_Epoll, Events.data(), MaxEvents, SweepMilliseconds);
+      if (Count < 0 && errno != EINTR) {
+        APP_ERROR("HTTP SERVER - EPOLL WAIT FAILED - {}", errno);
+        break;
+      }
+      for (int i = 0; i < Count; i++) {
+        void *Data = Events[i].data.ptr;
+        if (Data == nullptr) {
+          Accept();
+          continue;
+        }
+        if (Data == &m_Wakeup) {
+          continue;
+        }
+        auto &Current = *static_cast<Connection *>(Data);
+        if (Current.Socket < 0) {
+          continue;
+        }
+        if ((Events[i].events & EPOLLERR) != 0) {
+          Close(Current);
+        } else if (Current.Writing) {
+          Write(Current);
+        } else {
+          Read(Current);
+        }
+      }
+      const auto Now = std::chrono::steady_clock::now();
+      if (Now - LastSweep >= std::chrono::milliseconds(SweepMilliseconds)) {
+        Sweep(Now);
+        LastSweep = Now;
+      }
+      Release();
+    }
+  }
+
+  /**
+   * @brief makes Run return, from another thread.
+   */
+  void Wake() {
+    m_Running.store(false, std::memory_order_relaxed);
+    const uint64_t One = 1;
+    [[maybe_unused]] auto Written = write(m_Wakeup, &One, sizeof(One));
+  }
+
+private:
+  struct Connection {
+    int Socket{-1};
+    /** @brief its place in m_Connections. */
+    size_t Index{0};
+    std::string Input;
+    std::string Output;
+    size_t Sent{0};
+    /** @brief closes once Output is sent. */
+    bool Closing{false};
+    /** @brief waiting for EPOLLOUT. */
+    bool Writing{false};
+    std::chrono::steady_clock::time_point LastActive;
+  };
+
+  void Accept() {
+    while (true) {
+      const int Socket = accept4(m_Listener, nullptr, nullptr,
+                                 SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (Socket < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+          APP_WARNING_LIMITED("HTTP SERVER - ACCEPT FAILED - {}", errno);
+        }
+        return;
+      }
+      if (m_Connections.size() >= m_Options.MaxConnections) {
+        APP_WARNING_LIMITED("HTTP SERVER - CONNECTION LIMIT REACHED");
+        close(Socket);
+        continue;
+      }
+      int Enable = 1;
+      setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, &Enable, sizeof(Enable));
+
+      std::unique_ptr<Connection> Current;
+      if (m_Free.empty()) {
+        Current = std::make_unique<Connection>();
+      } else {
+        Current = std::move(m_Free.back());
+        m_Free.pop_back();
+      }
+      Current->Socket = Socket;
+      Current->Index = m_Connections.size();
+      Current->Sent = 0;
+      Current->Closing = false;
+      Current->Writing = false;
+      Current->LastActive = std::chrono::steady_clock::now();
+
+      epoll_event Event{};
+      Event.events = EPOLLIN | EPOLLRDHUP;
+      Event.data.ptr = Current.get();
+      if (epoll_ctl(m_Epoll, EPOLL_CTL_ADD, Socket, &Event) != 0) {
+        close(Socket);
+        m_Free.push_back(std::move(Current));
+        continue;
+      }
+      m_Connections.push_back(std::move(Current));
+      m_Server.m_ConnectionsGauge.Add(1);
+    }
+  }
+
+  void Read(Connection &Current) {
+    ssize_t Received = 0;
+    const size_t Used = Current.Input.size();
+    Current.Input.resize_and_overwrite(
+        Used + ReadChunk, [&Current, &Received, Used](char *Data, size_t) {
+          Received = recv(Current.Socket, Data + Used, ReadChunk, 0);
+          return Used + static_cast<size_t>(std::max<ssize_t>(Received, 0));
+        });
+    if (Received < 0 &&
+        (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+      return;
+    }
+    if (Received <= 0) {
+      Close(Current);
+      return;
+    }
+    Current.LastActive = std::chrono::steady_clock::now();
+    Process(Current);
+  }
+
+  /**
+   * @brief answers every complete request in Input, then sends.
+   */
+  void Process(Connection &Current) {
+    const std::string_view Input = Current.Input;
+    size_t Offset = 0;
+    while (!Current.Closing) {
+      size_t Consumed = 0;
+      const auto Status =
+          HttpRequest::Parse(Input.substr(Offset), m_Request, Consumed,
+                             m_Options.MaxRequestSize);
+      if (Status == HttpParseStatus::Incomplete) {
+        break;
+      }
+      m_Response.Clear();
+      if (Status != HttpParseStatus::Complete) {
+        if (Status == HttpParseStatus::TooLarge) {
+          m_Response.Error(413, "request too large");
+        } else {
+          m_Response.Error(400, "malformed request");
+        }
+        m_Response.AppendTo(Current.Output, false, false);
+        Current.Closing = true;
+        break;
+      }
+      m_Server.Dispatch(m_Request, m_Response);
+      m_Response.AppendTo(Current.Output, m_Request.KeepAlive,
+                          m_Request.Method == HttpMethod::Head);
+      Current.Closing = !m_Request.KeepAlive;
+      Offset += Consumed;
+    }
+    Current.Input.erase(0, Offset);
+    Write(Current);
+  }
+
+  void Write(Connection &Current) {
+    while (Current.Sent < Current.Output.size()) {
+      const ssize_t Written =
+          send(Current.Socket, Current.Output.data() + Current.Sent,
+               Current.Output.size() - Current.Sent, MSG_NOSIGNAL);
+      if (Written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          Watch(Current, true);
+          return;
+        }
+        Close(Current);
+        return;
+      }
+      Current.Sent += static_cast<size_t>(Written);
+      Current.LastActive = std::chrono::steady_clock::now();
+    }
+    Current.Output.clear();
+    Current.Sent = 0;
+    if (Current.Closing) {
+      Close(Current);
+      return;
+    }
+    Watch(Current, false);
+  }
+
+  /**
+   * @brief waits for EPOLLOUT while there's a response left, EPOLLIN after.
+   */
+  void Watch(Connection &Current, bool Writing) {
+    if (Current.Writing == Writing) {
+      return;
+    }
+    epoll_event Event{};
+    Event.events = Writing ? EPOLLOUT : EPOLLIN | EPOLLRDHUP;
+    Event.data.ptr = &Current;
+    if (epoll_ctl(m_Epoll, EPOLL_CTL_MOD, Current.Socket, &Event) != 0) {
+      Close(Current);
+      return;
+    }
+    Current.Writing = Writing;
+  }
+
+  void Close(Connection &Current) {
+    close(Current.Socket);
+    Current.Socket = -1;
+    m_Server.m_ConnectionsGauge.Add(-1);
+    const size_t Index = Current.Index;
+    std::swap(m_Connections[Index], m_Connections.back());
+    m_Connections[Index]->Index = Index;
+    m_Closed.push_back(std::move(m_Connections.back()));
+    m_Connections.pop_back();
+  }
+
+  void Sweep(std::chrono::steady_clock::time_point Now) {
+    const auto Deadline = Now - m_Options.IdleTimeout;
+    for (size_t i = m_Connections.size(); i-- > 0;) {
+      if (m_Connections[i]->LastActive < Deadline) {
+        Close(*m_Connections[i]);
+      }
+    }
+  }
+
+  /**
+   * @brief keeps the closed connections for the next accepts.
+   */
+  void Release() {
+    for (auto &Current : m_Closed) {
+      for (auto *Buffer : {&Current->Input, &Current->Output}) {
+        Buffer->clear();
+        if (Buffer->capacity() > KeptCapacity) {
+          Buffer->shrink_to_fit();
+        }
+      }
+      m_Free.push_back(std::move(Current));
+    }
+    m_Closed.clear();
+  }
+
+private:
+  const HttpServer &m_Server;
+  const HttpServerOptions &m_Options;
+  int m_Listener{-1};
+  int m_Epoll{-1};
+  int m_Wakeup{-1};
+  std::atomic<bool> m_Running{true};
+  HttpRequest m_Request;
+  HttpResponse m_Response;
+  std::vector<std::unique_ptr<Connection>> m_Connections;
+  std::vector<std::unique_ptr<Connection>> m_Closed;
+  std::vector<std::unique_ptr<Connection>> m_Free;
+};
+
+HttpServer::HttpServer(HttpServerOptions Options)
+    : m_Options(std::move(Options)) {}
+
+HttpServer::~HttpServer() { Stop(); }
+
+void HttpServer::Route(HttpMethod Method, std::string_view Pattern,
+                       Handler Callback) {
+  if (Pattern.empty() || Pattern.front() != '/') {
+    APP_CRITICAL("HTTP SERVER - INVALID ROUTE {}", Pattern);
+    throw std::invalid_argument("Route Pattern Must Start With '/'.");
+  }
+  RouteEntry Entry{Method, {}, std::move(Callback)};
+  Pattern.remove_prefix(1);
+  while (!Pattern.empty()) {
+    const size_t Slash = Pattern.find('/');
+    Entry.Segments.emplace_back(Pattern.substr(0, Slash));
+    Pattern = Slash == std::string_view::npos ? std::string_view{}
+                                              : Pattern.substr(Slash + 1);
+  }
+  m_Routes.push_back(std::move(Entry));
+}
+
+bool HttpServer::Start() {
+  if (!m_Loops.empty()) {
+    return true;
+  }
+  const size_t Threads =
+      m_Options.Threads != 0
+          ? m_Options.Threads
+          : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  uint16_t Port = m_Options.Port;
+  for (size_t i = 0; i < Threads; i++) {
+    auto Current = std::make_unique<Loop>(*this, m_Options);
+    if (!Current->Listen(Port)) {
+      APP_ERROR("HTTP SERVER - CAN'T LISTEN ON {}:{}", m_Options.Address,
+                m_Options.Port);
+      m_Loops.clear();
+      return false;
+    }
+    m_Loops.push_back(std::move(Current));
+  }
+  m_Port = Port;
+
+  const unsigned Cores = std::max(std::thread::hardware_concurrency(), 1U);
+  for (size_t i = 0; i < m_Loops.size(); i++) {
+    m_Threads.emplace_back([this, i, Cores] {
+      if (m_Options.PinThreads) {
+        cpu_set_t Set;
+        CPU_ZERO(&Set);
+        CPU_SET(i % Cores, &Set);
+        pthread_setaffinity_np(pthread_self(), sizeof(Set), &Set);
+      }
+      m_Loops[i]->Run();
+    });
+  }
+  APP_INFO("HTTP SERVER LISTENING - {}:{} - {} LOOPS", m_Options.Address,
+           m_Port, m_Loops.size());
+  return true;
+}
+
+void HttpServer::Stop() {
+  for (auto &Current : m_Loops) {
+    Current->Wake();
+  }
+  for (auto &Thread : m_Threads) {
+    Thread.join();
+  }
+  m_Threads.clear();
+  m_Loops.clear();
+  m_Port = 0;
+}
+
+void HttpServer::Dispatch(HttpRequest &Request, HttpResponse &Response) const {
+  const auto Begin = std::chrono::steady_clock::now();
+  const auto Method =
+      Request.Method == HttpMethod::Head ? HttpMethod::Get : Request.Method;
+  const RouteEntry *Found = nullptr;
+  bool PathMatched = false;
+  for (const auto &Entry : m_Routes) {
+    if (Match(Entry, Request.Path, Request)) {
+      PathMatched = true;
+      if (Entry.Method == Method) {
+        Found = &Entry;
+        break;
+      }
+    }
+  }
+
+  if (Found == nullptr) {
+    if (PathMatched) {
+      Response.Error(405, "method not allowed");
+    } else {
+      Response.Error(404, "not found");
+    }
+  } else {
+    try {
+      Found->Callback(Request, Response);
+    } catch (const std::exception &e) {
+      APP_ERROR_LIMITED("HTTP HANDLER ERROR - {} - {}", Request.Path,
+                        e.what());
+      Response.Error(500, "internal error");
+    }
+  }
+  m_RequestsCounter.Increment();
+  if (Response.Status >= 500) {
+    m_ErrorsCounter.Increment();
+  }
+  m_RequestHistogram.Observe(
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - Begin)
+          .count());
+}
+
+bool HttpServer::Match(const RouteEntry &Entry, std::string_view Path,
+                       HttpRequest &Request) {
+  if (Entry.Segments.empty()) {
+    return Path == "/";
+  }
+  Request.ParamCount = 0;
+  size_t Position = 1;
+  for (const auto &Segment : Entry.Segments) {
+    if (Position > Path.size()) {
+      return false;
+    }
+    const size_t Slash = Path.find('/', Position);
+    const auto Current = Path.substr(Position, Slash == std::string_view::npos
+                                                   ? std::string_view::npos
+                                                   : Slash - Position);
+    if (Segment == AnySegment) {
+      if (Current.empty() || Request.ParamCount == HttpRequest::MaxParams) {
+        return false;
+      }
+      Request.Params[Request.ParamCount++] = Current;
+    } else if (Segment != Current) {
+      return false;
+    }
+    Position = Slash == std::string_view::npos ? Path.size() + 1 : Slash + 1;
+  }
+  return Position > Path.size();
+}
@@ -1,14 +1,17 @@
 #include "../../inc/Models/AddressModel.h"
 
 AddressModel::AddressModel() : m_TableName("Address") {
-  APP_INFO("ADDRESS MODEL RESOURCE CREATED");
+  APP_INFO_LIMITED("ADDRESS MODEL RESOURCE CREATED");
 }
 
 AddressModel::~AddressModel() {
-  APP_CRITICAL("ADDRESS MODEL RESOURCE DESTROYED");
+  APP_CRITICAL_LIMITED("ADDRESS MODEL RESOURCE DESTROYED");
 }
 
 pqxx::result AddressModel::Add(SharedManager &Manager, StringUnMap Fields) {
+  if (!SetPlusCell(Fields)) {
+    return {};
+  }
   // Fields.emplace("addressfull", "USA NewYork....");
   auto Address = Fields["addressname"];
   auto Country = Fields["country"];
@@ -33,4 +36,119 @@ pqxx::result AddressModel::Add(SharedManager &Manager, StringUnMap Fields) {
 Address AddressModel::GetAddressData(SharedManager &Manager,
                                      const std::string &ID) {
   return Address(Manager, ID);
+}
+
+size_t AddressModel::LoadSpatialIndex(SharedManager &Manager,
+                                      SpatialIndex<std::string> &Index) {
+  auto Result = Manager->GetModelData(m_TableName);
+  std::vector<SpatialIndex<std::string>::Entry> Entries;
+  Entries.reserve(Result.size());
+  for (const auto &Row : Result) {
+    if (Row["latitude"].is_null() || Row["longitude"].is_null()) {
+      continue;
+    }
+    Entries.push_back({Row["addressid"].as<std::string>(),
+                       {Row["latitude"].as<double>(),
+                        Row["longitude"].as<double>()}});
+  }
+  Index.BulkLoad(std::move(Entries));
+  APP_INFO("ADDRESS SPATIAL INDEX LOADED: {}", Index.Size());
+  return Index.Size();
+}
+
+pqxx::result
+AddressModel::GetAddressesInBox(SharedManager &Manager,
+                                const openlocationcode::LatLng &SouthWest,
+                                const openlocationcode::LatLng &NorthEast) {
+  openlocationcode::LatLngRect Box(SouthWest, NorthEast);
+  auto Ranges = PlusCellRanges(Box);
+  auto First = std::to_string(2 * Ranges.size() + 1);
+  auto Second = std::to_string(2 * Ranges.size() + 2);
+  auto Third = std::to_string(2 * Ranges.size() + 3);
+  auto Fourth = std::to_string(2 * Ranges.size() + 4);
+
+  /** @brief the cells overshoot the box, the exact bounds filter them. */
+  std::string Condition;
+  Condition.append("latitude between $")
+      .append(First)
+      .append(" and $")
+      .append(Second);
+  double East = Box.hi().longitude;
+  if (Box.is_inverted()) {
+    East -= 360;
+    Condition.append(" and (longitude >= $")
+        .append(Third)
+        .append(" or longitude <= $")
+        .append(Fourth)
+        .append(")");
+  } else {
+    Condition.append(" and longitude between $")
+        .append(Third)
+        .append(" and $")
+        .append(Fourth);
+  }
+  return Manager->GetModelDataInRanges(
+      m_TableName, "pluscell", Ranges, Condition,
+      pqxx::params{Box.lo().latitude, Box.hi().latitude, Box.lo().longitude,
+                   East});
+}
+
+pqxx::result
+AddressModel::GetAddressesWithinRadius(SharedManager &Manager,
+                                       const openlocationcode::LatLng &Center,
+                                       double RadiusMeters) {
+  openlocationcode::Cap Circle(Center, RadiusMeters);
+  auto Ranges = PlusCellRanges(Circle);
+  auto Latitude = std::to_string(2 * Ranges.size() + 1);
+  auto Longitude = std::to_string(2 * Ranges.size() + 2);
+  auto Radius = std::to_string(2 * Ranges.size() + 3);
+
+  /** @brief haversine, like openlocationcode::DistanceMeters. */
+  std::string Condition;
+  Condition.append("2 * ")
+      .append(std::to_string(openlocationcode::kEarthRadiusMeters))
+      .append(" * asin(least(1, sqrt(power(sin(radians(latitude - $")
+      .append(Latitude)
+      .append(") / 2), 2) + cos(radians($")
+      .append(Latitude)
+      .append(")) * cos(radians(latitude)) * power(sin(radians(longitude - $")
+      .append(Longitude)
+      .append(") / 2), 2)))) <= $")
+      .append(Radius);
+  return Manager->GetModelDataInRanges(
+      m_TableName, "pluscell", Ranges, Condition,
+      pqxx::params{Circle.center().latitude, Circle.center().longitude,
+                   RadiusMeters});
+}
+
+bool AddressModel::SetPlusCell(StringUnMap &Fields) {
+  auto Latitude = Fields.find("latitude");
+  auto Longitude = Fields.find("longitude");
+  if (Latitude == Fields.end() || Longitude == Fields.end()) {
+    return true;
+  }
+  try {
+    auto Cell = openlocationcode::CellId::FromLatLng(
+        {std::stod(Latitude->second), std::stod(Longitude->second)},
+        openlocationcode::CellId::kMaxCodeLength);
+    Fields["pluscell"] = std::to_string(static_cast<int64_t>(Cell.id()));
+    return true;
+  } catch (const std::exception &e) {
+    APP_ERROR("ADDRESS COORDINATES ERROR - {}", e.what());
+    return false;
+  }
+}
+
+std::vector<std::pair<int64_t, int64_t>>
+AddressModel::PlusCellRanges(const openlocationcode::Region &Region) {
+  std::vector<std::pair<int64_t, int64_t>> Ranges;
+  for (const auto &Range : openlocationcode::GetRanges(
+           openlocationcode::GetCovering(Region, {.max_cells = 16}))) {
+    /** @brief ids never set bit 63, only the whole globe reaches it. */
+    constexpr auto Max =
+        static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    Ranges.emplace_back(static_cast<int64_t>(std::min(Range.min, Max)),
+                        static_cast<int64_t>(std::min(Range.max, Max)));
+  }
+  return Ranges;
 }
\ No newline at end of file
@@ -2,11 +2,11 @@
 
 BaseLogModel::BaseLogModel(std::string &&TableName)
     : m_TableName(std::move(TableName)) {
-  APP_INFO("LOGGER MODEL RESOURCE CREATED FOR " + m_TableName);
+  APP_INFO_LIMITED("LOGGER MODEL RESOURCE CREATED FOR {}", m_TableName);
 }
 
 BaseLogModel::~BaseLogModel() {
-  APP_CRITICAL("LOGGER MODEL RESOURCE DESTROYED FOR " + m_TableName);
+  APP_CRITICAL_LIMITED("LOGGER MODEL RESOURCE DESTROYED FOR {}", m_TableName);
 }
 
 pqxx::result BaseLogModel::Add(SharedManager &Manager,
@@ -14,6 +14,13 @@ pqxx::result BaseLogModel::Add(SharedManager &Manager,
   return Manager->InsertInto(m_TableName, Fields);
 }
 
+pqxx::result BaseLogModel::AddRows(SharedManager &Manager,
+                                   const std::vector<std::string> &Columns,
+                                   size_t RowCount,
+                                   const pqxx::params &Params) {
+  return Manager->InsertRows(m_TableName, Columns, RowCount, Params);
+}
+
 LogModel::LogModel() : Model(std::make_unique<BaseLogModel>("Log")) {}
 
 AddressLogModel::AddressLogModel()
@@ -14,8 +14,20 @@ Schemes::Schemes() {
       {"addressdistrict",
        DatabaseCommandToString(DatabaseFieldCommands::VarChar100Field)},
       {"country",
-       DatabaseCommandToString(DatabaseFieldCommands::VarChar100Field)}};
+       DatabaseCommandToString(DatabaseFieldCommands::VarChar100Field)},
+      {"latitude",
+       DatabaseCommandToString(DatabaseFieldCommands::DoublePrecisionField)},
+      {"longitude",
+       DatabaseCommandToString(DatabaseFieldCommands::DoublePrecisionField)},
+      {"pluscell",
+       DatabaseCommandToString(DatabaseFieldCommands::BigIntField)}};
   m_Schemes["Address"] = AddressScheme;
+  /**
+   * @brief pluscell holds the packed plus code cell id, proximity queries are
+   * ranges over it.
+   */
+  m_Indexes["Address"] = {"pluscell"};
+  m_Migrations["Address"] = {"latitude", "longitude", "pluscell"};
 
   SchemeMap LogScheme = {
       {"logid",
@@ -28,7 +40,12 @@ Schemes::Schemes() {
        DatabaseCommandToString(DatabaseFieldCommands::VarChar100NotNullField)}};
   m_Schemes["Log"] = LogScheme;
 
+  /**
+   * @brief logid orders an address's entries, a batch shares its timestamp.
+   */
   SchemeMap AddressLogScheme = {
+      {"logid", DatabaseCommandToString(
+                    DatabaseFieldCommands::BigSerialPrimaryKeyField)},
       {"addressid", "uuid"},
       {"", DatabaseCommandToString(DatabaseFieldCommands::FkAddress)},
       {"logtimestamp",
@@ -38,6 +55,7 @@ Schemes::Schemes() {
       {"logmsg",
        DatabaseCommandToString(DatabaseFieldCommands::VarChar100NotNullField)}};
   m_Schemes["AddressLog"] = AddressLogScheme;
+  m_Migrations["AddressLog"] = {"logid"};
 }
 
 Schemes::SchemeMap Schemes::GetSchema(const std::string &ModelName) const {
@@ -2,13 +2,8 @@
 
 /**
  * @attention
- * this acts as the frontend of the application in "swift".
- * in this main function we demonstrate how the backend's api is being held.
- * further tests will be run here.
- * maybe instead of main have a function that starts the threading or dbpool,
- * make it a library. communicate with the swift with grpc? graphql? what to
- * choose?? (probably pool for saving and limiting actions). for now act as a
- * int main() appliaction until we reach that bridge..
+ * the backend talks to the "swift" frontend as a json api over http, see
+ * AddressApi for the endpoints. main serves it until SIGINT or SIGTERM.
  */
 
 int main() {
@@ -20,7 +15,10 @@ int main() {
    */
   std::filesystem::path ConfigPath = "../../configs/config.json";
 
-  Logger::Init(Config::LoggingPathToString(ConfigPath));
+  Logger::Init(Config::LoggingOptions(ConfigPath));
+  Profiler::Init(Config::ProfilingOptions(ConfigPath));
+  QueryPlans::Init(Config::QueryPlanCaptureOptions(ConfigPath));
+  SingleFlight::Init(Config::ReadCoalescingOptions(ConfigPath));
   auto DatabaseConnectionString = Config::DatabaseToString(ConfigPath);
 
   APP_INFO("APP LOGGER INITIALIZED");
@@ -30,53 +28,43 @@ int main() {
   SYSTEM_INFO("SYSTEM INITIALIZED");
 
   /**
-   * @attention
-   * can be set to unique_ptr, but can't create models with it, can
-   * be used for fast managing actions. for modeling, use shared_ptr.
+   * @brief blocked before any thread starts so every thread inherits it,
+   * main waits for the signals itself.
    */
+  sigset_t Signals;
+  sigemptyset(&Signals);
+  sigaddset(&Signals, SIGINT);
+  sigaddset(&Signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &Signals, nullptr);
+
   {
-    Benchmark Here;
+    Benchmark Here{"main"};
+    MetricsExporter Exporter{Config::MetricsExporterOptions(ConfigPath)};
 
-    DatabasePool Pool{std::move(DatabaseConnectionString)};
+    DatabasePool Pool{std::move(DatabaseConnectionString),
+                      DatabasePool::DefaultPoolSize,
+                      Config::PoolCheckoutOptions(ConfigPath)};
 
     Pool.InitModels();
 
-    auto ManagerConnection = Pool.GetManagerConnection();
-
-    auto UniqueAddress = Pool.GetUniqueModelConnection<AddressModel>();
-    auto UniqueAddressLog = Pool.GetUniqueModelConnection<AddressLogModel>();
-    auto UniqueLog = Pool.GetUniqueModelConnection<LogModel>();
-
-    auto Result = UniqueAddress->Add(ManagerConnection,
-                                     {{"addressname", "hamaasdasdasdasd"},
-                                      {"addressnumber", "18"},
-                                      {"addresscity", "holon"},
-                                      {"addressdistrict", "center"},
-                                      {"country", "israel"}});
-
-    auto AddressID = UniqueAddress->GetAddressID(ManagerConnection,
-                                                 "hamaasdasdasdasd", "18");
-
-    /** @brief if used by lvalue, move it to .Add function.  */
-    UniqueAddressLog->GetModel()->Add(
-        ManagerConnection,
-        {{"addressid", AddressID}, {"loglevel", "DEBUG"}, {"logmsg", "test"}});
-
-    UniqueAddress->Update(ManagerConnection, {{"addressname", "holon"}},
-                          "addressnumber", 18);
-    UniqueAddress->Update(ManagerConnection,
-                          {{"addressname", "hn"}, {"addressnumber", "20"}},
-                          "addressnumber", 18);
-    UniqueAddress->Delete(ManagerConnection, "addressnumber", 20);
-
-    ManagerConnection->RemoveModel(
-        UniqueAddressLog->GetModel()->GetTableName());
-    ManagerConnection->RemoveModel(UniqueAddress->GetTableName());
-
-    UniqueLog->GetModel()->Add(
-        ManagerConnection,
-        {{"loglevel", "DEBUG"}, {"logmsg", "Test From Main"}});
+    /** @brief declared before the server, which stops first. */
+    ObjectLogPipeline Pipeline{Pool};
+    AddressApi Api{Pool, Pipeline};
+    HttpServer Server{Config::ServerOptions(ConfigPath)};
+    Api.Register(Server);
+
+    if (Server.Start()) {
+      int Signal = 0;
+      sigwait(&Signals, &Signal);
+      APP_INFO("SIGNAL {} RECEIVED - STOPPING", Signal);
+      Server.Stop();
+    }
+  }
 
-    Pool.ReturnConnection(ManagerConnection);
+  if (Profiler::IsEnabled()) {
+    APP_INFO("PROFILE REPORT\n{}", Profiler::Report());
+    Profiler::WriteTrace();
   }
+  QueryPlans::Shutdown();
+  Logger::Shutdown();
 }
\ No newline at end of file
@@ -0,0 +1,506 @@
+#include "../../inc/Config/AsyncDatabase.h"
+#include "../../inc/Config/DatabaseManager.h"
+#include "../../inc/Config/FlightRecorder.h"
+
+#include <array>
+#include <cerrno>
+#include <stdexcept>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+constexpr size_t MaxEvents = 64;
+/** @brief the eventfd's epoll data, the connections' is their index. */
+constexpr uint64_t WakeupToken = UINT64_MAX;
+
+/**
+ * @brief libpq's messages end with a newline.
+ */
+std::string TrimError(const char *Message) {
+  std::string Error = Message != nullptr ? Message : "";
+  while (!Error.empty() && (Error.back() == '\n' || Error.back() == ' ')) {
+    Error.pop_back();
+  }
+  return Error;
+}
+} // namespace
+
+const char *const *AsyncParams::GetValues() {
+  m_Pointers.clear();
+  for (size_t i = 0; i < m_Values.size(); i++) {
+    m_Pointers.push_back(m_IsNull[i] ? nullptr : m_Values[i].c_str());
+  }
+  return m_Pointers.data();
+}
+
+AsyncResult::AsyncResult(PGresult *Result) : m_Result(Result) {
+  const auto Status = PQresultStatus(Result);
+  if (Result == nullptr || Status == PGRES_BAD_RESPONSE ||
+      Status == PGRES_FATAL_ERROR) {
+    m_Error = TrimError(PQresultErrorMessage(Result));
+    if (m_Error.empty()) {
+      m_Error = "query failed";
+    }
+  }
+}
+
+AsyncResult AsyncResult::Failure(std::string Error) {
+  AsyncResult Result;
+  Result.m_Error = Error.empty() ? "query failed" : std::move(Error);
+  return Result;
+}
+
+std::string_view AsyncResult::GetColumnName(int Column) const {
+  const char *Name = m_Result ? PQfname(m_Result.get(), Column) : nullptr;
+  return Name != nullptr ? std::string_view{Name} : std::string_view{};
+}
+
+int AsyncResult::GetColumnIndex(const std::string &Name) const {
+  return m_Result ? PQfnumber(m_Result.get(), Name.c_str()) : -1;
+}
+
+std::string_view AsyncResult::GetValue(int Row, int Column) const {
+  if (Row < 0 || Row >= GetRowCount() || Column < 0 ||
+      Column >= GetColumnCount()) {
+    return {};
+  }
+  return {PQgetvalue(m_Result.get(), Row, Column),
+          static_cast<size_t>(PQgetlength(m_Result.get(), Row, Column))};
+}
+
+bool AsyncResult::IsNull(int Row, int Column) const {
+  if (Row < 0 || Row >= GetRowCount() || Column < 0 ||
+      Column >= GetColumnCount()) {
+    return true;
+  }
+  return PQgetisnull(m_Result.get(), Row, Column) == 1;
+}
+
+size_t AsyncResult::GetAffectedRows() const {
+  if (!m_Result) {
+    return 0;
+  }
+  const std::string_view Rows = PQcmdTuples(m_Result.get());
+  size_t Count = 0;
+  std::from_chars(Rows.data(), Rows.data() + Rows.size(), Count);
+  return Count;
+}
+
+bool AsyncQuery::await_suspend(std::coroutine_handle<> Awaiting) {
+  if (m_Query.empty()) {
+    return false;
+  }
+  m_Awaiting = Awaiting;
+  if (m_Database.Submit(this)) {
+    /** @brief it may have been resumed already, this is gone. */
+    return true;
+  }
+  m_Result = AsyncResult::Failure("async database stopped");
+  return false;
+}
+
+AsyncDatabase::AsyncDatabase(const std::string &ConnectionString,
+                             int Connections) {
+  if (Connections < 1) {
+    APP_CRITICAL("ASYNC DATABASE - AT LEAST ONE CONNECTION IS NEEDED");
+    throw std::invalid_argument("AsyncDatabase needs a connection.");
+  }
+  m_Epoll = epoll_create1(EPOLL_CLOEXEC);
+  m_Wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  epoll_event Event{};
+  Event.events = EPOLLIN;
+  Event.data.u64 = WakeupToken;
+  if (m_Epoll < 0 || m_Wakeup < 0 ||
+      epoll_ctl(m_Epoll, EPOLL_CTL_ADD, m_Wakeup, &Event) != 0) {
+    APP_CRITICAL("ASYNC DATABASE - EPOLL ERROR - {}", errno);
+    if (m_Epoll >= 0) {
+      close(m_Epoll);
+    }
+    if (m_Wakeup >= 0) {
+      close(m_Wakeup);
+    }
+    throw std::runtime_error("AsyncDatabase could not create its loop.");
+  }
+
+  m_Connections.resize(static_cast<size_t>(Connections));
+  for (size_t i = 0; i < m_Connections.size(); i++) {
+    auto &Current = m_Connections[i];
+    Current.Handle = PQconnectdb(ConnectionString.c_str());
+    if (PQstatus(Current.Handle) == CONNECTION_OK) {
+      Register(i);
+    } else {
+      APP_ERROR("ASYNC DATABASE CONNECTION ERROR - {}",
+                TrimError(PQerrorMessage(Current.Handle)));
+    }
+    m_Free.push_back(i);
+  }
+  m_Loop = std::thread([this] { Run(); });
+  APP_INFO("ASYNC DATABASE CREATED - {} CONNECTIONS", m_Connections.size());
+}
+
+AsyncDatabase::~AsyncDatabase() {
+  {
+    std::lock_guard Lock{m_Mutex};
+    m_Stopping = true;
+  }
+  const uint64_t One = 1;
+  [[maybe_unused]] auto Written = write(m_Wakeup, &One, sizeof(One));
+  if (m_Loop.joinable()) {
+    m_Loop.join();
+  }
+  for (auto &Current : m_Connections) {
+    PQfinish(Current.Handle);
+  }
+  close(m_Wakeup);
+  close(m_Epoll);
+  APP_INFO("ASYNC DATABASE CLOSED");
+}
+
+bool AsyncDatabase::IsDatabaseConnected() const {
+  for (const auto &Current : m_Connections) {
+    if (PQstatus(Current.Handle) != CONNECTION_OK) {
+      return false;
+    }
+  }
+  return true;
+}
+
+AsyncQuery AsyncDatabase::GetModelDataInRanges(
+    const std::string &ModelName, const std::string &FieldName,
+    const std::vector<std::pair<int64_t, int64_t>> &Ranges,
+    std::string_view Condition, const AsyncParams &Params) {
+  AsyncParams Bounds;
+  for (const auto &[Min, Max] : Ranges) {
+    Bounds.Append(Min);
+    Bounds.Append(Max);
+  }
+  if (!Condition.empty()) {
+    Bounds.Append(Params);
+  }
+  return Query(ModelName,
+               Ranges.empty() ? std::string{}
+                              : DatabaseQueries::SelectInRanges(
+                                    ModelName, FieldName, Ranges.size(),
+                                    Condition),
+               std::move(Bounds));
+}
+
+AsyncQuery AsyncDatabase::InsertInto(const std::string &ModelName,
+                                     const StringUnMap &Fields) {
+  AsyncParams Params;
+  for (const auto &[key, value] : Fields) {
+    Params.Append(value);
+  }
+  return Query(ModelName, DatabaseQueries::InsertInto(ModelName, Fields),
+               std::move(Params));
+}
+
+AsyncQuery AsyncDatabase::InsertRows(const std::string &ModelName,
+                                     const std::vector<std::string> &Columns,
+                                     size_t RowCount, AsyncParams Params) {
+  if (Columns.empty() || RowCount == 0) {
+    return Query(ModelName, {});
+  }
+  return Query(ModelName,
+               DatabaseQueries::InsertRows(ModelName, Columns, RowCount),
+               std::move(Params));
+}
+
+bool AsyncDatabase::Submit(AsyncQuery *Pending) {
+  /**
+   * @brief a coroutine the loop resumed, the loop dispatches it once the
+   * coroutine suspends again.
+   */
+  if (std::this_thread::get_id() == m_Loop.get_id()) {
+    m_Waiting.push_back(Pending);
+    return true;
+  }
+  bool Wake = false;
+  {
+    std::lock_guard Lock{m_Mutex};
+    if (m_Stopping) {
+      return false;
+    }
+    Wake = m_Submitted.empty();
+    m_Submitted.push_back(Pending);
+  }
+  if (Wake) {
+    const uint64_t One = 1;
+    [[maybe_unused]] auto Written = write(m_Wakeup, &One, sizeof(One));
+  }
+  return true;
+}
+
+void AsyncDatabase::Run() {
+  std::array<epoll_event, MaxEvents> Events;
+  while (true) {
+    const int Ready = epoll_wait(m_Epoll, Events.data(), MaxEvents, -1);
+    if (Ready < 0 && errno != EINTR) {
+      APP_CRITICAL("ASYNC DATABASE - EPOLL WAIT ERROR - {}", errno);
+      return;
+    }
+    for (int i = 0; i < Ready; i++) {
+      const uint64_t Token = Events[i].data.u64;
+      if (Token == WakeupToken) {
+        uint64_t Count;
+        [[maybe_unused]] auto Read = read(m_Wakeup, &Count, sizeof(Count));
+        std::lock_guard Lock{m_Mutex};
+        m_Waiting.insert(m_Waiting.end(), m_Submitted.begin(),
+                         m_Submitted.end());
+        m_Submitted.clear();
+        continue;
+      }
+      const auto Index = static_cast<size_t>(Token);
+      if (m_Connections[Index].Resetting) {
+        PollReset(Index);
+        continue;
+      }
+      if ((Events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0) {
+        Read(Index);
+      }
+      /**
+       * @brief libpq may need the input read before it can send more, a
+       * writing connection flushes again on either.
+       */
+      if (m_Connections[Index].Writing) {
+        Flush(Index);
+      }
+    }
+    Dispatch();
+
+    std::lock_guard Lock{m_Mutex};
+    if (m_Stopping && m_Submitted.empty() && m_Waiting.empty() &&
+        m_Running == 0) {
+      return;
+    }
+  }
+}
+
+void AsyncDatabase::Register(size_t Index) {
+  auto &Current = m_Connections[Index];
+  PQsetnonblocking(Current.Handle, 1);
+  Current.Socket = PQsocket(Current.Handle);
+  Current.Writing = false;
+  epoll_event Event{};
+  Event.events = EPOLLIN;
+  Event.data.u64 = Index;
+  if (Current.Socket < 0 ||
+      epoll_ctl(m_Epoll, EPOLL_CTL_ADD, Current.Socket, &Event) != 0) {
+    APP_ERROR("ASYNC DATABASE - SOCKET REGISTER ERROR - {}", errno);
+    Current.Socket = -1;
+  }
+}
+
+void AsyncDatabase::Watch(size_t Index, bool Writing) {
+  auto &Current = m_Connections[Index];
+  Current.Writing = Writing;
+  epoll_event Event{};
+  Event.events = EPOLLIN | (Writing ? EPOLLOUT : 0U);
+  Event.data.u64 = Index;
+  epoll_ctl(m_Epoll, EPOLL_CTL_MOD, Current.Socket, &Event);
+}
+
+void AsyncDatabase::Dispatch() {
+  while (!m_Free.empty() && !m_Waiting.empty()) {
+    const size_t Index = m_Free.back();
+    m_Free.pop_back();
+    AsyncQuery *Pending = m_Waiting.front();
+    m_Waiting.pop_front();
+    Send(Index, Pending);
+  }
+}
+
+void AsyncDatabase::Send(size_t Index, AsyncQuery *Pending) {
+  auto &Current = m_Connections[Index];
+  Current.Running = Pending;
+  m_Running++;
+  m_InFlight.Add(1);
+  Pending->m_Begin = std::chrono::steady_clock::now();
+  Pending->m_QueryHash = std::hash<std::string>{}(Pending->m_Query);
+  Pending->m_FlightBegin =
+      FlightRecorder::Record(FlightEvent::QueryBegin, Pending->m_QueryHash);
+
+  if (PQstatus(Current.Handle) != CONNECTION_OK || Current.Socket < 0) {
+    Reset(Index);
+    if (!Current.Resetting) {
+      Fail(Index, "RESET");
+    }
+    /** @brief the statement goes out once the reset ends. */
+    return;
+  }
+  Transmit(Index);
+}
+
+void AsyncDatabase::Transmit(size_t Index) {
+  auto &Current = m_Connections[Index];
+  AsyncQuery *Pending = Current.Running;
+  if (PQsendQueryParams(Current.Handle, Pending->m_Query.c_str(),
+                        static_cast<int>(Pending->m_Params.Size()), nullptr,
+                        Pending->m_Params.GetValues(), nullptr, nullptr,
+                        0) == 0) {
+    Fail(Index, "SEND");
+    return;
+  }
+  Flush(Index);
+}
+
+void AsyncDatabase::Flush(size_t Index) {
+  auto &Current = m_Connections[Index];
+  const int Flushed = PQflush(Current.Handle);
+  if (Flushed < 0) {
+    Fail(Index, "FLUSH");
+    return;
+  }
+  if ((Flushed == 1) != Current.Writing) {
+    Watch(Index, Flushed == 1);
+  }
+}
+
+void AsyncDatabase::Read(size_t Index) {
+  auto &Current = m_Connections[Index];
+  if (PQconsumeInput(Current.Handle) == 0) {
+    Fail(Index, "READ");
+    return;
+  }
+  while (PQisBusy(Current.Handle) == 0) {
+    PGresult *Result = PQgetResult(Current.Handle);
+    if (Result == nullptr) {
+      if (Current.Running != nullptr) {
+        Complete(Index);
+      }
+      return;
+    }
+    /** @brief one statement, the first error wins over what follows it. */
+    if (Current.Running != nullptr && !Current.Running->m_Result.IsFailed()) {
+      Current.Running->m_Result = AsyncResult{Result};
+    } else {
+      PQclear(Result);
+    }
+  }
+}
+
+void AsyncDatabase::Complete(size_t Index) {
+  auto &Current = m_Connections[Index];
+  AsyncQuery *Finished = std::exchange(Current.Running, nullptr);
+  if (Current.Writing) {
+    Watch(Index, false);
+  }
+  if (!Current.Resetting) {
+    m_Free.push_back(Index);
+  }
+  m_Running--;
+  m_InFlight.Add(-1);
+
+  const auto Elapsed = std::chrono::steady_clock::now() - Finished->m_Begin;
+  const bool Failed = Finished->m_Result.IsFailed();
+  if (Failed) {
+    FlightRecorder::Record(FlightEvent::QueryError, Finished->m_QueryHash);
+    APP_ERROR_LIMITED("ASYNC QUERY ERROR AT TABLE - {} {}",
+                      Finished->m_TableName, Finished->m_Result.GetError());
+  } else {
+    FlightRecorder::Record(FlightEvent::QueryEnd, Finished->m_QueryHash,
+                           FlightRecorder::Now() - Finished->m_FlightBegin);
+  }
+  DatabaseManager::RecordQuery(Finished->m_TableName, Finished->m_Query,
+                               Elapsed, Failed);
+  /** @brief the query lives in the coroutine's frame, last use of it. */
+  Finished->m_Awaiting.resume();
+}
+
+void AsyncDatabase::Fail(size_t Index, std::string_view Where) {
+  auto &Current = m_Connections[Index];
+  std::string Error = TrimError(PQerrorMessage(Current.Handle));
+  /** @brief without a socket it wasn't up, it broke in a reset. */
+  if (Current.Socket >= 0 && PQstatus(Current.Handle) != CONNECTION_OK) {
+    Reset(Index);
+  }
+  if (Current.Running == nullptr) {
+    /** @brief an idle connection is among the free ones. */
+    if (Current.Resetting) {
+      std::erase(m_Free, Index);
+    }
+    APP_ERROR_LIMITED("ASYNC DATABASE {} ERROR - {}", Where, Error);
+    return;
+  }
+  Current.Running->m_Result = AsyncResult::Failure(std::move(Error));
+  Complete(Index);
+}
+
+void AsyncDatabase::Reset(size_t Index) {
+  auto &Current = m_Connections[Index];
+  if (Current.Socket >= 0) {
+    epoll_ctl(m_Epoll, EPOLL_CTL_DEL, Current.Socket, nullptr);
+    Current.Socket = -1;
+  }
+  Current.Writing = false;
+  if (PQresetStart(Current.Handle) == 0) {
+    APP_ERROR_LIMITED("ASYNC DATABASE CONNECTION RESET ERROR - {}",
+                      TrimError(PQerrorMessage(Current.Handle)));
+    return;
+  }
+  /** @brief libpq starts as if the last poll asked to write. */
+  Current.Resetting = WatchReset(Index, true);
+  if (!Current.Resetting) {
+    APP_ERROR_LIMITED("ASYNC DATABASE - RESET SOCKET REGISTER ERROR - {}",
+                      errno);
+  }
+}
+
+void AsyncDatabase::PollReset(size_t Index) {
+  const auto Status = PQresetPoll(m_Connections[Index].Handle);
+  if (Status == PGRES_POLLING_READING || Status == PGRES_POLLING_WRITING) {
+    if (!WatchReset(Index, Status == PGRES_POLLING_WRITING)) {
+      APP_ERROR_LIMITED("ASYNC DATABASE - RESET SOCKET REGISTER ERROR - {}",
+                        errno);
+      EndReset(Index, false);
+    }
+    return;
+  }
+  EndReset(Index, Status == PGRES_POLLING_OK);
+}
+
+bool AsyncDatabase::WatchReset(size_t Index, bool Writing) {
+  auto &Current = m_Connections[Index];
+  /**
+   * @brief the old socket may be closed and its number reused, it is
+   * removed and the current one added every time.
+   */
+  if (Current.Socket >= 0) {
+    epoll_ctl(m_Epoll, EPOLL_CTL_DEL, Current.Socket, nullptr);
+  }
+  Current.Socket = PQsocket(Current.Handle);
+  epoll_event Event{};
+  Event.events = Writing ? EPOLLOUT : EPOLLIN;
+  Event.data.u64 = Index;
+  if (Current.Socket < 0 ||
+      epoll_ctl(m_Epoll, EPOLL_CTL_ADD, Current.Socket, &Event) != 0) {
+    Current.Socket = -1;
+    return false;
+  }
+  return true;
+}
+
+void AsyncDatabase::EndReset(size_t Index, bool Connected) {
+  auto &Current = m_Connections[Index];
+  Current.Resetting = false;
+  if (Current.Socket >= 0) {
+    epoll_ctl(m_Epoll, EPOLL_CTL_DEL, Current.Socket, nullptr);
+    Current.Socket = -1;
+  }
+  if (Connected) {
+    APP_WARNING_LIMITED("ASYNC DATABASE CONNECTION RESET");
+    Register(Index);
+  } else {
+    APP_ERROR_LIMITED("ASYNC DATABASE CONNECTION RESET ERROR - {}",
+                      TrimError(PQerrorMessage(Current.Handle)));
+  }
+  if (Current.Running == nullptr) {
+    m_Free.push_back(Index);
+  } else if (Current.Socket < 0) {
+    Fail(Index, "RESET");
+  } else {
+    Transmit(Index);
+  }
+}
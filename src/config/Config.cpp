@@ -37,7 +37,7 @@ std::string Config::DatabaseToString(const std::filesystem::path &Path) {
         .append(JsonData["DATABASE"]["dbname"]);
     return Data;
   } catch (const Json::exception &e) {
-    SYSTEM_ERROR("CONFIG FILE ERROR - DATABASE - " + std::string(e.what()));
+    SYSTEM_ERROR("CONFIG FILE ERROR - DATABASE - {}", e.what());
     return "";
   }
 }
@@ -62,8 +62,7 @@ std::string Config::TestDatabaseToString(const std::filesystem::path &Path) {
         .append(JsonData["TEST_DATABASE"]["dbname"]);
     return Data;
   } catch (const Json::exception &e) {
-    SYSTEM_ERROR("CONFIG FILE ERROR - TEST_DATABASE - " +
-                 std::string(e.what()));
+    SYSTEM_ERROR("CONFIG FILE ERROR - TEST_DATABASE - {}", e.what());
     return "";
   }
 }
@@ -77,4 +76,149 @@ std::string Config::LoggingPathToString(const std::filesystem::path &Path) {
     std::cerr << "FILE ERROR AT LOG PATH FUNCTION - " << e.what();
     return "";
   }
-}
\ No newline at end of file
+}
+
+LoggerOptions Config::LoggingOptions(const std::filesystem::path &Path) {
+  auto JsonData = ReadFile(Path);
+  LoggerOptions Options;
+  try {
+    const auto &Logging = JsonData.at("LOGGING");
+    Options.Path = Logging.value("path", Options.Path);
+    Options.Async = Logging.value("async", Options.Async);
+    Options.QueueSize = Logging.value("queue_size", Options.QueueSize);
+    Options.ThreadCount = Logging.value("threads", Options.ThreadCount);
+    Options.Overflow = Logging.value("overflow", std::string("block")) == "drop"
+                           ? LogOverflowPolicy::Drop
+                           : LogOverflowPolicy::Block;
+    Options.FlushInterval = std::chrono::seconds(Logging.value(
+        "flush_interval_seconds", Options.FlushInterval.count()));
+    Options.FlightDumps = Logging.value("flight_dumps", Options.FlightDumps);
+    Options.SlowQueryThreshold = std::chrono::milliseconds(
+        Logging.value("slow_query_ms", Options.SlowQueryThreshold.count()));
+    if (Logging.contains("flush_level")) {
+      Options.FlushLevel = spdlog::level::from_str(
+          Logging["flush_level"].get<std::string>());
+    }
+    return Options;
+  } catch (const Json::exception &e) {
+    std::cerr << "FILE ERROR AT LOGGING OPTIONS FUNCTION - " << e.what();
+    return Options;
+  }
+}
+
+MetricsOptions
+Config::MetricsExporterOptions(const std::filesystem::path &Path) {
+  auto JsonData = ReadFile(Path);
+  MetricsOptions Options;
+  try {
+    const auto &Section = JsonData.at("METRICS");
+    Options.Path = Section.value("path", Options.Path);
+    Options.Interval = std::chrono::seconds(
+        Section.value("interval_seconds", Options.Interval.count()));
+    Options.Port = Section.value("port", Options.Port);
+    return Options;
+  } catch (const Json::exception &e) {
+    std::cerr << "FILE ERROR AT METRICS OPTIONS FUNCTION - " << e.what();
+    return Options;
+  }
+}
+
+ProfilerOptions Config::ProfilingOptions(const std::filesystem::path &Path) {
+  auto JsonData = ReadFile(Path);
+  ProfilerOptions Options;
+  try {
+    const auto &Profiling = JsonData.at("PROFILING");
+    Options.Enabled = Profiling.value("enabled", Options.Enabled);
+    Options.TracePath = Profiling.value("trace_path", Options.TracePath);
+    Options.Clock = Profiling.value("clock", std::string("steady")) == "tsc"
+                        ? ProfilerClock::Tsc
+                        : ProfilerClock::Steady;
+    Options.HardwareCounters =
+        Profiling.value("hardware_counters", Options.HardwareCounters);
+    return Options;
+  } catch (const Json::exception &e) {
+    std::cerr << "FILE ERROR AT PROFILING OPTIONS FUNCTION - " << e.what();
+    return Options;
+  }
+}
+
+QueryPlanOptions
+Config::QueryPlanCaptureOptions(const std::filesystem::path &Path) {
+  auto JsonData = ReadFile(Path);
+  QueryPlanOptions Options;
+  try {
+    const auto &Section = JsonData.at("QUERY_PLANS");
+    Options.Threshold =
+        std::chrono::milliseconds(Section.value("threshold_ms", int64_t{0}));
+    Options.SampleRate = Section.value("sample_rate", Options.SampleRate);
+    Options.MaxPlans = Section.value("max_plans", Options.MaxPlans);
+    Options.RecaptureInterval = std::chrono::seconds(Section.value(
+        "recapture_seconds", Options.RecaptureInterval.count()));
+    Options.Timeout = std::chrono::milliseconds(
+        Section.value("timeout_ms", Options.Timeout.count()));
+    return Options;
+  } catch (const Json::exception &e) {
+    std::cerr << "FILE ERROR AT QUERY PLANS OPTIONS FUNCTION - " << e.what();
+    return Options;
+  }
+}
+
+SingleFlightOptions
+Config::ReadCoalescingOptions(const std::filesystem::path &Path) {
+  auto JsonData = ReadFile(Path);
+  SingleFlightOptions Options;
+  try {
+    const auto &Section = JsonData.at("SINGLE_FLIGHT");
+    Options.Enabled = Section.value("enabled", Options.Enabled);
+    return Options;
+  } catch (const Json::exception &e) {
+    std::cerr << "FILE ERROR AT SINGLE FLIGHT OPTIONS FUNCTION - " << e.what();
+    return Options;
+  }
+}
+
+CheckoutOptions Config::PoolCheckoutOptions(const std::filesystem::path &Path) {
+  auto JsonData = ReadFile(Path);
+  CheckoutOptions Options;
+  try {
+    const auto &Section = JsonData.at("POOL");
+    constexpr std::array<const char *, DatabasePool::Lanes> Names = {
+        "interactive", "write", "background"};
+    for (size_t Lane = 0; Lane < DatabasePool::Lanes; Lane++) {
+      if (!Section.contains(Names[Lane])) {
+        continue;
+      }
+      const auto &Current = Section.at(Names[Lane]);
+      auto &Limits = Options.Lanes[Lane];
+      Limits.MaxQueued = Current.value("max_queued", Limits.MaxQueued);
+      Limits.MaxWait = std::chrono::milliseconds(
+          Current.value("max_wait_ms", Limits.MaxWait.count()));
+    }
+    return Options;
+  } catch (const Json::exception &e) {
+    std::cerr << "FILE ERROR AT POOL OPTIONS FUNCTION - " << e.what();
+    return Options;
+  }
+}
+
+HttpServerOptions Config::ServerOptions(const std::filesystem::path &Path) {
+  auto JsonData = ReadFile(Path);
+  HttpServerOptions Options;
+  try {
+    const auto &Section = JsonData.at("SERVER");
+    Options.Address = Section.value("address", Options.Address);
+    Options.Port = Section.value("port", Options.Port);
+    Options.Threads = Section.value("threads", Options.Threads);
+    Options.PinThreads = Section.value("pin_threads", Options.PinThreads);
+    Options.MaxRequestSize =
+        Section.value("max_request_bytes", Options.MaxRequestSize);
+    Options.MaxConnections =
+        Section.value("max_connections", Options.MaxConnections);
+    Options.IdleTimeout = std::chrono::seconds(Section.value(
+        "idle_timeout_seconds", Options.IdleTimeout.count()));
+    return Options;
+  } catch (const Json::exception &e) {
+    std::cerr << "FILE ERROR AT SERVER OPTIONS FUNCTION - " << e.what();
+    return Options;
+  }
+}
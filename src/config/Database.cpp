@@ -1,4 +1,5 @@
 #include "../../inc/Config/Database.h"
+#include "../../inc/Core/Profiler.h"
 
 DatabaseConnection::DatabaseConnection(
     const std::string &ConnectionString) noexcept
@@ -13,31 +14,54 @@ DatabaseConnection::~DatabaseConnection() {
 }
 
 pqxx::result DatabaseConnection::CrQuery(const std::string &Query) {
+  PROFILE_ZONE("DatabaseConnection::CrQuery");
+  m_LastQueryFailed = true;
+  m_LastQueryTime = std::chrono::nanoseconds(0);
   if (!IsDatabaseConnected()) {
-    APP_ERROR("CRQUERY - QUERY ERROR - DATABASE CONNECTION ERROR");
+    APP_ERROR_LIMITED("CRQUERY - QUERY ERROR - DATABASE CONNECTION ERROR");
     return {};
   }
+  const uint64_t QueryHash = std::hash<std::string>{}(Query);
+  const int64_t Begin =
+      FlightRecorder::Record(FlightEvent::QueryBegin, QueryHash);
   try {
-    return m_DatabaseNonTransaction.exec(Query);
+    auto Result = m_DatabaseNonTransaction.exec(Query);
+    const int64_t Elapsed = FlightRecorder::Now() - Begin;
+    FlightRecorder::Record(FlightEvent::QueryEnd, QueryHash, Elapsed);
+    m_LastQueryTime = std::chrono::nanoseconds(Elapsed);
+    m_LastQueryFailed = false;
+    return Result;
   } catch (const std::exception &e) {
-    APP_ERROR("CRQUERY - QUERY EXECUTION ERROR - " + std::string(e.what()));
+    FlightRecorder::Record(FlightEvent::QueryError, QueryHash);
+    APP_ERROR_LIMITED("CRQUERY - QUERY EXECUTION ERROR - {}", e.what());
     return {};
   }
 }
 
 pqxx::result DatabaseConnection::WQuery(const std::string &Query) {
+  PROFILE_ZONE("DatabaseConnection::WQuery");
+  m_LastQueryFailed = true;
+  m_LastQueryTime = std::chrono::nanoseconds(0);
   if (!IsDatabaseConnected()) {
-    APP_ERROR("WRQUERY - QUERY ERROR - DATABASE CONNECTION ERROR");
+    APP_ERROR_LIMITED("WRQUERY - QUERY ERROR - DATABASE CONNECTION ERROR");
     return {};
   }
+  const uint64_t QueryHash = std::hash<std::string>{}(Query);
+  const int64_t Begin =
+      FlightRecorder::Record(FlightEvent::QueryBegin, QueryHash);
   DatabaseTransaction Transaction{m_DatabaseConnection};
   try {
     auto Result = Transaction.exec(Query);
     Transaction.commit();
+    const int64_t Elapsed = FlightRecorder::Now() - Begin;
+    FlightRecorder::Record(FlightEvent::QueryEnd, QueryHash, Elapsed);
+    m_LastQueryTime = std::chrono::nanoseconds(Elapsed);
+    m_LastQueryFailed = false;
     return Result;
   } catch (const std::exception &e) {
     Transaction.abort();
-    APP_ERROR("WQUERY - QUERY EXECUTION ERROR - " + std::string(e.what()));
+    FlightRecorder::Record(FlightEvent::QueryError, QueryHash);
+    APP_ERROR_LIMITED("WQUERY - QUERY EXECUTION ERROR - {}", e.what());
     return {};
   }
 }
\ No newline at end of file
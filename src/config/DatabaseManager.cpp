@@ -1,4 +1,58 @@
 #include "../../inc/Config/DatabaseManager.h"
+#include "../../inc/Core/Metrics/Metrics.h"
+#include "../../inc/Core/Profiler.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+struct QueryMetrics {
+  std::string_view Operation;
+  Histogram &Duration;
+  Counter &Errors;
+};
+
+/**
+ * @brief the metrics of the statement's operation, its first word. the
+ * operations are fixed up front, looking one up never locks.
+ */
+const QueryMetrics &GetQueryMetrics(std::string_view Query) {
+  static const std::vector<QueryMetrics> All = [] {
+    std::vector<QueryMetrics> Operations;
+    for (std::string_view Operation :
+         {"select", "insert", "update", "delete", "create", "alter", "drop",
+          "truncate", "set", "other"}) {
+      const MetricLabels Labels{{"operation", std::string(Operation)}};
+      Operations.push_back(
+          {Operation,
+           Metrics::GetHistogram("liveview_query_duration_seconds",
+                                 "Statement execution time.", Labels),
+           Metrics::GetCounter("liveview_query_errors_total",
+                               "Statements that failed.", Labels)});
+    }
+    return Operations;
+  }();
+  const size_t Start = Query.find_first_not_of(" \t\n(");
+  const std::string_view Word =
+      Start == std::string_view::npos
+          ? std::string_view{}
+          : Query.substr(Start, Query.find_first_of(" \t\n(;", Start) - Start);
+  auto Matches = [Word](std::string_view Operation) {
+    return Word.size() == Operation.size() &&
+           std::equal(Word.begin(), Word.end(), Operation.begin(),
+                      [](char Lhs, char Rhs) {
+                        return std::tolower(static_cast<unsigned char>(Lhs)) ==
+                               Rhs;
+                      });
+  };
+  for (const auto &Operation : All) {
+    if (Matches(Operation.Operation)) {
+      return Operation;
+    }
+  }
+  return All.back();
+}
+} // namespace
 
 DatabaseManager::DatabaseManager(const std::string &DatabaseConnectionString)
     : m_IsConnected(true) {
@@ -18,7 +72,7 @@ void DatabaseManager::InitTimezone() {
     m_DatabaseManager->CrQuery("set timezone = 'Asia/Jerusalem';");
     APP_INFO("DATABASE TIMEZONE SETTED TO - Asia/Jerusalem");
   } catch (const std::exception &e) {
-    APP_ERROR("DATABASE TIMEZONE SET ERROR - " + std::string(e.what()));
+    APP_ERROR("DATABASE TIMEZONE SET ERROR - {}", e.what());
   }
 }
 
@@ -28,12 +82,13 @@ void DatabaseManager::InitLogLevel() {
                                "'INFO', 'WARN', 'ERROR', 'CRIT');");
     APP_INFO("DATABASE LOG LEVEL ENUM CREATED");
   } catch (const std::exception &e) {
-    APP_ERROR("DATABASE LOG LEVEL ERROR - " + std::string(e.what()));
+    APP_ERROR("DATABASE LOG LEVEL ERROR - {}", e.what());
   }
 }
 
 std::string
 DatabaseManager::QuerySerialization(const StringUnMap &ModelFields) {
+  PROFILE_ZONE_COUNTERS("DatabaseManager::QuerySerialization");
   std::string Response;
   for (const auto &[key, value] : ModelFields) {
     Response.append(key).append(" ").append(value).append(", ");
@@ -48,7 +103,7 @@ DatabaseManager::QuerySerialization(const StringUnMap &ModelFields) {
 pqxx::result DatabaseManager::AddModel(const std::string &ModelName,
                                        const StringUnMap &ModelFields) {
   auto Response = CreateTable(ModelName, ModelFields);
-  APP_INFO("MODEL ADDED, TABLE CREATED - " + ModelName);
+  APP_INFO("MODEL ADDED, TABLE CREATED - {}", ModelName);
   return Response;
 }
 
@@ -56,7 +111,7 @@ pqxx::result DatabaseManager::RemoveModel(const std::string &ModelName) {
   try {
     return DeleteTable(ModelName, DatabaseQueryCommands::DropDrop);
   } catch (const std::exception &e) {
-    APP_ERROR("MODEL NOT FOUND - " + std::string(e.what()));
+    APP_ERROR("MODEL NOT FOUND - {}", e.what());
     return {};
   }
 }
@@ -69,6 +124,44 @@ pqxx::result DatabaseManager::GetModelData(const std::string &ModelName) {
   return GetTableData(ModelName);
 }
 
+pqxx::result DatabaseManager::GetModelDataInRanges(
+    const std::string &ModelName, const std::string &FieldName,
+    const std::vector<std::pair<int64_t, int64_t>> &Ranges,
+    std::string_view Condition, const pqxx::params &Params) {
+  if (Ranges.empty()) {
+    return {};
+  }
+  std::string query;
+  pqxx::params params;
+  {
+    PROFILE_ZONE_COUNTERS("DatabaseManager::GetModelDataInRanges/build");
+    query = DatabaseQueries::SelectInRanges(ModelName, FieldName,
+                                            Ranges.size(), Condition);
+    for (const auto &[Min, Max] : Ranges) {
+      params.append(Min);
+      params.append(Max);
+    }
+    if (!Condition.empty()) {
+      params.append(Params);
+    }
+  }
+  return MCrQuery(ModelName, query, params);
+}
+
+pqxx::result DatabaseManager::AddMissingColumn(const std::string &ModelName,
+                                               const std::string &FieldName,
+                                               const std::string &FieldType) {
+  std::string query;
+  query.append(DatabaseCommandToString(DatabaseQueryCommands::AlterTable))
+      .append(ModelName)
+      .append(" add column if not exists ")
+      .append(FieldName)
+      .append(" ")
+      .append(FieldType)
+      .append(";");
+  return MCrQuery(ModelName, query);
+}
+
 pqxx::result DatabaseManager::AddColumn(const std::string &ModelName,
                                         const std::string &FieldName,
                                         const std::string &FieldType) {
@@ -80,7 +173,7 @@ pqxx::result DatabaseManager::AddColumn(const std::string &ModelName,
       .append(" ")
       .append(FieldType)
       .append(";");
-  APP_INFO("COLUMN ADDED, TABLE ALTERED - " + ModelName + " - " + FieldName);
+  APP_INFO("COLUMN ADDED, TABLE ALTERED - {} - {}", ModelName, FieldName);
   return MCrQuery(ModelName, query);
 }
 
@@ -92,7 +185,7 @@ pqxx::result DatabaseManager::DropColumn(const std::string &ModelName,
       .append(" ")
       .append(DatabaseCommandToString(DatabaseQueryCommands::UpdateDropColumn))
       .append(FieldName);
-  APP_INFO("COLUMN DROPED, TABLE ALTERED - " + ModelName + " - " + FieldName);
+  APP_INFO("COLUMN DROPED, TABLE ALTERED - {} - {}", ModelName, FieldName);
   return MCrQuery(ModelName, query);
 }
 
@@ -107,49 +200,65 @@ pqxx::result DatabaseManager::AlterColumn(const std::string &ModelName,
       .append(FieldName)
       .append(" type ")
       .append(NewFieldType);
-  APP_INFO("COLUMN ALTERED, TABLE ALTERED - " + ModelName + " - " + FieldName);
+  APP_INFO("COLUMN ALTERED, TABLE ALTERED - {} - {}", ModelName, FieldName);
+  return MCrQuery(ModelName, query);
+}
+
+pqxx::result DatabaseManager::AddIndex(const std::string &ModelName,
+                                       const std::string &FieldName) {
+  std::string IndexName = ModelName + "_" + FieldName + "_idx";
+  std::transform(IndexName.begin(), IndexName.end(), IndexName.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  std::string query;
+  query.append(DatabaseCommandToString(DatabaseQueryCommands::CreateIndex))
+      .append(IndexName)
+      .append(" on ")
+      .append(ModelName)
+      .append(" (")
+      .append(FieldName)
+      .append(")");
+  APP_INFO("INDEX CREATED - {} - {}", ModelName, FieldName);
   return MCrQuery(ModelName, query);
 }
 
 pqxx::result DatabaseManager::InsertInto(const std::string &ModelName,
                                          const StringUnMap &Fields) {
-  int count = 0;
   std::string query;
-  std::string values_count;
   pqxx::params params;
-  query.append(DatabaseCommandToString(DatabaseQueryCommands::InsertInto))
-      .append(ModelName)
-      .append(" (");
-  for (const auto &[key, value] : Fields) {
-    count += 1;
-    query.append(key).append(", ");
-    values_count.append("$").append(std::to_string(count)).append(", ");
-    params.append(value);
-  }
-  if (!Fields.empty()) {
-    query.pop_back();
-    query.pop_back();
-    values_count.pop_back();
-    values_count.pop_back();
+  {
+    PROFILE_ZONE_COUNTERS("DatabaseManager::InsertInto/build");
+    query = DatabaseQueries::InsertInto(ModelName, Fields);
+    for (const auto &[key, value] : Fields) {
+      params.append(value);
+    }
   }
-  query.append(") values (").append(values_count).append(")");
-  APP_INFO("DATA INSERTED TO TABLE - " + ModelName);
+  APP_INFO_LIMITED("DATA INSERTED TO TABLE - {}", ModelName);
   return MCrQuery(ModelName, query, params);
 }
 
+pqxx::result
+DatabaseManager::InsertRows(const std::string &ModelName,
+                            const std::vector<std::string> &Columns,
+                            size_t RowCount, const pqxx::params &Params) {
+  if (Columns.empty() || RowCount == 0) {
+    return {};
+  }
+  std::string query;
+  {
+    PROFILE_ZONE("DatabaseManager::InsertRows/build");
+    query = DatabaseQueries::InsertRows(ModelName, Columns, RowCount);
+  }
+  APP_INFO_LIMITED("ROWS INSERTED TO TABLE - {} - {}", ModelName, RowCount);
+  return MCrQuery(ModelName, query, Params);
+}
+
 pqxx::result DatabaseManager::UpdateColumn(const std::string &ModelName,
                                            std::string_view FieldName,
                                            std::string_view Condition,
                                            const pqxx::params &Params) {
-  std::string query;
-  query.append(DatabaseCommandToString(DatabaseQueryCommands::Update))
-      .append(ModelName)
-      .append(" set ")
-      .append(FieldName)
-      .append("=$1 where ")
-      .append(Condition)
-      .append("=$2");
-  APP_INFO("COLUMN DATA UPDATED - " + ModelName);
+  const auto query =
+      DatabaseQueries::UpdateColumn(ModelName, FieldName, Condition);
+  APP_INFO_LIMITED("COLUMN DATA UPDATED - {}", ModelName);
   return MCrQuery(ModelName, query, Params);
 }
 
@@ -157,62 +266,73 @@ pqxx::result DatabaseManager::UpdateColumns(const std::string &ModelName,
                                             const StringUnMap &Fields,
                                             std::string_view Condition,
                                             const pqxx::params &Params) {
-  int count = 0;
   std::string query;
-  query.append(DatabaseCommandToString(DatabaseQueryCommands::Update))
-      .append(ModelName)
-      .append(" set ");
-  for (const auto &[key, value] : Fields) {
-    count += 1;
-    query.append(key).append("=$").append(std::to_string(count)).append(", ");
+  {
+    PROFILE_ZONE_COUNTERS("DatabaseManager::UpdateColumns/build");
+    query = DatabaseQueries::UpdateColumns(ModelName, Fields, Condition);
   }
-  if (!Fields.empty()) {
-    query.pop_back();
-    query.pop_back();
-  }
-  query.append(" where ").append(Condition).append("=$").append(
-      std::to_string(++count));
-  APP_INFO("COLUMNS DATA UPDATED - " + ModelName);
+  APP_INFO_LIMITED("COLUMNS DATA UPDATED - {}", ModelName);
   return MCrQuery(ModelName, query, Params);
 }
 
 pqxx::result DatabaseManager::DeleteRecord(const std::string &ModelName,
                                            std::string_view Condition,
                                            const pqxx::params &Params) {
-  std::string query;
-  query.append("delete from ")
-      .append(ModelName)
-      .append(" where ")
-      .append(Condition)
-      .append("=$1");
-  APP_INFO("RECORD DATA DELETED IN - " + ModelName);
+  const auto query = DatabaseQueries::DeleteRecord(ModelName, Condition);
+  APP_INFO_LIMITED("RECORD DATA DELETED IN - {}", ModelName);
   return MCrQuery(ModelName, query, Params);
 }
 
+void DatabaseManager::RecordQuery(std::string_view TableName,
+                                  std::string_view Query,
+                                  std::chrono::nanoseconds Elapsed,
+                                  bool Failed) {
+  QueryStats::Record(TableName, Query, Elapsed, Failed);
+  const auto &Operation = GetQueryMetrics(Query);
+  if (Operation.Operation != "select") {
+    SingleFlight::Invalidate();
+  }
+  Operation.Duration.Observe(std::chrono::duration<double>(Elapsed).count());
+  if (Failed) {
+    Operation.Errors.Increment();
+  }
+}
+
+DatabaseManager::QueryTimer::~QueryTimer() {
+  const auto Elapsed = std::chrono::steady_clock::now() - m_Begin;
+  const bool Failed = m_Manager.m_DatabaseManager->LastQueryFailed();
+  RecordQuery(m_TableName, m_Query, Elapsed, Failed);
+
+  if (m_Sampled && !Failed && Elapsed >= QueryPlans::GetThreshold()) {
+    QueryPlans::Submit(m_Manager.GetConnectionString(), m_TableName, m_Query,
+                       std::move(m_Params), Elapsed);
+  }
+}
+
 pqxx::result DatabaseManager::MCrQuery(const std::string &TableName,
                                        const std::string &Query) {
+  QueryTimer Timer{*this, TableName, Query};
   try {
     return m_DatabaseManager->CrQuery(Query);
   } catch (pqxx::sql_error const &e) {
-    APP_ERROR("MCRQUERY ERROR AT TABLE - " + TableName + " " +
-              std::string(e.what()));
+    APP_ERROR("MCRQUERY ERROR AT TABLE - {} {}", TableName, e.what());
     return {};
   } catch (std::exception const &e) {
-    APP_ERROR("MCRQUERY GENERAL ERROR - " + std::string(e.what()));
+    APP_ERROR("MCRQUERY GENERAL ERROR - {}", e.what());
     return {};
   }
 }
 
 pqxx::result DatabaseManager::MWQuery(const std::string &TableName,
                                       const std::string &query) {
+  QueryTimer Timer{*this, TableName, query};
   try {
     return m_DatabaseManager->WQuery(query);
   } catch (pqxx::sql_error const &e) {
-    APP_ERROR("MWQUERY ERROR AT TABLE - " + TableName + " " +
-              std::string(e.what()));
+    APP_ERROR("MWQUERY ERROR AT TABLE - {} {}", TableName, e.what());
     return {};
   } catch (std::exception const &e) {
-    APP_ERROR("MWQUERY GENERAL ERROR - " + std::string(e.what()));
+    APP_ERROR("MWQUERY GENERAL ERROR - {}", e.what());
     return {};
   }
 }
@@ -230,21 +350,17 @@ pqxx::result DatabaseManager::CreateTable(const std::string &TableName,
   try {
     return MCrQuery(TableName, query);
   } catch (const std::exception &e) {
-    APP_ERROR("ERROR AT CREATETABLE FUNCTION - " + TableName + " - " +
-              std::string(e.what()));
+    APP_ERROR("ERROR AT CREATETABLE FUNCTION - {} - {}", TableName, e.what());
     return {};
   }
 };
 
 pqxx::result DatabaseManager::GetTableData(const std::string &TableName) {
-  std::string query;
-  query.append(DatabaseCommandToString(DatabaseQueryCommands::SelectAll))
-      .append(TableName);
+  const auto query = DatabaseQueries::SelectAll(TableName);
   try {
-    return MCrQuery(TableName, query);
+    return MCrRead(TableName, query);
   } catch (const std::exception &e) {
-    APP_ERROR("ERROR AT GETTABLEDATA1 FUNCTION - " + TableName + " - " +
-              std::string(e.what()));
+    APP_ERROR("ERROR AT GETTABLEDATA1 FUNCTION - {} - {}", TableName, e.what());
     return {};
   }
 }
@@ -256,14 +372,13 @@ pqxx::result DatabaseManager::DeleteTable(const std::string &TableName,
   try {
     if (std::is_same_v<decltype(QueryCommand),
                        decltype(DatabaseQueryCommands::DropDrop)>)
-      APP_INFO("MODEL DELETED, TABLE DELETED - " + TableName);
+      APP_INFO("MODEL DELETED, TABLE DELETED - {}", TableName);
     else {
-      APP_INFO("MODEL MODIFIED, TABLE TRUNCATED - " + TableName);
+      APP_INFO("MODEL MODIFIED, TABLE TRUNCATED - {}", TableName);
     }
     return MCrQuery(TableName, query);
   } catch (const std::exception &e) {
-    APP_ERROR("ERROR AT DELETETABLE FUNCION - " + TableName + " - " +
-              std::string(e.what()));
+    APP_ERROR("ERROR AT DELETETABLE FUNCION - {} - {}", TableName, e.what());
     return {};
   }
 }
\ No newline at end of file
@@ -1,11 +1,57 @@
 #include "../../inc/Config/DatabasePool.h"
+#include "../../inc/Core/Profiler.h"
 
-DatabasePool::DatabasePool(std::string &&DatabaseConnectionString)
-    : m_DatabaseString(std::move(DatabaseConnectionString)) {
+#include <algorithm>
+
+namespace {
+constexpr std::array<std::string_view, DatabasePool::Lanes> LaneNames = {
+    "interactive", "write", "background"};
+
+/**
+ * @brief the lanes' waiting gauges and shedding counters, process wide like
+ * the pool's other metrics.
+ */
+struct LaneMetrics {
+  Gauge &Waiting;
+  Counter &QueueFull;
+  Counter &Timeout;
+};
+
+LaneMetrics &GetLaneMetrics(size_t Lane) {
+  static std::vector<LaneMetrics> All = [] {
+    std::vector<LaneMetrics> Lanes;
+    for (std::string_view Name : LaneNames) {
+      auto Rejected = [Name](std::string_view Reason) -> Counter & {
+        return Metrics::GetCounter(
+            "liveview_pool_rejected_total",
+            "Checkouts shed or timed out without a connection.",
+            {{"priority", std::string(Name)}, {"reason", std::string(Reason)}});
+      };
+      Lanes.push_back(
+          {Metrics::GetGauge("liveview_pool_waiting",
+                             "Checkouts waiting for a connection.",
+                             {{"priority", std::string(Name)}}),
+           Rejected("queue_full"), Rejected("timeout")});
+    }
+    return Lanes;
+  }();
+  return All[Lane];
+}
+} // namespace
+
+DatabasePool::DatabasePool(std::string &&DatabaseConnectionString,
+                           int PoolSize, const CheckoutOptions &Options)
+    : m_DatabasePoolSize(PoolSize),
+      m_DatabaseString(std::move(DatabaseConnectionString)),
+      m_Options(Options) {
   if (m_DatabaseString.empty()) {
     APP_CRITICAL("DATABASE MANAGER ERROR - EMPTY CONNECTION STRING");
     throw std::invalid_argument("Database Connection String Empty.");
   }
+  if (m_DatabasePoolSize < 1) {
+    APP_CRITICAL("DATABASE POOL ERROR - POOL SIZE {}", m_DatabasePoolSize);
+    throw std::invalid_argument("Database Pool Size Must Be Positive.");
+  }
   try {
     std::lock_guard<std::mutex> lock(m_PoolMutex);
     for (int i = 0; i < m_DatabasePoolSize; i++) {
@@ -13,21 +59,52 @@ DatabasePool::DatabasePool(std::string &&DatabaseConnectionString)
           std::make_shared<DatabaseManager>(m_DatabaseString));
     }
   } catch (const std::exception &e) {
-    APP_ERROR("DATABASE POOL CONSTRUCTOR ERROR - " + std::string(e.what()));
+    APP_ERROR("DATABASE POOL CONSTRUCTOR ERROR - {}", e.what());
   }
-  APP_INFO("DATABASE POOL CREATED - NUMBER OF CONNECTIONS: " +
-           std::to_string(m_DatabasePoolSize));
+  m_ConnectionCount = m_DatabasePool.size();
+  m_ConnectionsGauge.Add(static_cast<double>(m_ConnectionCount));
+  m_AvailableGauge.Add(static_cast<double>(m_ConnectionCount));
+  QueryStats::RegisterMetrics();
+  APP_INFO("DATABASE POOL CREATED - NUMBER OF CONNECTIONS: {}",
+           m_DatabasePoolSize);
 }
 
-DatabasePool::~DatabasePool() { APP_CRITICAL("DATABASE POOL DESTROYED"); }
+DatabasePool::~DatabasePool() {
+  /** @brief borrowed connections already left the available gauge. */
+  m_ConnectionsGauge.Add(-static_cast<double>(m_ConnectionCount));
+  m_AvailableGauge.Add(-static_cast<double>(m_DatabasePool.size()));
+  size_t Unserved = 0;
+  for (size_t Lane = 0; Lane < Lanes; Lane++) {
+    Unserved += m_Borrowers[Lane].size();
+    GetLaneMetrics(Lane).Waiting.Add(
+        -static_cast<double>(m_Borrowers[Lane].size()));
+  }
+  if (Unserved != 0) {
+    APP_ERROR("DATABASE POOL DESTROYED - {} BORROWERS NEVER SERVED", Unserved);
+  }
+  APP_CRITICAL("DATABASE POOL DESTROYED");
+}
 
 void DatabasePool::InitModels() {
+  PROFILE_ZONE("DatabasePool::InitModels");
   auto Manager = GetManagerConnection();
   {
     std::scoped_lock<std::mutex> lock(m_PoolMutex);
     for (const auto &[ModelName, Fields] : m_ModelSchemes.GetSchemes()) {
       Manager->AddModel(ModelName, Fields);
     }
+    /** @brief tables created before these fields existed get them now. */
+    for (const auto &[ModelName, Fields] : m_ModelSchemes.GetMigrations()) {
+      const auto Scheme = m_ModelSchemes.GetSchema(ModelName);
+      for (const auto &Field : Fields) {
+        Manager->AddMissingColumn(ModelName, Field, Scheme.at(Field));
+      }
+    }
+    for (const auto &[ModelName, Fields] : m_ModelSchemes.GetIndexes()) {
+      for (const auto &Field : Fields) {
+        Manager->AddIndex(ModelName, Field);
+      }
+    }
     APP_INFO("ALL MODELS TABLES CREATED IN DATABASE");
   }
   Manager->InitTimezone();
@@ -35,21 +112,146 @@ void DatabasePool::InitModels() {
   ReturnConnection(Manager);
 }
 
-SharedManager DatabasePool::GetManagerConnection() {
+SharedManager DatabasePool::GetManagerConnection(CheckoutPriority Priority) {
+  PROFILE_ZONE("DatabasePool::GetManagerConnection");
+  return *Acquire(Priority, std::nullopt);
+}
+
+DatabasePool::Checkout
+DatabasePool::CheckoutConnection(CheckoutPriority Priority) {
+  return CheckoutConnection(Priority,
+                            std::chrono::steady_clock::time_point::max());
+}
+
+DatabasePool::Checkout DatabasePool::CheckoutConnection(
+    CheckoutPriority Priority, std::chrono::steady_clock::time_point Deadline) {
+  PROFILE_ZONE("DatabasePool::CheckoutConnection");
+  return Acquire(Priority, Deadline);
+}
+
+DatabasePool::Checkout DatabasePool::Acquire(
+    CheckoutPriority Priority,
+    std::optional<std::chrono::steady_clock::time_point> Deadline) {
+  const auto Lane = static_cast<size_t>(Priority);
+  auto &LaneStats = GetLaneMetrics(Lane);
+  const int64_t Begin = FlightRecorder::Now();
   std::unique_lock<std::mutex> lock(m_PoolMutex);
-  m_PoolConditionVariable.wait(lock,
-                               [this]() { return !m_DatabasePool.empty(); });
-  auto Connection = std::move(m_DatabasePool.front());
-  m_DatabasePool.pop();
+  SharedManager Connection;
+  if (!m_DatabasePool.empty()) {
+    Connection = std::move(m_DatabasePool.front());
+    m_DatabasePool.pop();
+    m_AvailableGauge.Add(-1);
+  } else {
+    m_WaitsCounter.Increment();
+    if (Deadline) {
+      const auto &Limits = m_Options.Lanes[Lane];
+      if (GetQueuedAhead(Lane) >= Limits.MaxQueued) {
+        lock.unlock();
+        LaneStats.QueueFull.Increment();
+        APP_ERROR_LIMITED("DATABASE POOL SHED - {} - QUEUE FULL",
+                          LaneNames[Lane]);
+        return std::unexpected(CheckoutError::QueueFull);
+      }
+      const auto Now = std::chrono::steady_clock::now();
+      if (*Deadline - Now > Limits.MaxWait) {
+        Deadline = Now + Limits.MaxWait;
+      }
+    }
+    Waiter Self;
+    m_Waiters[Lane].push_back(&Self);
+    LaneStats.Waiting.Add(1);
+    auto Served = [&Self] { return Self.Served; };
+    if (Deadline) {
+      Self.Ready.wait_until(lock, *Deadline, Served);
+    } else {
+      Self.Ready.wait(lock, Served);
+    }
+    if (!Self.Served) {
+      std::erase(m_Waiters[Lane], &Self);
+      LaneStats.Waiting.Add(-1);
+      lock.unlock();
+      LaneStats.Timeout.Increment();
+      APP_ERROR_LIMITED("DATABASE POOL SHED - {} - TIMED OUT",
+                        LaneNames[Lane]);
+      return std::unexpected(CheckoutError::Timeout);
+    }
+    Connection = std::move(Self.Connection);
+  }
+  const int64_t Waited = FlightRecorder::Now() - Begin;
+  FlightRecorder::Record(FlightEvent::PoolAcquire, Waited,
+                         m_DatabasePool.size());
+  lock.unlock();
+  m_BorrowsCounter.Increment();
+  m_WaitHistogram.Observe(static_cast<double>(Waited) / 1e9);
   return Connection;
 }
 
+size_t DatabasePool::GetQueuedAhead(size_t Lane) const {
+  size_t Queued = 0;
+  for (size_t Ahead = 0; Ahead <= Lane; Ahead++) {
+    Queued += m_Borrowers[Ahead].size() + m_Waiters[Ahead].size();
+  }
+  return Queued;
+}
+
+void DatabasePool::Borrow(std::move_only_function<void(SharedManager)> &&Ready,
+                          CheckoutPriority Priority) {
+  const auto Lane = static_cast<size_t>(Priority);
+  SharedManager Connection;
+  {
+    std::scoped_lock<std::mutex> lock(m_PoolMutex);
+    if (m_DatabasePool.empty()) {
+      m_WaitsCounter.Increment();
+      m_Borrowers[Lane].push_back(std::move(Ready));
+      GetLaneMetrics(Lane).Waiting.Add(1);
+      return;
+    }
+    Connection = std::move(m_DatabasePool.front());
+    m_DatabasePool.pop();
+    FlightRecorder::Record(FlightEvent::PoolAcquire, 0, m_DatabasePool.size());
+  }
+  m_BorrowsCounter.Increment();
+  m_AvailableGauge.Add(-1);
+  Ready(std::move(Connection));
+}
+
 void DatabasePool::ReturnConnection(SharedManager &Connection) {
+  std::move_only_function<void(SharedManager)> Borrower;
   {
     std::scoped_lock<std::mutex> lock(m_PoolMutex);
-    m_DatabasePool.push(std::move(Connection));
+    for (size_t Lane = 0; Lane < Lanes; Lane++) {
+      if (!m_Borrowers[Lane].empty()) {
+        Borrower = std::move(m_Borrowers[Lane].front());
+        m_Borrowers[Lane].pop_front();
+        GetLaneMetrics(Lane).Waiting.Add(-1);
+        break;
+      }
+      if (!m_Waiters[Lane].empty()) {
+        /**
+         * @brief notified under the lock, the waiter's on its stack and
+         * can't return before it's released.
+         */
+        Waiter *Next = m_Waiters[Lane].front();
+        m_Waiters[Lane].pop_front();
+        GetLaneMetrics(Lane).Waiting.Add(-1);
+        Next->Connection = std::move(Connection);
+        Next->Served = true;
+        Next->Ready.notify_one();
+        return;
+      }
+    }
+    if (!Borrower) {
+      m_DatabasePool.push(std::move(Connection));
+      FlightRecorder::Record(FlightEvent::PoolRelease, m_DatabasePool.size());
+    }
+  }
+  if (Borrower) {
+    /** @brief handed over, it never went back to the available ones. */
+    m_BorrowsCounter.Increment();
+    Borrower(std::move(Connection));
+    return;
   }
-  m_PoolConditionVariable.notify_one();
+  m_AvailableGauge.Add(1);
 }
 
 int DatabasePool::GetPoolLimit() {
@@ -62,6 +264,12 @@ int DatabasePool::GetCurrentPoolSize() {
   return static_cast<int>(m_DatabasePool.size());
 }
 
+size_t DatabasePool::GetWaitingCount(CheckoutPriority Priority) {
+  const auto Lane = static_cast<size_t>(Priority);
+  std::lock_guard<std::mutex> lock(m_PoolMutex);
+  return m_Borrowers[Lane].size() + m_Waiters[Lane].size();
+}
+
 const std::string &DatabasePool::GetConnectionString() {
   std::lock_guard<std::mutex> lock(m_StatsMutex);
   return m_DatabaseString;
@@ -0,0 +1,148 @@
+#include "../../inc/Config/DatabaseQueries.h"
+
+std::string DatabaseQueries::SelectAll(std::string_view TableName) {
+  std::string query;
+  query.append(DatabaseCommandToString(DatabaseQueryCommands::SelectAll))
+      .append(TableName);
+  return query;
+}
+
+std::string DatabaseQueries::SelectWhere(std::string_view TableName,
+                                         std::string_view FieldName) {
+  std::string query = SelectAll(TableName);
+  query.append(" where ").append(FieldName).append("=$1");
+  return query;
+}
+
+std::string DatabaseQueries::SelectWhere(std::string_view TableName,
+                                         std::string_view FirstFieldName,
+                                         std::string_view SecondFieldName) {
+  std::string query = SelectAll(TableName);
+  query.append(" where ")
+      .append(FirstFieldName)
+      .append("=$1")
+      .append(" and ")
+      .append(SecondFieldName)
+      .append("=$2");
+  return query;
+}
+
+std::string DatabaseQueries::SelectInRanges(std::string_view TableName,
+                                            std::string_view FieldName,
+                                            size_t RangeCount,
+                                            std::string_view Condition) {
+  size_t count = 0;
+  std::string query = SelectAll(TableName);
+  query.append(" where (");
+  for (size_t Range = 0; Range < RangeCount; Range++) {
+    auto MinIndex = std::to_string(++count);
+    auto MaxIndex = std::to_string(++count);
+    query.append(FieldName)
+        .append(" between $")
+        .append(MinIndex)
+        .append(" and $")
+        .append(MaxIndex)
+        .append(" or ");
+  }
+  query.erase(query.size() - 4);
+  query.append(")");
+  if (!Condition.empty()) {
+    query.append(" and (").append(Condition).append(")");
+  }
+  return query;
+}
+
+std::string DatabaseQueries::InsertInto(std::string_view TableName,
+                                        const StringUnMap &Fields) {
+  int count = 0;
+  std::string query;
+  std::string values_count;
+  query.append(DatabaseCommandToString(DatabaseQueryCommands::InsertInto))
+      .append(TableName)
+      .append(" (");
+  for (const auto &[key, value] : Fields) {
+    count += 1;
+    query.append(key).append(", ");
+    values_count.append("$").append(std::to_string(count)).append(", ");
+  }
+  if (!Fields.empty()) {
+    query.pop_back();
+    query.pop_back();
+    values_count.pop_back();
+    values_count.pop_back();
+  }
+  query.append(") values (").append(values_count).append(")");
+  return query;
+}
+
+std::string
+DatabaseQueries::InsertRows(std::string_view TableName,
+                            const std::vector<std::string> &Columns,
+                            size_t RowCount) {
+  size_t count = 0;
+  std::string query;
+  query.append(DatabaseCommandToString(DatabaseQueryCommands::InsertInto))
+      .append(TableName)
+      .append(" (");
+  for (const auto &Column : Columns) {
+    query.append(Column).append(", ");
+  }
+  query.erase(query.size() - 2);
+  query.append(") values ");
+  for (size_t Row = 0; Row < RowCount; Row++) {
+    query.append("(");
+    for (size_t Column = 0; Column < Columns.size(); Column++) {
+      query.append("$").append(std::to_string(++count)).append(", ");
+    }
+    query.erase(query.size() - 2);
+    query.append("), ");
+  }
+  query.erase(query.size() - 2);
+  return query;
+}
+
+std::string DatabaseQueries::UpdateColumn(std::string_view TableName,
+                                          std::string_view FieldName,
+                                          std::string_view Condition) {
+  std::string query;
+  query.append(DatabaseCommandToString(DatabaseQueryCommands::Update))
+      .append(TableName)
+      .append(" set ")
+      .append(FieldName)
+      .append("=$1 where ")
+      .append(Condition)
+      .append("=$2");
+  return query;
+}
+
+std::string DatabaseQueries::UpdateColumns(std::string_view TableName,
+                                           const StringUnMap &Fields,
+                                           std::string_view Condition) {
+  int count = 0;
+  std::string query;
+  query.append(DatabaseCommandToString(DatabaseQueryCommands::Update))
+      .append(TableName)
+      .append(" set ");
+  for (const auto &[key, value] : Fields) {
+    count += 1;
+    query.append(key).append("=$").append(std::to_string(count)).append(", ");
+  }
+  if (!Fields.empty()) {
+    query.pop_back();
+    query.pop_back();
+  }
+  query.append(" where ").append(Condition).append("=$").append(
+      std::to_string(++count));
+  return query;
+}
+
+std::string DatabaseQueries::DeleteRecord(std::string_view TableName,
+                                          std::string_view Condition) {
+  std::string query;
+  query.append("delete from ")
+      .append(TableName)
+      .append(" where ")
+      .append(Condition)
+      .append("=$1");
+  return query;
+}
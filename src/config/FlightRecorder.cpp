@@ -0,0 +1,228 @@
+#include "../../inc/Config/FlightRecorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+std::array<std::atomic<FlightRecorder::Ring *>, FlightRecorder::MaxThreads>
+    FlightRecorder::s_Rings{};
+
+namespace {
+constexpr int CrashSignals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+
+/**
+ * @brief the dump paths are built by Init, the crash handler can't allocate.
+ */
+char CrashPath[4096];
+char ErrorPath[4096];
+std::atomic<bool> ErrorDumps{false};
+std::atomic<int64_t> ErrorDumpIntervalNs{0};
+std::atomic<int64_t> LastErrorDump{0};
+struct sigaction PreviousActions[sizeof(CrashSignals) / sizeof(int)];
+
+bool BuildPath(char (&Target)[4096], const std::string &Directory,
+               const char *Name) {
+  const std::string Path =
+      Directory + "flight-" + Name + "-" + std::to_string(getpid()) + ".bin";
+  if (Path.size() >= sizeof(Target)) {
+    Target[0] = '\0';
+    return false;
+  }
+  std::memcpy(Target, Path.c_str(), Path.size() + 1);
+  return true;
+}
+
+/** @brief write() until done, async signal safe. */
+bool WriteAll(int File, const void *Data, size_t Size) {
+  const auto *Bytes = static_cast<const char *>(Data);
+  while (Size > 0) {
+    const ssize_t Written = write(File, Bytes, Size);
+    if (Written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (Written <= 0) {
+      return false;
+    }
+    Bytes += Written;
+    Size -= static_cast<size_t>(Written);
+  }
+  return true;
+}
+} // namespace
+
+void FlightRecorder::Init(const FlightRecorderOptions &Options) {
+  const std::string Directory =
+      Options.Path.empty() ? "../../backend-logs/" : Options.Path;
+  BuildPath(ErrorPath, Directory, "error");
+  ErrorDumpIntervalNs.store(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          Options.ErrorDumpInterval)
+          .count(),
+      std::memory_order_relaxed);
+  ErrorDumps.store(Options.DumpOnError && ErrorPath[0] != '\0',
+                   std::memory_order_relaxed);
+
+  if (!Options.DumpOnCrash || !BuildPath(CrashPath, Directory, "crash")) {
+    return;
+  }
+  /** @brief once, a second Init would chain the handler to itself. */
+  static const bool Installed = [] {
+    struct sigaction Action{};
+    Action.sa_handler = &FlightRecorder::OnCrash;
+    sigemptyset(&Action.sa_mask);
+    for (size_t i = 0; i < std::size(CrashSignals); i++) {
+      sigaction(CrashSignals[i], &Action, &PreviousActions[i]);
+    }
+    return true;
+  }();
+  (void)Installed;
+}
+
+bool FlightRecorder::Dump(const char *Path, FlightDumpReason Reason,
+                          int Signal) {
+  const int File = open(Path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (File < 0) {
+    return false;
+  }
+  std::array<Ring *, MaxThreads> Rings{};
+  uint32_t ThreadCount = 0;
+  for (auto &Entry : s_Rings) {
+    if (auto *Current = Entry.load(std::memory_order_acquire)) {
+      Rings[ThreadCount++] = Current;
+    }
+  }
+
+  FileHeader Header{};
+  Header.Magic = Magic;
+  Header.Version = Version;
+  Header.EventTypes = static_cast<uint32_t>(FlightEventTypes.size());
+  Header.SteadyNs = Now();
+  Header.SystemNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
+  Header.ProcessId = static_cast<uint32_t>(getpid());
+  Header.Reason = Reason;
+  Header.Signal = static_cast<uint32_t>(Signal);
+  Header.ThreadCount = ThreadCount;
+  bool Written =
+      WriteAll(File, &Header, sizeof(Header)) &&
+      WriteAll(File, FlightEventTypes.data(),
+               FlightEventTypes.size() * sizeof(FlightEventType));
+
+  /** @brief copied out in chunks, no allocation on the crash path. */
+  std::array<Event, 64> Chunk;
+  for (uint32_t r = 0; r < ThreadCount && Written; r++) {
+    const Ring &Current = *Rings[r];
+    const uint64_t Head = Current.Head.load(std::memory_order_acquire);
+    const uint64_t Count = std::min<uint64_t>(Head, Capacity);
+    const ThreadHeader Thread{Current.ThreadId.load(std::memory_order_relaxed),
+                              static_cast<uint32_t>(Count)};
+    Written = WriteAll(File, &Thread, sizeof(Thread));
+
+    size_t Filled = 0;
+    for (uint64_t Index = Head - Count; Index < Head && Written; Index++) {
+      const Slot &Source = Current.Slots[Index & (Capacity - 1)];
+      Event &Target = Chunk[Filled++];
+      const uint64_t Before = Source.Sequence.load(std::memory_order_acquire);
+      Target.Timestamp = Source.Timestamp.load(std::memory_order_relaxed);
+      Target.Args[0] = Source.Args[0].load(std::memory_order_relaxed);
+      Target.Args[1] = Source.Args[1].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const uint64_t After = Source.Sequence.load(std::memory_order_relaxed);
+      Target.Id = static_cast<uint16_t>(Before & 0xFFFF);
+      Target.Torn = Before == 0 || Before != After;
+      Target.Reserved = 0;
+      if (Filled == Chunk.size()) {
+        Written = WriteAll(File, Chunk.data(), Filled * sizeof(Event));
+        Filled = 0;
+      }
+    }
+    if (Filled != 0 && Written) {
+      Written = WriteAll(File, Chunk.data(), Filled * sizeof(Event));
+    }
+  }
+  close(File);
+  return Written;
+}
+
+bool FlightRecorder::DumpOnError() {
+  if (!ErrorDumps.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  const int64_t Timestamp = Now();
+  int64_t Last = LastErrorDump.load(std::memory_order_relaxed);
+  if ((Last != 0 &&
+       Timestamp - Last <
+           ErrorDumpIntervalNs.load(std::memory_order_relaxed)) ||
+      !LastErrorDump.compare_exchange_strong(Last, Timestamp,
+                                             std::memory_order_relaxed)) {
+    return false;
+  }
+  return Dump(ErrorPath, FlightDumpReason::Error);
+}
+
+FlightRecorder::Ring *FlightRecorder::AttachThread() {
+  static thread_local bool Attached = false;
+  if (Attached) {
+    return t_Ring;
+  }
+  Attached = true;
+  /** @brief returns the ring when the thread exits. */
+  struct RingOwner {
+    ~RingOwner() { DetachThread(); }
+  };
+  static thread_local RingOwner Owner;
+  const auto ThreadId = static_cast<uint32_t>(syscall(SYS_gettid));
+
+  /** @brief a free entry, else the ring of a thread that exited. */
+  for (auto &Entry : s_Rings) {
+    if (Entry.load(std::memory_order_acquire) == nullptr) {
+      auto *Fresh = new Ring;
+      Fresh->ThreadId.store(ThreadId, std::memory_order_relaxed);
+      Ring *Expected = nullptr;
+      if (Entry.compare_exchange_strong(Expected, Fresh,
+                                        std::memory_order_acq_rel)) {
+        t_Ring = Fresh;
+        return t_Ring;
+      }
+      delete Fresh;
+    }
+  }
+  for (auto &Entry : s_Rings) {
+    Ring *Current = Entry.load(std::memory_order_acquire);
+    bool Retired = true;
+    if (Current != nullptr &&
+        Current->Retired.compare_exchange_strong(Retired, false,
+                                                 std::memory_order_acq_rel)) {
+      Current->ThreadId.store(ThreadId, std::memory_order_relaxed);
+      t_Ring = Current;
+      return t_Ring;
+    }
+  }
+  return nullptr;
+}
+
+void FlightRecorder::DetachThread() {
+  if (t_Ring != nullptr) {
+    t_Ring->Retired.store(true, std::memory_order_release);
+    t_Ring = nullptr;
+  }
+}
+
+void FlightRecorder::OnCrash(int Signal) {
+  Record(FlightEvent::Crash, static_cast<uint64_t>(Signal));
+  if (CrashPath[0] != '\0') {
+    Dump(CrashPath, FlightDumpReason::Crash, Signal);
+  }
+  /** @brief hands the signal to whoever had it before, the default kills. */
+  for (size_t i = 0; i < std::size(CrashSignals); i++) {
+    if (CrashSignals[i] == Signal) {
+      sigaction(Signal, &PreviousActions[i], nullptr);
+    }
+  }
+  raise(Signal);
+}
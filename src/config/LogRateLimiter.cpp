@@ -0,0 +1,94 @@
+#include "../../inc/Config/LogRateLimiter.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace {
+struct Registry {
+  std::mutex Mutex;
+  std::vector<const LogRateLimiter *> Limiters;
+};
+
+/** @brief built by the first limiter, so it outlives the static ones. */
+Registry &GetRegistry() {
+  static Registry Instance;
+  return Instance;
+}
+} // namespace
+
+LogRateLimiter::LogRateLimiter(std::string Key, double PerSecond, double Burst)
+    : m_Key(std::move(Key)),
+      m_IntervalNs(static_cast<int64_t>(1e9 / std::max(PerSecond, 1e-3))),
+      m_BurstNs(static_cast<int64_t>(m_IntervalNs * std::max(Burst, 1.0))),
+      m_LastSummary(Nanoseconds(Clock::now())) {
+  auto &Instance = GetRegistry();
+  std::lock_guard<std::mutex> Lock(Instance.Mutex);
+  Instance.Limiters.push_back(this);
+}
+
+LogRateLimiter::~LogRateLimiter() {
+  auto &Instance = GetRegistry();
+  std::lock_guard<std::mutex> Lock(Instance.Mutex);
+  std::erase(Instance.Limiters, this);
+}
+
+bool LogRateLimiter::Allow(Clock::time_point Now) {
+  const int64_t NowNs = Nanoseconds(Now);
+  int64_t FullAt = m_FullAt.load(std::memory_order_relaxed);
+  while (true) {
+    /** @brief taking a token pushes the refill time one interval out. */
+    const int64_t Next = std::max(FullAt, NowNs) + m_IntervalNs;
+    if (Next - NowNs > m_BurstNs) {
+      m_Suppressed.fetch_add(1, std::memory_order_relaxed);
+      m_Pending.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (m_FullAt.compare_exchange_weak(FullAt, Next,
+                                       std::memory_order_relaxed)) {
+      m_Emitted.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+}
+
+std::optional<LogRateLimiter::Summary>
+LogRateLimiter::TakeSummary(Clock::time_point Now) {
+  if (m_Pending.load(std::memory_order_relaxed) == 0) {
+    return std::nullopt;
+  }
+  const int64_t NowNs = Nanoseconds(Now);
+  int64_t Last = m_LastSummary.load(std::memory_order_relaxed);
+  const int64_t IntervalNs =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(SummaryInterval)
+          .count();
+  if (NowNs - Last < IntervalNs ||
+      !m_LastSummary.compare_exchange_strong(Last, NowNs,
+                                             std::memory_order_relaxed)) {
+    return std::nullopt;
+  }
+  return Summary{m_Pending.exchange(0, std::memory_order_relaxed),
+                 std::chrono::duration_cast<std::chrono::seconds>(
+                     std::chrono::nanoseconds(NowNs - Last))};
+}
+
+LogRateLimiter::Counters LogRateLimiter::GetCounters() const {
+  return {m_Key, m_Emitted.load(std::memory_order_relaxed),
+          m_Suppressed.load(std::memory_order_relaxed)};
+}
+
+std::vector<LogRateLimiter::Counters> LogRateLimiter::GetAllCounters() {
+  auto &Instance = GetRegistry();
+  std::lock_guard<std::mutex> Lock(Instance.Mutex);
+  std::vector<Counters> All;
+  All.reserve(Instance.Limiters.size());
+  for (const auto *Limiter : Instance.Limiters) {
+    All.push_back(Limiter->GetCounters());
+  }
+  return All;
+}
+
+int64_t LogRateLimiter::Nanoseconds(Clock::time_point Time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Time.time_since_epoch())
+      .count();
+}
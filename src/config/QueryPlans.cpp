@@ -0,0 +1,324 @@
+#include "../../inc/Config/QueryPlans.h"
+#include "../../inc/Config/Logger.h"
+#include "../../inc/Config/QueryStats.h"
+
+#include <algorithm>
+#include <cctype>
+#include <nlohmann/json.hpp>
+#include <random>
+
+std::atomic<int64_t> QueryPlans::s_ThresholdUs{0};
+std::atomic<double> QueryPlans::s_SampleRate{0.1};
+QueryPlanOptions QueryPlans::s_Options;
+std::mutex QueryPlans::s_Mutex;
+std::condition_variable QueryPlans::s_Wakeup;
+std::condition_variable QueryPlans::s_Idle;
+std::deque<QueryPlans::Request> QueryPlans::s_Pending;
+bool QueryPlans::s_Capturing{false};
+bool QueryPlans::s_Running{false};
+std::thread QueryPlans::s_Thread;
+std::unordered_map<std::string, QueryPlan> QueryPlans::s_Plans;
+
+namespace {
+/**
+ * @brief EXPLAIN takes select, insert, update and delete (and values,
+ * with).
+ */
+bool IsExplainable(std::string_view Query) {
+  const size_t Start = Query.find_first_not_of(" \t\n(");
+  if (Start == std::string_view::npos) {
+    return false;
+  }
+  const auto Word =
+      Query.substr(Start, Query.find_first_of(" \t\n(;", Start) - Start);
+  for (std::string_view Operation :
+       {"select", "insert", "update", "delete", "with", "values"}) {
+    if (Word.size() == Operation.size() &&
+        std::equal(Word.begin(), Word.end(), Operation.begin(),
+                   [](char Lhs, char Rhs) {
+                     return std::tolower(static_cast<unsigned char>(Lhs)) ==
+                            Rhs;
+                   })) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CollectSeqScans(const nlohmann::json &Node,
+                     std::vector<std::string> &Relations) {
+  if (Node.value("Node Type", "") == "Seq Scan" &&
+      Node.contains("Relation Name")) {
+    Relations.push_back(Node["Relation Name"].get<std::string>());
+  }
+  if (Node.contains("Plans")) {
+    for (const auto &Child : Node["Plans"]) {
+      CollectSeqScans(Child, Relations);
+    }
+  }
+}
+} // namespace
+
+void QueryPlans::Init(const QueryPlanOptions &Options) {
+  Shutdown();
+  {
+    std::lock_guard<std::mutex> Lock(s_Mutex);
+    s_Options = Options;
+    s_Options.SampleRate = std::clamp(Options.SampleRate, 0.0, 1.0);
+    s_Running = Options.Threshold.count() > 0 && s_Options.SampleRate > 0;
+  }
+  s_SampleRate.store(s_Options.SampleRate, std::memory_order_relaxed);
+  if (s_Running) {
+    s_Thread = std::thread(Run);
+    s_ThresholdUs.store(Options.Threshold.count(), std::memory_order_relaxed);
+    APP_INFO("QUERY PLANS CAPTURING - {}US - SAMPLE RATE {}",
+             Options.Threshold.count(), s_Options.SampleRate);
+  }
+}
+
+void QueryPlans::Shutdown() {
+  s_ThresholdUs.store(0, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> Lock(s_Mutex);
+    s_Running = false;
+    s_Pending.clear();
+  }
+  s_Wakeup.notify_all();
+  if (s_Thread.joinable()) {
+    s_Thread.join();
+  }
+  s_Idle.notify_all();
+}
+
+bool QueryPlans::ShouldSample() {
+  if (s_ThresholdUs.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  thread_local std::minstd_rand t_Generator{std::random_device{}()};
+  return std::uniform_real_distribution<double>(0, 1)(t_Generator) <
+         s_SampleRate.load(std::memory_order_relaxed);
+}
+
+void QueryPlans::Submit(std::string ConnectionString, std::string_view Table,
+                        std::string_view Query, pqxx::params &&Params,
+                        std::chrono::nanoseconds Elapsed) {
+  if (!IsExplainable(Query)) {
+    return;
+  }
+  auto Key = QueryStats::Fingerprint(Query);
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  if (!s_Running || s_Pending.size() >= s_Options.MaxPending) {
+    return;
+  }
+  auto It = s_Plans.find(Key);
+  if (It != s_Plans.end() && std::chrono::system_clock::now() <
+                                 It->second.Captured +
+                                     s_Options.RecaptureInterval) {
+    return;
+  }
+  for (const auto &Pending : s_Pending) {
+    if (Pending.Fingerprint == Key) {
+      return;
+    }
+  }
+  s_Pending.push_back({std::move(ConnectionString), std::move(Key),
+                       std::string(Table), std::string(Query),
+                       std::move(Params), Elapsed});
+  s_Wakeup.notify_one();
+}
+
+void QueryPlans::Flush() {
+  std::unique_lock<std::mutex> Lock(s_Mutex);
+  s_Idle.wait(Lock,
+              [] { return (s_Pending.empty() && !s_Capturing) || !s_Running; });
+}
+
+void QueryPlans::Run() {
+  std::unique_ptr<pqxx::connection> Connection;
+  std::string ConnectedTo;
+  std::unique_lock<std::mutex> Lock(s_Mutex);
+  while (true) {
+    s_Wakeup.wait(Lock, [] { return !s_Pending.empty() || !s_Running; });
+    if (!s_Running) {
+      break;
+    }
+    auto Current = std::move(s_Pending.front());
+    s_Pending.pop_front();
+    s_Capturing = true;
+    Lock.unlock();
+    Capture(Current, Connection, ConnectedTo);
+    Lock.lock();
+    s_Capturing = false;
+    if (s_Pending.empty()) {
+      s_Idle.notify_all();
+    }
+  }
+}
+
+void QueryPlans::Capture(Request &Current,
+                         std::unique_ptr<pqxx::connection> &Connection,
+                         std::string &ConnectedTo) {
+  try {
+    if (!Connection || !Connection->is_open() ||
+        ConnectedTo != Current.ConnectionString) {
+      Connection.reset();
+      Connection = std::make_unique<pqxx::connection>(Current.ConnectionString);
+      ConnectedTo = Current.ConnectionString;
+    }
+    const bool Analyze = IsReadOnly(Current.Query);
+    pqxx::read_transaction Transaction{*Connection};
+    Transaction.exec("set local statement_timeout = " +
+                     std::to_string(s_Options.Timeout.count()));
+    auto Result = Transaction.exec_params(
+        (Analyze ? "explain (analyze, buffers, format json) "
+                 : "explain (format json) ") +
+            Current.Query,
+        Current.Params);
+    Transaction.abort();
+
+    QueryPlan Plan;
+    Plan.Fingerprint = Current.Fingerprint;
+    Plan.Table = std::move(Current.Table);
+    Plan.Elapsed = Current.Elapsed;
+    Plan.Captured = std::chrono::system_clock::now();
+    Plan.Analyzed = Analyze;
+    Plan.Plan = Result[0][0].as<std::string>();
+    Plan.SeqScans = ParseSeqScans(Plan.Plan);
+    for (const auto &Statement : nlohmann::json::parse(Plan.Plan)) {
+      Plan.ExecutionTime +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::duration<double, std::milli>(
+                  Statement.value("Execution Time", 0.0)));
+    }
+    if (!Plan.SeqScans.empty()) {
+      APP_WARNING_LIMITED("QUERY PLAN - SEQ SCAN ON {} - {}",
+                          Plan.SeqScans.front(), Plan.Fingerprint);
+    }
+    Store(std::move(Plan));
+  } catch (const std::exception &e) {
+    APP_WARNING_LIMITED("QUERY PLAN CAPTURE ERROR - {} - {}",
+                        Current.Fingerprint, e.what());
+  }
+}
+
+void QueryPlans::Store(QueryPlan &&Plan) {
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  auto It = s_Plans.find(Plan.Fingerprint);
+  if (It != s_Plans.end()) {
+    Plan.Captures = It->second.Captures + 1;
+    It->second = std::move(Plan);
+    return;
+  }
+  if (s_Plans.size() >= std::max<size_t>(s_Options.MaxPlans, 1)) {
+    s_Plans.erase(std::min_element(s_Plans.begin(), s_Plans.end(),
+                                   [](const auto &Lhs, const auto &Rhs) {
+                                     return Lhs.second.Captured <
+                                            Rhs.second.Captured;
+                                   }));
+  }
+  Plan.Captures = 1;
+  auto Key = Plan.Fingerprint;
+  s_Plans.emplace(std::move(Key), std::move(Plan));
+}
+
+std::vector<QueryPlan> QueryPlans::Snapshot() {
+  std::vector<QueryPlan> Plans;
+  {
+    std::lock_guard<std::mutex> Lock(s_Mutex);
+    Plans.reserve(s_Plans.size());
+    for (const auto &[Key, Plan] : s_Plans) {
+      Plans.push_back(Plan);
+    }
+  }
+  std::sort(Plans.begin(), Plans.end(), [](const auto &Lhs, const auto &Rhs) {
+    return Lhs.Captured > Rhs.Captured;
+  });
+  return Plans;
+}
+
+std::optional<QueryPlan> QueryPlans::Find(std::string_view Fingerprint) {
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  auto It = s_Plans.find(std::string(Fingerprint));
+  if (It == s_Plans.end()) {
+    return std::nullopt;
+  }
+  return It->second;
+}
+
+std::string QueryPlans::Report() {
+  auto ToMicroseconds = [](std::chrono::nanoseconds Duration) {
+    return std::to_string(
+               std::chrono::duration_cast<std::chrono::microseconds>(Duration)
+                   .count()) +
+           "us";
+  };
+  std::string Status;
+  for (const auto &Plan : Snapshot()) {
+    Status.append("captures=")
+        .append(std::to_string(Plan.Captures))
+        .append(" elapsed=")
+        .append(ToMicroseconds(Plan.Elapsed))
+        .append(" explained=")
+        .append(ToMicroseconds(Plan.ExecutionTime));
+    if (!Plan.SeqScans.empty()) {
+      Status.append(" seqscan=");
+      for (const auto &Relation : Plan.SeqScans) {
+        Status.append(Relation).append(",");
+      }
+      Status.pop_back();
+    }
+    Status.append(" ").append(Plan.Table).append(" - ").append(
+        Plan.Fingerprint);
+    Status.append("\n");
+  }
+  return Status;
+}
+
+void QueryPlans::Reset() {
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  s_Plans.clear();
+}
+
+bool QueryPlans::IsReadOnly(std::string_view Query) {
+  std::string Word;
+  bool First = true;
+  bool With = false;
+  for (size_t i = 0; i <= Query.size(); i++) {
+    const auto Current =
+        i < Query.size() ? static_cast<unsigned char>(Query[i]) : ' ';
+    if (std::isalpha(Current)) {
+      Word.push_back(static_cast<char>(std::tolower(Current)));
+      continue;
+    }
+    if (Word.empty()) {
+      continue;
+    }
+    if (First) {
+      if (Word != "select" && Word != "values" && Word != "with") {
+        return false;
+      }
+      First = false;
+      With = Word == "with";
+    } else if (With && (Word == "insert" || Word == "update" ||
+                        Word == "delete" || Word == "merge")) {
+      /** @brief a data-modifying cte, or a word in a literal to be safe. */
+      return false;
+    }
+    Word.clear();
+  }
+  return !First;
+}
+
+std::vector<std::string> QueryPlans::ParseSeqScans(std::string_view Plan) {
+  std::vector<std::string> Relations;
+  try {
+    for (const auto &Statement : nlohmann::json::parse(Plan)) {
+      if (Statement.contains("Plan")) {
+        CollectSeqScans(Statement["Plan"], Relations);
+      }
+    }
+  } catch (const nlohmann::json::exception &e) {
+    APP_WARNING_LIMITED("QUERY PLAN PARSE ERROR - {}", e.what());
+  }
+  return Relations;
+}
@@ -0,0 +1,228 @@
+#include "../../inc/Config/QueryStats.h"
+#include "../../inc/Config/Logger.h"
+#include "../../inc/Core/Metrics/Metrics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+
+std::mutex QueryStats::s_Mutex;
+std::unordered_map<std::string, QueryStatsEntry> QueryStats::s_Entries;
+std::atomic<int64_t> QueryStats::s_SlowQueryThresholdMs{200};
+
+namespace {
+bool IsIdentifier(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+std::string ToMicroseconds(std::chrono::nanoseconds Duration) {
+  return std::to_string(
+             std::chrono::duration_cast<std::chrono::microseconds>(Duration)
+                 .count()) +
+         "us";
+}
+} // namespace
+
+std::chrono::nanoseconds QueryStatsEntry::Quantile(double Percentile) const {
+  if (Count == 0) {
+    return std::chrono::nanoseconds(0);
+  }
+  const auto Target = static_cast<uint64_t>(
+      std::max(1.0, static_cast<double>(Count) * Percentile / 100));
+  uint64_t Seen = 0;
+  for (size_t i = 0; i + 1 < BucketCount; i++) {
+    Seen += Buckets[i];
+    if (Seen >= Target) {
+      return std::min<std::chrono::nanoseconds>(
+          Max, std::chrono::microseconds(uint64_t{1} << i));
+    }
+  }
+  return Max;
+}
+
+void QueryStats::Record(std::string_view Table, std::string_view Query,
+                        std::chrono::nanoseconds Elapsed, bool Failed) {
+  std::string Key = Fingerprint(Query);
+  const auto Microseconds = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(Elapsed).count());
+  const size_t Bucket = std::min<size_t>(std::bit_width(Microseconds),
+                                         QueryStatsEntry::BucketCount - 1);
+  const auto Threshold = GetSlowQueryThreshold();
+  const bool Slow = Threshold.count() > 0 && Elapsed >= Threshold;
+  {
+    std::lock_guard<std::mutex> Lock(s_Mutex);
+    auto It = s_Entries.find(Key);
+    if (It == s_Entries.end()) {
+      if (s_Entries.size() >= MaxFingerprints) {
+        It = s_Entries.try_emplace(std::string(OtherFingerprint)).first;
+        It->second.Fingerprint = OtherFingerprint;
+      } else {
+        It = s_Entries.try_emplace(Key).first;
+        It->second.Fingerprint = Key;
+        It->second.Table = Table;
+      }
+    }
+    auto &Entry = It->second;
+    Entry.Count++;
+    Entry.Errors += Failed;
+    Entry.Slow += Slow;
+    Entry.Total += Elapsed;
+    Entry.Max = std::max(Entry.Max, Elapsed);
+    Entry.Buckets[Bucket]++;
+  }
+  if (Slow) {
+    if (auto &SlowLogger = Logger::GetSlowQueryLogger()) {
+      SlowLogger->warn("SLOW QUERY - {}MS - {} - {}{}",
+                       std::chrono::duration_cast<std::chrono::milliseconds>(
+                           Elapsed)
+                           .count(),
+                       Table, Key, Failed ? " - FAILED" : "");
+    }
+  }
+}
+
+std::vector<QueryStatsEntry> QueryStats::Snapshot() {
+  std::vector<QueryStatsEntry> Entries;
+  {
+    std::lock_guard<std::mutex> Lock(s_Mutex);
+    Entries.reserve(s_Entries.size());
+    for (const auto &[Key, Entry] : s_Entries) {
+      Entries.push_back(Entry);
+    }
+  }
+  std::sort(Entries.begin(), Entries.end(),
+            [](const QueryStatsEntry &Lhs, const QueryStatsEntry &Rhs) {
+              return Lhs.Total > Rhs.Total;
+            });
+  return Entries;
+}
+
+std::string QueryStats::Report() {
+  std::string Status;
+  for (const auto &Entry : Snapshot()) {
+    Status.append("count=")
+        .append(std::to_string(Entry.Count))
+        .append(" errors=")
+        .append(std::to_string(Entry.Errors))
+        .append(" slow=")
+        .append(std::to_string(Entry.Slow))
+        .append(" mean=")
+        .append(ToMicroseconds(Entry.Mean()))
+        .append(" p50=")
+        .append(ToMicroseconds(Entry.Quantile(50)))
+        .append(" p99=")
+        .append(ToMicroseconds(Entry.Quantile(99)))
+        .append(" max=")
+        .append(ToMicroseconds(Entry.Max))
+        .append(" ")
+        .append(Entry.Table)
+        .append(": ")
+        .append(Entry.Fingerprint)
+        .append("\n");
+  }
+  return Status;
+}
+
+void QueryStats::Reset() {
+  std::lock_guard<std::mutex> Lock(s_Mutex);
+  s_Entries.clear();
+}
+
+void QueryStats::SetSlowQueryThreshold(std::chrono::milliseconds Threshold) {
+  s_SlowQueryThresholdMs.store(Threshold.count(), std::memory_order_relaxed);
+}
+
+std::chrono::milliseconds QueryStats::GetSlowQueryThreshold() {
+  return std::chrono::milliseconds(
+      s_SlowQueryThresholdMs.load(std::memory_order_relaxed));
+}
+
+void QueryStats::RegisterMetrics() {
+  Metrics::AddCollector("query_stats", [](std::string &Out) {
+    const auto Entries = Snapshot();
+    auto Write = [&Out, &Entries](std::string_view Name, std::string_view Help,
+                                  auto Value) {
+      Metrics::WriteHeader(Out, Name, Metrics::Type::Counter, Help);
+      for (const auto &Entry : Entries) {
+        Metrics::WriteSample(
+            Out, Name,
+            {{"table", Entry.Table}, {"fingerprint", Entry.Fingerprint}},
+            Value(Entry));
+      }
+    };
+    Write("liveview_query_fingerprint_executions_total",
+          "Statements executed, by fingerprint.",
+          [](const QueryStatsEntry &Entry) {
+            return static_cast<double>(Entry.Count);
+          });
+    Write("liveview_query_fingerprint_errors_total",
+          "Statements that failed, by fingerprint.",
+          [](const QueryStatsEntry &Entry) {
+            return static_cast<double>(Entry.Errors);
+          });
+    Write("liveview_query_fingerprint_slow_total",
+          "Statements over the slow query threshold, by fingerprint.",
+          [](const QueryStatsEntry &Entry) {
+            return static_cast<double>(Entry.Slow);
+          });
+    Write("liveview_query_fingerprint_seconds_total",
+          "Time spent executing statements, by fingerprint.",
+          [](const QueryStatsEntry &Entry) {
+            return std::chrono::duration<double>(Entry.Total).count();
+          });
+  });
+}
+
+std::string QueryStats::Fingerprint(std::string_view Query) {
+  std::string Result;
+  Result.reserve(Query.size());
+  size_t i = 0;
+  while (i < Query.size()) {
+    const char c = Query[i];
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      while (i < Query.size() &&
+             std::isspace(static_cast<unsigned char>(Query[i]))) {
+        i++;
+      }
+      if (!Result.empty()) {
+        Result.push_back(' ');
+      }
+      continue;
+    }
+    if (c == '\'') {
+      /** @brief a string literal, '' is an escaped quote inside it. */
+      for (i++; i < Query.size(); i++) {
+        if (Query[i] == '\'') {
+          if (i + 1 < Query.size() && Query[i + 1] == '\'') {
+            i++;
+            continue;
+          }
+          break;
+        }
+      }
+      i++;
+      Result.push_back('?');
+      continue;
+    }
+    const bool Placeholder =
+        c == '$' && i + 1 < Query.size() &&
+        std::isdigit(static_cast<unsigned char>(Query[i + 1]));
+    const bool Number = std::isdigit(static_cast<unsigned char>(c)) &&
+                        (Result.empty() || !IsIdentifier(Result.back()));
+    if (Placeholder || Number) {
+      for (i++; i < Query.size() &&
+                (IsIdentifier(Query[i]) || Query[i] == '.');
+           i++) {
+      }
+      Result.push_back('?');
+      continue;
+    }
+    Result.push_back(
+        static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    i++;
+  }
+  while (!Result.empty() && (Result.back() == ' ' || Result.back() == ';')) {
+    Result.pop_back();
+  }
+  return Result;
+}
@@ -0,0 +1,96 @@
+#include "../../inc/Config/SingleFlight.h"
+#include "../../inc/Config/Logger.h"
+#include "../../inc/Core/Metrics/Metrics.h"
+
+#include <functional>
+
+std::atomic<bool> SingleFlight::s_Enabled{true};
+std::atomic<uint64_t> SingleFlight::s_Epoch{0};
+std::array<SingleFlight::Shard, SingleFlight::SHARDS> SingleFlight::s_Shards;
+
+namespace {
+Counter &GetCoalescedCounter() {
+  static Counter &s_Coalesced =
+      Metrics::GetCounter("liveview_db_reads_coalesced_total",
+                          "Reads served by an identical read in flight.");
+  return s_Coalesced;
+}
+
+Counter &GetExecutedCounter() {
+  static Counter &s_Executed =
+      Metrics::GetCounter("liveview_db_reads_executed_total",
+                          "Reads that ran their statement for a flight.");
+  return s_Executed;
+}
+
+Gauge &GetInFlightGauge() {
+  static Gauge &s_InFlight = Metrics::GetGauge(
+      "liveview_db_reads_in_flight", "Coalescable reads running now.");
+  return s_InFlight;
+}
+} // namespace
+
+void SingleFlight::Init(const SingleFlightOptions &Options) {
+  s_Enabled.store(Options.Enabled, std::memory_order_relaxed);
+  APP_INFO("SINGLE FLIGHT READS - {}", Options.Enabled ? "ON" : "OFF");
+}
+
+uint64_t SingleFlight::GetCoalesced() { return GetCoalescedCounter().Get(); }
+
+uint64_t SingleFlight::GetExecuted() { return GetExecutedCounter().Get(); }
+
+size_t SingleFlight::GetInFlight() {
+  return static_cast<size_t>(GetInFlightGauge().Get());
+}
+
+SingleFlight::Shard &SingleFlight::GetShard(const std::string &Key) {
+  return s_Shards[std::hash<std::string>{}(Key) % SHARDS];
+}
+
+std::shared_ptr<SingleFlight::Flight>
+SingleFlight::Join(const std::string &Key, bool &Leader) {
+  const uint64_t Epoch = s_Epoch.load(std::memory_order_acquire);
+  Shard &Current = GetShard(Key);
+  std::lock_guard Lock{Current.Mutex};
+  auto &Entry = Current.Flights[Key];
+  if (Entry && Entry->Epoch == Epoch) {
+    Leader = false;
+    GetCoalescedCounter().Increment();
+    return Entry;
+  }
+  /**
+   * @brief a flight of an older epoch keeps its followers but loses the
+   * key, it may have read from before a write that completed since.
+   */
+  Entry = std::make_shared<Flight>(Epoch);
+  Leader = true;
+  GetExecutedCounter().Increment();
+  GetInFlightGauge().Add(1);
+  return Entry;
+}
+
+SingleFlight::Outcome SingleFlight::Wait(Flight &Current) {
+  std::unique_lock Lock{Current.Mutex};
+  Current.Landed.wait(Lock, [&] { return Current.Done; });
+  return Current.Result;
+}
+
+void SingleFlight::Land(const std::string &Key,
+                        const std::shared_ptr<Flight> &Current,
+                        const Outcome &Result) {
+  {
+    Shard &Owner = GetShard(Key);
+    std::lock_guard Lock{Owner.Mutex};
+    auto Entry = Owner.Flights.find(Key);
+    if (Entry != Owner.Flights.end() && Entry->second == Current) {
+      Owner.Flights.erase(Entry);
+    }
+  }
+  GetInFlightGauge().Add(-1);
+  {
+    std::lock_guard Lock{Current->Mutex};
+    Current->Result = Result;
+    Current->Done = true;
+  }
+  Current->Landed.notify_all();
+}
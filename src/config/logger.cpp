@@ -1,11 +1,73 @@
 #include "../inc/Config/Logger.h"
+#include "../inc/Config/QueryStats.h"
+#include "../inc/Core/Metrics/Metrics.h"
+
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/sinks/base_sink.h>
+
+namespace {
+/**
+ * @brief sits next to the file sinks at error level, marks the error in the
+ * flight recorder and dumps what led to it.
+ */
+class FlightRecorderSink
+    : public spdlog::sinks::base_sink<spdlog::details::null_mutex> {
+protected:
+  void sink_it_(const spdlog::details::log_msg &Message) override {
+    FlightRecorder::Record(FlightEvent::LogError,
+                           static_cast<uint64_t>(Message.level));
+    FlightRecorder::DumpOnError();
+  }
+  void flush_() override {}
+};
+
+/**
+ * @brief the rate limited call sites' counters and the async queue's drops.
+ */
+void CollectLogMetrics(std::string &Out) {
+  const auto Sites = LogRateLimiter::GetAllCounters();
+  Metrics::WriteHeader(Out, "liveview_log_emitted_total",
+                       Metrics::Type::Counter,
+                       "Messages logged by rate limited call sites.");
+  for (const auto &Site : Sites) {
+    Metrics::WriteSample(Out, "liveview_log_emitted_total",
+                         {{"site", Site.Key}},
+                         static_cast<double>(Site.Emitted));
+  }
+  Metrics::WriteHeader(Out, "liveview_log_suppressed_total",
+                       Metrics::Type::Counter,
+                       "Messages suppressed by rate limited call sites.");
+  for (const auto &Site : Sites) {
+    Metrics::WriteSample(Out, "liveview_log_suppressed_total",
+                         {{"site", Site.Key}},
+                         static_cast<double>(Site.Suppressed));
+  }
+  Metrics::WriteHeader(Out, "liveview_log_dropped_total",
+                       Metrics::Type::Counter,
+                       "Messages dropped by a full async logging queue.");
+  Metrics::WriteSample(Out, "liveview_log_dropped_total", {},
+                       static_cast<double>(Logger::GetDroppedCount()));
+}
+} // namespace
 
 std::shared_ptr<spdlog::logger> Logger::s_AppLogger;
 std::shared_ptr<spdlog::logger> Logger::s_SystemLogger;
+std::shared_ptr<spdlog::logger> Logger::s_SlowQueryLogger;
+std::shared_ptr<spdlog::details::thread_pool> Logger::s_ThreadPool;
 
 void Logger::Init(const std::string &path) {
+  LoggerOptions Options;
+  Options.Path = path;
+  Options.FlushLevel = spdlog::level::trace;
+  Init(Options);
+}
+
+void Logger::Init(const LoggerOptions &Options) {
+  Shutdown();
+
   std::string p_Path;
-  p_Path = (path == "") ? p_Path = "../../backend-logs/" : p_Path = path;
+  p_Path = (Options.Path == "") ? p_Path = "../../backend-logs/"
+                                : p_Path = Options.Path;
 
   spdlog::sink_ptr app_sink =
       std::make_shared<spdlog::sinks::basic_file_sink_mt>(p_Path + "app.log",
@@ -14,17 +76,84 @@ void Logger::Init(const std::string &path) {
       std::make_shared<spdlog::sinks::basic_file_sink_mt>(p_Path + "sys.log",
                                                           true);
 
+  spdlog::sink_ptr slow_query_sink =
+      std::make_shared<spdlog::sinks::basic_file_sink_mt>(p_Path + "slow.log",
+                                                          true);
+
   app_sink->set_pattern("[%T] [%l] %n: %v");
   system_sink->set_pattern("[%T] [%l] %n: %v");
+  slow_query_sink->set_pattern("[%Y-%m-%d %T.%e] %v");
+
+  QueryStats::SetSlowQueryThreshold(Options.SlowQueryThreshold);
+  FlightRecorder::Init({.Path = p_Path,
+                        .DumpOnCrash = Options.FlightDumps,
+                        .DumpOnError = Options.FlightDumps});
+  Metrics::AddCollector("logging", CollectLogMetrics);
+  spdlog::sink_ptr flight_sink = std::make_shared<FlightRecorderSink>();
+  flight_sink->set_level(spdlog::level::err);
 
-  s_AppLogger = std::make_shared<spdlog::logger>("APP", app_sink);
-  s_SystemLogger = std::make_shared<spdlog::logger>("SYSTEM", system_sink);
+  if (Options.Async) {
+    s_ThreadPool = std::make_shared<spdlog::details::thread_pool>(
+        std::max<size_t>(Options.QueueSize, 1),
+        std::max<size_t>(Options.ThreadCount, 1));
+    auto Policy = Options.Overflow == LogOverflowPolicy::Drop
+                      ? spdlog::async_overflow_policy::overrun_oldest
+                      : spdlog::async_overflow_policy::block;
+    s_AppLogger = std::make_shared<spdlog::async_logger>(
+        "APP", spdlog::sinks_init_list{app_sink, flight_sink}, s_ThreadPool,
+        Policy);
+    s_SystemLogger = std::make_shared<spdlog::async_logger>(
+        "SYSTEM", spdlog::sinks_init_list{system_sink, flight_sink},
+        s_ThreadPool, Policy);
+    s_SlowQueryLogger = std::make_shared<spdlog::async_logger>(
+        "SLOW", slow_query_sink, s_ThreadPool, Policy);
+  } else {
+    s_AppLogger = std::make_shared<spdlog::logger>(
+        "APP", spdlog::sinks_init_list{app_sink, flight_sink});
+    s_SystemLogger = std::make_shared<spdlog::logger>(
+        "SYSTEM", spdlog::sinks_init_list{system_sink, flight_sink});
+    s_SlowQueryLogger =
+        std::make_shared<spdlog::logger>("SLOW", slow_query_sink);
+  }
 
   spdlog::register_logger(s_AppLogger);
   s_AppLogger->set_level(spdlog::level::trace);
-  s_AppLogger->flush_on(spdlog::level::trace);
+  s_AppLogger->flush_on(Options.FlushLevel);
 
   spdlog::register_logger(s_SystemLogger);
   s_SystemLogger->set_level(spdlog::level::trace);
-  s_SystemLogger->flush_on(spdlog::level::trace);
+  s_SystemLogger->flush_on(Options.FlushLevel);
+
+  spdlog::register_logger(s_SlowQueryLogger);
+  s_SlowQueryLogger->flush_on(Options.FlushLevel);
+
+  /** @brief the registry's flusher thread, covers every registered logger. */
+  if (Options.FlushLevel != spdlog::level::trace &&
+      Options.FlushInterval.count() > 0) {
+    spdlog::flush_every(Options.FlushInterval);
+  }
+}
+
+void Logger::Shutdown() {
+  if (s_AppLogger) {
+    s_AppLogger->flush();
+    spdlog::drop(s_AppLogger->name());
+  }
+  if (s_SystemLogger) {
+    s_SystemLogger->flush();
+    spdlog::drop(s_SystemLogger->name());
+  }
+  if (s_SlowQueryLogger) {
+    s_SlowQueryLogger->flush();
+    spdlog::drop(s_SlowQueryLogger->name());
+  }
+  s_AppLogger.reset();
+  s_SystemLogger.reset();
+  s_SlowQueryLogger.reset();
+  /** @brief joins the workers once the queued messages are written. */
+  s_ThreadPool.reset();
+}
+
+size_t Logger::GetDroppedCount() {
+  return s_ThreadPool ? s_ThreadPool->overrun_counter() : 0;
 }
@@ -23,4 +23,12 @@ TEST_F(ConfigTest, ConfigDatabaseString) {
   std::string GoodDataString = "user=arielkriheli password=password "
                                 "host=localhost port=5432 dbname=live_view";
   EXPECT_EQ(DataString, GoodDataString);
+}
+
+TEST_F(ConfigTest, ConfigLoggingOptions) {
+  auto Options = Config::LoggingOptions("../../configs/config.json");
+  EXPECT_TRUE(Options.Async);
+  EXPECT_EQ(Options.QueueSize, 8192);
+  EXPECT_EQ(Options.Overflow, LogOverflowPolicy::Block);
+  EXPECT_EQ(Options.FlushLevel, spdlog::level::warn);
 }
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "Config/AsyncDatabase.h"
+#include "../../Test.h"
+#include "Config/DatabaseManager.h"
+
+#include <memory>
+#include <stdexcept>
+
+class AsyncDatabaseTest : public ::testing::Test {
+protected:
+  std::unique_ptr<DatabaseManager> Manager;
+  std::unique_ptr<AsyncDatabase> Database;
+  std::string TestTableName = "AsyncTest";
+
+  void SetUp() override {
+    std::string TestDatabaseConnectionString;
+    if (std::getenv("GITHUB_ACTIONS") != nullptr) {
+      TestDatabaseConnectionString =
+          Config::TestDatabaseToString("../../configs/ci-config.json");
+    } else {
+      TestDatabaseConnectionString =
+          Config::TestDatabaseToString("../../configs/config.json");
+    }
+    Manager = std::make_unique<DatabaseManager>(TestDatabaseConnectionString);
+    Manager->AddModel(TestTableName,
+                      {{"addressname", "text"}, {"addressnumber", "int"}});
+    Database = std::make_unique<AsyncDatabase>(TestDatabaseConnectionString, 4);
+  }
+
+  void TearDown() override {
+    Database.reset();
+    Manager->RemoveModel(TestTableName);
+    Manager.reset();
+  }
+};
+
+TEST(TaskTest, TaskWhenAllTest) {
+  auto Square = [](int Value) -> Task<int> { co_return Value * Value; };
+  auto Sum = [&]() -> Task<int> {
+    std::vector<Task<int>> Squares;
+    for (int i = 1; i <= 4; i++) {
+      Squares.push_back(Square(i));
+    }
+    int Total = 0;
+    for (int Value : co_await WhenAll(std::move(Squares))) {
+      Total += Value;
+    }
+    co_return Total;
+  };
+  EXPECT_EQ(SyncWait(Sum()), 30);
+
+  auto Throw = []() -> Task<> {
+    throw std::runtime_error("fail");
+    co_return;
+  };
+  EXPECT_THROW(SyncWait(Throw()), std::runtime_error);
+}
+
+TEST_F(AsyncDatabaseTest, AsyncDatabaseCrudTest) {
+  ASSERT_TRUE(Database->IsDatabaseConnected());
+  auto Flow = [&]() -> Task<> {
+    const std::string Name = "hamaas";
+    const StringUnMap Fields{{"addressname", Name}, {"addressnumber", "18"}};
+    auto Inserted = co_await Database->InsertInto(TestTableName, Fields);
+    EXPECT_FALSE(Inserted.IsFailed()) << Inserted.GetError();
+    EXPECT_EQ(Inserted.GetAffectedRows(), 1);
+
+    auto Found = co_await Database->GetModelDataArgs(
+        TestTableName, "addressname", "addressnumber", Name, 18);
+    EXPECT_EQ(Found.GetRowCount(), 1);
+    EXPECT_EQ(Found.GetValue(0, "addressname"), Name);
+
+    auto Updated = co_await Database->UpdateColumn(
+        TestTableName, "addressnumber", "addressname", AsyncParams{20, Name});
+    EXPECT_EQ(Updated.GetAffectedRows(), 1);
+
+    auto Changed = co_await Database->GetModelData(TestTableName,
+                                                   "addressnumber", 20);
+    EXPECT_EQ(Changed.GetRowCount(), 1);
+
+    auto Deleted = co_await Database->DeleteRecord(
+        TestTableName, "addressname", AsyncParams{Name});
+    EXPECT_EQ(Deleted.GetAffectedRows(), 1);
+    auto Remaining = co_await Database->GetModelData(TestTableName);
+    EXPECT_TRUE(Remaining.IsEmpty());
+  };
+  SyncWait(Flow());
+}
+
+TEST_F(AsyncDatabaseTest, AsyncDatabaseConcurrentTest) {
+  constexpr int Queries = 64;
+  auto Insert = [&](int Number) -> Task<bool> {
+    const StringUnMap Fields{{"addressname", "concurrent"},
+                             {"addressnumber", std::to_string(Number)}};
+    auto Result = co_await Database->InsertInto(TestTableName, Fields);
+    co_return !Result.IsFailed();
+  };
+  auto InsertAll = [&]() -> Task<std::vector<bool>> {
+    std::vector<Task<bool>> Inserts;
+    for (int i = 0; i < Queries; i++) {
+      Inserts.push_back(Insert(i));
+    }
+    co_return co_await WhenAll(std::move(Inserts));
+  };
+  for (bool Inserted : SyncWait(InsertAll())) {
+    EXPECT_TRUE(Inserted);
+  }
+
+  auto Count = [&]() -> Task<int> {
+    const std::vector<std::pair<int64_t, int64_t>> Ranges{{0, 9},
+                                                          {50, Queries}};
+    auto Rows = co_await Database->GetModelDataInRanges(
+        TestTableName, "addressnumber", Ranges);
+    co_return Rows.GetRowCount();
+  };
+  EXPECT_EQ(SyncWait(Count()), 24);
+}
+
+TEST_F(AsyncDatabaseTest, AsyncDatabaseFailureTest) {
+  auto Flow = [&]() -> Task<> {
+    auto Missing = co_await Database->GetModelData("AsyncMissing");
+    EXPECT_TRUE(Missing.IsFailed());
+    EXPECT_FALSE(Missing.GetError().empty());
+
+    /** @brief the connection serves the next statement. */
+    auto Rows = co_await Database->Query(TestTableName,
+                                         "select count(*) from asynctest");
+    EXPECT_FALSE(Rows.IsFailed());
+    EXPECT_EQ(Rows.GetValue(0, 0), "0");
+
+    auto Nothing = co_await Database->InsertRows(TestTableName, {}, 0, {});
+    EXPECT_FALSE(Nothing.IsFailed());
+    EXPECT_TRUE(Nothing.IsEmpty());
+  };
+  SyncWait(Flow());
+}
+
+TEST_F(AsyncDatabaseTest, AsyncDatabaseResetTest) {
+  Database.reset();
+  std::string TestDatabaseConnectionString;
+  if (std::getenv("GITHUB_ACTIONS") != nullptr) {
+    TestDatabaseConnectionString =
+        Config::TestDatabaseToString("../../configs/ci-config.json");
+  } else {
+    TestDatabaseConnectionString =
+        Config::TestDatabaseToString("../../configs/config.json");
+  }
+  Database = std::make_unique<AsyncDatabase>(TestDatabaseConnectionString, 1);
+  auto Flow = [&]() -> Task<> {
+    /** @brief the backend goes away under the only connection. */
+    auto Terminated = co_await Database->Query(
+        TestTableName, "select pg_terminate_backend(pg_backend_pid())");
+    EXPECT_TRUE(Terminated.IsFailed());
+
+    /** @brief waits for the reset, then runs on the new connection. */
+    auto Rows = co_await Database->Query(TestTableName,
+                                         "select count(*) from asynctest");
+    EXPECT_FALSE(Rows.IsFailed());
+    EXPECT_EQ(Rows.GetValue(0, 0), "0");
+  };
+  SyncWait(Flow());
+  EXPECT_TRUE(Database->IsDatabaseConnected());
+}
@@ -121,6 +121,38 @@ TEST_F(DatabaseTest, DatabaseModelGetDataByFieldTest) {
   EXPECT_NE(Response.affected_rows(), 0);
 }
 
+TEST_F(DatabaseTest, DatabaseResponseTest) {
+  TestFieldsFirst.insert({
+      {"id",
+       DatabaseCommandToString(DatabaseFieldCommands::SerialPrimaryKeyField)},
+      {"addressname",
+       DatabaseCommandToString(DatabaseFieldCommands::VarChar100Field)},
+  });
+  Manager->AddModel(TestTableName, TestFieldsFirst);
+
+  auto Insert = Manager->Diagnose([&] {
+    return Manager->InsertInto(TestTableName,
+                               {{"addressname", "rami"}, {"id", "1"}});
+  });
+  EXPECT_FALSE(Insert.IsFailed());
+  EXPECT_EQ(Insert.GetAffectedRows(), 1);
+  EXPECT_EQ(Insert.GetRowCount(), 0);
+  EXPECT_GT(Insert.GetExecutionTime().count(), 0);
+  EXPECT_NE(Insert.GetBackendPid(), 0);
+
+  auto Select = Manager->Diagnose(
+      [&] { return Manager->GetModelData(TestTableName, "id", "1"); });
+  EXPECT_EQ(Select.GetRowCount(), 1);
+  /** @brief "1" and "rami". */
+  EXPECT_EQ(Select.GetResponseSize(), 5);
+  EXPECT_EQ(Select.GetBackendPid(), Insert.GetBackendPid());
+
+  auto Failed = Manager->Diagnose(
+      [&] { return Manager->GetModelData("MissingTable"); });
+  EXPECT_TRUE(Failed.IsFailed());
+  EXPECT_EQ(Failed.GetRowCount(), 0);
+}
+
 TEST_F(DatabaseTest, DatabaseTruncateModelTest) {
   TestFieldsFirst.insert({
       {"id",
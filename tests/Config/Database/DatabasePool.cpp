@@ -1,5 +1,6 @@
 #include "Config/DatabasePool.h"
 #include "../../Test.h"
+#include "Core/Scheduler.h"
 #include "Models/AddressModel.h"
 
 #include <future>
@@ -89,6 +90,14 @@ TEST_F(DatabasePoolTest, DatabasePoolLimitTest) {
   EXPECT_NE(PreSize, AfterSize);
 }
 
+TEST_F(DatabasePoolTest, DatabasePoolSizeTest) {
+  DatabasePool Pool{std::string(Manager->GetConnectionString()), 2};
+  EXPECT_EQ(Pool.GetPoolLimit(), 2);
+  EXPECT_EQ(Pool.GetCurrentPoolSize(), 2);
+  EXPECT_THROW(DatabasePool(std::string(Manager->GetConnectionString()), 0),
+               std::invalid_argument);
+}
+
 TEST_F(DatabasePoolTest, DatabasePoolInitModelsTest) {
   Manager->InitModels();
 
@@ -111,6 +120,37 @@ TEST_F(DatabasePoolTest, DatabasePoolInitModelsTest) {
   EXPECT_NE(PreData, PostData);
 }
 
+TEST_F(DatabasePoolTest, DatabasePoolMigrationTest) {
+  auto Connection = Manager->GetManagerConnection();
+  Connection->RemoveModel("AddressLog");
+  Connection->RemoveModel("Address");
+  /** @brief the table as it was before the coordinates. */
+  Connection->AddModel("Address", {{"addressid", "uuid primary key"},
+                                   {"addressname", "varchar(100) not null"},
+                                   {"addressnumber", "int not null"},
+                                   {"addresscity", "varchar(100) not null"},
+                                   {"addressdistrict", "varchar(100)"},
+                                   {"country", "varchar(100)"}});
+  Manager->ReturnConnection(Connection);
+  Manager->InitModels();
+
+  Connection = Manager->GetManagerConnection();
+  auto Address = Manager->GetUniqueModelConnection<AddressModel>();
+  Address->Add(Connection, {{"addressname", "hamaas"},
+                            {"addressnumber", "18"},
+                            {"addresscity", "holon"},
+                            {"latitude", "32.0171"},
+                            {"longitude", "34.7737"}});
+  EXPECT_FALSE(Connection->LastQueryFailed());
+  EXPECT_EQ(Address
+                ->GetAddressesWithinRadius(Connection, {32.0171, 34.7737}, 100)
+                .size(),
+            1);
+  Connection->RemoveModel("AddressLog");
+  Connection->RemoveModel("Address");
+  Manager->ReturnConnection(Connection);
+}
+
 TEST_F(DatabasePoolTest, DatabasePoolMethodsTest) {
   auto UniqueModelConn = Manager->GetUniqueModelConnection<AddressModel>();
   auto SharedModelConn = Manager->GetSharedModelConnection<AddressModel>();
@@ -138,4 +178,83 @@ TEST_F(DatabasePoolTest, DatabaseMultiThreadedTest) {
   }
 
   EXPECT_EQ(SuccessfulHits, 300);
-}
\ No newline at end of file
+}
+
+TEST_F(DatabasePoolTest, DatabasePoolScheduledTest) {
+  constexpr int JOBS = 32;
+  DatabasePool Pool{std::string(Manager->GetConnectionString()), 2};
+  Scheduler Workers{{.Threads = 8}};
+  std::atomic<int> Borrowed{0};
+  std::atomic<int> MostBorrowed{0};
+  std::atomic<int> Connected{0};
+
+  TaskGroup Group{Workers};
+  for (int i = 0; i < JOBS; i++) {
+    Group.RunWithConnection(Pool, [&](SharedManager &Connection) {
+      const int Now = ++Borrowed;
+      int Most = MostBorrowed.load();
+      while (Now > Most && !MostBorrowed.compare_exchange_weak(Most, Now)) {
+      }
+      if (Connection->IsDatabaseConnected()) {
+        Connected++;
+      }
+      Borrowed--;
+    });
+  }
+  Group.Wait();
+
+  EXPECT_EQ(Connected, JOBS);
+  EXPECT_LE(MostBorrowed, 2);
+  EXPECT_EQ(Pool.GetCurrentPoolSize(), 2);
+}
+
+TEST_F(DatabasePoolTest, DatabasePoolCheckoutTest) {
+  using namespace std::chrono_literals;
+  CheckoutOptions Options;
+  /** @brief the interactive and background lanes. */
+  Options.Lanes[0] = {1, 20ms};
+  Options.Lanes[2] = {2, 10s};
+  DatabasePool Pool{std::string(Manager->GetConnectionString()), 1, Options};
+
+  auto Held = Pool.CheckoutConnection(CheckoutPriority::Interactive);
+  ASSERT_TRUE(Held);
+  /** @brief the pool is empty, the interactive lane waits 20ms at most. */
+  auto Late = Pool.CheckoutConnection(CheckoutPriority::Interactive,
+                                      std::chrono::steady_clock::now() + 1h);
+  ASSERT_FALSE(Late);
+  EXPECT_EQ(Late.error(), CheckoutError::Timeout);
+  EXPECT_EQ(Pool.GetWaitingCount(CheckoutPriority::Interactive), 0);
+
+  std::mutex Mutex;
+  std::vector<CheckoutPriority> Served;
+  auto Wait = [&](CheckoutPriority Priority) {
+    auto Connection = Pool.GetManagerConnection(Priority);
+    {
+      std::lock_guard Lock{Mutex};
+      Served.push_back(Priority);
+    }
+    Pool.ReturnConnection(Connection);
+  };
+  auto Background =
+      std::async(std::launch::async, Wait, CheckoutPriority::Background);
+  while (Pool.GetWaitingCount(CheckoutPriority::Background) == 0) {
+    std::this_thread::yield();
+  }
+  auto Write = std::async(std::launch::async, Wait, CheckoutPriority::Write);
+  while (Pool.GetWaitingCount(CheckoutPriority::Write) == 0) {
+    std::this_thread::yield();
+  }
+  /** @brief two waiters are served before a new background one. */
+  auto Shed = Pool.CheckoutConnection(CheckoutPriority::Background);
+  ASSERT_FALSE(Shed);
+  EXPECT_EQ(Shed.error(), CheckoutError::QueueFull);
+
+  /** @brief the write came second but is served first. */
+  Pool.ReturnConnection(*Held);
+  Background.get();
+  Write.get();
+  const std::vector<CheckoutPriority> Order{CheckoutPriority::Write,
+                                            CheckoutPriority::Background};
+  EXPECT_EQ(Served, Order);
+  EXPECT_EQ(Pool.GetCurrentPoolSize(), 1);
+}
@@ -0,0 +1,97 @@
+#include "Config/QueryPlans.h"
+#include "../../Test.h"
+#include "Config/DatabaseManager.h"
+
+class QueryPlansTest : public ::testing::Test {
+protected:
+  void SetUp() override { QueryPlans::Reset(); }
+  void TearDown() override {
+    QueryPlans::Init({});
+    QueryPlans::Reset();
+  }
+};
+
+TEST_F(QueryPlansTest, QueryPlansParseTest) {
+  const std::string Plan = R"([{
+    "Plan": {
+      "Node Type": "Nested Loop",
+      "Plans": [
+        {"Node Type": "Seq Scan", "Relation Name": "address"},
+        {"Node Type": "Index Scan", "Relation Name": "addresslog",
+         "Index Name": "addresslog_pkey"},
+        {"Node Type": "Hash", "Plans": [
+          {"Node Type": "Seq Scan", "Relation Name": "addresslog"}]}
+      ]
+    },
+    "Planning Time": 0.1,
+    "Execution Time": 1.5
+  }])";
+  EXPECT_EQ(QueryPlans::ParseSeqScans(Plan),
+            (std::vector<std::string>{"address", "addresslog"}));
+  EXPECT_TRUE(QueryPlans::ParseSeqScans("not json").empty());
+}
+
+TEST_F(QueryPlansTest, QueryPlansReadOnlyTest) {
+  EXPECT_TRUE(QueryPlans::IsReadOnly("select * from address where id=$1"));
+  EXPECT_TRUE(QueryPlans::IsReadOnly(" (SELECT 1)"));
+  EXPECT_TRUE(QueryPlans::IsReadOnly("with a as (select 1) select * from a"));
+  EXPECT_FALSE(QueryPlans::IsReadOnly(
+      "with a as (delete from address returning *) select * from a"));
+  EXPECT_FALSE(QueryPlans::IsReadOnly("insert into address values ($1)"));
+  EXPECT_FALSE(QueryPlans::IsReadOnly("UPDATE address set x=$1"));
+  EXPECT_FALSE(QueryPlans::IsReadOnly(""));
+}
+
+TEST_F(QueryPlansTest, QueryPlansSampleTest) {
+  QueryPlans::Init({});
+  EXPECT_FALSE(QueryPlans::ShouldSample());
+  QueryPlans::Init({.Threshold = std::chrono::microseconds(1),
+                    .SampleRate = 1});
+  EXPECT_TRUE(QueryPlans::ShouldSample());
+  QueryPlans::Init({.Threshold = std::chrono::microseconds(1),
+                    .SampleRate = 0});
+  EXPECT_FALSE(QueryPlans::ShouldSample());
+}
+
+TEST_F(QueryPlansTest, QueryPlansCaptureTest) {
+  std::string ConnectionString;
+  if (std::getenv("GITHUB_ACTIONS") != nullptr) {
+    ConnectionString =
+        Config::TestDatabaseToString("../../configs/ci-config.json");
+  } else {
+    ConnectionString =
+        Config::TestDatabaseToString("../../configs/config.json");
+  }
+  auto Manager = std::make_shared<DatabaseManager>(ConnectionString);
+  Manager->AddModel("PlanTest", {{"id", "int"}, {"name", "text"}});
+  Manager->InsertInto("PlanTest", {{"id", "1"}, {"name", "plan"}});
+
+  QueryPlans::Init({.Threshold = std::chrono::microseconds(1),
+                    .SampleRate = 1});
+  Manager->GetModelData("PlanTest", "id", 1);
+  Manager->InsertInto("PlanTest", {{"id", "2"}, {"name", "plan"}});
+  QueryPlans::Flush();
+
+  const auto Select = QueryPlans::Find("select * from plantest where id=?");
+  ASSERT_TRUE(Select.has_value());
+  EXPECT_EQ(Select->SeqScans, (std::vector<std::string>{"plantest"}));
+  EXPECT_EQ(Select->Table, "PlanTest");
+  EXPECT_EQ(Select->Captures, 1);
+  EXPECT_NE(QueryPlans::Report().find("seqscan=plantest"), std::string::npos);
+
+  EXPECT_TRUE(Select->Analyzed);
+
+  /** @brief the insert is planned, not run again. */
+  auto Insert =
+      QueryPlans::Find("insert into plantest (name, id) values (?, ?)");
+  if (!Insert) {
+    Insert = QueryPlans::Find("insert into plantest (id, name) values (?, ?)");
+  }
+  ASSERT_TRUE(Insert.has_value());
+  EXPECT_FALSE(Insert->Analyzed);
+  EXPECT_EQ(Insert->ExecutionTime.count(), 0);
+  QueryPlans::Init({});
+  EXPECT_EQ(Manager->GetModelData("PlanTest").size(), 2);
+
+  Manager->RemoveModel("PlanTest");
+}
@@ -0,0 +1,87 @@
+#include "Config/QueryStats.h"
+#include "../../Test.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+class QueryStatsTest : public ::testing::Test {
+protected:
+  void SetUp() override { QueryStats::Reset(); }
+  void TearDown() override {
+    QueryStats::Reset();
+    QueryStats::SetSlowQueryThreshold(std::chrono::milliseconds(200));
+  }
+};
+
+TEST_F(QueryStatsTest, QueryStatsFingerprintTest) {
+  EXPECT_EQ(QueryStats::Fingerprint(
+                "insert into Address (addressname, addressnumber) values "
+                "($1, $2)"),
+            "insert into address (addressname, addressnumber) values (?, ?)");
+  EXPECT_EQ(QueryStats::Fingerprint("select *  from Address\n where id = 42 "
+                                    "and name = 'it''s' ;"),
+            "select * from address where id = ? and name = ?");
+  EXPECT_EQ(QueryStats::Fingerprint("update address set addressname=$1 where "
+                                    "addressnumber=$2"),
+            QueryStats::Fingerprint("UPDATE address SET addressname=$1 WHERE "
+                                    "addressnumber=$2"));
+  /** @brief digits inside identifiers are kept. */
+  EXPECT_EQ(QueryStats::Fingerprint("select col1 from t2 where x = -3.5e2"),
+            "select col1 from t2 where x = -?");
+}
+
+TEST_F(QueryStatsTest, QueryStatsRecordTest) {
+  using std::chrono::microseconds;
+  for (int i = 1; i <= 100; i++) {
+    QueryStats::Record("address",
+                       "select * from address where id=" + std::to_string(i),
+                       microseconds(i * 10), i % 10 == 0);
+  }
+  QueryStats::Record("logs", "delete from logs where id=$1",
+                     microseconds(5000), false);
+
+  auto Entries = QueryStats::Snapshot();
+  ASSERT_EQ(Entries.size(), 2);
+  const auto &Select = Entries[0];
+  EXPECT_EQ(Select.Fingerprint, "select * from address where id=?");
+  EXPECT_EQ(Select.Table, "address");
+  EXPECT_EQ(Select.Count, 100);
+  EXPECT_EQ(Select.Errors, 10);
+  EXPECT_EQ(Select.Slow, 0);
+  EXPECT_EQ(Select.Max, microseconds(1000));
+  EXPECT_EQ(Select.Mean(), microseconds(505));
+  /** @brief quantiles are bucket bounds, within a factor of two. */
+  EXPECT_GE(Select.Quantile(50), microseconds(500));
+  EXPECT_LE(Select.Quantile(50), microseconds(1000));
+  EXPECT_EQ(Select.Quantile(100), microseconds(1000));
+  EXPECT_EQ(Entries[1].Count, 1);
+
+  EXPECT_NE(QueryStats::Report().find("count=100 errors=10"),
+            std::string::npos);
+}
+
+TEST_F(QueryStatsTest, QueryStatsSlowQueryTest) {
+  const auto Directory =
+      std::filesystem::temp_directory_path() / "query-stats-test/";
+  std::filesystem::create_directories(Directory);
+  Logger::Init(LoggerOptions{.Path = Directory.string(),
+                             .FlushLevel = spdlog::level::trace,
+                             .SlowQueryThreshold =
+                                 std::chrono::milliseconds(50)});
+
+  QueryStats::Record("address", "select * from address where name = 'secret'",
+                     std::chrono::milliseconds(10), false);
+  QueryStats::Record("address", "select * from address where name = 'secret'",
+                     std::chrono::milliseconds(80), false);
+  Logger::Shutdown();
+
+  EXPECT_EQ(QueryStats::Snapshot().at(0).Slow, 1);
+  std::ifstream File(Directory / "slow.log");
+  std::stringstream Log;
+  Log << File.rdbuf();
+  EXPECT_NE(Log.str().find("SLOW QUERY - 80MS - address"), std::string::npos);
+  /** @brief only the fingerprint is written, never the values. */
+  EXPECT_EQ(Log.str().find("secret"), std::string::npos);
+  std::filesystem::remove_all(Directory);
+}
@@ -0,0 +1,136 @@
+#include "Config/SingleFlight.h"
+#include "../../Test.h"
+
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+void WaitForCoalesced(uint64_t Before, uint64_t Followers) {
+  while (SingleFlight::GetCoalesced() - Before < Followers) {
+    std::this_thread::yield();
+  }
+}
+} // namespace
+
+class SingleFlightTest : public ::testing::Test {
+protected:
+  void SetUp() override { SingleFlight::Init({.Enabled = true}); }
+  void TearDown() override { SingleFlight::Init({}); }
+};
+
+TEST_F(SingleFlightTest, SingleFlightKeyTest) {
+  const std::string Query = "select * from address where addressname = $1";
+  const std::string Name = "hamaas";
+  EXPECT_EQ(SingleFlight::MakeKey(Query, Name, 18),
+            SingleFlight::MakeKey(Query, "hamaas", 18));
+  EXPECT_NE(SingleFlight::MakeKey(Query, Name, 18),
+            SingleFlight::MakeKey(Query, Name, 19));
+  EXPECT_NE(SingleFlight::MakeKey(Query, "ab", "c"),
+            SingleFlight::MakeKey(Query, "a", "bc"));
+  EXPECT_NE(SingleFlight::MakeKey(Query), SingleFlight::MakeKey(Query, ""));
+  EXPECT_NE(SingleFlight::MakeKey(Query, true),
+            SingleFlight::MakeKey(Query, false));
+}
+
+TEST_F(SingleFlightTest, SingleFlightCoalesceTest) {
+  constexpr int Readers = 8;
+  const auto Key = SingleFlight::MakeKey("select 1 where $1", 42);
+  const uint64_t Coalesced = SingleFlight::GetCoalesced();
+  const uint64_t Executed = SingleFlight::GetExecuted();
+  std::promise<void> Release;
+  std::shared_future<void> Released = Release.get_future().share();
+  std::atomic<int> Executions{0};
+
+  std::vector<std::future<SingleFlight::Outcome>> Reads;
+  for (int i = 0; i < Readers; i++) {
+    Reads.push_back(std::async(std::launch::async, [&] {
+      return SingleFlight::Run(Key, [&] {
+        Executions++;
+        Released.wait();
+        return SingleFlight::Outcome{{}, false, 5ns};
+      });
+    }));
+  }
+  WaitForCoalesced(Coalesced, Readers - 1);
+  EXPECT_EQ(SingleFlight::GetInFlight(), 1);
+  Release.set_value();
+  for (auto &Read : Reads) {
+    const auto Result = Read.get();
+    EXPECT_FALSE(Result.Failed);
+    EXPECT_EQ(Result.Elapsed, 5ns);
+  }
+  EXPECT_EQ(Executions, 1);
+  EXPECT_EQ(SingleFlight::GetExecuted() - Executed, 1);
+  EXPECT_EQ(SingleFlight::GetInFlight(), 0);
+
+  /** @brief landed, the next read runs again. */
+  SingleFlight::Run(Key, [&] {
+    Executions++;
+    return SingleFlight::Outcome{};
+  });
+  EXPECT_EQ(Executions, 2);
+}
+
+TEST_F(SingleFlightTest, SingleFlightInvalidateTest) {
+  const auto Key = SingleFlight::MakeKey("select 2");
+  const uint64_t Coalesced = SingleFlight::GetCoalesced();
+  std::promise<void> Release;
+  std::shared_future<void> Released = Release.get_future().share();
+  auto Stale = [&] {
+    return SingleFlight::Run(Key, [&] {
+      Released.wait();
+      return SingleFlight::Outcome{{}, false, 1ns};
+    });
+  };
+  auto Leader = std::async(std::launch::async, Stale);
+  auto Follower = std::async(std::launch::async, Stale);
+  WaitForCoalesced(Coalesced, 1);
+
+  /** @brief a read after a write doesn't join the flight before it. */
+  SingleFlight::Invalidate();
+  const auto Fresh = SingleFlight::Run(
+      Key, [] { return SingleFlight::Outcome{{}, false, 2ns}; });
+  EXPECT_EQ(Fresh.Elapsed, 2ns);
+
+  Release.set_value();
+  EXPECT_EQ(Leader.get().Elapsed, 1ns);
+  EXPECT_EQ(Follower.get().Elapsed, 1ns);
+}
+
+TEST_F(SingleFlightTest, SingleFlightFailureTest) {
+  const auto Key = SingleFlight::MakeKey("select 3");
+  const uint64_t Coalesced = SingleFlight::GetCoalesced();
+  std::promise<void> Release;
+  std::shared_future<void> Released = Release.get_future().share();
+  auto Leader = std::async(std::launch::async, [&] {
+    return SingleFlight::Run(Key, [&]() -> SingleFlight::Outcome {
+      Released.wait();
+      throw std::runtime_error("fail");
+    });
+  });
+  /** @brief the leader runs first, it waits for the release. */
+  while (SingleFlight::GetInFlight() == 0) {
+    std::this_thread::yield();
+  }
+  auto Follower = std::async(std::launch::async, [&] {
+    return SingleFlight::Run(Key, [] { return SingleFlight::Outcome{}; });
+  });
+  WaitForCoalesced(Coalesced, 1);
+  Release.set_value();
+  EXPECT_THROW(Leader.get(), std::runtime_error);
+  EXPECT_TRUE(Follower.get().Failed);
+
+  SingleFlight::Init({.Enabled = false});
+  int Executions = 0;
+  for (int i = 0; i < 2; i++) {
+    SingleFlight::Run(Key, [&] {
+      Executions++;
+      return SingleFlight::Outcome{};
+    });
+  }
+  EXPECT_EQ(Executions, 2);
+}
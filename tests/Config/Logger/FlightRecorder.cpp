@@ -0,0 +1,123 @@
+#include "Config/FlightRecorder.h"
+#include "../../Test.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+class FlightRecorderTest : public ::testing::Test {
+protected:
+  struct Dumped {
+    FlightRecorder::FileHeader Header{};
+    std::vector<FlightRecorder::Event> Events;
+    size_t Torn = 0;
+  };
+
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "flight-recorder-test";
+
+  void SetUp() override { std::filesystem::create_directories(directory); }
+  void TearDown() override { std::filesystem::remove_all(directory); }
+
+  static Dumped Read(const std::filesystem::path &Path) {
+    Dumped Result;
+    std::ifstream File(Path, std::ios::binary);
+    File.read(reinterpret_cast<char *>(&Result.Header), sizeof(Result.Header));
+    File.seekg(Result.Header.EventTypes * sizeof(FlightEventType),
+               std::ios::cur);
+    for (uint32_t t = 0; t < Result.Header.ThreadCount; t++) {
+      FlightRecorder::ThreadHeader Thread{};
+      File.read(reinterpret_cast<char *>(&Thread), sizeof(Thread));
+      for (uint32_t e = 0; e < Thread.Count; e++) {
+        FlightRecorder::Event Event{};
+        File.read(reinterpret_cast<char *>(&Event), sizeof(Event));
+        if (Event.Torn != 0) {
+          Result.Torn++;
+        } else {
+          Result.Events.push_back(Event);
+        }
+      }
+    }
+    EXPECT_TRUE(File.good());
+    return Result;
+  }
+};
+
+TEST_F(FlightRecorderTest, FlightRecorderDumpTest) {
+  constexpr uint64_t Marker = 0xF11647;
+  std::vector<std::thread> Threads;
+  for (uint64_t t = 0; t < 3; t++) {
+    Threads.emplace_back([t] {
+      for (uint64_t i = 0; i < 100; i++) {
+        FlightRecorder::Record(FlightEvent::Mark, Marker, t * 1000 + i);
+      }
+    });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+
+  /** @brief the rings of exited threads are still dumped. */
+  const auto Path = directory / "manual.bin";
+  ASSERT_TRUE(FlightRecorder::Dump(Path.string()));
+  auto Dump = Read(Path);
+  EXPECT_EQ(Dump.Header.Magic, FlightRecorder::Magic);
+  EXPECT_EQ(Dump.Header.Reason, FlightDumpReason::Manual);
+  EXPECT_EQ(Dump.Header.EventTypes, FlightEventTypes.size());
+  EXPECT_EQ(Dump.Torn, 0);
+  size_t Marked = 0;
+  for (const auto &Event : Dump.Events) {
+    if (Event.Id == static_cast<uint16_t>(FlightEvent::Mark) &&
+        Event.Args[0] == Marker) {
+      Marked++;
+    }
+  }
+  EXPECT_EQ(Marked, 300);
+}
+
+TEST_F(FlightRecorderTest, FlightRecorderConcurrentDumpTest) {
+  std::atomic<bool> Running{true};
+  std::vector<std::thread> Threads;
+  for (int t = 0; t < 4; t++) {
+    Threads.emplace_back([&Running] {
+      for (uint64_t i = 0; Running.load(std::memory_order_relaxed); i++) {
+        FlightRecorder::Record(FlightEvent::QueryEnd, i, i * 2);
+      }
+    });
+  }
+  /** @brief dumps taken under writers only keep whole events. */
+  const auto Path = directory / "concurrent.bin";
+  for (int i = 0; i < 20; i++) {
+    ASSERT_TRUE(FlightRecorder::Dump(Path.string()));
+    for (const auto &Event : Read(Path).Events) {
+      ASSERT_LT(Event.Id, static_cast<uint16_t>(FlightEvent::Count));
+      if (Event.Id == static_cast<uint16_t>(FlightEvent::QueryEnd)) {
+        ASSERT_EQ(Event.Args[1], Event.Args[0] * 2);
+      }
+    }
+  }
+  Running = false;
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+}
+
+TEST_F(FlightRecorderTest, FlightRecorderErrorDumpTest) {
+  FlightRecorder::Init({.Path = directory.string() + "/",
+                        .DumpOnCrash = false,
+                        .ErrorDumpInterval = std::chrono::minutes(1)});
+  FlightRecorder::Record(FlightEvent::LogError, 4);
+  EXPECT_TRUE(FlightRecorder::DumpOnError());
+  EXPECT_FALSE(FlightRecorder::DumpOnError());
+
+  bool Found = false;
+  for (const auto &Entry : std::filesystem::directory_iterator(directory)) {
+    if (Entry.path().filename().string().starts_with("flight-error-")) {
+      Found = true;
+      EXPECT_EQ(Read(Entry.path()).Header.Reason, FlightDumpReason::Error);
+    }
+  }
+  EXPECT_TRUE(Found);
+}
@@ -0,0 +1,86 @@
+#include "Config/LogRateLimiter.h"
+#include "../../Test.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+class LogRateLimiterTest : public ::testing::Test {
+protected:
+  const LogRateLimiter::Clock::time_point now = LogRateLimiter::Clock::now();
+};
+
+TEST_F(LogRateLimiterTest, LogRateLimiterBurstTest) {
+  LogRateLimiter Limiter("BURST TEST", 10, 5);
+  int Allowed = 0;
+  for (int i = 0; i < 100; i++) {
+    Allowed += Limiter.Allow(now);
+  }
+  EXPECT_EQ(Allowed, 5);
+  EXPECT_EQ(Limiter.GetCounters().Emitted, 5);
+  EXPECT_EQ(Limiter.GetCounters().Suppressed, 95);
+
+  /** @brief a token every 100ms. */
+  EXPECT_FALSE(Limiter.Allow(now + std::chrono::milliseconds(50)));
+  EXPECT_TRUE(Limiter.Allow(now + std::chrono::milliseconds(100)));
+  EXPECT_FALSE(Limiter.Allow(now + std::chrono::milliseconds(100)));
+
+  /** @brief an idle bucket refills up to the burst, not past it. */
+  Allowed = 0;
+  for (int i = 0; i < 100; i++) {
+    Allowed += Limiter.Allow(now + std::chrono::minutes(1));
+  }
+  EXPECT_EQ(Allowed, 5);
+}
+
+TEST_F(LogRateLimiterTest, LogRateLimiterSummaryTest) {
+  LogRateLimiter Limiter("SUMMARY TEST", 1, 1);
+  /** @brief the summary interval starts when the limiter is built. */
+  const auto now = LogRateLimiter::Clock::now();
+  EXPECT_TRUE(Limiter.Allow(now));
+  EXPECT_FALSE(Limiter.TakeSummary(now).has_value());
+
+  for (int i = 0; i < 10; i++) {
+    EXPECT_FALSE(Limiter.Allow(now));
+  }
+  /** @brief nothing before the interval, then everything once. */
+  EXPECT_FALSE(Limiter.TakeSummary(now).has_value());
+  auto Summary = Limiter.TakeSummary(now + LogRateLimiter::SummaryInterval);
+  ASSERT_TRUE(Summary.has_value());
+  EXPECT_EQ(Summary->Suppressed, 10);
+  EXPECT_GE(Summary->Period, LogRateLimiter::SummaryInterval);
+  EXPECT_FALSE(
+      Limiter.TakeSummary(now + LogRateLimiter::SummaryInterval * 3)
+          .has_value());
+}
+
+TEST_F(LogRateLimiterTest, LogRateLimiterConcurrencyTest) {
+  LogRateLimiter Limiter("CONCURRENCY TEST", 10, 100);
+  std::vector<std::thread> Threads;
+  for (int t = 0; t < 8; t++) {
+    Threads.emplace_back([this, &Limiter] {
+      for (int i = 0; i < 10'000; i++) {
+        Limiter.Allow(now);
+      }
+    });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  EXPECT_EQ(Limiter.GetCounters().Emitted, 100);
+  EXPECT_EQ(Limiter.GetCounters().Suppressed, 80'000 - 100);
+}
+
+TEST_F(LogRateLimiterTest, LogRateLimiterCountersTest) {
+  auto Contains = [](const std::string &Key) {
+    auto All = LogRateLimiter::GetAllCounters();
+    return std::any_of(All.begin(), All.end(),
+                       [&Key](const auto &Entry) { return Entry.Key == Key; });
+  };
+  {
+    LogRateLimiter Limiter("COUNTERS TEST");
+    Limiter.Allow(now);
+    EXPECT_TRUE(Contains("COUNTERS TEST"));
+  }
+  EXPECT_FALSE(Contains("COUNTERS TEST"));
+}
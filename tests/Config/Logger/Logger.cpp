@@ -17,4 +17,33 @@ int main() {
   SYSTEM_CRITICAL("Test");
   SYSTEM_DEBUG("Test");
   SYSTEM_WARNING("Test");
+
+  /**
+   * @brief the arguments of a filtered statement are never evaluated, the
+   * ones of a statement that passes are, once.
+   */
+  int Evaluated = 0;
+  Logger::GetAppLogger()->set_level(spdlog::level::info);
+  APP_TRACE("Test {}", ++Evaluated);
+  APP_DEBUG("Test {}", ++Evaluated);
+  APP_INFO("Test {}", ++Evaluated);
+  if (Evaluated != 1) {
+    return 1;
+  }
+
+  /** @brief a queue smaller than the burst, drops instead of blocking. */
+  Logger::Init(LoggerOptions{.Path = "logs/",
+                             .Async = true,
+                             .QueueSize = 16,
+                             .Overflow = LogOverflowPolicy::Drop});
+  for (int i = 0; i < 1000; i++) {
+    APP_INFO("Async Test");
+  }
+  APP_ERROR("Async Test");
+  /** @brief what liveview_log_dropped_total reports. */
+  const size_t Dropped = Logger::GetDroppedCount();
+  Logger::Shutdown();
+  if (Dropped == 0) {
+    return 1;
+  }
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "Core/Location/GeoPoint.h"
+#include "../../Test.h"
+
+#include <limits>
+
+static_assert(GeoPoint::Create(47.0000625, 8.0000625)->GetPlusCode() ==
+              "8FVC2222+22");
+static_assert(GeoPoint::Create(91, 0).error() ==
+              GeoPointError::LatitudeOutOfRange);
+
+class GeoPointTest : public ::testing::Test {
+protected:
+  const double latitude = 35.689487;
+  const double longitude = 139.691711;
+};
+
+TEST_F(GeoPointTest, GeoPointCreateTest) {
+  auto Point = GeoPoint::Create(latitude, longitude);
+
+  ASSERT_TRUE(Point.has_value());
+  EXPECT_EQ(Point->GetLatitudeE7(), 356894870);
+  EXPECT_NEAR(Point->GetLatitude(), latitude, 1e-7);
+  EXPECT_NEAR(Point->GetLongitude(), longitude, 1e-7);
+  EXPECT_EQ(GeoPoint::FromE7(356894870, 1396917110), *Point);
+}
+
+TEST_F(GeoPointTest, GeoPointValidationTest) {
+  EXPECT_EQ(GeoPoint::Create(-90.5, 0).error(),
+            GeoPointError::LatitudeOutOfRange);
+  EXPECT_EQ(GeoPoint::Create(0, 181).error(),
+            GeoPointError::LongitudeOutOfRange);
+  EXPECT_EQ(GeoPoint::Create(std::numeric_limits<double>::quiet_NaN(), 0)
+                .error(),
+            GeoPointError::NotFinite);
+  EXPECT_EQ(GeoPoint::FromE7(0, 1'800'000'001).error(),
+            GeoPointError::LongitudeOutOfRange);
+  EXPECT_TRUE(GeoPoint::Create(90, 180).has_value());
+}
+
+TEST_F(GeoPointTest, GeoPointPlusCodeTest) {
+  auto Point = GeoPoint::Create(latitude, longitude).value();
+
+  for (size_t Length : {2, 4, 6, 8, 9, 10, 11, 12, 14}) {
+    EXPECT_EQ(Point.GetPlusCode(Length),
+              openlocationcode::Encode(Point.ToLatLng(), Length));
+  }
+  EXPECT_EQ(Point.GetCellId().code_length(), GeoPoint::CellCodeLength);
+  EXPECT_EQ(GeoPoint().GetCellId(),
+            openlocationcode::CellId::FromLatLng({0, 0}, 12));
+}
+
+TEST_F(GeoPointTest, GeoPointGeolocationTest) {
+  auto Point = GeoPoint::Create(latitude, longitude).value();
+  auto Location = Point.ToGeolocation();
+
+  EXPECT_EQ(Location.GetPlusCode(), Point.GetPlusCode().str());
+  EXPECT_EQ(Location.GetCellId(), Point.GetCellId().parent(10));
+}
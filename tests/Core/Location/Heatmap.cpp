@@ -0,0 +1,106 @@
+#include "Core/Location/Heatmap.h"
+#include "../../Test.h"
+
+#include <thread>
+#include <vector>
+
+class HeatmapTest : public ::testing::Test {
+protected:
+  const openlocationcode::LatLng location{35.689487, 139.691711};
+  const Heatmap::TimePoint now =
+      Heatmap::TimePoint(std::chrono::seconds(1'700'000'000));
+};
+
+TEST_F(HeatmapTest, HeatmapRecordTest) {
+  Heatmap Map;
+  auto Point = GeoPoint::Create(location.latitude, location.longitude);
+  ASSERT_TRUE(Point.has_value());
+
+  EXPECT_TRUE(Map.Record(location, 1, now));
+  EXPECT_TRUE(Map.Record(*Point, 2.5, now));
+  EXPECT_FALSE(Map.Record(openlocationcode::CellId(), 1, now));
+
+  auto Cell = Map.Get(openlocationcode::CellId::FromLatLng(location, 10),
+                      std::chrono::minutes(1), now);
+  EXPECT_EQ(Map.CellCount(), 1);
+  EXPECT_EQ(Cell.Count, 2);
+  EXPECT_DOUBLE_EQ(Cell.Sum, 3.5);
+  EXPECT_EQ(Map.Get(Point->GetCellId(), std::chrono::minutes(1), now).Count,
+            2);
+}
+
+TEST_F(HeatmapTest, HeatmapSlidingWindowTest) {
+  Heatmap Map({.CodeLength = 8,
+               .BucketWidth = std::chrono::seconds(10),
+               .BucketCount = 6});
+  auto Id = openlocationcode::CellId::FromLatLng(location, 8);
+  for (int i = 0; i < 6; i++) {
+    EXPECT_TRUE(Map.Record(location, 1, now + std::chrono::seconds(10 * i)));
+  }
+  auto Last = now + std::chrono::seconds(50);
+
+  EXPECT_EQ(Map.Get(Id, std::chrono::seconds(10), Last).Count, 1);
+  EXPECT_EQ(Map.Get(Id, std::chrono::seconds(30), Last).Count, 3);
+  EXPECT_EQ(Map.Get(Id, std::chrono::hours(1), Last).Count, 6);
+
+  /** @brief the ring turned, the first bucket is reused and dropped. */
+  EXPECT_TRUE(Map.Record(location, 1, now + std::chrono::seconds(60)));
+  EXPECT_FALSE(Map.Record(location, 1, now));
+  EXPECT_EQ(
+      Map.Get(Id, std::chrono::minutes(1), now + std::chrono::seconds(60))
+          .Count,
+      6);
+
+  EXPECT_EQ(Map.Prune(now + std::chrono::seconds(119)), 0);
+  EXPECT_EQ(Map.Prune(now + std::chrono::seconds(120)), 1);
+  EXPECT_EQ(Map.CellCount(), 0);
+}
+
+TEST_F(HeatmapTest, HeatmapRollupTest) {
+  Heatmap Map({.CodeLength = 10});
+  for (double Offset = 0; Offset < 0.01; Offset += 0.001) {
+    Map.Record(openlocationcode::LatLng{location.latitude + Offset, location.longitude}, 1, now);
+    Map.Record(openlocationcode::LatLng{-location.latitude, location.longitude + Offset}, 2, now);
+  }
+  auto Snapshot = Map.Snapshot(std::chrono::minutes(1), now);
+  auto Parents = Heatmap::Rollup(Snapshot, 4);
+
+  EXPECT_EQ(Snapshot.size(), 20);
+  ASSERT_EQ(Parents.size(), 2);
+  for (const auto &Parent : Parents) {
+    EXPECT_EQ(Parent.Id.code_length(), 4);
+    EXPECT_EQ(Parent.Count, 10);
+    auto Cell = Map.Get(Parent.Id, std::chrono::minutes(1), now);
+    EXPECT_EQ(Cell.Count, Parent.Count);
+    EXPECT_DOUBLE_EQ(Cell.Sum, Parent.Sum);
+  }
+}
+
+TEST_F(HeatmapTest, HeatmapConcurrentWritersTest) {
+  Heatmap Map;
+  std::vector<std::thread> Writers;
+  for (int Thread = 0; Thread < 4; Thread++) {
+    Writers.emplace_back([&Map, this, Thread] {
+      for (int i = 0; i < 10000; i++) {
+        Map.Record(
+            openlocationcode::LatLng{location.latitude + (i % 50) * 0.0005,
+                                     location.longitude + Thread * 0.0005},
+            1, now);
+      }
+    });
+  }
+  /** @brief snapshots are taken while the writers run. */
+  for (int i = 0; i < 10; i++) {
+    EXPECT_LE(Map.Snapshot(std::chrono::minutes(1), now).size(), 200);
+  }
+  for (auto &Writer : Writers) {
+    Writer.join();
+  }
+
+  uint64_t Total = 0;
+  for (const auto &Cell : Map.Snapshot(std::chrono::minutes(1), now)) {
+    Total += Cell.Count;
+  }
+  EXPECT_EQ(Total, 40000);
+  EXPECT_EQ(Map.CellCount(), 200);
+}
@@ -0,0 +1,236 @@
+#include "Core/Location/PlusCodes/cellid.h"
+#include "Core/Location/PlusCodes/covering.h"
+#include "Core/Location/PlusCodes/openlocationcode.h"
+#include "Core/Location/PlusCodes/validator.h"
+#include "../../Test.h"
+#include "Reference/Differential.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace olc = openlocationcode;
+
+/**
+ * @brief the encode/decode path is constexpr, these are checked at compile
+ * time.
+ */
+static_assert(olc::Encode({47.0000625, 8.0000625}) == "8FVC2222+22");
+static_assert(olc::Encode({47.0000625, 8.0000625}, 4) == "8FVC0000+");
+static_assert(olc::IsValid("8FVC2222+22"));
+static_assert(olc::IsFull("8FVC2222+22"));
+static_assert(olc::IsShort("CJ+2VX"));
+static_assert(olc::CodeLength("8FVC2222+22") == 10);
+static_assert(olc::Classify("8FVC2222+22") == olc::CodeType::kFull);
+static_assert(olc::Classify("CJ+2VX") == olc::CodeType::kShort);
+static_assert(olc::Classify("WC2F0000+") == olc::CodeType::kOutOfRange);
+static_assert(olc::Classify("8FVC00+00") == olc::CodeType::kInvalid);
+static_assert(olc::Decode("8FVC2222+22").GetCodeLength() == 10);
+static_assert(olc::Shorten("9C3W9QCJ+2VX", {51.3708675, -1.217765625}) ==
+              "CJ+2VX");
+static_assert(olc::RecoverNearest("CJ+2VX", {51.3708675, -1.217765625}) ==
+              "9C3W9QCJ+2VX");
+
+static_assert(olc::CellId::FromCode("8FVC2222+22").ToCode() == "8FVC2222+22");
+static_assert(olc::CellId::FromCode("8FVC2222+22").parent(4) ==
+              olc::CellId::FromCode("8FVC0000+"));
+static_assert(olc::CellId::FromCode("8FVC0000+").contains(
+    olc::CellId::FromCode("8FVC2222+22")));
+static_assert(olc::CellId::FromCode("8FVC2222+2222").child(0) ==
+              olc::CellId::FromCode("8FVC2222+2222"));
+
+class PlusCodesTest : public ::testing::Test {
+protected:
+  const olc::LatLng location{35.689487, 139.691711};
+};
+
+TEST_F(PlusCodesTest, PlusCodesEncodeLengthTest) {
+  EXPECT_EQ(olc::Encode(location, 2).size(), 9);
+  EXPECT_EQ(olc::Encode(location, 10).size(), 11);
+  EXPECT_EQ(olc::Encode(location, 15).size(), 16);
+  EXPECT_EQ(olc::Encode(location, 20).size(), olc::CodeBuffer::kCapacity);
+}
+
+TEST_F(PlusCodesTest, PlusCodesDecodeTest) {
+  auto Code = olc::Encode(location, 11);
+  auto Area = olc::Decode(Code);
+
+  EXPECT_EQ(Area.GetCodeLength(), 11);
+  EXPECT_LE(Area.GetLatitudeLo(), location.latitude);
+  EXPECT_GT(Area.GetLatitudeHi(), location.latitude);
+  EXPECT_LE(Area.GetLongitudeLo(), location.longitude);
+  EXPECT_GT(Area.GetLongitudeHi(), location.longitude);
+}
+
+TEST_F(PlusCodesTest, PlusCodesStringInteropTest) {
+  std::string Code = olc::Encode(location);
+  std::string Shortened =
+      olc::Shorten(Code, {location.latitude + 0.01, location.longitude});
+
+  EXPECT_TRUE(olc::IsFull(Code));
+  EXPECT_TRUE(olc::IsShort(Shortened));
+  EXPECT_EQ(olc::RecoverNearest(Shortened, location), Code);
+}
+
+TEST_F(PlusCodesTest, PlusCodesCellIdRoundTripTest) {
+  for (size_t Length : {2, 4, 6, 8, 10, 11, 12}) {
+    auto Cell = olc::CellId::FromLatLng(location, Length);
+
+    EXPECT_TRUE(Cell.is_valid());
+    EXPECT_EQ(Cell.code_length(), Length);
+    EXPECT_EQ(Cell.ToCode(), olc::Encode(location, Length));
+    EXPECT_LT(Cell.id(), uint64_t{1} << 63);
+  }
+  EXPECT_FALSE(olc::CellId::FromCode("CJ+2VX").is_valid());
+  EXPECT_EQ(olc::CellId::FromLatLng(location, 15).code_length(),
+            olc::CellId::kMaxCodeLength);
+}
+
+TEST_F(PlusCodesTest, PlusCodesCellIdHierarchyTest) {
+  auto Cell = olc::CellId::FromLatLng(location, 12);
+  auto Area = Cell.ToArea();
+
+  for (size_t Length = 0; Length <= Cell.code_length(); Length++) {
+    auto Parent = Cell.parent(Length);
+    EXPECT_TRUE(Parent.contains(Cell));
+    EXPECT_GE(Cell.id(), Parent.range_min());
+    EXPECT_LE(Cell.id(), Parent.range_max());
+  }
+  EXPECT_EQ(Cell.parent().child(Cell.digit(11)), Cell);
+  EXPECT_EQ(Cell.parent(0), olc::CellId::Root());
+  EXPECT_TRUE(olc::CellId::Root().is_root());
+  EXPECT_FALSE(Cell.is_root());
+  EXPECT_EQ(olc::CellId::Root().parent(), olc::CellId::Root());
+  EXPECT_EQ(Cell.child(0), Cell);
+  EXPECT_EQ(Cell.parent().child(0).child(0), Cell.parent().child(0));
+  EXPECT_LE(Area.GetLatitudeLo(), location.latitude);
+  EXPECT_GE(Area.GetLatitudeHi(), location.latitude);
+}
+
+TEST_F(PlusCodesTest, PlusCodesCellIdOrderTest) {
+  std::vector<olc::CellId> Cells;
+  std::vector<std::string> Codes;
+  for (double Latitude = -80; Latitude < 80; Latitude += 7.3) {
+    for (double Longitude = -170; Longitude < 170; Longitude += 11.1) {
+      auto Cell = olc::CellId::FromLatLng({Latitude, Longitude});
+      Cells.push_back(Cell);
+      Codes.push_back(Cell.ToCode());
+    }
+  }
+  /** @brief the alphabet is in ascii order, so ids sort like the codes. */
+  std::sort(Cells.begin(), Cells.end());
+  std::sort(Codes.begin(), Codes.end());
+
+  for (size_t i = 0; i < Cells.size(); i++) {
+    EXPECT_EQ(Cells[i].ToCode(), Codes[i]);
+  }
+}
+
+TEST_F(PlusCodesTest, PlusCodesCoveringTest) {
+  olc::LatLngRect Box({35.68, 139.68}, {35.70, 139.70});
+  olc::Cap Circle(location, 1500);
+  olc::LatLngRect Antimeridian({-17.0, 179.9}, {-16.9, -179.9});
+
+  for (const olc::Region *Region :
+       std::initializer_list<const olc::Region *>{&Box, &Circle,
+                                                  &Antimeridian}) {
+    auto Cells = olc::GetCovering(*Region);
+    auto Ranges = olc::GetRanges(Cells);
+    EXPECT_LE(Cells.size(), 8);
+    EXPECT_LE(Ranges.size(), Cells.size());
+    EXPECT_TRUE(std::is_sorted(Cells.begin(), Cells.end()));
+  }
+
+  /** @brief every point inside a region falls in one of its ranges. */
+  auto Covered = [](const std::vector<olc::CellRange> &Ranges,
+                    const olc::LatLng &Point) {
+    auto Id = olc::CellId::FromLatLng(Point, olc::CellId::kMaxCodeLength).id();
+    return std::any_of(Ranges.begin(), Ranges.end(), [Id](const auto &Range) {
+      return Id >= Range.min && Id <= Range.max;
+    });
+  };
+  auto BoxRanges = olc::GetRanges(olc::GetCovering(Box));
+  auto CircleRanges = olc::GetRanges(olc::GetCovering(Circle));
+  auto AntimeridianRanges = olc::GetRanges(olc::GetCovering(Antimeridian));
+  for (double i = 0; i <= 1; i += 0.05) {
+    for (double j = 0; j <= 1; j += 0.05) {
+      EXPECT_TRUE(Covered(BoxRanges, {35.68 + 0.02 * i, 139.68 + 0.02 * j}));
+      double Longitude = 179.9 + 0.2 * j;
+      EXPECT_TRUE(Covered(AntimeridianRanges,
+                          {-17.0 + 0.1 * i,
+                           Longitude >= 180 ? Longitude - 360 : Longitude}));
+      olc::LatLng Point{location.latitude - 0.014 + 0.028 * i,
+                        location.longitude - 0.017 + 0.034 * j};
+      if (Circle.Contains(Point)) {
+        EXPECT_TRUE(Covered(CircleRanges, Point));
+      }
+    }
+  }
+}
+
+TEST_F(PlusCodesTest, PlusCodesReferenceTest) {
+  /** @brief random points, each with a nearby and a far reference location. */
+  std::mt19937 Generator(42);
+  std::uniform_real_distribution<double> Latitude(-90, 90);
+  std::uniform_real_distribution<double> Longitude(-180, 180);
+  std::uniform_real_distribution<double> Offset(-0.5, 0.5);
+  for (int i = 0; i < 5000; i++) {
+    olc::LatLng Point{Latitude(Generator), Longitude(Generator)};
+    olc::LatLng Near{Point.latitude + Offset(Generator) / 10,
+                     Point.longitude + Offset(Generator) / 10};
+    olc::LatLng Far{Latitude(Generator), Longitude(Generator)};
+    for (const auto &Difference : PlusCodesDifferences(Point, Near)) {
+      ADD_FAILURE() << Difference;
+    }
+    for (const auto &Difference : PlusCodesDifferences(Point, Far)) {
+      ADD_FAILURE() << Difference;
+    }
+  }
+  for (double Latitude : {-90.0, -89.9999999, 0.0, 89.9999999, 90.0}) {
+    for (double Longitude : {-180.0, -179.9999999, 0.0, 179.9999999, 180.0}) {
+      for (const auto &Difference :
+           PlusCodesDifferences({Latitude, Longitude}, location)) {
+        ADD_FAILURE() << Difference;
+      }
+    }
+  }
+  for (const char *Code :
+       {"", "+", "8F", "8FVC+", "8FVC0000+", "8FVC000+", "8FVC00+00",
+        "8fvc2222+22", "8FVC2222+2", "8FVC2222+2222222", "CJ+2VX", "CJ+2V0",
+        "+2VX", "9C3W9QCJ2VX", "9C3W9QCJ++2VX", "C2000000+", "WC2F0000+"}) {
+    for (const auto &Difference : PlusCodesValidationDifferences(Code)) {
+      ADD_FAILURE() << Difference;
+    }
+  }
+}
+
+TEST_F(PlusCodesTest, PlusCodesClassifyBatchTest) {
+  /** @brief encoded codes, then the same codes with a character replaced. */
+  std::mt19937 Generator(7);
+  std::uniform_real_distribution<double> Latitude(-90, 90);
+  std::uniform_real_distribution<double> Longitude(-180, 180);
+  std::uniform_int_distribution<size_t> Length(2, 15);
+  const std::string Characters = "23456789CFGHJMPQRVWXcfgx01+ AZ\xff";
+  std::uniform_int_distribution<size_t> Character(0, Characters.size() - 1);
+  std::vector<std::string> Codes;
+  for (int i = 0; i < 20000; i++) {
+    std::string Code =
+        olc::Encode({Latitude(Generator), Longitude(Generator)},
+                    Length(Generator));
+    Codes.push_back(Code);
+    Code[Generator() % Code.size()] = Characters[Character(Generator)];
+    Codes.push_back(Code);
+    Codes.push_back(Code.substr(Generator() % Code.size()));
+  }
+  for (const char *Code : {"", "+", "8FVC2222+2222222", "8FVC2222+22222222",
+                           "8FVC0000+", "8FVC000+", "CJ+2VX", "WC2F0000+"}) {
+    Codes.emplace_back(Code);
+  }
+
+  auto Types = olc::ClassifyBatch(std::span<const std::string>(Codes));
+  ASSERT_EQ(Types.size(), Codes.size());
+  for (size_t i = 0; i < Codes.size(); i++) {
+    EXPECT_EQ(Types[i], olc::Classify(Codes[i])) << Codes[i];
+    EXPECT_EQ(Types[i] != olc::CodeType::kInvalid, olc::IsValid(Codes[i]));
+  }
+}
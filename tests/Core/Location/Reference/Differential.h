@@ -0,0 +1,118 @@
+#ifndef PLUS_CODES_DIFFERENTIAL_H
+#define PLUS_CODES_DIFFERENTIAL_H
+
+#include "Core/Location/PlusCodes/openlocationcode.h"
+#include "openlocationcode.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file Differential.h
+ * @brief checks the constexpr plus code implementation against the reference
+ * one it replaced, shared by the PlusCodes tests and benchmarks.
+ */
+
+/**
+ * @brief the code lengths checked, odd lengths below 10 are rounded up by
+ * Encode and lengths past 15 are clamped.
+ */
+inline constexpr size_t DifferentialCodeLengths[] = {2,  3,  4,  6,  8,
+                                                     9,  10, 11, 12, 13,
+                                                     14, 15, 16};
+
+/**
+ * @brief IsValid, IsShort, IsFull, Classify and CodeLength of any string.
+ * @param Code
+ * @return std::vector<std::string>, a description of each difference.
+ */
+inline std::vector<std::string>
+PlusCodesValidationDifferences(std::string_view Code) {
+  namespace olc = openlocationcode;
+  namespace ref = openlocationcode_reference;
+  std::vector<std::string> Differences;
+  const std::string Input(Code);
+  if (olc::IsValid(Code) != ref::IsValid(Input)) {
+    Differences.push_back("IsValid(" + Input + ")");
+  }
+  if (olc::IsShort(Code) != ref::IsShort(Input)) {
+    Differences.push_back("IsShort(" + Input + ")");
+  }
+  if (olc::IsFull(Code) != ref::IsFull(Input)) {
+    Differences.push_back("IsFull(" + Input + ")");
+  }
+  const olc::CodeType Type = olc::Classify(Code);
+  if ((Type != olc::CodeType::kInvalid) != ref::IsValid(Input) ||
+      (Type == olc::CodeType::kShort) != ref::IsShort(Input) ||
+      (Type == olc::CodeType::kFull) != ref::IsFull(Input)) {
+    Differences.push_back("Classify(" + Input + ")");
+  }
+  if (olc::CodeLength(Code) != ref::CodeLength(Input)) {
+    Differences.push_back("CodeLength(" + Input + ")");
+  }
+  return Differences;
+}
+
+/**
+ * @brief Encode at every checked length, then Decode, validation, Shorten and
+ * RecoverNearest of the encoded code.
+ * @param Location
+ * @param Reference reference location for Shorten and RecoverNearest.
+ * @return std::vector<std::string>, a description of each difference.
+ */
+inline std::vector<std::string>
+PlusCodesDifferences(const openlocationcode::LatLng &Location,
+                     const openlocationcode::LatLng &Reference) {
+  namespace olc = openlocationcode;
+  namespace ref = openlocationcode_reference;
+  std::vector<std::string> Differences;
+  const ref::LatLng RefLocation{Location.latitude, Location.longitude};
+  const ref::LatLng RefReference{Reference.latitude, Reference.longitude};
+  auto Point = [](const olc::LatLng &L) {
+    return std::to_string(L.latitude) + "," + std::to_string(L.longitude);
+  };
+
+  for (size_t Length : DifferentialCodeLengths) {
+    const std::string Expected = ref::Encode(RefLocation, Length);
+    const olc::CodeBuffer Code = olc::Encode(Location, Length);
+    if (Code != Expected) {
+      Differences.push_back("Encode(" + Point(Location) + ", " +
+                            std::to_string(Length) + ") " + Code.str() +
+                            " != " + Expected);
+    }
+
+    const auto ExpectedArea = ref::Decode(Expected);
+    const auto Area = olc::Decode(Expected);
+    if (Area.GetLatitudeLo() != ExpectedArea.GetLatitudeLo() ||
+        Area.GetLongitudeLo() != ExpectedArea.GetLongitudeLo() ||
+        Area.GetLatitudeHi() != ExpectedArea.GetLatitudeHi() ||
+        Area.GetLongitudeHi() != ExpectedArea.GetLongitudeHi() ||
+        Area.GetCodeLength() != ExpectedArea.GetCodeLength()) {
+      Differences.push_back("Decode(" + Expected + ")");
+    }
+
+    auto Validation = PlusCodesValidationDifferences(Expected);
+    Differences.insert(Differences.end(), Validation.begin(),
+                       Validation.end());
+
+    const std::string ExpectedShort = ref::Shorten(Expected, RefReference);
+    const olc::CodeBuffer Short = olc::Shorten(Expected, Reference);
+    if (Short != ExpectedShort) {
+      Differences.push_back("Shorten(" + Expected + ", " + Point(Reference) +
+                            ") " + Short.str() + " != " + ExpectedShort);
+    }
+
+    const std::string ExpectedFull =
+        ref::RecoverNearest(ExpectedShort, RefReference);
+    const olc::CodeBuffer Full = olc::RecoverNearest(ExpectedShort, Reference);
+    if (Full != ExpectedFull) {
+      Differences.push_back("RecoverNearest(" + ExpectedShort + ", " +
+                            Point(Reference) + ") " + Full.str() +
+                            " != " + ExpectedFull);
+    }
+  }
+  return Differences;
+}
+
+#endif
@@ -1,8 +1,8 @@
-#include "../inc/Core/Location/PlusCodes/codearea.h"
+#include "codearea.h"
 
 #include <algorithm>
 
-namespace openlocationcode {
+namespace openlocationcode_reference {
 
 const double kLatitudeMaxDegrees = 90;
 const double kLongitudeMaxDegrees = 180;
@@ -33,4 +33,4 @@ LatLng CodeArea::GetCenter() const {
   return center;
 }
 
-} // namespace openlocationcode
\ No newline at end of file
+} // namespace openlocationcode_reference
\ No newline at end of file
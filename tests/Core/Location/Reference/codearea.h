@@ -0,0 +1,34 @@
+#ifndef REFERENCE_OPENLOCATIONCODE_CODEAREA_H
+#define REFERENCE_OPENLOCATIONCODE_CODEAREA_H
+
+#include <cstdlib>
+
+namespace openlocationcode_reference {
+
+struct LatLng {
+  double latitude;
+  double longitude;
+};
+
+class CodeArea {
+ public:
+  CodeArea(double latitude_lo, double longitude_lo, double latitude_hi,
+           double longitude_hi, size_t code_length);
+  double GetLatitudeLo() const;
+  double GetLongitudeLo() const;
+  double GetLatitudeHi() const;
+  double GetLongitudeHi() const;
+  size_t GetCodeLength() const;
+  LatLng GetCenter() const;
+
+ private:
+  double latitude_lo_;
+  double longitude_lo_;
+  double latitude_hi_;
+  double longitude_hi_;
+  size_t code_length_;
+};
+
+} // namespace openlocationcode_reference
+
+#endif  // REFERENCE_OPENLOCATIONCODE_CODEAREA_H_
\ No newline at end of file
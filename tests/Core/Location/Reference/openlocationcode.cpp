@@ -1,11 +1,11 @@
-#include "../inc/Core/Location/PlusCodes/openlocationcode.h"
+#include "openlocationcode.h"
 
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <float.h>
 
-namespace openlocationcode {
+namespace openlocationcode_reference {
 namespace internal {
 const char kSeparator = '+';
 const char kPaddingCharacter = '0';
@@ -455,4 +455,4 @@ size_t CodeLength(const std::string &code) {
   return clean_code.size();
 }
 
-} // namespace openlocationcode
\ No newline at end of file
+} // namespace openlocationcode_reference
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "Core/Location/SpatialIndex.h"
+#include "../../Test.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+class SpatialIndexTest : public ::testing::Test {
+protected:
+  using Index = SpatialIndex<int>;
+
+  void SetUp() override {
+    std::mt19937 Generator(42);
+    std::normal_distribution<double> Spread(0, 0.05);
+    std::uniform_real_distribution<double> Latitude(-89.9, 89.9);
+    std::uniform_real_distribution<double> Longitude(-180, 180);
+    for (int i = 0; i < 20000; i++) {
+      if (i % 4 == 0) {
+        Points.push_back({i, {Latitude(Generator), Longitude(Generator)}});
+      } else {
+        /** @brief clustered around tel aviv and across the antimeridian. */
+        double Lng = i % 2 ? 34.78 : 179.98;
+        Points.push_back(
+            {i, {32.08 + Spread(Generator), Lng + Spread(Generator)}});
+      }
+    }
+  }
+
+  std::vector<Index::Result> BruteForce(const Index::LatLng &Query) const {
+    std::vector<Index::Result> Results;
+    for (const auto &Point : Points) {
+      Results.push_back({Point.Key, Point.Location,
+                         Index::Distance(Query, Point.Location)});
+    }
+    std::sort(Results.begin(), Results.end(), [](auto &Lhs, auto &Rhs) {
+      return Lhs.Distance < Rhs.Distance;
+    });
+    return Results;
+  }
+
+  std::vector<Index::Entry> Points;
+  const std::vector<Index::LatLng> Queries{
+      {32.08, 34.78}, {32.1, -179.99}, {89.95, 10}, {-89.95, -170},
+      {0, 0},         {51.5, -0.12},   {32.08, 179.99}};
+};
+
+TEST_F(SpatialIndexTest, SpatialIndexNearestTest) {
+  for (size_t CodeLength : {4, 6, 8}) {
+    Index Grid(CodeLength);
+    Grid.BulkLoad(Points);
+    EXPECT_EQ(Grid.Size(), Points.size());
+
+    for (const auto &Query : Queries) {
+      auto Expected = BruteForce(Query);
+      auto Results = Grid.Nearest(Query, 25);
+      ASSERT_EQ(Results.size(), 25);
+      for (size_t i = 0; i < Results.size(); i++) {
+        EXPECT_DOUBLE_EQ(Results[i].Distance, Expected[i].Distance);
+      }
+    }
+  }
+}
+
+TEST_F(SpatialIndexTest, SpatialIndexWithinRadiusTest) {
+  Index Grid(8);
+  Grid.BulkLoad(Points);
+
+  for (const auto &Query : Queries) {
+    for (double Radius : {500.0, 5000.0, 2000000.0}) {
+      auto Expected = BruteForce(Query);
+      auto Count = std::count_if(Expected.begin(), Expected.end(),
+                                 [Radius](const Index::Result &Result) {
+                                   return Result.Distance <= Radius;
+                                 });
+      auto Results = Grid.WithinRadius(Query, Radius);
+      ASSERT_EQ(Results.size(), Count);
+      EXPECT_TRUE(std::is_sorted(
+          Results.begin(), Results.end(),
+          [](auto &Lhs, auto &Rhs) { return Lhs.Distance < Rhs.Distance; }));
+    }
+  }
+}
+
+TEST_F(SpatialIndexTest, SpatialIndexInsertRemoveTest) {
+  Index Grid;
+  Grid.Insert(1, {32.08, 34.78});
+  Grid.Insert(2, {32.09, 34.79});
+
+  EXPECT_EQ(Grid.Nearest({32.09, 34.79}, 1).front().Key, 2);
+  EXPECT_TRUE(Grid.Remove(2, {32.09, 34.79}));
+  EXPECT_FALSE(Grid.Remove(2, {32.09, 34.79}));
+  EXPECT_EQ(Grid.Nearest({32.09, 34.79}, 1).front().Key, 1);
+  EXPECT_EQ(Grid.Size(), 1);
+  EXPECT_TRUE(Grid.Nearest({0, 0}, 0).empty());
+}
@@ -0,0 +1,102 @@
+#include "Core/Metrics/Metrics.h"
+#include "Core/Metrics/MetricsExporter.h"
+#include "../Test.h"
+
+#include <arpa/inet.h>
+#include <filesystem>
+#include <fstream>
+#include <netinet/in.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+
+TEST(MetricsTest, MetricsRenderTest) {
+  auto &Requests = Metrics::GetCounter("test_requests_total", "Requests.",
+                                       {{"method", "get"}});
+  auto &Connections = Metrics::GetGauge("test_connections", "Connections.");
+  auto &Latency = Metrics::GetHistogram("test_latency_seconds", "Latency.",
+                                        {{"method", "get"}}, {0.1, 1});
+  Requests.Increment(3);
+  Connections.Set(2);
+  Connections.Add(-0.5);
+  Latency.Observe(0.05);
+  Latency.Observe(0.5);
+  Latency.Observe(5);
+
+  /** @brief the same name and labels are the same metric. */
+  EXPECT_EQ(&Requests, &Metrics::GetCounter("test_requests_total", "Requests.",
+                                            {{"method", "get"}}));
+  EXPECT_THROW(Metrics::GetGauge("test_requests_total", "Requests."),
+               std::invalid_argument);
+
+  const auto Output = Metrics::Render();
+  EXPECT_NE(Output.find("# HELP test_requests_total Requests.\n"
+                        "# TYPE test_requests_total counter\n"
+                        "test_requests_total{method=\"get\"} 3\n"),
+            std::string::npos);
+  EXPECT_NE(Output.find("# TYPE test_connections gauge\n"
+                        "test_connections 1.5\n"),
+            std::string::npos);
+  EXPECT_NE(
+      Output.find("test_latency_seconds_bucket{method=\"get\",le=\"0.1\"} 1\n"
+                  "test_latency_seconds_bucket{method=\"get\",le=\"1\"} 2\n"
+                  "test_latency_seconds_bucket{method=\"get\",le=\"+Inf\"} 3\n"
+                  "test_latency_seconds_sum{method=\"get\"} 5.55\n"
+                  "test_latency_seconds_count{method=\"get\"} 3\n"),
+      std::string::npos);
+}
+
+TEST(MetricsTest, MetricsLabelsAndCollectorTest) {
+  EXPECT_EQ(Metrics::FormatLabels({}), "");
+  EXPECT_EQ(Metrics::FormatLabels({{"a", "x"}, {"b", "say \"hi\"\\\n"}}),
+            "{a=\"x\",b=\"say \\\"hi\\\"\\\\\\n\"}");
+
+  Metrics::AddCollector("test", [](std::string &Out) {
+    Metrics::WriteHeader(Out, "test_collected", Metrics::Type::Gauge,
+                         "Collected.");
+    Metrics::WriteSample(Out, "test_collected", {{"source", "test"}}, 7);
+  });
+  EXPECT_NE(Metrics::Render().find("# TYPE test_collected gauge\n"
+                                   "test_collected{source=\"test\"} 7\n"),
+            std::string::npos);
+  Metrics::RemoveCollector("test");
+  EXPECT_EQ(Metrics::Render().find("test_collected"), std::string::npos);
+}
+
+TEST(MetricsTest, MetricsExporterTest) {
+  Metrics::GetCounter("test_exported_total", "Exported.").Increment();
+  const auto Path =
+      std::filesystem::temp_directory_path() / "liveview-metrics.prom";
+
+  MetricsExporter Exporter{
+      {.Path = Path.string(), .Interval = std::chrono::seconds(60),
+       .Port = 19464}};
+  ASSERT_TRUE(Exporter.WriteFile());
+  std::stringstream File;
+  File << std::ifstream(Path).rdbuf();
+  EXPECT_NE(File.str().find("test_exported_total 1\n"), std::string::npos);
+
+  ASSERT_EQ(Exporter.GetPort(), 19464);
+  const int Socket = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in Address{};
+  Address.sin_family = AF_INET;
+  Address.sin_port = htons(Exporter.GetPort());
+  Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(connect(Socket, reinterpret_cast<sockaddr *>(&Address),
+                    sizeof(Address)),
+            0);
+  const std::string Request = "GET /metrics HTTP/1.1\r\nHost: x\r\n\r\n";
+  ASSERT_EQ(send(Socket, Request.data(), Request.size(), 0),
+            static_cast<ssize_t>(Request.size()));
+  std::string Response;
+  char Buffer[4096];
+  ssize_t Read = 0;
+  while ((Read = recv(Socket, Buffer, sizeof(Buffer), 0)) > 0) {
+    Response.append(Buffer, static_cast<size_t>(Read));
+  }
+  close(Socket);
+  EXPECT_EQ(Response.rfind("HTTP/1.1 200 OK\r\n", 0), 0);
+  EXPECT_NE(Response.find("test_exported_total 1\n"), std::string::npos);
+
+  std::filesystem::remove(Path);
+}
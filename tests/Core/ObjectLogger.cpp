@@ -0,0 +1,129 @@
+#include "Core/ObjectLogger.h"
+#include "../Test.h"
+#include "Models/AddressModel.h"
+
+#include <algorithm>
+#include <thread>
+
+class ObjectLoggerTest : public ::testing::Test {
+protected:
+  std::shared_ptr<DatabaseManager> ManagerConnection;
+  std::unique_ptr<DatabasePool> Pool;
+
+  void SetUp() override {
+    std::string DatabaseConnectionString;
+    if (std::getenv("GITHUB_ACTIONS") != nullptr) {
+      DatabaseConnectionString =
+          Config::TestDatabaseToString("../../configs/ci-config.json");
+    } else {
+      DatabaseConnectionString =
+          Config::TestDatabaseToString("../../configs/config.json");
+    }
+    Pool = std::make_unique<DatabasePool>(std::move(DatabaseConnectionString));
+    Pool->InitModels();
+    ManagerConnection = Pool->GetManagerConnection();
+  }
+
+  void TearDown() override {
+    ManagerConnection->RemoveModel("AddressLog");
+    ManagerConnection->RemoveModel("Log");
+    ManagerConnection->RemoveModel("Address");
+    ManagerConnection.reset();
+  }
+
+  std::string AddAddress(int Number) {
+    auto Address = Pool->GetUniqueModelConnection<AddressModel>();
+    Address->Add(ManagerConnection, {{"addressname", "objectlogger"},
+                                     {"addressnumber", std::to_string(Number)},
+                                     {"addresscity", "holon"},
+                                     {"country", "israel"}});
+    return Address->GetAddressID(ManagerConnection, "objectlogger", Number);
+  }
+
+  /**
+   * @brief the address' messages in the order they were written.
+   */
+  std::vector<std::string> AddressMessages(const std::string &ID) {
+    auto Result =
+        ManagerConnection->GetModelData("AddressLog", "addressid", ID);
+    std::vector<std::pair<int64_t, std::string>> Rows;
+    for (const auto &Row : Result) {
+      Rows.emplace_back(Row["logid"].as<int64_t>(),
+                        Row["logmsg"].as<std::string>());
+    }
+    std::sort(Rows.begin(), Rows.end());
+    std::vector<std::string> Messages;
+    for (auto &[LogID, Message] : Rows) {
+      Messages.push_back(std::move(Message));
+    }
+    return Messages;
+  }
+};
+
+TEST_F(ObjectLoggerTest, ObjectLoggerOrderTest) {
+  constexpr int Threads = 4;
+  constexpr int Entries = 2000;
+  std::vector<std::string> IDs;
+  for (int i = 0; i < Threads; i++) {
+    IDs.push_back(AddAddress(i + 1));
+  }
+
+  ObjectLogPipeline Pipeline{*Pool, {.Capacity = 1 << 14, .BatchSize = 256}};
+  std::vector<std::thread> Producers;
+  for (int i = 0; i < Threads; i++) {
+    Producers.emplace_back([&Pipeline, &IDs, i] {
+      AddressLogger Logger{Pipeline, IDs[i]};
+      for (int j = 0; j < Entries; j++) {
+        Logger.log(std::to_string(j));
+      }
+    });
+  }
+  for (auto &Producer : Producers) {
+    Producer.join();
+  }
+  Pipeline.Flush();
+
+  EXPECT_EQ(Pipeline.GetDropped(), 0);
+  EXPECT_EQ(Pipeline.GetFailed(), 0);
+  for (const auto &ID : IDs) {
+    const auto Messages = AddressMessages(ID);
+    ASSERT_EQ(Messages.size(), Entries);
+    for (int j = 0; j < Entries; j++) {
+      EXPECT_EQ(Messages[j], std::to_string(j));
+    }
+  }
+}
+
+TEST_F(ObjectLoggerTest, ObjectLoggerFailedRowTest) {
+  const auto ID = AddAddress(1);
+  ObjectLogPipeline Pipeline{*Pool, {.FlushInterval = std::chrono::hours(1)}};
+  AddressLogger Logger{Pipeline, ID};
+  AddressLogger Missing{Pipeline, "00000000-0000-0000-0000-000000000000"};
+
+  Logger.log("first");
+  Missing.log(ObjectLogLevel::Error, "missing");
+  Logger.log(ObjectLogLevel::Warn, "second");
+  Pipeline.Flush();
+
+  EXPECT_EQ(Pipeline.GetFailed(), 1);
+  EXPECT_EQ(AddressMessages(ID), (std::vector<std::string>{"first", "second"}));
+}
+
+TEST_F(ObjectLoggerTest, ObjectLoggerBusinessTest) {
+  {
+    ObjectLogPipeline Pipeline{*Pool};
+    BusinessLogger Logger{Pipeline, "business"};
+    Logger.log(std::string(150, 'x'));
+  }
+
+  std::vector<std::string> Messages;
+  for (const auto &Row : ManagerConnection->GetModelData("Log")) {
+    auto Message = Row["logmsg"].as<std::string>();
+    if (Message.starts_with("business ")) {
+      Messages.push_back(std::move(Message));
+    }
+  }
+  ASSERT_EQ(Messages.size(), 1);
+  /** @brief logmsg holds 100 characters. */
+  EXPECT_EQ(Messages[0], "business " + std::string(91, 'x'));
+}
@@ -0,0 +1,141 @@
+#ifndef ENABLE_PROFILING
+#define ENABLE_PROFILING
+#endif
+#include "Core/Profiler.h"
+#include "../Test.h"
+
+#include <algorithm>
+#include <set>
+#include <thread>
+
+class ProfilerTest : public ::testing::Test {
+protected:
+  void SetUp() override { Profiler::Init({.Enabled = true}); }
+  void TearDown() override { Profiler::Init({}); }
+};
+
+TEST_F(ProfilerTest, ProfilerBucketTest) {
+  for (uint64_t Nanoseconds :
+       {uint64_t{0}, uint64_t{3}, uint64_t{4}, uint64_t{9}, uint64_t{1000},
+        uint64_t{123456789}}) {
+    const size_t Index = ProfileZone::BucketIndex(Nanoseconds);
+    EXPECT_LE(Nanoseconds, ProfileZone::BucketUpperBound(Index));
+    if (Index > 0) {
+      EXPECT_GT(Nanoseconds, ProfileZone::BucketUpperBound(Index - 1));
+    }
+  }
+  EXPECT_EQ(ProfileZone::BucketIndex(~uint64_t{0}),
+            ProfileZone::BucketCount - 1);
+}
+
+TEST_F(ProfilerTest, ProfilerAggregateTest) {
+  auto &Zone = Profiler::GetZone("ProfilerAggregateTest");
+  EXPECT_EQ(&Zone, &Profiler::GetZone("ProfilerAggregateTest"));
+  for (int i = 1; i <= 100; i++) {
+    Zone.Add(static_cast<uint64_t>(i) * 1000);
+  }
+  const auto Stats = Zone.GetStats();
+  EXPECT_EQ(Stats.Count, 100);
+  EXPECT_EQ(Stats.Mean, std::chrono::nanoseconds(50500));
+  EXPECT_EQ(Stats.Max, std::chrono::nanoseconds(100000));
+  /** @brief a bucket spans a quarter of its power of two. */
+  EXPECT_GE(Stats.P50, std::chrono::nanoseconds(50000));
+  EXPECT_LE(Stats.P50, std::chrono::nanoseconds(50000 * 5 / 4));
+  EXPECT_GE(Stats.P99, std::chrono::nanoseconds(99000));
+  EXPECT_LE(Stats.P99, Stats.Max);
+
+  Profiler::Reset();
+  EXPECT_EQ(Zone.GetStats().Count, 0);
+}
+
+TEST_F(ProfilerTest, ProfilerThreadsTest) {
+  std::vector<std::thread> Threads;
+  for (int i = 0; i < 4; i++) {
+    Threads.emplace_back([] {
+      for (int j = 0; j < 1000; j++) {
+        PROFILE_ZONE("ProfilerThreadsTest");
+      }
+    });
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  EXPECT_EQ(Profiler::GetZone("ProfilerThreadsTest").GetStats().Count, 4000);
+
+  Profiler::SetEnabled(false);
+  {
+    PROFILE_ZONE("ProfilerThreadsTest");
+  }
+  EXPECT_EQ(Profiler::GetZone("ProfilerThreadsTest").GetStats().Count, 4000);
+}
+
+TEST_F(ProfilerTest, ProfilerCountersTest) {
+  PerfSample Begin;
+  PerfSample End;
+  Begin.Values[0] = 10;
+  End.Values[0] = 25;
+  Begin.Valid = 0b11;
+  End.Valid = 0b01;
+  const auto Delta = End - Begin;
+  EXPECT_TRUE(Delta.Has(PerfEvent::Cycles));
+  EXPECT_FALSE(Delta.Has(PerfEvent::Instructions));
+  EXPECT_EQ(Delta.Get(PerfEvent::Cycles), 15);
+
+  /** @brief context switches fall back to getrusage, always counted. */
+  EXPECT_TRUE(PerfCounters::ForThread().Has(PerfEvent::ContextSwitches));
+  Profiler::Init({.Enabled = true, .HardwareCounters = true});
+  for (int i = 0; i < 3; i++) {
+    PROFILE_ZONE_COUNTERS("ProfilerCountersTest");
+    std::this_thread::yield();
+  }
+  {
+    PROFILE_ZONE("ProfilerCountersTest");
+  }
+  const auto Stats = Profiler::GetZone("ProfilerCountersTest").GetStats();
+  EXPECT_EQ(Stats.Count, 4);
+  EXPECT_EQ(Stats.CounterRuns[static_cast<size_t>(PerfEvent::ContextSwitches)],
+            3);
+  for (size_t i = 0; i < PerfSample::Size; i++) {
+    EXPECT_EQ(Stats.Counters.Has(static_cast<PerfEvent>(i)),
+              PerfCounters::ForThread().Has(static_cast<PerfEvent>(i)));
+  }
+  EXPECT_NE(Profiler::Report().find("context_switches="), std::string::npos);
+
+  Benchmark Run{"ProfilerCountersTest", true};
+  Run.Stop();
+  EXPECT_TRUE(Run.GetCounters().Has(PerfEvent::ContextSwitches));
+}
+
+TEST_F(ProfilerTest, ProfilerTraceTest) {
+  const auto Path =
+      std::filesystem::temp_directory_path() / "liveview-trace.json";
+  Profiler::Init({.Enabled = true, .TracePath = Path.string()});
+  {
+    PROFILE_ZONE("Outer \"zone\"");
+    std::thread([] { PROFILE_ZONE("Inner"); }).join();
+  }
+  {
+    Benchmark Run{"ProfilerTraceTest"};
+    EXPECT_GE(Run.Stop(), 0);
+  }
+
+  ASSERT_TRUE(Profiler::WriteTrace());
+  std::ifstream File(Path);
+  const auto Trace = Json::parse(File);
+  std::vector<std::string> Names;
+  std::set<uint64_t> Threads;
+  for (const auto &Event : Trace.at("traceEvents")) {
+    EXPECT_EQ(Event.at("ph"), "X");
+    EXPECT_GE(Event.at("ts").get<double>(), 0);
+    EXPECT_GE(Event.at("dur").get<double>(), 0);
+    Names.push_back(Event.at("name"));
+    Threads.insert(Event.at("tid").get<uint64_t>());
+  }
+  std::sort(Names.begin(), Names.end());
+  EXPECT_EQ(Names, (std::vector<std::string>{"Inner", "Outer \"zone\"",
+                                             "ProfilerTraceTest"}));
+  EXPECT_EQ(Threads.size(), 2);
+  EXPECT_NE(Profiler::Report().find("ProfilerTraceTest"), std::string::npos);
+
+  std::filesystem::remove(Path);
+}
@@ -0,0 +1,101 @@
+#include "Core/Scheduler.h"
+#include "../Test.h"
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+uint64_t Fibonacci(Scheduler &Workers, uint64_t Value) {
+  if (Value < 2) {
+    return Value;
+  }
+  uint64_t First = 0;
+  uint64_t Second = 0;
+  TaskGroup Group{Workers};
+  Group.Run([&] { First = Fibonacci(Workers, Value - 1); });
+  Second = Fibonacci(Workers, Value - 2);
+  Group.Wait();
+  return First + Second;
+}
+} // namespace
+
+TEST(SchedulerTest, SchedulerSubmitTest) {
+  constexpr int JOBS = 10000;
+  std::atomic<int> Ran{0};
+  {
+    Scheduler Workers{{.Threads = 4, .DequeCapacity = 2}};
+    EXPECT_EQ(Workers.GetThreadCount(), 4);
+    EXPECT_FALSE(Workers.IsWorkerThread());
+    for (int i = 0; i < JOBS; i++) {
+      Workers.Submit([&] { Ran++; });
+    }
+  }
+  /** @brief the destructor runs what was submitted. */
+  EXPECT_EQ(Ran, JOBS);
+}
+
+TEST(SchedulerTest, SchedulerTaskGroupTest) {
+  Scheduler Workers{{.Threads = 4, .DequeCapacity = 2}};
+  /** @brief nested groups, every worker waits on jobs others stole. */
+  EXPECT_EQ(Fibonacci(Workers, 24), 46368);
+
+  TaskGroup Group{Workers};
+  std::atomic<int> Ran{0};
+  for (int i = 0; i < 100; i++) {
+    Group.Run([&, i] {
+      Ran++;
+      if (i == 42) {
+        throw std::runtime_error("fail");
+      }
+    });
+  }
+  EXPECT_THROW(Group.Wait(), std::runtime_error);
+  EXPECT_EQ(Ran, 100);
+  /** @brief the exception was taken, the group can be reused. */
+  Group.Run([&] { Ran++; });
+  EXPECT_NO_THROW(Group.Wait());
+  EXPECT_EQ(Ran, 101);
+}
+
+TEST(SchedulerTest, SchedulerSingleWorkerTest) {
+  /** @brief a job waiting on its group runs the group itself. */
+  Scheduler Workers{{.Threads = 1}};
+  std::atomic<int> Ran{0};
+  TaskGroup Outer{Workers};
+  Outer.Run([&] {
+    TaskGroup Inner{Workers};
+    for (int i = 0; i < 10; i++) {
+      Inner.Run([&] { Ran++; });
+    }
+    Inner.Wait();
+  });
+  Outer.Wait();
+  EXPECT_EQ(Ran, 10);
+}
+
+TEST(SchedulerTest, SchedulerParallelForTest) {
+  Scheduler Workers{{.Threads = 4}};
+  std::vector<int> Hits(100000, 0);
+  std::atomic<size_t> Chunks{0};
+  ParallelFor(Workers, 0, Hits.size(), 1000, [&](size_t Begin, size_t End) {
+    EXPECT_LE(End - Begin, 1000);
+    for (size_t i = Begin; i < End; i++) {
+      Hits[i]++;
+    }
+    Chunks++;
+  });
+  EXPECT_EQ(std::count(Hits.begin(), Hits.end(), 1), Hits.size());
+  EXPECT_GE(Chunks, 100);
+
+  std::atomic<uint64_t> Sum{0};
+  ParallelFor(Workers, 1, 1001, 0, [&](size_t Begin, size_t End) {
+    uint64_t Local = 0;
+    for (size_t i = Begin; i < End; i++) {
+      Local += i;
+    }
+    Sum += Local;
+  });
+  EXPECT_EQ(Sum, 500500);
+  ParallelFor(Workers, 5, 5, 0, [](size_t, size_t) { FAIL(); });
+}
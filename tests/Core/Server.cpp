@@ -0,0 +1,165 @@
+#include "Core/Server/HttpServer.h"
+#include "../Test.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+/**
+ * @brief sends Request on a new loopback connection and reads until the
+ * server closes it or Expected bytes came.
+ */
+std::string Exchange(uint16_t Port, std::string_view Request,
+                     size_t Expected) {
+  const int Socket = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in Address{};
+  Address.sin_family = AF_INET;
+  Address.sin_port = htons(Port);
+  Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  timeval Timeout{5, 0};
+  setsockopt(Socket, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof(Timeout));
+  std::string Received;
+  if (connect(Socket, reinterpret_cast<sockaddr *>(&Address),
+              sizeof(Address)) == 0 &&
+      send(Socket, Request.data(), Request.size(), MSG_NOSIGNAL) ==
+          static_cast<ssize_t>(Request.size())) {
+    char Buffer[4096];
+    while (Received.size() < Expected) {
+      const ssize_t Read = recv(Socket, Buffer, sizeof(Buffer), 0);
+      if (Read <= 0) {
+        break;
+      }
+      Received.append(Buffer, static_cast<size_t>(Read));
+    }
+  }
+  close(Socket);
+  return Received;
+}
+
+std::string Serialize(int Status, std::string Body, bool KeepAlive) {
+  HttpResponse Response;
+  Response.Status = Status;
+  Response.Body = std::move(Body);
+  std::string Output;
+  Response.AppendTo(Output, KeepAlive, false);
+  return Output;
+}
+} // namespace
+
+TEST(HttpServerTest, HttpServerParseTest) {
+  HttpRequest Request;
+  size_t Consumed = 0;
+  const std::string_view Buffer =
+      "POST /addresses/42?name=ha+maas&number=18 HTTP/1.1\r\n"
+      "Host: localhost\r\nCONTENT-LENGTH: 4\r\n\r\nbodyGET / HTTP/1.0\r\n";
+  ASSERT_EQ(HttpRequest::Parse(Buffer, Request, Consumed, 1024),
+            HttpParseStatus::Complete);
+  EXPECT_EQ(Request.Method, HttpMethod::Post);
+  EXPECT_EQ(Request.Path, "/addresses/42");
+  EXPECT_EQ(Request.Body, "body");
+  EXPECT_TRUE(Request.KeepAlive);
+  EXPECT_EQ(Request.Header("host"), "localhost");
+  EXPECT_EQ(HttpRequest::Decode(Request.QueryParameter("name")), "ha maas");
+  EXPECT_EQ(Request.QueryParameter("number"), "18");
+  EXPECT_TRUE(Request.QueryParameter("missing").empty());
+
+  /** @brief the pipelined request isn't complete yet. */
+  EXPECT_EQ(HttpRequest::Parse(Buffer.substr(Consumed), Request, Consumed,
+                               1024),
+            HttpParseStatus::Incomplete);
+  EXPECT_EQ(HttpRequest::Parse("GET / HTTP/1.0\r\n\r\n", Request, Consumed,
+                               1024),
+            HttpParseStatus::Complete);
+  EXPECT_FALSE(Request.KeepAlive);
+
+  EXPECT_EQ(HttpRequest::Parse("GET / HTTP/2\r\n\r\n", Request, Consumed,
+                               1024),
+            HttpParseStatus::Invalid);
+  EXPECT_EQ(HttpRequest::Parse("POST / HTTP/1.1\r\nContent-Length: x\r\n\r\n",
+                               Request, Consumed, 1024),
+            HttpParseStatus::Invalid);
+  EXPECT_EQ(HttpRequest::Parse(
+                "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n",
+                Request, Consumed, 1024),
+            HttpParseStatus::Invalid);
+  EXPECT_EQ(HttpRequest::Parse(
+                "POST / HTTP/1.1\r\nContent-Length: 2000\r\n\r\n", Request,
+                Consumed, 1024),
+            HttpParseStatus::TooLarge);
+  EXPECT_EQ(HttpRequest::Parse(std::string(2000, 'a'), Request, Consumed,
+                               1024),
+            HttpParseStatus::TooLarge);
+}
+
+TEST(HttpServerTest, HttpServerDispatchTest) {
+  HttpServer Server{{}};
+  Server.Route(HttpMethod::Get, "/addresses/{}/logs",
+               [](const HttpRequest &Request, HttpResponse &Response) {
+                 Response.Body = Request.Param(0);
+               });
+  Server.Route(HttpMethod::Post, "/fail",
+               [](const HttpRequest &, HttpResponse &) {
+                 throw std::runtime_error("fail");
+               });
+
+  HttpRequest Request;
+  HttpResponse Response;
+  Request.Method = HttpMethod::Head;
+  Request.Path = "/addresses/7/logs";
+  Server.Dispatch(Request, Response);
+  EXPECT_EQ(Response.Status, 200);
+  EXPECT_EQ(Response.Body, "7");
+
+  for (auto [Method, Path, Status] :
+       {std::tuple{HttpMethod::Get, "/addresses//logs", 404},
+        std::tuple{HttpMethod::Get, "/addresses/7/logs/", 404},
+        std::tuple{HttpMethod::Delete, "/addresses/7/logs", 405},
+        std::tuple{HttpMethod::Post, "/fail", 500}}) {
+    Response.Clear();
+    Request.Method = Method;
+    Request.Path = Path;
+    Server.Dispatch(Request, Response);
+    EXPECT_EQ(Response.Status, Status) << Path;
+  }
+  EXPECT_THROW(Server.Route(HttpMethod::Get, "fail", {}),
+               std::invalid_argument);
+}
+
+TEST(HttpServerTest, HttpServerLoopbackTest) {
+  HttpServer Server{{.Port = 0, .Threads = 2}};
+  Server.Route(HttpMethod::Post, "/echo",
+               [](const HttpRequest &Request, HttpResponse &Response) {
+                 Response.ContentType = "text/plain";
+                 Response.Body = Request.Body;
+               });
+  ASSERT_TRUE(Server.Start());
+  ASSERT_NE(Server.GetPort(), 0);
+  EXPECT_EQ(Server.GetThreadCount(), 2);
+
+  /** @brief two pipelined requests on one kept alive connection. */
+  auto Echo = [](std::string_view Body, bool KeepAlive) {
+    HttpResponse Response;
+    Response.ContentType = "text/plain";
+    Response.Body = Body;
+    std::string Output;
+    Response.AppendTo(Output, KeepAlive, false);
+    return Output;
+  };
+  const std::string Expected = Echo("first", true) + Echo("second", false);
+  EXPECT_EQ(Exchange(Server.GetPort(),
+                     "POST /echo HTTP/1.1\r\nContent-Length: 5\r\n\r\nfirst"
+                     "POST /echo HTTP/1.1\r\nContent-Length: 6\r\n"
+                     "Connection: close\r\n\r\nsecond",
+                     Expected.size() + 1),
+            Expected);
+
+  EXPECT_EQ(Exchange(Server.GetPort(), "GET /missing HTTP/1.0\r\n\r\n", 1024),
+            Serialize(404, R"({"error":"not found"})", false));
+  EXPECT_EQ(Exchange(Server.GetPort(), "BROKEN\r\n\r\n", 1024),
+            Serialize(400, R"({"error":"malformed request"})", false));
+
+  Server.Stop();
+  EXPECT_EQ(Server.GetPort(), 0);
+}
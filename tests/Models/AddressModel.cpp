@@ -88,6 +88,33 @@ TEST_F(AddressModelTest, AddressUpdateColumnsRecordTest) {
   EXPECT_NE(PreData, PostData);
 }
 
+TEST_F(AddressModelTest, AddressUpdateCoordinateTest) {
+  auto Address = Pool->GetUniqueModelConnection<AddressModel>();
+  Address->Add(ManagerConnection, {{"addressname", "hamaasdasdasdasd"},
+                                   {"addressnumber", "18"},
+                                   {"addresscity", "holon"},
+                                   {"latitude", "32.0171"},
+                                   {"longitude", "34.7737"}});
+  EXPECT_EQ(Address
+                ->GetAddressesWithinRadius(ManagerConnection,
+                                           {32.0171, 34.7737}, 100)
+                .size(),
+            1);
+
+  /** @brief only the longitude moves, the pluscell follows it. */
+  Address->Update(ManagerConnection, {{"longitude", "34.7937"}},
+                  "addressnumber", 18);
+  EXPECT_EQ(Address
+                ->GetAddressesWithinRadius(ManagerConnection,
+                                           {32.0171, 34.7937}, 100)
+                .size(),
+            1);
+  EXPECT_TRUE(Address
+                  ->GetAddressesWithinRadius(ManagerConnection,
+                                             {32.0171, 34.7737}, 100)
+                  .empty());
+}
+
 TEST_F(AddressModelTest, AddressDeleteRecordTest) {
   auto Address = Pool->GetUniqueModelConnection<AddressModel>();
   Address->Add(ManagerConnection, {{"addressname", "hamaasdasdasdasd"},
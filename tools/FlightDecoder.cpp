@@ -0,0 +1,137 @@
+#include "Config/FlightRecorder.h"
+
+#include <spdlog/fmt/chrono.h>
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief turns flight recorder dumps into text, the events of every thread
+ * merged by time.
+ * @details usage: FlightDecoder <dump>... the dump carries its event names,
+ * so files written by older builds decode as long as the layout version
+ * matches.
+ */
+
+namespace {
+struct DecodedEvent {
+  uint32_t ThreadId;
+  FlightRecorder::Event Event;
+};
+
+template <typename T> bool ReadValue(std::ifstream &File, T &Value) {
+  return static_cast<bool>(
+      File.read(reinterpret_cast<char *>(&Value), sizeof(Value)));
+}
+
+std::string ToString(const auto &Chars) {
+  return {Chars.data(), strnlen(Chars.data(), Chars.size())};
+}
+
+std::string_view ReasonToString(FlightDumpReason Reason) {
+  switch (Reason) {
+  case FlightDumpReason::Manual:
+    return "Manual";
+  case FlightDumpReason::Error:
+    return "Error";
+  case FlightDumpReason::Crash:
+    return "Crash";
+  }
+  return "Unknown";
+}
+
+bool Decode(const char *Path) {
+  std::ifstream File(Path, std::ios::binary);
+  FlightRecorder::FileHeader Header{};
+  if (!File || !ReadValue(File, Header) ||
+      Header.Magic != FlightRecorder::Magic) {
+    std::cerr << Path << ": NOT A FLIGHT RECORDER DUMP\n";
+    return false;
+  }
+  if (Header.Version != FlightRecorder::Version) {
+    std::cerr << Path << ": UNSUPPORTED VERSION " << Header.Version << "\n";
+    return false;
+  }
+
+  std::vector<FlightEventType> Types(Header.EventTypes);
+  for (auto &Type : Types) {
+    if (!ReadValue(File, Type)) {
+      std::cerr << Path << ": TRUNCATED EVENT TYPES\n";
+      return false;
+    }
+  }
+
+  std::vector<DecodedEvent> Events;
+  size_t Torn = 0;
+  for (uint32_t t = 0; t < Header.ThreadCount; t++) {
+    FlightRecorder::ThreadHeader Thread{};
+    if (!ReadValue(File, Thread)) {
+      std::cerr << Path << ": TRUNCATED THREAD HEADER\n";
+      return false;
+    }
+    for (uint32_t e = 0; e < Thread.Count; e++) {
+      FlightRecorder::Event Event{};
+      if (!ReadValue(File, Event)) {
+        std::cerr << Path << ": TRUNCATED EVENTS\n";
+        return false;
+      }
+      if (Event.Torn != 0) {
+        Torn++;
+        continue;
+      }
+      Events.push_back({Thread.ThreadId, Event});
+    }
+  }
+  std::stable_sort(Events.begin(), Events.end(),
+                   [](const DecodedEvent &Lhs, const DecodedEvent &Rhs) {
+                     return Lhs.Event.Timestamp < Rhs.Event.Timestamp;
+                   });
+
+  const auto DumpTime = std::chrono::sys_time<std::chrono::nanoseconds>(
+      std::chrono::nanoseconds(Header.SystemNs));
+  std::cout << fmt::format(
+      "{}: pid {}, {} dump{}, {:%F %T} UTC, {} threads, {} events, {} torn\n",
+      Path, Header.ProcessId, ReasonToString(Header.Reason),
+      Header.Signal != 0 ? fmt::format(" (signal {})", Header.Signal) : "",
+      DumpTime, Header.ThreadCount, Events.size(), Torn);
+
+  for (const auto &[ThreadId, Event] : Events) {
+    /** @brief steady clock timestamps, placed against the dump's wall time. */
+    const auto Time = DumpTime + std::chrono::nanoseconds(Event.Timestamp -
+                                                          Header.SteadyNs);
+    std::string Name = fmt::format("EVENT {}", Event.Id);
+    std::string Arguments =
+        fmt::format("arg0={} arg1={}", Event.Args[0], Event.Args[1]);
+    if (Event.Id < Types.size()) {
+      Name = ToString(Types[Event.Id].Name);
+      try {
+        Arguments = fmt::vformat(ToString(Types[Event.Id].Format),
+                                 fmt::make_format_args(Event.Args[0],
+                                                       Event.Args[1]));
+      } catch (const fmt::format_error &) {
+      }
+    }
+    const auto Seconds = std::chrono::floor<std::chrono::seconds>(Time);
+    std::cout << fmt::format("{:%T}.{:09} [{}] {} {}\n", Seconds,
+                             (Time - Seconds).count(), ThreadId, Name,
+                             Arguments);
+  }
+  return true;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <dump>...\n";
+    return 2;
+  }
+  bool Decoded = true;
+  for (int i = 1; i < argc; i++) {
+    Decoded = Decode(argv[i]) && Decoded;
+  }
+  return Decoded ? 0 : 1;
+}